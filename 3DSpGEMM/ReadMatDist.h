@@ -28,10 +28,7 @@ namespace combblas {
 template <typename PARMAT>
 void Symmetricize(PARMAT & A)
 {
-    PARMAT AT = A;
-    AT.Transpose();
-    AT.RemoveLoops(); // needed for non-boolean matrix
-    A += AT;
+    A.Symmetrize(std::plus<typename PARMAT::GlobalNT>(), false); // loops are not doubled, needed for non-boolean matrix
 }
 
 /**
@@ -41,9 +41,12 @@ void ShowUsage()
     {
         cout << "\n-------------- usage --------------\n";
         cout << "Usage: ./awpm -input <filename>\n";
+        cout << "       ./awpm -rmat <scale>: R-MAT matrix with random weights in [2,64] plus a unit diagonal\n";
         cout << "Optional parameters: -randPerm: randomly permute the matrix for load balance (default: no random permutation)\n";
         cout << "                     -optsum: Optimize the sum of diagonal (default: Optimize the product of diagonal)\n";
         cout << "                     -noWeightedCard: do not use weighted cardinality matching (default: use weighted cardinality matching)\n";
+        cout << "                     -auction: refine the matching with an epsilon-scaling auction\n";
+        cout << "                     -verify: with -auction, check that the refined matching is perfect and not lighter than the unrefined one\n";
         cout << "                     -output <output file>: output file name \n";
         //cout << "                     -saveMCM <output file>: output file where maximum cardinality matching is saved \n";
         cout << " \n-------------- examples ----------\n";
@@ -83,6 +86,9 @@ int main(int argc, char* argv[])
     bool optimizeProd = true; // by default optimize sum_log_abs(aii) (after equil)
     
     bool weightedCard = true;
+    bool auction = false;
+    bool verify = false;
+    int scale = 0;
     string ifilename = "";
     string ofname = "";
     //string ofnameMCM = "";
@@ -94,12 +100,16 @@ int main(int argc, char* argv[])
         if (string(argv[i]) == string("-optsum")) optimizeProd = false;
         if (string(argv[i]) == string("-noWeightedCard")) weightedCard = false;
         if (string(argv[i]) == string("-randPerm")) randPerm = true;
+        if (string(argv[i]) == string("-rmat")) scale = atoi(argv[i+1]);
+        if (string(argv[i]) == string("-auction")) auction = true;
+        if (string(argv[i]) == string("-verify")) verify = true;
     }
 
     
     
     
     // ------------ Process input arguments and build matrix ---------------
+    bool correct = true;
     {
         Par_DCSC_Double * AWeighted;
         ostringstream tinfo;
@@ -130,6 +140,39 @@ int main(int argc, char* argv[])
             
             AWeighted->PrintInfo();
         }
+        else if(scale > 0)
+        {
+            double initiator[4] = {.57, .19, .19, .05};
+            DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+            DEL->GenGraph500Data(initiator, scale, 8, true, false);
+            Par_DCSC_Double G(*DEL, false);
+            delete DEL;
+            
+            // deterministic weights in [2,64] that do not depend on the process count
+            FullyDistVec<int64_t, int64_t> ri(G.getcommgrid()), ci(G.getcommgrid());
+            FullyDistVec<int64_t, double> w(G.getcommgrid());
+            G.Find(ri, ci, w);
+            w.iota(ri.TotalLength(), 0);
+            w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 63 + 2); });
+            AWeighted = new Par_DCSC_Double(G.getnrow(), G.getncol(), ri, ci, w, false);
+            
+            // the generator stores every edge once, add the other direction with different weights
+            Par_DCSC_Double AT = *AWeighted;
+            AT.Transpose();
+            AT.Apply([](double x){ return 66.0 - x; });
+            *AWeighted += AT;
+            
+            // a light diagonal guarantees a perfect matching
+            FullyDistVec<int64_t, int64_t> diag(G.getcommgrid());
+            diag.iota(G.getnrow(), 0);
+            Par_DCSC_Double D(G.getnrow(), G.getncol(), diag, diag, 1.0, false);
+            *AWeighted += D;
+            
+            tinfo.str("");
+            tinfo << "Generated R-MAT matrix of scale " << scale << endl;
+            SpParHelper::Print(tinfo.str());
+            AWeighted->PrintInfo();
+        }
         else
         {
             ShowUsage();
@@ -180,8 +223,13 @@ int main(int argc, char* argv[])
         FullyDistVec<int64_t, int64_t> mateRow2Col ( A.getcommgrid(), A.getnrow(), (int64_t) -1);
         FullyDistVec<int64_t, int64_t> mateCol2Row ( A.getcommgrid(), A.getncol(), (int64_t) -1);
         
+        FullyDistVec<int64_t, int64_t> unrefinedRow2Col ( A.getcommgrid(), A.getnrow(), (int64_t) -1);
+        FullyDistVec<int64_t, int64_t> unrefinedCol2Row ( A.getcommgrid(), A.getncol(), (int64_t) -1);
+        if(auction && verify)
+            AWPM(*AWeighted, unrefinedRow2Col, unrefinedCol2Row,  optimizeProd, weightedCard);
+        
         double startT = MPI_Wtime();
-        AWPM(*AWeighted, mateRow2Col, mateCol2Row,  optimizeProd, weightedCard);
+        AWPM(*AWeighted, mateRow2Col, mateCol2Row,  optimizeProd, weightedCard, auction);
         double endT = MPI_Wtime();
         
 
@@ -198,6 +246,13 @@ int main(int argc, char* argv[])
         tinfo  << "Sum of Diagonal (with transformation)" << endl;
         tinfo << "      After matching: "<< mWeight  << endl;
         tinfo << "      Before matching: " << origWeight << endl;
+        if(auction && verify)
+        {
+            double unrefinedWeight = MatchingWeight( *AWeighted, unrefinedRow2Col, unrefinedCol2Row) ;
+            tinfo << "      Without auction: " << unrefinedWeight << endl;
+            correct = CheckMatching(mateRow2Col, mateCol2Row) && mWeight >= unrefinedWeight - 1e-9 * fabs(unrefinedWeight);
+            tinfo << (correct ? "Verification passed" : "ERROR: the refined matching is not perfect or lighter than the unrefined one") << endl;
+        }
         
         tinfo  << "Time: " << endT - startT << endl;
         tinfo  << "----------------------------------------\n";
@@ -218,7 +273,7 @@ int main(int argc, char* argv[])
         
     }
     MPI_Finalize();
-    return 0;
+    return correct ? 0 : 1;
 }
 
 
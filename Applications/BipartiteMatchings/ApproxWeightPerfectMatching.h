@@ -40,13 +40,15 @@ struct AWPM_param
 };
 
 
-template <class IT, class NT>
-std::vector<std::tuple<IT,IT,NT>> ExchangeData(std::vector<std::vector<std::tuple<IT,IT,NT>>> & tempTuples, MPI_Comm World)
+// Personalized all-to-all exchange of fixed size records (tuples of indices and values)
+// tempTuples[k] is sent to process k of World and is cleared on return
+template <class T>
+std::vector<T> ExchangeData(std::vector<std::vector<T>> & tempTuples, MPI_Comm World)
 {
 	
 	/* Create/allocate variables for vector assignment */
 	MPI_Datatype MPI_tuple;
-	MPI_Type_contiguous(sizeof(std::tuple<IT,IT,NT>), MPI_CHAR, &MPI_tuple);
+	MPI_Type_contiguous(sizeof(T), MPI_CHAR, &MPI_tuple);
 	MPI_Type_commit(&MPI_tuple);
 	
 	int nprocs;
@@ -58,8 +60,8 @@ std::vector<std::tuple<IT,IT,NT>> ExchangeData(std::vector<std::vector<std::tupl
 	int * rdispls = new int[nprocs]();
 	
 	// Set the newly found vector entries
-	IT totsend = 0;
-	for(IT i=0; i<nprocs; ++i)
+	int64_t totsend = 0;
+	for(int i=0; i<nprocs; ++i)
 	{
 		sendcnt[i] = tempTuples[i].size();
 		totsend += tempTuples[i].size();
@@ -69,16 +71,16 @@ std::vector<std::tuple<IT,IT,NT>> ExchangeData(std::vector<std::vector<std::tupl
 	
 	std::partial_sum(sendcnt, sendcnt+nprocs-1, sdispls+1);
 	std::partial_sum(recvcnt, recvcnt+nprocs-1, rdispls+1);
-	IT totrecv = accumulate(recvcnt,recvcnt+nprocs, static_cast<IT>(0));
+	int64_t totrecv = std::accumulate(recvcnt,recvcnt+nprocs, static_cast<int64_t>(0));
 	
 	
-	std::vector< std::tuple<IT,IT,NT> > sendTuples(totsend);
+	std::vector< T > sendTuples(totsend);
 	for(int i=0; i<nprocs; ++i)
 	{
 		copy(tempTuples[i].begin(), tempTuples[i].end(), sendTuples.data()+sdispls[i]);
-		std::vector< std::tuple<IT,IT,NT> >().swap(tempTuples[i]);	// clear memory
+		std::vector< T >().swap(tempTuples[i]);	// clear memory
 	}
-	std::vector< std::tuple<IT,IT,NT> > recvTuples(totrecv);
+	std::vector< T > recvTuples(totrecv);
 	MPI_Alltoallv(sendTuples.data(), sendcnt, sdispls, MPI_tuple, recvTuples.data(), recvcnt, rdispls, MPI_tuple, World);
 	DeleteAll(sendcnt, recvcnt, sdispls, rdispls); // free all memory
 	MPI_Type_free(&MPI_tuple);
@@ -87,54 +89,6 @@ std::vector<std::tuple<IT,IT,NT>> ExchangeData(std::vector<std::vector<std::tupl
 }
 
 
-
-template <class IT, class NT>
-std::vector<std::tuple<IT,IT,IT,NT>> ExchangeData1(std::vector<std::vector<std::tuple<IT,IT,IT,NT>>> & tempTuples, MPI_Comm World)
-{
-	
-	/* Create/allocate variables for vector assignment */
-	MPI_Datatype MPI_tuple;
-	MPI_Type_contiguous(sizeof(std::tuple<IT,IT,IT,NT>), MPI_CHAR, &MPI_tuple);
-	MPI_Type_commit(&MPI_tuple);
-	
-	int nprocs;
-	MPI_Comm_size(World, &nprocs);
-	
-	int * sendcnt = new int[nprocs];
-	int * recvcnt = new int[nprocs];
-	int * sdispls = new int[nprocs]();
-	int * rdispls = new int[nprocs]();
-	
-	// Set the newly found vector entries
-	IT totsend = 0;
-	for(IT i=0; i<nprocs; ++i)
-	{
-		sendcnt[i] = tempTuples[i].size();
-		totsend += tempTuples[i].size();
-	}
-	
-	MPI_Alltoall(sendcnt, 1, MPI_INT, recvcnt, 1, MPI_INT, World);
-	
-	std::partial_sum(sendcnt, sendcnt+nprocs-1, sdispls+1);
-	std::partial_sum(recvcnt, recvcnt+nprocs-1, rdispls+1);
-	IT totrecv = std::accumulate(recvcnt,recvcnt+nprocs, static_cast<IT>(0));
-	
-	std::vector< std::tuple<IT,IT,IT,NT> > sendTuples(totsend);
-	for(int i=0; i<nprocs; ++i)
-	{
-		copy(tempTuples[i].begin(), tempTuples[i].end(), sendTuples.data()+sdispls[i]);
-		std::vector< std::tuple<IT,IT,IT,NT> >().swap(tempTuples[i]);	// clear memory
-	}
-	std::vector< std::tuple<IT,IT,IT,NT> > recvTuples(totrecv);
-	MPI_Alltoallv(sendTuples.data(), sendcnt, sdispls, MPI_tuple, recvTuples.data(), recvcnt, rdispls, MPI_tuple, World);
-	DeleteAll(sendcnt, recvcnt, sdispls, rdispls); // free all memory
-	MPI_Type_free(&MPI_tuple);
-	return recvTuples;
-}
-
-
-
-
 // remember that getnrow() and getncol() require collectives
 // Hence, we save them once and pass them to this function
 template <class IT, class NT,class DER>
@@ -181,13 +135,14 @@ int OwnerProcs(SpParMat < IT, NT, DER > & A, IT grow, IT gcol, IT nrows, IT ncol
  */
 
 
-template <class IT>
-std::vector<std::tuple<IT,IT>> MateBcast(std::vector<std::tuple<IT,IT>> sendTuples, MPI_Comm World)
+// Allgather of fixed size records: every process of World receives the records of all processes
+template <class T>
+std::vector<T> MateBcast(std::vector<T> sendTuples, MPI_Comm World)
 {
 	
 	/* Create/allocate variables for vector assignment */
 	MPI_Datatype MPI_tuple;
-	MPI_Type_contiguous(sizeof(std::tuple<IT,IT>) , MPI_CHAR, &MPI_tuple);
+	MPI_Type_contiguous(sizeof(T) , MPI_CHAR, &MPI_tuple);
 	MPI_Type_commit(&MPI_tuple);
 	
 	
@@ -202,9 +157,9 @@ std::vector<std::tuple<IT,IT>> MateBcast(std::vector<std::tuple<IT,IT>> sendTupl
 	MPI_Allgather(&sendcnt, 1, MPI_INT, recvcnt, 1, MPI_INT, World);
 	
 	std::partial_sum(recvcnt, recvcnt+nprocs-1, rdispls+1);
-	IT totrecv = std::accumulate(recvcnt,recvcnt+nprocs, static_cast<IT>(0));
+	int64_t totrecv = std::accumulate(recvcnt,recvcnt+nprocs, static_cast<int64_t>(0));
 	
-	std::vector< std::tuple<IT,IT> > recvTuples(totrecv);
+	std::vector< T > recvTuples(totrecv);
 	
 	
 	MPI_Allgatherv(sendTuples.data(), sendcnt, MPI_tuple,
@@ -389,6 +344,98 @@ void UpdateMatching(FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mat
 
 
 
+
+// -----------------------------------------------------------
+// replicate mate vectors for mateCol2Row
+// Every process gets the mates of its local columns, indexed by local column id
+// Communication cost: same as the first communication of SpMV
+// -----------------------------------------------------------
+template <class IT>
+std::vector<IT> ReplicateColMates(FullyDistVec<IT, IT>& mateCol2Row)
+{
+	auto commGrid = mateCol2Row.getcommgrid();
+	MPI_Comm World = commGrid->GetWorld();
+	MPI_Comm ColWorld = commGrid->GetColWorld();
+	int pc = commGrid->GetGridCols();
+	int colrank = commGrid->GetRankInProcCol();
+	int diagneigh = commGrid->GetComplementRank();
+	
+	int xsize = (int)  mateCol2Row.LocArrSize();
+	int trxsize = 0;
+	MPI_Status status;
+	MPI_Sendrecv(&xsize, 1, MPI_INT, diagneigh, TRX, &trxsize, 1, MPI_INT, diagneigh, TRX, World, &status);
+	std::vector<IT> trxnums(trxsize);
+	MPI_Sendrecv(mateCol2Row.GetLocArr(), xsize, MPIType<IT>(), diagneigh, TRX, trxnums.data(), trxsize, MPIType<IT>(), diagneigh, TRX, World, &status);
+	
+	
+	std::vector<int> colsize(pc);
+	colsize[colrank] = trxsize;
+	MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, colsize.data(), 1, MPI_INT, ColWorld);
+	std::vector<int> dpls(pc,0);	// displacements (zero initialized pid)
+	std::partial_sum(colsize.data(), colsize.data()+pc-1, dpls.data()+1);
+	int accsize = std::accumulate(colsize.data(), colsize.data()+pc, 0);
+	std::vector<IT> RepMateC2R(accsize);
+	MPI_Allgatherv(trxnums.data(), trxsize, MPIType<IT>(), RepMateC2R.data(), colsize.data(), dpls.data(), MPIType<IT>(), ColWorld);
+	return RepMateC2R;
+}
+
+
+// -----------------------------------------------------------
+// replicate mate vectors for mateRow2Col
+// Every process gets the mates of its local rows, indexed by local row id
+// Communication cost: same as the first communication of SpMV
+//                      (minus the cost of tranposing vector)
+// -----------------------------------------------------------
+template <class IT>
+std::vector<IT> ReplicateRowMates(FullyDistVec<IT, IT>& mateRow2Col)
+{
+	auto commGrid = mateRow2Col.getcommgrid();
+	MPI_Comm RowWorld = commGrid->GetRowWorld();
+	int pr = commGrid->GetGridRows();
+	int rowrank = commGrid->GetRankInProcRow();
+	
+	int xsize = (int)  mateRow2Col.LocArrSize();
+	
+	std::vector<int> rowsize(pr);
+	rowsize[rowrank] = xsize;
+	MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, rowsize.data(), 1, MPI_INT, RowWorld);
+	std::vector<int> rdpls(pr,0);	// displacements (zero initialized pid)
+	std::partial_sum(rowsize.data(), rowsize.data()+pr-1, rdpls.data()+1);
+	int accsize = std::accumulate(rowsize.data(), rowsize.data()+pr, 0);
+	std::vector<IT> RepMateR2C(accsize);
+	MPI_Allgatherv(mateRow2Col.GetLocArr(), xsize, MPIType<IT>(), RepMateR2C.data(), rowsize.data(), rdpls.data(), MPIType<IT>(), RowWorld);
+	return RepMateR2C;
+}
+
+
+// Getting column pointers for all columns (for CSC-style access)
+// An empty local matrix (no dcsc to iterate over) gets all-zero pointers
+template <class DER>
+std::vector<typename DER::LocalIT> ColumnPointers(DER* spSeq)
+{
+	typedef typename DER::LocalIT IT;
+	IT lncol = spSeq->getncol();
+	if(spSeq->getnnz() == 0)
+		return std::vector<IT>(lncol+1, 0);
+    std::vector<IT> colptr (lncol+1,-1);
+	for(auto colit = spSeq->begcol(); colit != spSeq->endcol(); ++colit) // iterate over all columns
+	{
+		IT lj = colit.colid(); // local numbering
+        
+		colptr[lj] = colit.colptr();
+	}
+	colptr[lncol] = spSeq->getnnz();
+	for(IT k=lncol-1; k>=0; k--)
+	{
+		if(colptr[k] == -1)
+        {
+            colptr[k] = colptr[k+1];
+        }
+	}
+	return colptr;
+}
+
+
 int ThreadBuffLenForBinning(int itemsize, int nbins)
 {
     // 1MB shared cache (per 2 cores) in KNL
@@ -839,67 +886,9 @@ void TwoThirdApprox(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2
     double tPhase1 = 0, tPhase2 = 0, tPhase3 = 0, tPhase4 = 0, tPhase5 = 0, tUpdate = 0;
     
 	
-	// -----------------------------------------------------------
-	// replicate mate vectors for mateCol2Row
-	// Communication cost: same as the first communication of SpMV
-	// -----------------------------------------------------------
-	int xsize = (int)  mateCol2Row.LocArrSize();
-	int trxsize = 0;
-	MPI_Status status;
-	MPI_Sendrecv(&xsize, 1, MPI_INT, diagneigh, TRX, &trxsize, 1, MPI_INT, diagneigh, TRX, World, &status);
-	std::vector<IT> trxnums(trxsize);
-	MPI_Sendrecv(mateCol2Row.GetLocArr(), xsize, MPIType<IT>(), diagneigh, TRX, trxnums.data(), trxsize, MPIType<IT>(), diagneigh, TRX, World, &status);
-	
-	
-	std::vector<int> colsize(pc);
-	colsize[colrank] = trxsize;
-	MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, colsize.data(), 1, MPI_INT, ColWorld);
-	std::vector<int> dpls(pc,0);	// displacements (zero initialized pid)
-	std::partial_sum(colsize.data(), colsize.data()+pc-1, dpls.data()+1);
-	int accsize = std::accumulate(colsize.data(), colsize.data()+pc, 0);
-	std::vector<IT> RepMateC2R(accsize);
-	MPI_Allgatherv(trxnums.data(), trxsize, MPIType<IT>(), RepMateC2R.data(), colsize.data(), dpls.data(), MPIType<IT>(), ColWorld);
-	// -----------------------------------------------------------
-	
-	
-    // -----------------------------------------------------------
-	// replicate mate vectors for mateRow2Col
-	// Communication cost: same as the first communication of SpMV
-	//                      (minus the cost of tranposing vector)
-	// -----------------------------------------------------------
-	
-	
-	xsize = (int)  mateRow2Col.LocArrSize();
-	
-	std::vector<int> rowsize(pr);
-	rowsize[rowrank] = xsize;
-	MPI_Allgather(MPI_IN_PLACE, 1, MPI_INT, rowsize.data(), 1, MPI_INT, RowWorld);
-	std::vector<int> rdpls(pr,0);	// displacements (zero initialized pid)
-	std::partial_sum(rowsize.data(), rowsize.data()+pr-1, rdpls.data()+1);
-	accsize = std::accumulate(rowsize.data(), rowsize.data()+pr, 0);
-	std::vector<IT> RepMateR2C(accsize);
-	MPI_Allgatherv(mateRow2Col.GetLocArr(), xsize, MPIType<IT>(), RepMateR2C.data(), rowsize.data(), rdpls.data(), MPIType<IT>(), RowWorld);
-	// -----------------------------------------------------------
-	
-	
-	
-	// Getting column pointers for all columns (for CSC-style access)
-    std::vector<IT> colptr (lncol+1,-1);
-	for(auto colit = spSeq->begcol(); colit != spSeq->endcol(); ++colit) // iterate over all columns
-	{
-		IT lj = colit.colid(); // local numbering
-        
-		colptr[lj] = colit.colptr();
-	}
-	colptr[lncol] = spSeq->getnnz();
-	for(IT k=lncol-1; k>=0; k--)
-	{
-		if(colptr[k] == -1)
-        {
-            colptr[k] = colptr[k+1];
-        }
-	}
-    // TODO: will this fail empty local matrix where every entry of colptr will be zero
+	std::vector<IT> RepMateC2R = ReplicateColMates(mateCol2Row);
+	std::vector<IT> RepMateR2C = ReplicateRowMates(mateRow2Col);
+	std::vector<IT> colptr = ColumnPointers(spSeq);
 	
     
     // -----------------------------------------------------------
@@ -977,7 +966,7 @@ void TwoThirdApprox(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2
 			}
 		}
 		//vector< tuple<IT,IT,IT, NT> >().swap(recvTuples1);
-		recvTuples1 = ExchangeData1(tempTuples1, World);
+		recvTuples1 = ExchangeData(tempTuples1, World);
 		
         tPhase3 += (MPI_Wtime() - tstart);
         tstart = MPI_Wtime();
@@ -1039,7 +1028,7 @@ void TwoThirdApprox(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2
 				winnerTuples[owner].push_back(std::make_tuple(mj, mi, j, i));
 			}
 		}
-		std::vector<std::tuple<IT,IT,IT,IT>> recvWinnerTuples = ExchangeData1(winnerTuples, World);
+		std::vector<std::tuple<IT,IT,IT,IT>> recvWinnerTuples = ExchangeData(winnerTuples, World);
         tPhase4 += (MPI_Wtime() - tstart);
         tstart = MPI_Wtime();
 		
@@ -1118,6 +1107,311 @@ void TwoThirdApprox(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2
 }
     
     
+/**
+ * Refines a perfect matching towards a maximum weight perfect matching with a
+ * distributed epsilon-scaling auction (Bertsekas). Rows are the objects and carry
+ * prices, columns are the bidders. The input matching and zero prices are the warm
+ * start: every phase first frees the columns that violate epsilon-complementary
+ * slackness and then runs bulk synchronous bidding rounds until every column is
+ * assigned again. The final matching is within ncols*epsfinal of the optimum.
+ *
+ * Prices and RepMateR2C are replicated along processor rows and RepMateC2R along
+ * processor columns, exactly as in TwoThirdApprox. Column j is evaluated by the
+ * process with ColWorld rank (j%pr) and row i is auctioned by the process with
+ * RowWorld rank (i%pc), both with local indices.
+ * @param[in] epsfinal: final epsilon (default: AUCTIONFINALEPS * weight range / ncols)
+ * @return true if the auction found a heavier perfect matching and replaced the input
+ */
+template <class IT, class NT, class DER>
+bool AuctionRefine(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCol2Row, NT epsfinal = 0)
+{
+	auto commGrid = A.getcommgrid();
+	int myrank=commGrid->GetRank();
+	MPI_Comm World = commGrid->GetWorld();
+	MPI_Comm ColWorld = commGrid->GetColWorld();
+	MPI_Comm RowWorld = commGrid->GetRowWorld();
+	int nprocs = commGrid->GetSize();
+	int pr = commGrid->GetGridRows();
+	int pc = commGrid->GetGridCols();
+	int rowrank = commGrid->GetRankInProcRow();
+	int colrank = commGrid->GetRankInProcCol();
+	
+	IT nrows = A.getnrow();
+	IT ncols = A.getncol();
+	if(nrows != ncols || pr != pc || mateCol2Row.Count([](IT mate){return mate==-1;}) > 0)
+	{
+		SpParHelper::Print("Auction refinement needs a perfect matching of a square matrix on a square process grid.\n");
+		return false;
+	}
+	IT m_perproc = nrows / pr;
+	IT n_perproc = ncols / pc;
+	DER* spSeq = A.seqptr(); // local submatrix
+	Dcsc<IT, NT>* dcsc = spSeq->GetDCSC();
+	IT lnrow = spSeq->getnrow();
+	IT lncol = spSeq->getncol();
+	IT localRowStart = colrank * m_perproc; // first row in this process
+	IT localColStart = rowrank * n_perproc; // first col in this process
+	
+	AWPM_param<IT> param;
+	param.nprocs = nprocs;
+	param.pr = pr;
+	param.pc = pc;
+	param.lncol = lncol;
+	param.lnrow = lnrow;
+	param.m_perproc = m_perproc;
+	param.n_perproc = n_perproc;
+	param.localRowStart = localRowStart;
+	param.localColStart = localColStart;
+	param.myrank = myrank;
+	param.commGrid = commGrid;
+	
+	auto rowBlock = [m_perproc, pr](IT i){ return (m_perproc != 0) ? std::min(static_cast<int>(i / m_perproc), pr-1) : pr-1; };
+	auto colBlock = [n_perproc, pc](IT j){ return (n_perproc != 0) ? std::min(static_cast<int>(j / n_perproc), pc-1) : pc-1; };
+	
+	std::vector<IT> RepMateC2R = ReplicateColMates(mateCol2Row);
+	std::vector<IT> RepMateR2C = ReplicateRowMates(mateRow2Col);
+	std::vector<IT> colptr = ColumnPointers(spSeq);
+	std::vector<NT> RepMateWR2C(lnrow);
+	std::vector<NT> RepMateWC2R(lncol);
+	ReplicateMateWeights(param, dcsc, colptr, RepMateC2R, RepMateWR2C, RepMateWC2R);
+	NT minw;
+	NT initWeight = MatchingWeight(RepMateWC2R, RowWorld, minw);
+	
+	const NT lowest = std::numeric_limits<NT>::lowest();
+	NT wrange[2] = {std::numeric_limits<NT>::max(), lowest};
+	for(IT cp = 0; cp < colptr[lncol]; ++cp)
+	{
+		wrange[0] = std::min(wrange[0], dcsc->numx[cp]);
+		wrange[1] = std::max(wrange[1], dcsc->numx[cp]);
+	}
+	wrange[0] = -wrange[0];
+	MPI_Allreduce(MPI_IN_PLACE, wrange, 2, MPIType<NT>(), MPI_MAX, World);
+	NT range = wrange[1] + wrange[0];
+	if(!(range > 0)) return false;	// all perfect matchings have the same weight
+	if(!(epsfinal > 0)) epsfinal = AUCTIONFINALEPS * range / ncols;
+	
+	std::vector<NT> price(lnrow, 0);
+	std::vector<NT> colbest(lncol), mateval(lncol);
+	// best value w(i,j)-price(i) of every local column and value of its matched edge, over all processes of the processor column
+	auto ColumnValues = [&]()
+	{
+#ifdef THREADED
+#pragma omp parallel for
+#endif
+		for(IT lj=0; lj<lncol; ++lj)
+		{
+			colbest[lj] = lowest;
+			mateval[lj] = lowest;
+			for(IT cp = colptr[lj]; cp < colptr[lj+1]; ++cp)
+			{
+				IT li = dcsc->ir[cp];
+				NT v = dcsc->numx[cp] - price[li];
+				colbest[lj] = std::max(colbest[lj], v);
+				if(li + localRowStart == RepMateC2R[lj]) mateval[lj] = v;
+			}
+		}
+		MPI_Allreduce(MPI_IN_PLACE, colbest.data(), lncol, MPIType<NT>(), MPI_MAX, ColWorld);
+		MPI_Allreduce(MPI_IN_PLACE, mateval.data(), lncol, MPIType<NT>(), MPI_MAX, ColWorld);
+	};
+	
+	std::vector<IT> bestrow(lncol);
+	std::vector<NT> bestval(lncol), secondval(lncol), bestw(lncol);
+	std::vector<IT> winner(lnrow, -1);
+	std::vector<NT> winbid(lnrow);
+	
+	NT eps = range;
+	int phases = 0, rounds = 0;
+	bool converged = true;
+	double tstart = MPI_Wtime();
+	while(converged)
+	{
+		// -----------------------------------------------------------
+		// free the columns that violate eps-complementary slackness
+		// -----------------------------------------------------------
+		ColumnValues();
+		std::vector<IT> freedRows;
+		for(IT lj=0; lj<lncol; ++lj)
+		{
+			IT mj = RepMateC2R[lj];
+			if(mj != -1 && mateval[lj] < colbest[lj] - eps)
+			{
+				if(mj >= localRowStart && mj < localRowStart + lnrow) freedRows.push_back(mj);
+				RepMateC2R[lj] = -1;
+			}
+		}
+		freedRows = MateBcast(freedRows, RowWorld);
+		for(size_t k=0; k<freedRows.size(); ++k)
+			RepMateR2C[freedRows[k] - localRowStart] = -1;
+		
+		// -----------------------------------------------------------
+		// bidding rounds
+		// -----------------------------------------------------------
+		int phaseRounds = 0;
+		while(true)
+		{
+			IT unassigned = 0;
+			if(colrank == 0)
+				unassigned = std::count(RepMateC2R.begin(), RepMateC2R.end(), static_cast<IT>(-1));
+			MPI_Allreduce(MPI_IN_PLACE, &unassigned, 1, MPIType<IT>(), MPI_SUM, World);
+			if(unassigned == 0) break;
+			++rounds;
+			if(++phaseRounds > AUCTIONMAXROUNDS)
+			{
+				converged = false;
+				break;
+			}
+			
+			// local two best objects of every unassigned column: (j, best row, best value, second value, best weight)
+#ifdef THREADED
+#pragma omp parallel for
+#endif
+			for(IT lj=0; lj<lncol; ++lj)
+			{
+				bestrow[lj] = -1;
+				if(RepMateC2R[lj] != -1) continue;
+				NT v1 = lowest, v2 = lowest;
+				for(IT cp = colptr[lj]; cp < colptr[lj+1]; ++cp)
+				{
+					IT li = dcsc->ir[cp];
+					NT v = dcsc->numx[cp] - price[li];
+					if(v > v1)
+					{
+						v2 = v1;
+						v1 = v;
+						bestrow[lj] = li + localRowStart;
+						bestw[lj] = dcsc->numx[cp];
+					}
+					else if(v > v2) v2 = v;
+				}
+				bestval[lj] = v1;
+				secondval[lj] = v2;
+			}
+			std::vector<std::vector<std::tuple<IT,IT,NT,NT,NT>>> candTuples (pr);
+			for(IT lj=0; lj<lncol; ++lj)
+			{
+				if(bestrow[lj] != -1)
+					candTuples[lj % pr].push_back(std::make_tuple(lj, bestrow[lj], bestval[lj], secondval[lj], bestw[lj]));
+			}
+			std::vector<std::tuple<IT,IT,NT,NT,NT>> recvCands = ExchangeData(candTuples, ColWorld);
+			
+			// column leaders merge the candidates of the processor column and bid
+			for(IT lj=colrank; lj<lncol; lj+=pr) bestrow[lj] = -1;
+			for(size_t k=0; k<recvCands.size(); ++k)
+			{
+				IT lj = std::get<0>(recvCands[k]);
+				IT i = std::get<1>(recvCands[k]);
+				NT v1 = std::get<2>(recvCands[k]);
+				NT v2 = std::get<3>(recvCands[k]);
+				if(bestrow[lj] == -1)
+				{
+					bestrow[lj] = i;
+					bestval[lj] = v1;
+					secondval[lj] = v2;
+					bestw[lj] = std::get<4>(recvCands[k]);
+				}
+				else if(v1 > bestval[lj] || (v1 == bestval[lj] && i < bestrow[lj]))
+				{
+					secondval[lj] = std::max(bestval[lj], v2);
+					bestrow[lj] = i;
+					bestval[lj] = v1;
+					bestw[lj] = std::get<4>(recvCands[k]);
+				}
+				else
+					secondval[lj] = std::max(secondval[lj], v1);
+			}
+			std::vector<std::vector<std::tuple<IT,IT,NT>>> bidTuples (nprocs);
+			for(IT lj=colrank; lj<lncol; lj+=pr)
+			{
+				if(bestrow[lj] == -1) continue;
+				IT i = bestrow[lj];
+				// a column with a single edge can outbid anyone for its row
+				NT v2 = (secondval[lj] == lowest) ? bestval[lj] - range : secondval[lj];
+				int R = rowBlock(i);
+				int owner = commGrid->GetRank(R, static_cast<int>((i - R * m_perproc) % pc));
+				bidTuples[owner].push_back(std::make_tuple(i, lj + localColStart, bestw[lj] - v2 + eps));
+			}
+			std::vector<std::tuple<IT,IT,NT>> recvBids = ExchangeData(bidTuples, World);
+			
+			// row leaders pick the highest bid of each row (smaller column on ties)
+			std::vector<IT> touched;
+			for(size_t k=0; k<recvBids.size(); ++k)
+			{
+				IT li = std::get<0>(recvBids[k]) - localRowStart;
+				IT j = std::get<1>(recvBids[k]);
+				NT bid = std::get<2>(recvBids[k]);
+				if(winner[li] == -1)
+				{
+					touched.push_back(li);
+					winner[li] = j;
+					winbid[li] = bid;
+				}
+				else if(bid > winbid[li] || (bid == winbid[li] && j < winner[li]))
+				{
+					winner[li] = j;
+					winbid[li] = bid;
+				}
+			}
+			std::vector<std::tuple<IT,IT,NT>> rowUpdates;
+			std::vector<std::vector<std::tuple<IT,IT>>> colTuples (nprocs);
+			for(size_t k=0; k<touched.size(); ++k)
+			{
+				IT li = touched[k];
+				IT i = li + localRowStart;
+				IT j = winner[li];
+				IT oldj = RepMateR2C[li];
+				rowUpdates.push_back(std::make_tuple(i, j, winbid[li]));
+				int C = colBlock(j);
+				for(int r=0; r<pr; ++r) colTuples[commGrid->GetRank(r, C)].push_back(std::make_tuple(j, i));
+				if(oldj != -1)
+				{
+					C = colBlock(oldj);
+					for(int r=0; r<pr; ++r) colTuples[commGrid->GetRank(r, C)].push_back(std::make_tuple(oldj, static_cast<IT>(-1)));
+				}
+				winner[li] = -1;
+			}
+			rowUpdates = MateBcast(rowUpdates, RowWorld);
+			std::vector<std::tuple<IT,IT>> colUpdates = ExchangeData(colTuples, World);
+			for(size_t k=0; k<rowUpdates.size(); ++k)
+			{
+				IT li = std::get<0>(rowUpdates[k]) - localRowStart;
+				RepMateR2C[li] = std::get<1>(rowUpdates[k]);
+				price[li] = std::get<2>(rowUpdates[k]);
+			}
+			for(size_t k=0; k<colUpdates.size(); ++k)
+				RepMateC2R[std::get<0>(colUpdates[k]) - localColStart] = std::get<1>(colUpdates[k]);
+		}
+		++phases;
+		if(eps <= epsfinal) break;
+		eps = std::max(eps / AUCTIONEPSFACTOR, epsfinal);
+	}
+	
+	if(!converged)
+	{
+		SpParHelper::Print("Warning: The auction did not converge. Keeping the approximate matching.\n");
+		return false;
+	}
+	ReplicateMateWeights(param, dcsc, colptr, RepMateC2R, RepMateWR2C, RepMateWC2R);
+	NT auctionWeight = MatchingWeight(RepMateWC2R, RowWorld, minw);
+	
+#ifdef DETAIL_STATS
+	// dual objective: sum of prices plus the best value of every column
+	ColumnValues();
+	NT dual[2] = {0, 0};
+	if(rowrank == 0) dual[0] = std::accumulate(price.begin(), price.end(), static_cast<NT>(0));
+	if(colrank == 0) dual[1] = std::accumulate(colbest.begin(), colbest.end(), static_cast<NT>(0));
+	MPI_Allreduce(MPI_IN_PLACE, dual, 2, MPIType<NT>(), MPI_SUM, World);
+	if(myrank==0)
+	{
+		std::cout << "Auction: " << phases << " phases, " << rounds << " rounds, " << MPI_Wtime() - tstart << " seconds" << std::endl;
+		std::cout << "Auction: weight " << initWeight << " -> " << auctionWeight << ", duality gap " << dual[0] + dual[1] - auctionWeight << " (bound " << ncols * epsfinal << ")" << std::endl;
+	}
+#endif
+	if(auctionWeight <= initWeight) return false;
+	UpdateMatching(mateRow2Col, mateCol2Row, RepMateR2C, RepMateC2R);
+	return true;
+}
+    
+    
     template <class IT, class NT, class DER>
     void TransformWeight(SpParMat < IT, NT, DER > & A, bool applylog)
     {
@@ -1141,7 +1435,7 @@ void TwoThirdApprox(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2
     }
     
     template <class IT, class NT>
-    void AWPM(SpParMat < IT, NT, SpDCCols<IT, NT> > & A1, FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCol2Row, bool optimizeProd=true, bool weightedCard=true)
+    void AWPM(SpParMat < IT, NT, SpDCCols<IT, NT> > & A1, FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCol2Row, bool optimizeProd=true, bool weightedCard=true, bool auction=false)
     {
         SpParMat < IT, NT, SpDCCols<IT, NT> > A(A1); // creating a copy because it is being transformed
         
@@ -1234,6 +1528,12 @@ void TwoThirdApprox(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2
             mateCol2Row.iota(A.getncol(), 0);
             awpmWeight = origWeight;
         }
+        
+        //--------------------------------------------------------
+        // Refine towards the maximum weight perfect matching
+        //--------------------------------------------------------
+        if(auction)
+            AuctionRefine(A, mateRow2Col, mateCol2Row);
     }
 
 }
@@ -32,7 +32,7 @@ typedef SpParMat < int64_t, double, SpDCCols<int64_t, double> > Par_DCSC_Double;
 typedef SpParMat < int64_t, bool, SpCCols<int64_t,bool> > Par_CSC_Bool;
 
 // algorithmic options
-bool prune, randMM, moreSplit;
+bool prune, randMM, moreSplit, hybrid;
 int init;
 bool randMaximal;
 bool fewexp;
@@ -126,6 +126,7 @@ void ShowUsage()
         cout << "** (optional) randMaximal: random parent selection in greedy/Karp-Sipser\n" ;
         //cout << "** (optional) diropt: employ direction-optimized BFS\n" ;
         cout << "** (optional) prune: discard trees as soon as an augmenting path is found\n" ;
+        cout << "** (optional) hybrid: finish on one process once phases find few augmenting paths (checked against the distributed result)\n" ;
         //cout << "** (optional) graft: employ tree grafting\n" ;
         cout << "** (optional) moreSplit: more splitting of Matrix.\n" ;
         cout << "** (optional) randPerm: Randomly permute the matrix for load balance.\n" ;
@@ -158,6 +159,8 @@ void GetOptions(char* argv[], int argc)
         saveMatching=true;
     if(allArg.find("randMM")!=string::npos)
         randMM = true;
+    if(allArg.find("hybrid")!=string::npos)
+        hybrid = true;
     if(allArg.find("randMaximal")!=string::npos)
         randMaximal = true;
     if(allArg.find("randPerm")!=string::npos)
@@ -186,6 +189,7 @@ void showCurOptions()
     if(init == GREEDY) tinfo << " greedy, ";
     if(randMaximal) tinfo << " random parent selection in greedy/Karp-Sipser, ";
     if(prune) tinfo << " tree pruning, ";
+    if(hybrid) tinfo << " gathered solver for the last phases, ";
     if(moreSplit) tinfo << " moreSplit ";
     if(randPerm) tinfo << " Randomly permute the matrix for load balance ";
     if(saveMatching) tinfo << " Write the matcing in a file";
@@ -253,7 +257,8 @@ void experiment(Par_DCSC_Bool & A, Par_DCSC_Bool & AT, FullyDistVec<int64_t, int
 
 
 // default experiment
-void defaultExp(Par_DCSC_Bool & A, Par_DCSC_Bool & AT, FullyDistVec<int64_t, int64_t> degCol)
+// returns false if the hybrid and the distributed matchings differ in cardinality
+bool defaultExp(Par_DCSC_Bool & A, Par_DCSC_Bool & AT, FullyDistVec<int64_t, int64_t> degCol)
 {
     FullyDistVec<int64_t, int64_t> mateRow2Col ( A.getcommgrid(), A.getnrow(), (int64_t) -1);
     FullyDistVec<int64_t, int64_t> mateCol2Row ( A.getcommgrid(), A.getncol(), (int64_t) -1);
@@ -262,14 +267,34 @@ void defaultExp(Par_DCSC_Bool & A, Par_DCSC_Bool & AT, FullyDistVec<int64_t, int
     init = DMD; randMaximal = false; randMM = true; prune = true;
     showCurOptions();
     MaximalMatching(A, AT, mateRow2Col, mateCol2Row, degCol, init, randMaximal);
-    maximumMatching(A, mateRow2Col, mateCol2Row, prune, randMM);
+    double t1 = MPI_Wtime();
+    maximumMatching(A, mateRow2Col, mateCol2Row, prune, randMM, false, hybrid);
+    double t2 = MPI_Wtime();
     if(saveMatching && ofname!="")
     {
         mateRow2Col.ParallelWrite(ofname,false,false);
     }
+    int64_t card = mateRow2Col.Count([](int64_t mate){return mate!=-1;});
     mateRow2Col.Apply([](int64_t val){return (int64_t) -1;});
     mateCol2Row.Apply([](int64_t val){return (int64_t) -1;});
     
+    bool correct = true;
+    if(hybrid)
+    {
+        MaximalMatching(A, AT, mateRow2Col, mateCol2Row, degCol, init, randMaximal);
+        double t3 = MPI_Wtime();
+        maximumMatching(A, mateRow2Col, mateCol2Row, prune, randMM);
+        double t4 = MPI_Wtime();
+        int64_t distcard = mateRow2Col.Count([](int64_t mate){return mate!=-1;});
+        correct = (card == distcard);
+        ostringstream tinfo;
+        tinfo << "Hybrid matching: " << card << " edges in " << t2-t1 << " seconds, distributed: " << distcard << " edges in " << t4-t3 << " seconds" << endl;
+        if(!correct) tinfo << "ERROR: cardinalities differ" << endl;
+        SpParHelper::Print(tinfo.str());
+        mateRow2Col.Apply([](int64_t val){return (int64_t) -1;});
+        mateCol2Row.Apply([](int64_t val){return (int64_t) -1;});
+    }
+    return correct;
 }
 
 
@@ -367,12 +392,14 @@ int main(int argc, char* argv[])
     randMaximal = false;
     prune = false;
     randMM = true;
+    hybrid = false;
     moreSplit = false;
     fewexp=false;
     saveMatching = false;
     ofname = "";
     randPerm = false;
     
+    bool correct = true;
     SpParHelper::Print("***** I/O and other preprocessing steps *****\n");
     // ------------ Process input arguments and build matrix ---------------
     {
@@ -515,10 +542,10 @@ int main(int argc, char* argv[])
         
         
         SpParHelper::Print("**************************************************\n\n");
-        defaultExp(A, AT, degCol);
+        correct = defaultExp(A, AT, degCol);
     }
     MPI_Finalize();
-    return 0;
+    return correct ? 0 : 1;
 }
 
 
@@ -224,11 +224,277 @@ void AugmentPath(FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCo
 
 
 
+/***************************************************************************
+// Sequential maximum matching (Pothen-Fan with lookahead) on a CSC graph.
+// Starts from the given matching; rows are never unmatched again, hence the
+// lookahead pointers are kept across phases.
+***************************************************************************/
+
+template <typename IT>
+void PothenFanMatching(IT ncol, IT nrow, const std::vector<IT>& colptr, const std::vector<IT>& rowids, std::vector<IT>& mateCol, std::vector<IT>& mateRow)
+{
+    std::vector<IT> lookahead(colptr.begin(), colptr.end()-1);
+    std::vector<IT> next(ncol);
+    std::vector<IT> visited(nrow, -1);
+    std::vector<IT> stack;  // columns on the current DFS path
+    std::vector<IT> via;    // via[k] leads from stack[k] to stack[k+1]
+    
+    bool augmented = true;
+    for(IT phase = 0; augmented; ++phase)
+    {
+        augmented = false;
+        std::copy(colptr.begin(), colptr.end()-1, next.begin());
+        for(IT root = 0; root < ncol; ++root)
+        {
+            if(mateCol[root] != -1) continue;
+            stack.assign(1, root);
+            via.clear();
+            IT freerow = -1;
+            while(!stack.empty())
+            {
+                IT c = stack.back();
+                for(; lookahead[c] < colptr[c+1]; ++lookahead[c])
+                {
+                    if(mateRow[rowids[lookahead[c]]] == -1)
+                    {
+                        freerow = rowids[lookahead[c]];
+                        break;
+                    }
+                }
+                if(freerow != -1) break;
+                
+                bool pushed = false;
+                for(; next[c] < colptr[c+1]; ++next[c])
+                {
+                    IT r = rowids[next[c]];
+                    if(visited[r] != phase)
+                    {
+                        visited[r] = phase;
+                        via.push_back(r);
+                        stack.push_back(mateRow[r]);    // r is matched, otherwise the lookahead had found it
+                        ++next[c];
+                        pushed = true;
+                        break;
+                    }
+                }
+                if(!pushed)
+                {
+                    stack.pop_back();
+                    if(!via.empty()) via.pop_back();
+                }
+            }
+            if(freerow != -1)
+            {
+                for(size_t k = stack.size(); k-- > 0; )
+                {
+                    IT r = (k == stack.size()-1) ? freerow : via[k];
+                    mateCol[stack[k]] = r;
+                    mateRow[r] = stack[k];
+                }
+                augmented = true;
+            }
+        }
+    }
+}
+
+
+/***************************************************************************
+// Columns reachable from the unmatched columns by alternating paths, with their mates.
+// Every augmenting path starts at an unmatched column, so all of them lie in the
+// subgraph formed by these columns and their edges. That subgraph is closed under
+// augmentation: a maximum matching of it is a maximum matching of A.
+***************************************************************************/
+
+template <typename IT, typename NT, typename DER>
+FullyDistSpVec<IT, IT> AlternatingReach(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCol2Row)
+{
+    IT nrow = A.getnrow();
+    IT ncol = A.getncol();
+    FullyDistVec<IT, IT> visitedRow(A.getcommgrid(), nrow, (IT) -1);
+    FullyDistVec<IT, IT> visitedCol(A.getcommgrid(), ncol, (IT) -1);
+    FullyDistSpVec<IT, IT> fringeCol(mateCol2Row, [](IT mate){return mate==-1;});
+    FullyDistSpVec<IT, IT> fringeRow(A.getcommgrid(), nrow);
+    fringeCol.ApplyInd([](IT mate, IT idx){return idx;});
+    visitedCol.Set(fringeCol);
+    
+    while(fringeCol.getnnz() > 0)
+    {
+        SpMV<Select2ndMinSR<NT, IT>>(A, fringeCol, fringeRow, false);
+        fringeRow = EWiseApply<IT>(fringeRow, visitedRow,
+                                   [](IT parent, IT visited){return parent;},
+                                   [](IT parent, IT visited){return visited==-1;},
+                                   false, (IT)-1);
+        visitedRow.Set(fringeRow);
+        
+        // matched rows lead to their mates
+        fringeRow = EWiseApply<IT>(fringeRow, mateRow2Col,
+                                   [](IT parent, IT mate){return mate;},
+                                   [](IT parent, IT mate){return mate!=-1;},
+                                   false, (IT)-1);
+        fringeCol = fringeRow.Invert(ncol);
+        fringeCol = EWiseApply<IT>(fringeCol, visitedCol,
+                                   [](IT row, IT visited){return row;},
+                                   [](IT row, IT visited){return visited==-1;},
+                                   false, (IT)-1);
+        visitedCol.Set(fringeCol);
+    }
+    FullyDistSpVec<IT, IT> reach(visitedCol, [](IT visited){return visited!=-1;});
+    return EWiseApply<IT>(reach, mateCol2Row,
+                          [](IT visited, IT mate){return mate;},
+                          [](IT visited, IT mate){return true;},
+                          false, (IT)-1);
+}
+
+
+/***************************************************************************
+// Finishes a maximum matching on one process: the subgraph reachable from the
+// unmatched columns is gathered to the root, matched with Pothen-Fan, and the
+// changed mates are broadcast back. This replaces the long tail of MS-BFS phases
+// that find only a few long augmenting paths but pay full collective costs each.
+// Returns false (and changes nothing) if the subgraph has more than maxnnz edges.
+// Only DCSC matrices are supported; other formats keep running MS-BFS phases.
+***************************************************************************/
+
+template <typename IT, typename NT, typename DER>
+bool GatheredMaximumMatching(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCol2Row, IT maxnnz)
+{
+    return false;
+}
+
+template <typename IT, typename NT, typename LIT>
+bool GatheredMaximumMatching(SpParMat < IT, NT, SpDCCols<LIT, NT> > & A, FullyDistVec<IT, IT>& mateRow2Col, FullyDistVec<IT, IT>& mateCol2Row, IT maxnnz)
+{
+    typedef SpDCCols<LIT, NT> DER;
+    std::shared_ptr<CommGrid> grid = A.getcommgrid();
+    MPI_Comm World = grid->GetWorld();
+    int nprocs = grid->GetSize();
+    int myrank = grid->GetRank();
+    IT nrow = A.getnrow();
+    IT ncol = A.getncol();
+    
+    FullyDistSpVec<IT, IT> reach = AlternatingReach(A, mateRow2Col, mateCol2Row);
+    FullyDistVec<IT, IT> degCol(grid);
+    A.Reduce(degCol, Column, std::plus<IT>(), (IT) 0, [](NT val){return (IT) 1;});
+    FullyDistSpVec<IT, IT> reachDeg = EWiseApply<IT>(reach, degCol,
+                                                     [](IT mate, IT deg){return deg;},
+                                                     [](IT mate, IT deg){return true;},
+                                                     false, (IT)0);
+    IT subnnz = reachDeg.Reduce(std::plus<IT>(), (IT) 0);
+    if(subnnz > maxnnz) return false;
+    
+    // isolated columns stay unmatched anyway
+    reach = EWiseApply<IT>(reach, degCol,
+                           [](IT mate, IT deg){return mate;},
+                           [](IT mate, IT deg){return deg > 0;},
+                           false, (IT)0);
+    // column k of B is the k-th reachable column
+    FullyDistVec<IT, IT> reachCols = reach.FindInds([](IT mate){return true;});
+    SpParMat < IT, NT, DER > B = A(reachCols, Column);
+    
+    IT roffset = grid->GetRankInProcCol() * (nrow / grid->GetGridRows());
+    IT coffset = grid->GetRankInProcRow() * (B.getncol() / grid->GetGridCols());
+    SpTuples<LIT, NT> tuples(*B.seqptr());
+    std::vector<IT> sendedges(2 * tuples.getnnz());
+    for(int64_t i = 0; i < tuples.getnnz(); ++i)
+    {
+        sendedges[2*i] = tuples.colindex(i) + coffset;
+        sendedges[2*i+1] = tuples.rowindex(i) + roffset;
+    }
+    std::vector<IT> sendreach;
+    std::vector<IT> reachind = reach.GetLocalInd();
+    std::vector<IT> reachnum = reach.GetLocalNum();
+    IT reachoffset = reach.LengthUntil();
+    for(size_t i = 0; i < reachind.size(); ++i)
+    {
+        sendreach.push_back(reachind[i] + reachoffset);
+        sendreach.push_back(reachnum[i]);
+    }
+    
+    std::vector<int> edgecnt(nprocs), reachcnt(nprocs), edgedispls(nprocs+1, 0), reachdispls(nprocs+1, 0);
+    int myedgecnt = static_cast<int>(sendedges.size());
+    int myreachcnt = static_cast<int>(sendreach.size());
+    MPI_Gather(&myedgecnt, 1, MPI_INT, edgecnt.data(), 1, MPI_INT, 0, World);
+    MPI_Gather(&myreachcnt, 1, MPI_INT, reachcnt.data(), 1, MPI_INT, 0, World);
+    std::partial_sum(edgecnt.begin(), edgecnt.end(), edgedispls.begin()+1);
+    std::partial_sum(reachcnt.begin(), reachcnt.end(), reachdispls.begin()+1);
+    std::vector<IT> alledges(myrank == 0 ? edgedispls[nprocs] : 0);
+    std::vector<IT> allreach(myrank == 0 ? reachdispls[nprocs] : 0);
+    MPI_Gatherv(sendedges.data(), myedgecnt, MPIType<IT>(), alledges.data(), edgecnt.data(), edgedispls.data(), MPIType<IT>(), 0, World);
+    MPI_Gatherv(sendreach.data(), myreachcnt, MPIType<IT>(), allreach.data(), reachcnt.data(), reachdispls.data(), MPIType<IT>(), 0, World);
+    std::vector<IT>().swap(sendedges);
+    
+    std::vector<IT> updates;    // (column, row) pairs of the new matching edges
+    if(myrank == 0)
+    {
+        IT subcols = static_cast<IT>(allreach.size() / 2);
+        std::vector<IT> cols(subcols);
+        for(IT i = 0; i < subcols; ++i) cols[i] = allreach[2*i];   // sorted, as reach is
+        std::vector<IT> rows;
+        for(size_t i = 1; i < alledges.size(); i += 2) rows.push_back(alledges[i]);
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+        IT subrows = static_cast<IT>(rows.size());
+        auto rowid = [&rows](IT r){return static_cast<IT>(std::lower_bound(rows.begin(), rows.end(), r) - rows.begin());};
+        
+        std::vector<IT> colptr(subcols+1, 0);
+        for(size_t i = 0; i < alledges.size(); i += 2) ++colptr[alledges[i]+1];
+        std::partial_sum(colptr.begin(), colptr.end(), colptr.begin());
+        std::vector<IT> rowids(colptr.back());
+        std::vector<IT> fill(colptr.begin(), colptr.end()-1);
+        for(size_t i = 0; i < alledges.size(); i += 2)
+            rowids[fill[alledges[i]]++] = rowid(alledges[i+1]);
+        std::vector<IT>().swap(alledges);
+        
+        std::vector<IT> mateCol(subcols, -1), mateRow(subrows, -1);
+        for(IT i = 0; i < subcols; ++i)
+        {
+            if(allreach[2*i+1] != -1)
+            {
+                mateCol[i] = rowid(allreach[2*i+1]);
+                mateRow[mateCol[i]] = i;
+            }
+        }
+        PothenFanMatching(subcols, subrows, colptr, rowids, mateCol, mateRow);
+        for(IT i = 0; i < subcols; ++i)
+        {
+            if(mateCol[i] != -1 && rows[mateCol[i]] != allreach[2*i+1])
+            {
+                updates.push_back(cols[i]);
+                updates.push_back(rows[mateCol[i]]);
+            }
+        }
+    }
+    
+    // rows are only ever (re)matched, so the new column mates determine all changes
+    IT nupdates = static_cast<IT>(updates.size());
+    MPI_Bcast(&nupdates, 1, MPIType<IT>(), 0, World);
+    updates.resize(nupdates);
+    MPI_Bcast(updates.data(), static_cast<int>(nupdates), MPIType<IT>(), 0, World);
+    for(IT i = 0; i < nupdates; i += 2)
+    {
+        IT locind;
+        if(mateCol2Row.Owner(updates[i], locind) == myrank)
+            mateCol2Row.SetLocalElement(locind, updates[i+1]);
+        if(mateRow2Col.Owner(updates[i+1], locind) == myrank)
+            mateRow2Col.SetLocalElement(locind, updates[i]);
+    }
+    
+#ifdef TIMING
+    std::ostringstream outs;
+    outs << "Gathered the remaining matching problem: " << reach.getnnz() << " columns, " << subnnz << " edges, " << nupdates/2 << " new or changed mates" << std::endl;
+    SpParHelper::Print(outs.str());
+#endif
+    return true;
+}
+
+
+
 // Maximum cardinality matching
 // Output: mateRow2Col and mateRow2Col
+// hybrid: once a phase finds few augmenting paths, finish on one process with GatheredMaximumMatching
 template <typename IT, typename NT,typename DER>
 void maximumMatching(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow2Col,
-                     FullyDistVec<IT, IT>& mateCol2Row, bool prune=true, bool randMM = false, bool maximizeWeight = false)
+                     FullyDistVec<IT, IT>& mateCol2Row, bool prune=true, bool randMM = false, bool maximizeWeight = false, bool hybrid = false)
 {
 	
 	typedef VertexTypeMM <IT> VertexType;
@@ -271,6 +537,12 @@ void maximumMatching(SpParMat < IT, NT, DER > & A, FullyDistVec<IT, IT>& mateRow
     
     while(matched)
     {
+        if(hybrid && !phaseMatched.empty() && phaseMatched.back() < HYBRIDMATCHFRINGE * nprocs)
+        {
+            hybrid = false; // the reachable subgraph rarely shrinks enough later, so try only once
+            if(GatheredMaximumMatching(A, mateRow2Col, mateCol2Row, (IT) HYBRIDMATCHNNZ))
+                break;
+        }
         time_phase = MPI_Wtime();
   
         std::vector<double> phase_timing(8,0);
@@ -12,6 +12,26 @@
 #include "CombBLAS/CombBLAS.h"
 #include <iostream>
 
+#ifndef HYBRIDMATCHFRINGE
+#define HYBRIDMATCHFRINGE 16	// hybrid maximum matching gathers the rest of the problem once a phase finds fewer than HYBRIDMATCHFRINGE paths per process
+#endif
+
+#ifndef HYBRIDMATCHNNZ
+#define HYBRIDMATCHNNZ (1 << 24)	// ... provided the subgraph reachable from unmatched columns has at most that many edges
+#endif
+
+#ifndef AUCTIONEPSFACTOR
+#define AUCTIONEPSFACTOR 4	// epsilon-scaling auction divides epsilon by this factor after every phase
+#endif
+
+#ifndef AUCTIONFINALEPS
+#define AUCTIONFINALEPS 0.1	// ... until it reaches AUCTIONFINALEPS times the weight range over the number of columns
+#endif
+
+#ifndef AUCTIONMAXROUNDS
+#define AUCTIONMAXROUNDS 10000	// bidding rounds per phase after which the auction gives up and keeps the approximate matching
+#endif
+
 namespace combblas {
 
 // Vertex data structure for maximal cardinality matching
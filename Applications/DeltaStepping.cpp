@@ -0,0 +1,180 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include <mpi.h>
+
+// These macros should be defined before stdint.h is included
+#ifndef __STDC_CONSTANT_MACROS
+#define __STDC_CONSTANT_MACROS
+#endif
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+#include <stdint.h>
+
+#include <sys/time.h>
+#include <iostream>
+#include <fstream>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include "CombBLAS/CombBLAS.h"
+#include "DeltaStepping.h"
+
+using namespace std;
+using namespace combblas;
+
+#define EDGEFACTOR 16
+#define NSOURCES 4
+
+class Dist
+{
+public:
+    typedef SpDCCols < int64_t, double > DCCols;
+    typedef SpParMat < int64_t, double, DCCols > MPI_DCCols;
+};
+
+
+/**
+ * Reference solution: Bellman-Ford with dense SpMV sweeps
+ */
+FullyDistVec<int64_t, double> BellmanFord(const Dist::MPI_DCCols & A, int64_t source)
+{
+    Dist::MPI_DCCols AT = A;
+    AT.Transpose();
+    FullyDistVec<int64_t, double> dist(A.getcommgrid(), A.getnrow(), numeric_limits<double>::max());
+    dist.SetElement(source, 0.0);
+    while(true)
+    {
+        FullyDistVec<int64_t, double> next = SpMV<MinPlusSRing<double, double> >(AT, dist);
+        next.EWiseApply(dist, minimum<double>());
+        if(next == dist) break;
+        dist = next;
+    }
+    return dist;
+}
+
+
+int main(int argc, char* argv[])
+{
+    int nprocs, myrank;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+    if(argc < 3)
+    {
+        if(myrank == 0)
+        {
+            cout << "Usage: ./sssp <rmat|er|input> <scale|filename> [delta] [-verify]" << endl;
+            cout << "Example with a user supplied matrix: mpirun -np 4 ./sssp input a.mtx 10" << endl;
+            cout << "Example with an Erdos-Renyi matrix: mpirun -np 4 ./sssp er 16 10 -verify" << endl;
+            cout << "Generated matrices get pseudo-random integral edge weights in [1,64]" << endl;
+        }
+        MPI_Finalize();
+        return -1;
+    }
+    {
+        double delta = 16;
+        bool verify = false;
+        if(argc > 3 && strcmp(argv[3], "-verify") != 0)
+            delta = atof(argv[3]);
+        for (int i = 1; i < argc; i++)
+        {
+            if (strcmp(argv[i],"-verify")==0)
+                verify = true;
+        }
+
+        Dist::MPI_DCCols A;
+        if(string(argv[1]) == string("input"))
+        {
+            A.ParallelReadMM(string(argv[2]), true, minimum<double>());
+        }
+        else if(string(argv[1]) == string("rmat") || string(argv[1]) == string("er"))
+        {
+            unsigned scale = static_cast<unsigned>(atoi(argv[2]));
+            double rmat[4] = {.57, .19, .19, .05};
+            double er[4] = {.25, .25, .25, .25};
+            DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+            DEL->GenGraph500Data(string(argv[1]) == string("er") ? er : rmat, scale, EDGEFACTOR, true, false);
+            Dist::MPI_DCCols G(*DEL, false);
+            delete DEL;
+
+            // deterministic weights that do not depend on the process count
+            FullyDistVec<int64_t, int64_t> ri(G.getcommgrid()), ci(G.getcommgrid());
+            FullyDistVec<int64_t, double> w(G.getcommgrid());
+            G.Find(ri, ci, w);
+            w.iota(ri.TotalLength(), 0);
+            w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 64 + 1); });
+            A = Dist::MPI_DCCols(G.getnrow(), G.getncol(), ri, ci, w, false);
+        }
+        else
+        {
+            SpParHelper::Print("Unknown input option\n");
+            MPI_Finalize();
+            return -1;
+        }
+        A.PrintInfo();
+
+        vector<int64_t> sources;
+        for(int i = 0; i < NSOURCES; ++i)
+            sources.push_back((A.getnrow() / NSOURCES) * i);
+
+        double t1 = MPI_Wtime();
+        vector< FullyDistVec<int64_t, double> > dists = DeltaStepping(A, sources, delta);
+        double t2 = MPI_Wtime();
+
+        ostringstream outs;
+        outs << "Delta-stepping (delta = " << delta << ") from " << sources.size() << " sources took " << t2 - t1 << " seconds" << endl;
+        for(size_t i = 0; i < sources.size(); ++i)
+        {
+            int64_t nreached = dists[i].Count([](double d){ return d < numeric_limits<double>::max(); });
+            outs << "Source " << sources[i] << " reaches " << nreached << " vertices" << endl;
+        }
+        SpParHelper::Print(outs.str());
+
+        if(verify)
+        {
+            bool correct = true;
+            for(size_t i = 0; i < sources.size(); ++i)
+            {
+                FullyDistVec<int64_t, double> ref = BellmanFord(A, sources[i]);
+                if(!(ref == dists[i])) correct = false;
+            }
+            SpParHelper::Print(correct ? "Verification passed\n" : "ERROR: distances differ from Bellman-Ford\n");
+            if(!correct)
+            {
+                MPI_Finalize();
+                return 1;
+            }
+        }
+    }
+    MPI_Finalize();
+    return 0;
+}
@@ -0,0 +1,253 @@
+#include <mpi.h>
+
+// These macros should be defined before stdint.h is included
+#ifndef __STDC_CONSTANT_MACROS
+#define __STDC_CONSTANT_MACROS
+#endif
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+#include "CombBLAS/CombBLAS.h"
+
+/**
+ ** Single source shortest paths based on the delta-stepping algorithm of Meyer and Sanders
+ ** Edges are split into light (w <= delta) and heavy (w > delta) pieces once, and vertices
+ ** are processed in buckets of width delta. Light edges of a bucket are relaxed repeatedly
+ ** until the bucket does not change anymore; heavy edges are relaxed once per bucket because
+ ** they can never reinsert a vertex into the current bucket.
+ ** Edge weights must be non-negative. A(i,j) is the weight of the edge from i to j.
+ **/
+
+namespace combblas {
+
+template <typename IT, typename NT, typename DER>
+class DeltaSteppingSplit
+{
+public:
+    /**
+     * Splits A into its light and heavy pieces and stores them transposed,
+     * so that SpMV(AT, x) relaxes the out-edges of the vertices in x
+     */
+    DeltaSteppingSplit(const SpParMat<IT,NT,DER> & A, NT delta): delta(delta), ALightT(A), AHeavyT(A)
+    {
+        ALightT.Prune([delta](NT w){ return w > delta; });
+        AHeavyT.Prune([delta](NT w){ return w <= delta; });
+        ALightT.Transpose();
+        AHeavyT.Transpose();
+    }
+
+    NT delta;
+    SpParMat<IT,NT,DER> ALightT;
+    SpParMat<IT,NT,DER> AHeavyT;
+};
+
+
+/**
+ * Masked relaxation: computes the tentative distances reachable from frontier through AT
+ * and keeps only those that improve dist. dist is updated in place.
+ * @return the vertices whose distances have been improved (with their new distances)
+ */
+template <typename IT, typename NT, typename DER>
+FullyDistSpVec<IT,NT> Relax(const SpParMat<IT,NT,DER> & AT, const FullyDistSpVec<IT,NT> & frontier, FullyDistVec<IT,NT> & dist)
+{
+    FullyDistSpVec<IT,NT> reach(dist.getcommgrid(), dist.TotalLength());
+    SpMV<MinPlusSRing<NT,NT> >(AT, frontier, reach, false);
+    FullyDistSpVec<IT,NT> improved = EWiseApply<NT>(reach, dist,
+            [](NT r, NT d){ return r; },
+            [](NT r, NT d){ return r < d; },
+            false, static_cast<NT>(0));
+    dist.Set(improved);
+    return improved;
+}
+
+
+/**
+ * Delta-stepping on an already split matrix
+ * Unreachable vertices keep std::numeric_limits<NT>::max() as their distance
+ */
+template <typename IT, typename NT, typename DER>
+FullyDistVec<IT,NT> DeltaStepping(const DeltaSteppingSplit<IT,NT,DER> & split, IT source)
+{
+    const NT inf = std::numeric_limits<NT>::max();
+    const NT delta = split.delta;
+    FullyDistVec<IT,NT> dist(split.ALightT.getcommgrid(), split.ALightT.getnrow(), inf);
+    dist.SetElement(source, static_cast<NT>(0));
+
+    NT lo = 0;  // every vertex with a distance smaller than lo is settled
+#ifdef SSSP_DEBUG
+    int nbuckets = 0;
+#endif
+    while(true)
+    {
+        // the smallest unsettled tentative distance decides the next non-empty bucket
+        NT dmin = dist.Reduce(minimum<NT>(), inf, [lo, inf](NT d){ return d >= lo ? d : inf; });
+        if(dmin == inf) break;
+
+        lo = static_cast<NT>(std::floor(static_cast<double>(dmin) / static_cast<double>(delta)) * delta);
+        NT hi = lo + delta;
+        auto inBucket = [lo, hi](NT d){ return d >= lo && d < hi; };
+
+        // light edges can reinsert vertices into the current bucket
+        FullyDistSpVec<IT,NT> frontier(dist, inBucket);
+        while(frontier.getnnz() > 0)
+        {
+            frontier = Relax(split.ALightT, frontier, dist);
+            frontier.Select(dist, inBucket);
+        }
+        // the bucket is now settled, relax its heavy edges once
+        FullyDistSpVec<IT,NT> settled(dist, inBucket);
+        Relax(split.AHeavyT, settled, dist);
+
+        lo = hi;
+#ifdef SSSP_DEBUG
+        ++nbuckets;
+#endif
+    }
+#ifdef SSSP_DEBUG
+    std::ostringstream outs;
+    outs << "Delta-stepping from " << source << " processed " << nbuckets << " buckets" << std::endl;
+    SpParHelper::Print(outs.str());
+#endif
+    return dist;
+}
+
+
+template <typename IT, typename NT, typename DER>
+FullyDistVec<IT,NT> DeltaStepping(const SpParMat<IT,NT,DER> & A, IT source, NT delta)
+{
+    DeltaSteppingSplit<IT,NT,DER> split(A, delta);
+    return DeltaStepping(split, source);
+}
+
+/**
+ * Batched masked relaxation: column s of F is the frontier of source s and column s of D holds
+ * its tentative distances (missing entries are infinite). All frontiers are relaxed with one
+ * MinPlus SpGEMM and D is updated in place.
+ * @return the entries of D that have been improved
+ */
+template <typename IT, typename NT, typename DER>
+SpParMat<IT,NT,DER> RelaxBatch(SpParMat<IT,NT,DER> & AT, SpParMat<IT,NT,DER> & F, SpParMat<IT,NT,DER> & D)
+{
+    const NT inf = std::numeric_limits<NT>::max();
+    SpParMat<IT,NT,DER> reach = Mult_AnXBn_Synch<MinPlusSRing<NT,NT>, NT, DER>(AT, F);
+    SpParMat<IT,NT,DER> improved = EWiseApply<NT, DER>(reach, D,
+            [](NT r, NT d){ return r; },
+            [](NT r, NT d){ return r < d; },
+            false, true, inf, inf, true);
+    D = EWiseApply<NT, DER>(D, improved,
+            [](NT d, NT r){ return std::min(d, r); },
+            [](NT d, NT r){ return true; },
+            true, true, inf, inf, true);
+    return improved;
+}
+
+/**
+ * Batched version: the distances of all sources form the columns of one n x k sparse matrix,
+ * so every light/heavy relaxation step is a single SpGEMM with a k-column frontier instead of
+ * k separate SpMSpVs. The buckets are shared: bucket b is processed for all sources at once
+ * and a source without vertices in it simply contributes an empty column.
+ */
+template <typename IT, typename NT, typename DER>
+std::vector< FullyDistVec<IT,NT> > DeltaStepping(const SpParMat<IT,NT,DER> & A, const std::vector<IT> & sources, NT delta)
+{
+    const NT inf = std::numeric_limits<NT>::max();
+    DeltaSteppingSplit<IT,NT,DER> split(A, delta);
+    std::shared_ptr<CommGrid> grid = A.getcommgrid();
+    IT n = A.getnrow();
+    IT k = static_cast<IT>(sources.size());
+
+    FullyDistVec<IT,IT> srcrows(grid, k, 0), srccols(grid);
+    std::vector<IT> batch(sources.size());
+    std::iota(batch.begin(), batch.end(), static_cast<IT>(0));
+    srcrows.SetElements(batch, sources);
+    srccols.iota(k, 0);
+    FullyDistVec<IT,NT> zeros(grid, k, static_cast<NT>(0));
+    SpParMat<IT,NT,DER> D(n, k, srcrows, srccols, zeros, false);
+
+    NT lo = 0;  // every distance smaller than lo is settled, for all sources
+#ifdef SSSP_DEBUG
+    int nbuckets = 0;
+#endif
+    while(true)
+    {
+        FullyDistVec<IT,NT> colmin = D.Reduce(Column, minimum<NT>(), inf, [lo, inf](NT d){ return d >= lo ? d : inf; });
+        NT dmin = colmin.Reduce(minimum<NT>(), inf);
+        if(dmin == inf) break;
+
+        lo = static_cast<NT>(std::floor(static_cast<double>(dmin) / static_cast<double>(delta)) * delta);
+        NT hi = lo + delta;
+        auto outsideBucket = [lo, hi](NT d){ return d < lo || d >= hi; };
+
+        SpParMat<IT,NT,DER> frontier = D.Prune(outsideBucket, false);
+        while(frontier.getnnz() > 0)
+        {
+            frontier = RelaxBatch(split.ALightT, frontier, D);
+            frontier.Prune(outsideBucket);
+        }
+        SpParMat<IT,NT,DER> settled = D.Prune(outsideBucket, false);
+        RelaxBatch(split.AHeavyT, settled, D);
+
+        lo = hi;
+#ifdef SSSP_DEBUG
+        ++nbuckets;
+#endif
+    }
+#ifdef SSSP_DEBUG
+    std::ostringstream outs;
+    outs << "Batched delta-stepping from " << k << " sources processed " << nbuckets << " buckets" << std::endl;
+    SpParHelper::Print(outs.str());
+#endif
+
+    // scatter all columns of D into the dense distance vectors with one pass over the local block and one all-to-all
+    std::vector< FullyDistVec<IT,NT> > dists(sources.size(), FullyDistVec<IT,NT>(grid, n, inf));
+    MPI_Comm World = grid->GetWorld();
+    int nprocs = grid->GetSize();
+    IT roffset = grid->GetRankInProcCol() * (n / grid->GetGridRows());    // offsets of the local block of D
+    IT coffset = grid->GetRankInProcRow() * (k / grid->GetGridCols());
+    std::vector< std::vector< std::tuple<IT,IT,NT> > > data(nprocs);   // (source, local index at the owner, distance)
+    DER * spSeq = D.seqptr();
+    for(typename DER::SpColIter colit = spSeq->begcol(); colit != spSeq->endcol(); ++colit)
+    {
+        for(typename DER::SpColIter::NzIter nzit = spSeq->begnz(colit); nzit != spSeq->endnz(colit); ++nzit)
+        {
+            IT locind;
+            int owner = dists[0].Owner(nzit.rowid() + roffset, locind);   // all distance vectors are distributed alike
+            data[owner].push_back(std::make_tuple(colit.colid() + coffset, locind, nzit.value()));
+        }
+    }
+
+    std::vector<int> sendcnt(nprocs), recvcnt(nprocs), sdispls(nprocs, 0), rdispls(nprocs, 0);
+    for(int i=0; i<nprocs; ++i)
+        sendcnt[i] = static_cast<int>(data[i].size());
+    MPI_Alltoall(sendcnt.data(), 1, MPI_INT, recvcnt.data(), 1, MPI_INT, World);
+    std::partial_sum(sendcnt.begin(), sendcnt.end()-1, sdispls.begin()+1);
+    std::partial_sum(recvcnt.begin(), recvcnt.end()-1, rdispls.begin()+1);
+    std::vector< std::tuple<IT,IT,NT> > senddata(sdispls.back() + sendcnt.back());
+    for(int i=0; i<nprocs; ++i)
+    {
+        std::copy(data[i].begin(), data[i].end(), senddata.begin() + sdispls[i]);
+        std::vector< std::tuple<IT,IT,NT> >().swap(data[i]);
+    }
+    std::vector< std::tuple<IT,IT,NT> > recvdata(rdispls.back() + recvcnt.back());
+    MPI_Datatype MPI_triple;
+    MPI_Type_contiguous(sizeof(std::tuple<IT,IT,NT>), MPI_CHAR, &MPI_triple);
+    MPI_Type_commit(&MPI_triple);
+    MPI_Alltoallv(senddata.data(), sendcnt.data(), sdispls.data(), MPI_triple, recvdata.data(), recvcnt.data(), rdispls.data(), MPI_triple, World);
+    MPI_Type_free(&MPI_triple);
+
+    for(const auto & t : recvdata)
+        dists[std::get<0>(t)].SetLocalElement(std::get<1>(t), std::get<2>(t));
+    return dists;
+}
+
+} /* namespace combblas */
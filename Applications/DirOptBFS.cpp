@@ -35,6 +35,7 @@
 #include <iomanip>
 #include <functional>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -320,6 +321,9 @@ int main(int argc, char* argv[])
 		{
 			Cands.SetElement(i,loccandints[i]);
 		}
+		vector<int64_t> candinds(ITERS);
+		iota(candinds.begin(), candinds.end(), 0);
+		vector<int64_t> sources = Cands.GetElements(candinds);	// one collective instead of a broadcast per Cands[i]
 
 		#define MAXTRIALS 1
 		for(int trials =0; trials < MAXTRIALS; trials++)	// try different algorithms for BFS if MAXTRIALS > 1
@@ -367,8 +371,8 @@ int main(int argc, char* argv[])
 				devout << "param " << num_nodes << " vertices with " << num_edges << " edges" << endl;
 				devout << up_cutoff << " up and " << down_cutoff << " down" << endl;
 
-				fringe.SetElement(Cands[i], Cands[i]);
-				parents.SetElement(Cands[i], Cands[i]);
+				fringe.SetElement(sources[i], sources[i]);
+				parents.SetElement(sources[i], sources[i]);
 				int iterations = 0;
 
 				BitMapFringe<int64_t,int64_t> bm_fringe(fringe.getcommgrid(), fringe);
@@ -452,7 +456,7 @@ int main(int argc, char* argv[])
 				int64_t nverts = parentsp.Reduce(plus<int64_t>(), (int64_t) 0);
 				
 				ostringstream outnew;
-				outnew << i << "th starting vertex was " << Cands[i] << endl;
+				outnew << i << "th starting vertex was " << sources[i] << endl;
 				outnew << "Number iterations: " << iterations << endl;
 				outnew << "Number of vertices found: " << nverts << endl; 
 				outnew << "Number of edges traversed: " << nedges << endl;
@@ -101,6 +101,7 @@ int main(int argc, char* argv[])
             cout << "-I <INPUT FILE TYPE> (mm: matrix market, triples: (vtx1, vtx2, edge_weight) triples. default:mm)\n";
             cout << "-base <BASE OF MATRIX MARKET> (default:1)\n";
             cout << "-rand <RANDOMLY PERMUTE VERTICES> (default:0)\n";
+            cout << "-incremental <NUMBER OF BATCHES> (insert the edges in batches with IncrementalSV and check against SV. default:0)\n";
             cout << "Example (0-indexed mtx with random permutation): ./fastsv -M input.mtx -base 0 -rand 1" << endl;
             cout << "Example (triples format): ./fastsv -I triples -M input.txt" << endl;
         }
@@ -112,6 +113,7 @@ int main(int argc, char* argv[])
         int base = 1;
         int randpermute = 0;
         int step = 1;
+        int nbatches = 0;
         bool isMatrixMarket = true;
 
         for (int i = 1; i < argc; i++)
@@ -136,6 +138,11 @@ int main(int argc, char* argv[])
                 randpermute = atoi(argv[i + 1]);
                 if(myrank == 0) printf("\nRandomly permute the matrix? (1 or 0):%d\n",randpermute);
             }
+            else if (strcmp(argv[i],"-incremental")==0)
+            {
+                nbatches = atoi(argv[i + 1]);
+                if(myrank == 0) printf("\nNumber of incremental batches:%d\n",nbatches);
+            }
             else if (strcmp(argv[i],"-step")==0)
             {
                 step = atoi(argv[i + 1]);
@@ -224,6 +231,54 @@ int main(int argc, char* argv[])
         s2 <<  "=================================================\n" << endl ;
         SpParHelper::Print(s2.str());
 
+        if(nbatches > 0)
+        {
+            // stream the edges in nbatches batches, starting from singletons
+            FullyDistVec<Int, Int> ri(A.getcommgrid()), ci(A.getcommgrid()), vi(A.getcommgrid());
+            A.Find(ri, ci, vi);
+            vector< vector<Int> > brows(nbatches), bcols(nbatches);
+            const Int * pr = ri.GetLocArr();
+            const Int * pc = ci.GetLocArr();
+            for(Int i = 0; i < ri.LocArrSize(); ++i)
+            {
+                if(pr[i] < pc[i])   // one direction of each undirected edge suffices
+                {
+                    int b = static_cast<int>(((pr[i] * 2654435761ULL) ^ pc[i]) % nbatches);
+                    brows[b].push_back(pr[i]);
+                    bcols[b].push_back(pc[i]);
+                }
+            }
+            FullyDistVec<Int, Int> father(A.getcommgrid());
+            father.iota(A.getnrow(), 0);
+            double tinc = 0;
+            for(int b = 0; b < nbatches; ++b)
+            {
+                FullyDistVec<Int, Int> rows(brows[b], A.getcommgrid());
+                FullyDistVec<Int, Int> cols(bcols[b], A.getcommgrid());
+                double tb = MPI_Wtime();
+                Int nrelabeled = IncrementalSV(father, rows, cols);
+                tinc += MPI_Wtime() - tb;
+                outs.str("");
+                outs.clear();
+                outs << "Batch " << b << ": " << rows.TotalLength() << " edges, " << nrelabeled << " vertices relabeled" << endl;
+                SpParHelper::Print(outs.str());
+            }
+            FullyDistVec<Int, Int> D(A.getcommgrid());
+            D.iota(A.getnrow(), 0);
+            FullyDistVec<Int, Int> full = SVFather(A, D);
+            outs.str("");
+            outs.clear();
+            outs << "Incremental time: " << tinc << endl;
+            SpParHelper::Print(outs.str());
+            if(!(full == father))
+            {
+                SpParHelper::Print("ERROR: incremental labels differ from SV\n");
+                MPI_Finalize();
+                return 1;
+            }
+            SpParHelper::Print("Incremental labels match SV\n");
+        }
+
     }
 
     MPI_Finalize();
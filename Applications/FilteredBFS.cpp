@@ -33,6 +33,7 @@
 #include <iostream>
 #include <functional>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -77,9 +78,8 @@ void Symmetricize(PARMAT & A)
 {
 	// boolean addition is practically a "logical or"
 	// therefore this doesn't destruct any links
-	PARMAT AT = A;
-	AT.Transpose();
-	A += AT;
+	typedef typename PARMAT::GlobalNT NT;
+	A.Symmetrize([](NT a, const NT & b){ a += b; return a; });	// TwitterEdge has += but no +
 }
 
 
@@ -347,6 +347,9 @@ int main(int argc, char* argv[])
 		FullyDistVec<int64_t, int64_t> Cands(MAX_ITERS, 0);
 		double nver = (double) degrees.TotalLength();
 		Cands.SelectCandidates(nver);
+		vector<int64_t> candinds(MAX_ITERS);
+		iota(candinds.begin(), candinds.end(), 0);
+		vector<int64_t> sources = Cands.GetElements(candinds);	// one collective instead of a broadcast per Cands[i]
 
 		for(int trials =0; trials < MAXTRIALS; trials++)	
 		{
@@ -381,8 +384,8 @@ int main(int argc, char* argv[])
 				long long ptr2values[combblas_papi_num_events];
 			#endif
 
-				fringe.SetElement(Cands[i], Cands[i]);
-				parents.SetElement(Cands[i], ParentType(Cands[i]));	// make root discovered
+				fringe.SetElement(sources[i], sources[i]);
+				parents.SetElement(sources[i], ParentType(sources[i]));	// make root discovered
 				int iterations = 0;
 				while(fringe.getnnz() > 0)
 				{
@@ -508,7 +511,7 @@ int main(int argc, char* argv[])
 				#endif
 					
 					ostringstream outnew;  
-					outnew << i << "th starting vertex was " << Cands[i] << endl;
+					outnew << i << "th starting vertex was " << sources[i] << endl;
 					outnew << "Number iterations: " << iterations << endl;
 					outnew << "Number of vertices found: " << parentsp.getnnz() << endl; 
 					outnew << "Number of edges traversed in both directions: " << nedges << endl;
@@ -527,7 +530,7 @@ int main(int argc, char* argv[])
 					/* Write to PAPI */
 				#ifdef USE_PAPI
 					ostringstream papiout;
-					papiout << i << "th starting vertex was " << Cands[i] << endl;
+					papiout << i << "th starting vertex was " << sources[i] << endl;
 					papiout << "Threshold is " << LatestRetwitterBFS::sincedate  << endl;
 					
 					for(int i=0; i < iterations; i++)	// over all spmv iterations in this BFS  
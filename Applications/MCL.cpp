@@ -45,6 +45,7 @@
 #include <sstream>  // Required for stringstreams
 #include <ctime>
 #include <cmath>
+#include <atomic>
 #include "CombBLAS/CombBLAS.h"
 #include "CC.h"
 #include "WriteMCLClusters.h"
@@ -93,6 +94,7 @@ typedef struct
     
     //Preprocessing
     int randpermute;
+    bool balancepermute;
     bool remove_isolated;
     
     //inflation
@@ -132,6 +134,7 @@ void InitParam(HipMCLParam & param)
     // we don't do this because it will create different ordering of vertices!
     param.remove_isolated = false;
     param.randpermute = 0;
+    param.balancepermute = false;
     
     //inflation
     param.inflation = 0.0;
@@ -181,6 +184,10 @@ void ShowParam(HipMCLParam & param)
     if (param.randpermute) runinfo << "yes";
     else runinfo << "no" << endl;
     
+    runinfo << "    Permute vertices for nnz balance? : ";
+    if (param.balancepermute) runinfo << "yes" << endl;
+    else runinfo << "no" << endl;
+    
     runinfo << "Inflation: " << param.inflation << endl;
     
     runinfo << "Pruning" << endl;
@@ -266,6 +273,9 @@ void ProcessParam(int argc, char* argv[], HipMCLParam & param)
         else if (strcmp(argv[i],"-rand")==0) {
             param.randpermute = atoi(argv[i + 1]);
         }
+        else if (strcmp(argv[i],"--balance")==0) {
+            param.balancepermute = true;
+        }
         else if (strcmp(argv[i],"--preprune")==0) {
             param.preprune = true;
         }
@@ -314,6 +324,7 @@ void ShowOptions()
     
     runinfo << "Preprocessing" << endl;
     runinfo << "    -rand <randomly permute vertices> (default:0)\n";
+    runinfo << "    --balance : if provided, permute vertices to balance the nonzeros of the processor grid while keeping their order where possible (default: don't permute)\n";
     runinfo << "    --remove-isolated : if provided, remove isolated vertices (default: don't remove isolated vertices)\n";
     
     
@@ -396,6 +407,31 @@ void Inflate(SpParMat<IT,NT,DER> & A, double power)
     A.Apply(bind2nd(exponentiate(), power));
 }
 
+// Fused MakeColStochastic, Chaos, Inflate and MakeColStochastic:
+// the column statistics are gathered while inflating (one pass, one allreduce), then a second pass rescales.
+// Normalizing before inflation is not needed, since (a/s)^p / sum((a/s)^p) = a^p / sum(a^p)
+template <typename IT, typename NT, typename DER>
+NT ChaosInflate(SpParMat<IT,NT,DER> & A, double power)
+{
+    std::vector< ColumnStats<NT> > stats = A.ColumnStatsApply(bind2nd(exponentiate(), power));
+    NT chaos = 0;
+    std::vector<NT> scale(stats.size());
+    for(size_t j=0; j < stats.size(); ++j)
+    {
+        if(stats[j].nnz > 0 && stats[j].sum > 0)   // an all zero column has no stochastic form and no chaos
+        {
+            // max and sum of squares of the column stochastic column
+            NT colmax = stats[j].max / stats[j].sum;
+            NT colssq = stats[j].sumsq / (stats[j].sum * stats[j].sum);
+            chaos = std::max(chaos, (colmax - colssq) * stats[j].nnz);
+        }
+        scale[j] = safemultinv<NT>()(stats[j].appliedsum);
+    }
+    MPI_Allreduce(MPI_IN_PLACE, &chaos, 1, MPIType<NT>(), MPI_MAX, A.getcommgrid()->GetWorld());
+    A.ColumnApply(scale, multiplies<NT>());
+    return chaos;
+}
+
 // default adjustloop setting
 // 1. Remove loops
 // 2. set loops to max of all arc weights
@@ -450,6 +486,31 @@ void RandPermute(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
     }
 }
 
+/**
+ * Symmetric permutation that balances the nonzeros across the processor grid (see SpParMat::NnzBalancedPermutation)
+ * @return the new id of each original vertex, used to report clusters in the original vertex order
+ */
+template <typename IT, typename NT, typename DER>
+FullyDistVec<IT, IT> BalancePermute(SpParMat<IT,NT,DER> & A)
+{
+    FullyDistVec<IT, IT> newids(A.getcommgrid());
+    if(A.getnrow() == A.getncol())
+    {
+        float before = A.LoadImbalance();
+        FullyDistVec<IT, IT> p = A.NnzBalancedPermutation();
+        (A)(p,p,true);// in-place permute to save memory
+        newids = p.sort();
+        stringstream s;
+        s << "Applied nnz-balancing symmetric permutation, load imbalance " << before << " -> " << A.LoadImbalance() << endl;
+        SpParHelper::Print(s.str());
+    }
+    else
+    {
+        SpParHelper::Print("Rectangular matrix: Can not apply symmetric permutation.\n");
+    }
+    return newids;
+}
+
 template <typename IT, typename NT, typename DER>
 FullyDistVec<IT, IT> HipMCL(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
 {
@@ -462,6 +523,10 @@ FullyDistVec<IT, IT> HipMCL(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
     
     if(param.randpermute)
         RandPermute(A, param);
+    
+    FullyDistVec<IT, IT> newids(A.getcommgrid());
+    if(param.balancepermute)
+        newids = BalancePermute(A);
 
     // Adjust self loops
     AdjustLoops(A);
@@ -515,7 +580,6 @@ FullyDistVec<IT, IT> HipMCL(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
         //A.Square<PTFF>() ;		// expand
         A = MemEfficientSpGEMM<PTFF, NT, DER>(A, A, param.phases, param.prunelimit, (IT)param.select, (IT)param.recover_num, param.recover_pct, param.kselectVersion, param.perProcessMem);
         
-        MakeColStochastic(A);
         tExpand += (MPI_Wtime() - t1);
         
         if(param.show)
@@ -523,11 +587,9 @@ FullyDistVec<IT, IT> HipMCL(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
             SpParHelper::Print("After expansion\n");
             A.PrintInfo();
         }
-        chaos = Chaos(A);
         
         double tInflate1 = MPI_Wtime();
-        Inflate(A, param.inflation);
-        MakeColStochastic(A);
+        chaos = ChaosInflate(A, param.inflation);
         tInflate += (MPI_Wtime() - tInflate1);
         
         if(param.show)
@@ -569,6 +631,8 @@ FullyDistVec<IT, IT> HipMCL(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
     // hence, we are forcing this with IT and double
     SpParMat<IT,double, SpDCCols < IT, double >> ADouble = A;
     FullyDistVec<IT, IT> cclabels = Interpret(ADouble);
+    if(newids.TotalLength() > 0)
+        cclabels = cclabels(newids);	// back to the original vertex order
     
     
 #ifdef TIMING
@@ -597,16 +661,20 @@ FullyDistVec<IT, IT> HipMCL(SpParMat<IT,NT,DER> & A, HipMCLParam & param)
 
 }
 
+// A += A' if A is not symmetric, without forming A'
+// Symmetrize doubles every entry of a symmetric matrix (the diagonal included), which is undone afterwards
 template <typename IT, typename NT, typename DER>
 void Symmetricize(SpParMat<IT,NT,DER> & A)
 {
-    SpParMat<IT,NT,DER> AT = A;
-    AT.Transpose();
-    if(!(AT == A))
-    {
+    IT nnz = A.getnnz();
+    std::atomic<bool> differ(false);
+    A.Symmetrize([&differ](NT a, NT b){ if(a != b) differ.store(true, std::memory_order_relaxed); return a + b; });
+    int unsymmetric = (differ.load() || A.getnnz() != nnz);
+    MPI_Allreduce(MPI_IN_PLACE, &unsymmetric, 1, MPI_INT, MPI_LOR, A.getcommgrid()->GetWorld());
+    if(unsymmetric)
         SpParHelper::Print("Symmatricizing an unsymmetric input matrix.\n");
-        A += AT;
-    }
+    else
+        A.Apply([](NT val){ return val / 2; });
 }
 
 template <typename GIT, typename LIT, typename NT>
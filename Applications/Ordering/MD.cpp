@@ -21,10 +21,7 @@ void Symmetricize(PARMAT & A)
 {
     // boolean addition is practically a "logical or"
     // therefore this doesn't destruct any links
-    PARMAT AT = A;
-    AT.Transpose();
-    AT.RemoveLoops(); // not needed for boolean matrices, but no harm in keeping it
-    A += AT;
+    A.Symmetrize();
 }
 
 
@@ -0,0 +1,250 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include <mpi.h>
+
+// These macros should be defined before stdint.h is included
+#ifndef __STDC_CONSTANT_MACROS
+#define __STDC_CONSTANT_MACROS
+#endif
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+#include <stdint.h>
+
+#include <sys/time.h>
+#include <iostream>
+#include <string>
+#include <sstream>
+#include <cmath>
+#include "CombBLAS/CombBLAS.h"
+#include "NestedDissection.h"
+
+using namespace std;
+using namespace combblas;
+
+#define EDGEFACTOR 16
+
+class Dist
+{
+public:
+    typedef SpDCCols < int64_t, double > DCCols;
+    typedef SpParMat < int64_t, double, DCCols > MPI_DCCols;
+};
+
+
+/**
+ * 5-point stencil on a k x k grid, each process generates the rows of its piece of the vertex space
+ */
+Dist::MPI_DCCols GridGraph(int64_t k)
+{
+    shared_ptr<CommGrid> fullWorld(new CommGrid(MPI_COMM_WORLD, 0, 0));
+    int64_t n = k * k;
+    FullyDistVec<int64_t, int64_t> verts(fullWorld);
+    verts.iota(n, 0);
+    vector<int64_t> ri, ci;
+    for(int64_t i = 0; i < verts.LocArrSize(); ++i)
+    {
+        int64_t v = verts.GetLocArr()[i];
+        int64_t x = v % k, y = v / k;
+        if(x > 0) { ri.push_back(v); ci.push_back(v - 1); }
+        if(x < k-1) { ri.push_back(v); ci.push_back(v + 1); }
+        if(y > 0) { ri.push_back(v); ci.push_back(v - k); }
+        if(y < k-1) { ri.push_back(v); ci.push_back(v + k); }
+    }
+    FullyDistVec<int64_t, int64_t> rows(ri, fullWorld), cols(ci, fullWorld);
+    return Dist::MPI_DCCols(n, n, rows, cols, 1.0, false);
+}
+
+
+/**
+ * Number of nonzeros of the Cholesky factor of PAP' where order[v] is the position of v,
+ * from the elimination tree (with path compression) and the row subtrees
+ */
+int64_t CholeskyFill(const vector<int64_t> & rowptr, const vector<int64_t> & colids, const vector<int64_t> & order)
+{
+    int64_t n = static_cast<int64_t>(order.size());
+    vector<int64_t> perm(n);	// perm[position] = vertex
+    for(int64_t v = 0; v < n; ++v) perm[order[v]] = v;
+    vector<int64_t> parent(n, -1), ancestor(n, -1), mark(n, -1);
+    for(int64_t i = 0; i < n; ++i)
+    {
+        int64_t v = perm[i];
+        for(int64_t k = rowptr[v]; k < rowptr[v+1]; ++k)
+        {
+            int64_t j = order[colids[k]];
+            while(j != -1 && j < i)
+            {
+                int64_t next = ancestor[j];
+                ancestor[j] = i;
+                if(next == -1) parent[j] = i;
+                j = next;
+            }
+        }
+    }
+    int64_t fill = n;
+    for(int64_t i = 0; i < n; ++i)
+    {
+        int64_t v = perm[i];
+        mark[i] = i;
+        for(int64_t k = rowptr[v]; k < rowptr[v+1]; ++k)
+        {
+            for(int64_t j = order[colids[k]]; j < i && mark[j] != i; j = parent[j])
+            {
+                mark[j] = i;
+                ++fill;
+            }
+        }
+    }
+    return fill;
+}
+
+
+int main(int argc, char* argv[])
+{
+    int nprocs, myrank;
+    MPI_Init(&argc, &argv);
+    MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+    MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+    if(argc < 3)
+    {
+        if(myrank == 0)
+        {
+            cout << "Usage: ./nd <grid|rmat|er|input> <k|scale|filename> [-parts k] [-verify]" << endl;
+            cout << "Example with a 2D grid graph: mpirun -np 4 ./nd grid 128 -parts 8 -verify" << endl;
+            cout << "Example with a user supplied matrix: mpirun -np 4 ./nd input a.mtx" << endl;
+            cout << "The pattern of A+A' is ordered; -parts also partitions it into k parts, -verify compares Cholesky fill with the natural order" << endl;
+        }
+        MPI_Finalize();
+        return -1;
+    }
+    int status = 0;
+    {
+        int nparts = 0;
+        bool verify = false;
+        for (int i = 3; i < argc; i++)
+        {
+            if (strcmp(argv[i],"-verify")==0)
+                verify = true;
+            if (strcmp(argv[i],"-parts")==0 && i+1 < argc)
+                nparts = atoi(argv[++i]);
+        }
+
+        Dist::MPI_DCCols A;
+        if(string(argv[1]) == string("input"))
+        {
+            A.ParallelReadMM(string(argv[2]), true, maximum<double>());
+        }
+        else if(string(argv[1]) == string("grid"))
+        {
+            A = GridGraph(atoll(argv[2]));
+        }
+        else if(string(argv[1]) == string("rmat") || string(argv[1]) == string("er"))
+        {
+            unsigned scale = static_cast<unsigned>(atoi(argv[2]));
+            double rmat[4] = {.57, .19, .19, .05};
+            double er[4] = {.25, .25, .25, .25};
+            DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+            DEL->GenGraph500Data(string(argv[1]) == string("er") ? er : rmat, scale, EDGEFACTOR, true, false);
+            A = Dist::MPI_DCCols(*DEL, false);
+            delete DEL;
+        }
+        else
+        {
+            SpParHelper::Print("Unknown input option\n");
+            MPI_Finalize();
+            return -1;
+        }
+        // unit weights on the pattern of A+A'
+        A.Apply([](double w){ return 1.0; });
+        Dist::MPI_DCCols AT = A;
+        AT.Transpose();
+        A += AT;
+        A.RemoveLoops();
+        A.Apply([](double w){ return 1.0; });
+        A.PrintInfo();
+
+        if(nparts > 1)
+        {
+            double t1 = MPI_Wtime();
+            FullyDistVec<int64_t, int64_t> part = Partition(A, nparts);
+            double t2 = MPI_Wtime();
+            ostringstream outs;
+            outs << "Partitioning into " << nparts << " parts took " << t2 - t1 << " seconds, edge cut " << EdgeCut(A, part) << endl;
+            int64_t largest = 0;
+            for(int p = 0; p < nparts; ++p)
+                largest = max(largest, part.Count([p](int64_t q){ return q == p; }));
+            outs << "Largest part has " << largest << " vertices, imbalance " << static_cast<double>(largest) * nparts / A.getnrow() << endl;
+            SpParHelper::Print(outs.str());
+        }
+
+        double t1 = MPI_Wtime();
+        FullyDistVec<int64_t, int64_t> order = NestedDissection(A);
+        double t2 = MPI_Wtime();
+        ostringstream outs;
+        outs << "Nested dissection ordering took " << t2 - t1 << " seconds" << endl;
+        SpParHelper::Print(outs.str());
+
+        if(verify)
+        {
+            // order must be a permutation
+            FullyDistVec<int64_t, int64_t> ones(A.getcommgrid(), A.getnrow(), 1);
+            FullyDistSpVec<int64_t, int64_t> hits(A.getnrow(), order, ones, true);
+            bool correct = (order.Count([](int64_t p){ return p < 0; }) == 0) && (hits.getnnz() == A.getnrow()) && (hits.Reduce(maximum<int64_t>(), (int64_t) 0) == 1);
+
+            vector<int64_t> rowptr, colids;
+            vector<double> wgts;
+            GatherGraph(A, 0, rowptr, colids, wgts);
+            int64_t n = A.getnrow();
+            vector<int64_t> allorder(myrank == 0 ? n : 0);
+            vector<int> cnt(nprocs), displs(nprocs+1, 0);
+            int mycnt = static_cast<int>(order.LocArrSize());
+            MPI_Gather(&mycnt, 1, MPI_INT, cnt.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+            partial_sum(cnt.begin(), cnt.end(), displs.begin()+1);
+            MPI_Gatherv(order.GetLocArr(), mycnt, MPIType<int64_t>(), allorder.data(), cnt.data(), displs.data(), MPIType<int64_t>(), 0, MPI_COMM_WORLD);
+            int fewer = 1;
+            if(myrank == 0 && correct)
+            {
+                vector<int64_t> natural(n);
+                iota(natural.begin(), natural.end(), 0);
+                int64_t fillnat = CholeskyFill(rowptr, colids, natural);
+                int64_t fillnd = CholeskyFill(rowptr, colids, allorder);
+                cout << "Cholesky factor has " << fillnd << " nonzeros with nested dissection, " << fillnat << " in natural order" << endl;
+                fewer = (fillnd < fillnat);
+            }
+            MPI_Bcast(&fewer, 1, MPI_INT, 0, MPI_COMM_WORLD);
+            correct = correct && fewer;
+            SpParHelper::Print(correct ? "Verification passed\n" : "ERROR: ordering is not a permutation or does not reduce fill\n");
+            if(!correct) status = 1;
+        }
+    }
+    MPI_Finalize();
+    return status;
+}
@@ -0,0 +1,798 @@
+#ifndef NESTED_DISSECTION_H
+#define NESTED_DISSECTION_H
+
+#include <mpi.h>
+
+// These macros should be defined before stdint.h is included
+#ifndef __STDC_CONSTANT_MACROS
+#define __STDC_CONSTANT_MACROS
+#endif
+#ifndef __STDC_LIMIT_MACROS
+#define __STDC_LIMIT_MACROS
+#endif
+#include <stdint.h>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <sstream>
+#include <vector>
+#include "CombBLAS/CombBLAS.h"
+#include "../BipartiteMatchings/ApproxWeightPerfectMatching.h"
+
+/**
+ ** Multilevel graph bisection, recursive bisection partitioning and nested dissection ordering
+ ** of a symmetric matrix without self loops (edge weights are the matrix values).
+ ** Coarsening contracts the pairs of a heavy-edge maximal matching (WeightedGreedy) with the
+ ** Galerkin product P'AP, the coarsest graph is bisected on one process by greedy graph growing,
+ ** and every level is refined by distributed gain-based passes that move boundary vertices.
+ ** Nested dissection turns bisections into vertex separators (minimum vertex covers of the cut
+ ** edges, found with the maximum matching code) and recurses while the subgraphs are large;
+ ** the remaining small subgraphs are dealt to processes and dissected serially.
+ **/
+
+#ifndef NDCOARSESIZE
+#define NDCOARSESIZE 1024	// coarsening stops once the graph has at most NDCOARSESIZE vertices
+#endif
+
+#ifndef NDCOARSENRATIO
+#define NDCOARSENRATIO 0.9	// ... or once a level keeps more than this fraction of the vertices
+#endif
+
+#ifndef NDIMBALANCE
+#define NDIMBALANCE 0.03	// a part may exceed its target weight by this fraction
+#endif
+
+#ifndef NDREFINEPASSES
+#define NDREFINEPASSES 8	// maximum number of refinement passes per level and direction
+#endif
+
+#ifndef NDINITTRIES
+#define NDINITTRIES 4	// number of seeds tried by the serial initial bisection
+#endif
+
+#ifndef NDGATHERSIZE
+#define NDGATHERSIZE 4096	// nested dissection orders subgraphs of at most NDGATHERSIZE vertices on a single process
+#endif
+
+#ifndef NDLEAFSIZE
+#define NDLEAFSIZE 16	// the serial dissection keeps pieces of at most NDLEAFSIZE vertices in their natural order
+#endif
+
+namespace combblas {
+
+/**
+ * Collects a distributed matrix as CSR arrays (with global indices) on process root
+ */
+template <class IT>
+void GatherGraph(SpParMat < IT, double, SpDCCols<IT, double> > & A, int root, std::vector<IT> & rowptr, std::vector<IT> & colids, std::vector<double> & wgts)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	MPI_Comm World = grid->GetWorld();
+	int nprocs = grid->GetSize();
+	int myrank = grid->GetRank();
+	IT nrow = A.getnrow();
+	IT ncol = A.getncol();
+
+	IT roffset = grid->GetRankInProcCol() * (nrow / grid->GetGridRows());
+	IT coffset = grid->GetRankInProcRow() * (ncol / grid->GetGridCols());
+	SpTuples<IT, double> tuples(*A.seqptr());
+	std::vector<IT> sendedges(2 * tuples.getnnz());
+	std::vector<double> sendwgts(tuples.getnnz());
+	for(int64_t i = 0; i < tuples.getnnz(); ++i)
+	{
+		sendedges[2*i] = tuples.rowindex(i) + roffset;
+		sendedges[2*i+1] = tuples.colindex(i) + coffset;
+		sendwgts[i] = tuples.numvalue(i);
+	}
+
+	std::vector<int> cnt(nprocs), displs(nprocs+1, 0);
+	int mycnt = static_cast<int>(sendwgts.size());
+	MPI_Gather(&mycnt, 1, MPI_INT, cnt.data(), 1, MPI_INT, root, World);
+	std::partial_sum(cnt.begin(), cnt.end(), displs.begin()+1);
+	std::vector<double> allwgts(myrank == root ? displs[nprocs] : 0);
+	MPI_Gatherv(sendwgts.data(), mycnt, MPI_DOUBLE, allwgts.data(), cnt.data(), displs.data(), MPI_DOUBLE, root, World);
+	for(int i = 0; i < nprocs; ++i)
+	{
+		cnt[i] *= 2;
+		displs[i+1] *= 2;
+	}
+	mycnt *= 2;
+	std::vector<IT> alledges(myrank == root ? displs[nprocs] : 0);
+	MPI_Gatherv(sendedges.data(), mycnt, MPIType<IT>(), alledges.data(), cnt.data(), displs.data(), MPIType<IT>(), root, World);
+
+	if(myrank == root)
+	{
+		rowptr.assign(nrow+1, 0);
+		for(size_t i = 0; i < alledges.size(); i += 2) ++rowptr[alledges[i]+1];
+		std::partial_sum(rowptr.begin(), rowptr.end(), rowptr.begin());
+		colids.resize(rowptr.back());
+		wgts.resize(rowptr.back());
+		std::vector<IT> fill(rowptr.begin(), rowptr.end()-1);
+		for(size_t i = 0; i < alledges.size(); i += 2)
+		{
+			IT k = fill[alledges[i]]++;
+			colids[k] = alledges[i+1];
+			wgts[k] = allwgts[i/2];
+		}
+	}
+}
+
+
+/**
+ * Greedy graph growing bisection of a serial graph: part 1 grows from a seed by always
+ * adding the boundary vertex with the largest gain until it reaches its target weight.
+ * Seeds are a pseudo-peripheral vertex and vertices spread over the index space; the cut is minimized.
+ * @return part[v] in {0,1}
+ */
+template <class IT>
+std::vector<IT> SerialGrowBisection(const std::vector<IT> & rowptr, const std::vector<IT> & colids, const std::vector<double> & wgts, const std::vector<double> & vw, double tfrac)
+{
+	IT n = static_cast<IT>(vw.size());
+	std::vector<IT> best(n, 0);
+	if(n < 2) return best;
+	double total = std::accumulate(vw.begin(), vw.end(), 0.0);
+	double target = tfrac * total;
+	std::vector<double> deg(n, 0);
+	for(IT v = 0; v < n; ++v)
+		for(IT k = rowptr[v]; k < rowptr[v+1]; ++k) deg[v] += wgts[k];
+
+	// pseudo-peripheral vertex: last vertex reached by a BFS from vertex 0
+	std::vector<IT> dist(n, -1);
+	std::vector<IT> bfs(1, 0);
+	dist[0] = 0;
+	for(size_t h = 0; h < bfs.size(); ++h)
+		for(IT k = rowptr[bfs[h]]; k < rowptr[bfs[h]+1]; ++k)
+			if(dist[colids[k]] == -1)
+			{
+				dist[colids[k]] = dist[bfs[h]] + 1;
+				bfs.push_back(colids[k]);
+			}
+
+	double bestcut = std::numeric_limits<double>::max();
+	for(int t = 0; t < NDINITTRIES; ++t)
+	{
+		IT seed = (t == 0) ? bfs.back() : static_cast<IT>((static_cast<int64_t>(t) * n) / NDINITTRIES);
+		std::vector<IT> part(n, 0);
+		std::vector<double> conn(n, 0);	// edge weight to part 1
+		std::priority_queue< std::pair<double,IT> > pq;
+		pq.push(std::make_pair(0.0, seed));
+		double w1 = 0;
+		IT next = 0;	// restarts growing from unassigned vertices of other components
+		while(w1 < target)
+		{
+			IT v = -1;
+			while(!pq.empty())
+			{
+				std::pair<double,IT> top = pq.top();
+				pq.pop();
+				if(part[top.second] == 0 && top.first == 2*conn[top.second] - deg[top.second])
+				{
+					v = top.second;
+					break;
+				}
+			}
+			if(v == -1)
+			{
+				while(next < n && part[next] == 1) ++next;
+				if(next == n) break;
+				v = next;
+			}
+			if(w1 + vw[v] > target && w1 + vw[v] - target > target - w1) break;
+			part[v] = 1;
+			w1 += vw[v];
+			for(IT k = rowptr[v]; k < rowptr[v+1]; ++k)
+			{
+				IT u = colids[k];
+				if(part[u] == 0)
+				{
+					conn[u] += wgts[k];
+					pq.push(std::make_pair(2*conn[u] - deg[u], u));
+				}
+			}
+		}
+		double cut = 0;
+		for(IT v = 0; v < n; ++v)
+			for(IT k = rowptr[v]; k < rowptr[v+1]; ++k)
+				if(part[v] != part[colids[k]]) cut += wgts[k];
+		if(cut < bestcut)
+		{
+			bestcut = cut;
+			best.swap(part);
+		}
+	}
+	return best;
+}
+
+
+/**
+ * Bisects a (small) distributed graph on process 0 with SerialGrowBisection
+ */
+template <class IT>
+FullyDistVec<IT, IT> InitialBisection(SpParMat < IT, double, SpDCCols<IT, double> > & A, const FullyDistVec<IT, double> & vw, double tfrac)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	MPI_Comm World = grid->GetWorld();
+	int nprocs = grid->GetSize();
+	int myrank = grid->GetRank();
+
+	std::vector<IT> rowptr, colids;
+	std::vector<double> wgts;
+	GatherGraph(A, 0, rowptr, colids, wgts);
+
+	// FullyDistVec pieces are laid out in rank order
+	std::vector<int> cnt(nprocs), displs(nprocs+1, 0);
+	int mycnt = static_cast<int>(vw.LocArrSize());
+	MPI_Gather(&mycnt, 1, MPI_INT, cnt.data(), 1, MPI_INT, 0, World);
+	std::partial_sum(cnt.begin(), cnt.end(), displs.begin()+1);
+	std::vector<double> allvw(myrank == 0 ? displs[nprocs] : 0);
+	MPI_Gatherv(vw.GetLocArr(), mycnt, MPI_DOUBLE, allvw.data(), cnt.data(), displs.data(), MPI_DOUBLE, 0, World);
+
+	std::vector<IT> allpart;
+	if(myrank == 0) allpart = SerialGrowBisection(rowptr, colids, wgts, allvw, tfrac);
+	std::vector<IT> mypart(mycnt);
+	MPI_Scatterv(allpart.data(), cnt.data(), displs.data(), MPIType<IT>(), mypart.data(), mycnt, MPIType<IT>(), 0, World);
+
+	FullyDistVec<IT, IT> part(grid, A.getnrow(), static_cast<IT>(0));
+	for(IT i = 0; i < mycnt; ++i) part.SetLocalElement(i, mypart[i]);
+	return part;
+}
+
+
+/**
+ * Distributed refinement of a bisection: every pass computes the gain of moving each vertex
+ * to the other part with one SpMV and moves the vertices of one side with positive gain (or all,
+ * while that side is overweight) at once. Moves in one direction never increase the cut, so the
+ * direction alternates. If the movers would overload the receiving part, only those above a gain
+ * threshold (found by bisection on the gain) are moved.
+ */
+template <class IT>
+void RefineBisection(SpParMat < IT, double, SpDCCols<IT, double> > & A, const FullyDistVec<IT, double> & vw, FullyDistVec<IT, IT> & part, double tfrac)
+{
+	typedef PlusTimesSRing<double, double> PTDD;
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	MPI_Comm World = grid->GetWorld();
+	IT n = A.getnrow();
+	IT nloc = part.LocArrSize();
+	const double * lvw = vw.GetLocArr();
+
+	FullyDistVec<IT, double> deg(grid);
+	A.Reduce(deg, Row, std::plus<double>(), 0.0);
+	const double * ldeg = deg.GetLocArr();
+
+	double wsum[2] = {0, 0};
+	for(IT i = 0; i < nloc; ++i) wsum[part.GetLocArr()[i]] += lvw[i];
+	MPI_Allreduce(MPI_IN_PLACE, wsum, 2, MPI_DOUBLE, MPI_SUM, World);
+	double target[2] = {(1-tfrac) * (wsum[0] + wsum[1]), tfrac * (wsum[0] + wsum[1])};
+
+	int idle = 0;	// consecutive passes without moves
+	for(int pass = 0; pass < 2*NDREFINEPASSES && idle < 2; ++pass)
+	{
+		// move out of the relatively heavier side first
+		int from = (wsum[0] / std::max(target[0], 1e-300) >= wsum[1] / std::max(target[1], 1e-300)) ? 0 : 1;
+		if(pass % 2 == 1) from = 1 - from;
+		int to = 1 - from;
+		bool overweight = wsum[from] > (1 + NDIMBALANCE) * target[from];
+		double room = (1 + NDIMBALANCE) * target[to] - wsum[to];
+		if(overweight) room = std::min(room, wsum[from] - target[from]);
+		if(room <= 0)
+		{
+			++idle;
+			continue;
+		}
+
+		FullyDistVec<IT, double> x(grid, n, 0.0);
+		for(IT i = 0; i < nloc; ++i)
+			if(part.GetLocArr()[i] == to) x.SetLocalElement(i, 1.0);
+		FullyDistVec<IT, double> y = SpMV<PTDD>(A, x);	// edge weight to the receiving side
+		const double * ly = y.GetLocArr();
+
+		const double lowest = std::numeric_limits<double>::lowest();
+		std::vector<double> gain(nloc, lowest);
+		double range[2] = {lowest, lowest};	// max gain and -min gain among candidates
+		for(IT i = 0; i < nloc; ++i)
+		{
+			if(part.GetLocArr()[i] != from) continue;
+			double g = 2 * ly[i] - ldeg[i];
+			if(g > 0 || (overweight && ly[i] > 0))	// overweight sides also give up boundary vertices that lose cut
+			{
+				gain[i] = g;
+				range[0] = std::max(range[0], g);
+				range[1] = std::max(range[1], -g);
+			}
+		}
+		MPI_Allreduce(MPI_IN_PLACE, range, 2, MPI_DOUBLE, MPI_MAX, World);
+		if(range[0] == lowest)
+		{
+			++idle;
+			continue;
+		}
+
+		// smallest gain threshold whose movers fit into the room
+		auto moverWeight = [&](double threshold)
+		{
+			double w = 0;
+			for(IT i = 0; i < nloc; ++i)
+				if(gain[i] >= threshold) w += lvw[i];
+			MPI_Allreduce(MPI_IN_PLACE, &w, 1, MPI_DOUBLE, MPI_SUM, World);
+			return w;
+		};
+		double lo = -range[1], hi = range[0];
+		if(moverWeight(lo) > room)
+		{
+			if(moverWeight(hi) > room)
+			{
+				++idle;
+				continue;
+			}
+			for(int it = 0; it < 30; ++it)
+			{
+				double mid = (lo + hi) / 2;
+				if(moverWeight(mid) > room) lo = mid;
+				else hi = mid;
+			}
+			lo = hi;
+		}
+
+		double moved[2] = {0, 0};	// moved weight and number of movers
+		for(IT i = 0; i < nloc; ++i)
+		{
+			if(gain[i] != lowest && gain[i] >= lo)
+			{
+				part.SetLocalElement(i, to);
+				moved[0] += lvw[i];
+				moved[1] += 1;
+			}
+		}
+		MPI_Allreduce(MPI_IN_PLACE, moved, 2, MPI_DOUBLE, MPI_SUM, World);
+		wsum[from] -= moved[0];
+		wsum[to] += moved[0];
+		idle = (moved[1] > 0) ? 0 : idle + 1;
+	}
+}
+
+
+/**
+ * Coarsening map of one level: column v of the heavy-edge maximal matching is matched to row
+ * mateCol2Row[v], and v joins the aggregate labelled min(v, mate). Since the matching is
+ * injective, every label is claimed by at most one other vertex, so aggregates are matched
+ * pairs or singletons. Labels are renumbered to [0,nc).
+ * @return the number of coarse vertices nc
+ */
+template <class IT>
+IT CoarseningMap(SpParMat < IT, double, SpDCCols<IT, double> > & A, FullyDistVec<IT, IT> & cmap)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	IT n = A.getnrow();
+	SpParMat < IT, double, SpCCols<IT, double> > Acsc(A);
+	FullyDistVec<IT, IT> degCol(grid);
+	A.Reduce(degCol, Column, std::plus<IT>(), static_cast<IT>(0), [](double w){return static_cast<IT>(1);});
+	FullyDistVec<IT, IT> mateRow2Col(grid, n, static_cast<IT>(-1));
+	FullyDistVec<IT, IT> mateCol2Row(grid, n, static_cast<IT>(-1));
+	WeightedGreedy(Acsc, mateRow2Col, mateCol2Row, degCol);
+
+	FullyDistVec<IT, IT> label(grid);
+	label.iota(n, 0);
+	label.EWiseApply(mateCol2Row, [](IT v, IT mate){return (mate == -1) ? v : std::min(v, mate);});
+	FullyDistVec<IT, IT> ones(grid, n, static_cast<IT>(1));
+	FullyDistSpVec<IT, IT> used(n, label, ones, true);
+	used.nziota(0);
+	FullyDistVec<IT, IT> newid(grid, n, static_cast<IT>(-1));
+	newid.Set(used);
+	cmap = newid(label);
+	return used.getnnz();
+}
+
+
+/**
+ * Multilevel bisection of a symmetric graph with vertex weights vw
+ * @param[in] tfrac: target fraction of the vertex weight in part 1
+ * @return part[v] in {0,1}
+ */
+template <class IT>
+FullyDistVec<IT, IT> Bisect(SpParMat < IT, double, SpDCCols<IT, double> > & A, const FullyDistVec<IT, double> & vw, double tfrac = 0.5)
+{
+	typedef SpParMat < IT, double, SpDCCols<IT, double> > PSpMat;
+	typedef PlusTimesSRing<double, double> PTDD;
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+
+	std::vector<PSpMat> mats(1, A);
+	std::vector< FullyDistVec<IT, double> > vws(1, vw);
+	std::vector< FullyDistVec<IT, IT> > cmaps;
+	while(mats.back().getnrow() > NDCOARSESIZE)
+	{
+		PSpMat & cur = mats.back();
+		IT n = cur.getnrow();
+		FullyDistVec<IT, IT> cmap(grid);
+		IT nc = CoarseningMap(cur, cmap);
+		if(nc > NDCOARSENRATIO * n) break;
+
+		// Galerkin product P'AP sums the edge weights between aggregates
+		FullyDistVec<IT, IT> rows(grid);
+		rows.iota(n, 0);
+		PSpMat P(n, nc, rows, cmap, 1.0, false);
+		PSpMat AP = PSpGEMM<PTDD>(cur, P);
+		P.Transpose();
+		PSpMat Ac = PSpGEMM<PTDD>(P, AP);
+		Ac.RemoveLoops();
+		FullyDistVec<IT, double> vwc = SpMV<PTDD>(P, vws.back());
+		cmaps.push_back(cmap);
+		mats.push_back(Ac);
+		vws.push_back(vwc);
+	}
+
+	FullyDistVec<IT, IT> part = InitialBisection(mats.back(), vws.back(), tfrac);
+	RefineBisection(mats.back(), vws.back(), part, tfrac);
+	for(int l = static_cast<int>(cmaps.size()) - 1; l >= 0; --l)
+	{
+		part = part(cmaps[l]);	// project to the finer level
+		mats.pop_back();
+		vws.pop_back();
+		RefineBisection(mats.back(), vws.back(), part, tfrac);
+	}
+#ifdef ND_DEBUG
+	std::ostringstream outs;
+	outs << "Bisected " << A.getnrow() << " vertices with " << cmaps.size() << " coarsening levels" << std::endl;
+	SpParHelper::Print(outs.str());
+#endif
+	return part;
+}
+
+
+/**
+ * Edge weight cut by a partition
+ */
+template <class IT>
+double EdgeCut(SpParMat < IT, double, SpDCCols<IT, double> > & A, const FullyDistVec<IT, IT> & part)
+{
+	SpParMat < IT, double, SpDCCols<IT, double> > C = A;
+	FullyDistVec<IT, double> p(part);
+	C.DimApply(Row, p, [](double w, double pr){return pr;});
+	SpParMat < IT, double, SpDCCols<IT, double> > W = A;
+	W.DimApply(Column, p, [](double w, double pc){return pc;});
+	SpParMat < IT, double, SpDCCols<IT, double> > D = EWiseApply<double, SpDCCols<IT, double> >(C, W, [](double pr, double pc){return (pr != pc) ? 1.0 : 0.0;}, false, 0.0);
+	D = EWiseApply<double, SpDCCols<IT, double> >(D, A, [](double cut, double w){return cut * w;}, false, 0.0);
+	return D.Reduce(Column, std::plus<double>(), 0.0).Reduce(std::plus<double>(), 0.0) / 2;
+}
+
+
+/**
+ * Recursive bisection into nparts parts of (nearly) equal size
+ * @return part[v] in [0,nparts)
+ */
+template <class IT>
+FullyDistVec<IT, IT> Partition(SpParMat < IT, double, SpDCCols<IT, double> > & A, int nparts)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	IT n = A.getnrow();
+	FullyDistVec<IT, IT> part(grid, n, static_cast<IT>(0));
+
+	// (vertices, first part, number of parts) of the subgraphs still to be split
+	std::vector< std::tuple< FullyDistVec<IT, IT>, int, int > > jobs;
+	FullyDistVec<IT, IT> all(grid);
+	all.iota(n, 0);
+	jobs.push_back(std::make_tuple(all, 0, nparts));
+	while(!jobs.empty())
+	{
+		FullyDistVec<IT, IT> ind = std::get<0>(jobs.back());
+		int first = std::get<1>(jobs.back());
+		int k = std::get<2>(jobs.back());
+		jobs.pop_back();
+		if(k == 1 || ind.TotalLength() == 0)
+		{
+			FullyDistVec<IT, IT> firstvec(grid, ind.TotalLength(), static_cast<IT>(first));
+			part.Set(FullyDistSpVec<IT, IT>(n, ind, firstvec));
+			continue;
+		}
+		int k1 = k / 2;
+		SpParMat < IT, double, SpDCCols<IT, double> > S = A(ind, ind);
+		FullyDistVec<IT, double> vw(grid, ind.TotalLength(), 1.0);
+		FullyDistVec<IT, IT> half = Bisect(S, vw, static_cast<double>(k1) / k);
+		jobs.push_back(std::make_tuple(ind(half.FindInds([](IT p){return p == 0;})), first, k - k1));
+		jobs.push_back(std::make_tuple(ind(half.FindInds([](IT p){return p == 1;})), first + k - k1, k1));
+	}
+	return part;
+}
+
+
+/**
+ * Turns a bisection into a vertex separator: the minimum vertex cover of the bipartite graph
+ * of cut edges (Koenig's theorem), computed from a maximum matching and the set Z of columns
+ * reachable from unmatched columns by alternating paths: cover = (columns not in Z) + (mates of Z)
+ * Separator vertices get part 2.
+ */
+template <class IT>
+void VertexSeparator(SpParMat < IT, double, SpDCCols<IT, double> > & A, FullyDistVec<IT, IT> & part)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	IT n = A.getnrow();
+	IT nloc = part.LocArrSize();
+	FullyDistVec<IT, double> x(grid, n, 0.0);
+	for(IT i = 0; i < nloc; ++i)
+		if(part.GetLocArr()[i] == 1) x.SetLocalElement(i, 1.0);
+	FullyDistVec<IT, double> y1 = SpMV<PlusTimesSRing<double, double> >(A, x);
+	FullyDistVec<IT, double> deg(grid);
+	A.Reduce(deg, Row, std::plus<double>(), 0.0);
+
+	// boundary vertices: part 0 vertices with neighbors in part 1 and vice versa
+	FullyDistVec<IT, IT> side(part);
+	for(IT i = 0; i < nloc; ++i)
+	{
+		IT p = part.GetLocArr()[i];
+		bool boundary = (p == 0) ? (y1.GetLocArr()[i] > 0) : (y1.GetLocArr()[i] < deg.GetLocArr()[i]);
+		side.SetLocalElement(i, boundary ? p : static_cast<IT>(-1));
+	}
+	FullyDistVec<IT, IT> rows = side.FindInds([](IT p){return p == 0;});
+	FullyDistVec<IT, IT> cols = side.FindInds([](IT p){return p == 1;});
+	if(rows.TotalLength() == 0 || cols.TotalLength() == 0) return;
+
+	SpParMat < IT, double, SpDCCols<IT, double> > B = A(rows, cols);
+	FullyDistVec<IT, IT> mateRow2Col(grid, B.getnrow(), static_cast<IT>(-1));
+	FullyDistVec<IT, IT> mateCol2Row(grid, B.getncol(), static_cast<IT>(-1));
+	maximumMatching(B, mateRow2Col, mateCol2Row);
+	FullyDistSpVec<IT, IT> reach = AlternatingReach(B, mateRow2Col, mateCol2Row);
+
+	FullyDistSpVec<IT, IT> z(reach);
+	z.Apply([](IT mate){return static_cast<IT>(1);});
+	FullyDistVec<IT, IT> inZ(grid, B.getncol(), static_cast<IT>(0));
+	inZ.Set(z);
+	FullyDistVec<IT, IT> coverCols = inZ.FindInds([](IT zc){return zc == 0;});
+	std::vector<IT> zmates = reach.GetLocalNum();
+	zmates.erase(std::remove(zmates.begin(), zmates.end(), static_cast<IT>(-1)), zmates.end());
+	FullyDistVec<IT, IT> coverRows(zmates, grid);
+
+	FullyDistVec<IT, IT> sep = cols(coverCols);
+	FullyDistVec<IT, IT> seprows = rows(coverRows);
+	FullyDistVec<IT, IT> two(grid, sep.TotalLength(), static_cast<IT>(2));
+	part.Set(FullyDistSpVec<IT, IT>(n, sep, two));
+	two = FullyDistVec<IT, IT>(grid, seprows.TotalLength(), static_cast<IT>(2));
+	part.Set(FullyDistSpVec<IT, IT>(n, seprows, two));
+}
+
+
+/**
+ * Serial nested dissection (George) of the graph induced by vertices: the middle level of a BFS
+ * level structure rooted at a pseudo-peripheral vertex separates each connected piece.
+ * Appends the vertices to order in elimination order.
+ */
+template <class IT>
+void SerialNestedDissection(const std::vector<IT> & rowptr, const std::vector<IT> & colids, std::vector<IT> vertices, std::vector<IT> & mark, std::vector<IT> & level, std::vector<IT> & order)
+{
+	if(static_cast<IT>(vertices.size()) <= NDLEAFSIZE)
+	{
+		order.insert(order.end(), vertices.begin(), vertices.end());
+		return;
+	}
+	// mark[v] == 1 for the vertices of this piece
+	for(size_t i = 0; i < vertices.size(); ++i) mark[vertices[i]] = 1;
+	auto BFS = [&](IT root, std::vector<IT> & visited)
+	{
+		visited.assign(1, root);
+		level[root] = 0;
+		mark[root] = 2;
+		for(size_t h = 0; h < visited.size(); ++h)
+		{
+			IT v = visited[h];
+			for(IT k = rowptr[v]; k < rowptr[v+1]; ++k)
+			{
+				IT u = colids[k];
+				if(mark[u] == 1)
+				{
+					mark[u] = 2;
+					level[u] = level[v] + 1;
+					visited.push_back(u);
+				}
+			}
+		}
+		for(size_t h = 0; h < visited.size(); ++h) mark[visited[h]] = 1;
+	};
+
+	std::vector< std::vector<IT> > pieces;
+	std::vector<IT> separators;
+	std::vector<IT> comp, comp2;
+	for(size_t i = 0; i < vertices.size(); ++i)
+	{
+		IT s = vertices[i];
+		if(mark[s] != 1) continue;
+		BFS(s, comp);
+		BFS(comp.back(), comp2);	// from the farthest vertex: a pseudo-peripheral root
+		for(size_t h = 0; h < comp2.size(); ++h) mark[comp2[h]] = 3;	// done with this component
+		IT depth = level[comp2.back()];
+		if(static_cast<IT>(comp2.size()) <= NDLEAFSIZE || depth < 2)
+		{
+			pieces.push_back(comp2);
+			continue;
+		}
+		// the level where half of the vertices have been reached
+		IT mid = level[comp2[comp2.size() / 2]];
+		mid = std::max(static_cast<IT>(1), std::min(mid, depth - 1));
+		std::vector<IT> below, above;
+		for(size_t h = 0; h < comp2.size(); ++h)
+		{
+			IT v = comp2[h];
+			if(level[v] < mid) below.push_back(v);
+			else if(level[v] > mid) above.push_back(v);
+			else
+			{
+				// separator vertices without neighbors beyond mid can join the lower part
+				bool needed = false;
+				for(IT k = rowptr[v]; k < rowptr[v+1] && !needed; ++k)
+					needed = (mark[colids[k]] == 3 && level[colids[k]] > mid);
+				if(needed) separators.push_back(v);
+				else below.push_back(v);
+			}
+		}
+		pieces.push_back(below);
+		pieces.push_back(above);
+	}
+	for(size_t i = 0; i < vertices.size(); ++i) mark[vertices[i]] = 0;
+	for(size_t i = 0; i < pieces.size(); ++i)
+	{
+		if(pieces[i].size() == vertices.size())	// no progress: a small or clique-like component
+			order.insert(order.end(), pieces[i].begin(), pieces[i].end());
+		else
+			SerialNestedDissection(rowptr, colids, pieces[i], mark, level, order);
+	}
+	order.insert(order.end(), separators.begin(), separators.end());
+}
+
+
+/**
+ * Orders the leaf subgraphs (dom[v] = leaf id, -1 for vertices that are already ordered):
+ * leaf d is gathered on process d % nprocs, dissected serially, and its vertices get the
+ * positions leafstart[d], leafstart[d]+1, ...
+ */
+template <class IT>
+void OrderLeaves(SpParMat < IT, double, SpDCCols<IT, double> > & A, const FullyDistVec<IT, IT> & dom, const std::vector<IT> & leafstart, FullyDistVec<IT, IT> & order)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	MPI_Comm World = grid->GetWorld();
+	int nprocs = grid->GetSize();
+	int myrank = grid->GetRank();
+
+	// keep the edges inside leaves, labelled with leaf id + 1
+	FullyDistVec<IT, double> d1(dom);
+	d1.Apply([](double d){return d + 1;});
+	SpParMat < IT, double, SpDCCols<IT, double> > R = A;
+	R.DimApply(Row, d1, [](double w, double d){return d;});
+	SpParMat < IT, double, SpDCCols<IT, double> > C = A;
+	C.DimApply(Column, d1, [](double w, double d){return d;});
+	SpParMat < IT, double, SpDCCols<IT, double> > E = EWiseApply<double, SpDCCols<IT, double> >(R, C, [](double dr, double dc){return (dr == dc) ? dr : 0.0;}, false, 0.0);
+	E.Prune([](double d){return d == 0;});
+	FullyDistVec<IT, IT> ri(grid), ci(grid);
+	FullyDistVec<IT, double> di(grid);
+	E.Find(ri, ci, di);
+
+	std::vector< std::vector< std::tuple<IT,IT,IT> > > sendedges(nprocs);
+	for(IT k = 0; k < ri.LocArrSize(); ++k)
+	{
+		IT d = static_cast<IT>(di.GetLocArr()[k]) - 1;
+		sendedges[d % nprocs].push_back(std::make_tuple(d, ri.GetLocArr()[k], ci.GetLocArr()[k]));
+	}
+	IT offset = dom.LengthUntil();
+	for(IT k = 0; k < dom.LocArrSize(); ++k)
+	{
+		IT d = dom.GetLocArr()[k];
+		if(d != -1) sendedges[d % nprocs].push_back(std::make_tuple(d, offset + k, offset + k));	// vertex records are self loops
+	}
+	std::vector< std::tuple<IT,IT,IT> > recvedges = ExchangeData(sendedges, World);
+	std::sort(recvedges.begin(), recvedges.end());
+
+	std::vector< std::vector< std::tuple<IT,IT> > > sendpos(nprocs);
+	std::vector<IT> mark, level, order1;
+	for(size_t b = 0; b < recvedges.size(); )
+	{
+		IT d = std::get<0>(recvedges[b]);
+		size_t e = b;
+		while(e < recvedges.size() && std::get<0>(recvedges[e]) == d) ++e;
+		std::vector<IT> verts;
+		for(size_t k = b; k < e; ++k)
+			if(std::get<1>(recvedges[k]) == std::get<2>(recvedges[k])) verts.push_back(std::get<1>(recvedges[k]));
+		std::sort(verts.begin(), verts.end());
+		IT nv = static_cast<IT>(verts.size());
+		auto localid = [&verts](IT v){return static_cast<IT>(std::lower_bound(verts.begin(), verts.end(), v) - verts.begin());};
+		std::vector<IT> rowptr(nv+1, 0), colids;
+		for(size_t k = b; k < e; ++k)	// sorted by row, then column
+		{
+			if(std::get<1>(recvedges[k]) == std::get<2>(recvedges[k])) continue;
+			++rowptr[localid(std::get<1>(recvedges[k]))+1];
+			colids.push_back(localid(std::get<2>(recvedges[k])));
+		}
+		std::partial_sum(rowptr.begin(), rowptr.end(), rowptr.begin());
+
+		std::vector<IT> all(nv);
+		std::iota(all.begin(), all.end(), 0);
+		mark.assign(nv, 0);
+		level.assign(nv, 0);
+		order1.clear();
+		SerialNestedDissection(rowptr, colids, all, mark, level, order1);
+		for(IT k = 0; k < nv; ++k)
+		{
+			IT v = verts[order1[k]];
+			IT locind;
+			int owner = order.Owner(v, locind);
+			sendpos[owner].push_back(std::make_tuple(locind, leafstart[d] + k));
+		}
+		b = e;
+	}
+	std::vector< std::tuple<IT,IT> > recvpos = ExchangeData(sendpos, World);
+	for(size_t k = 0; k < recvpos.size(); ++k)
+		order.SetLocalElement(std::get<0>(recvpos[k]), std::get<1>(recvpos[k]));
+}
+
+
+/**
+ * Nested dissection ordering of a symmetric matrix without self loops
+ * Subgraphs with more than NDGATHERSIZE vertices are split by distributed multilevel bisection
+ * and a vertex separator, which is ordered last; smaller subgraphs are ordered by OrderLeaves.
+ * @return order[v] = position of vertex v in the elimination order
+ */
+template <class IT>
+FullyDistVec<IT, IT> NestedDissection(SpParMat < IT, double, SpDCCols<IT, double> > & A)
+{
+	std::shared_ptr<CommGrid> grid = A.getcommgrid();
+	IT n = A.getnrow();
+	FullyDistVec<IT, IT> order(grid, n, static_cast<IT>(-1));
+	FullyDistVec<IT, IT> dom(grid, n, static_cast<IT>(-1));
+	std::vector<IT> leafstart;
+
+	// (vertices, first position) of the subgraphs still to be ordered
+	std::vector< std::pair< FullyDistVec<IT, IT>, IT > > jobs;
+	FullyDistVec<IT, IT> all(grid);
+	all.iota(n, 0);
+	jobs.push_back(std::make_pair(all, static_cast<IT>(0)));
+	int nsplits = 0;
+	while(!jobs.empty())
+	{
+		FullyDistVec<IT, IT> ind = jobs.back().first;
+		IT start = jobs.back().second;
+		jobs.pop_back();
+		IT m = ind.TotalLength();
+		if(m == 0) continue;
+
+		bool leaf = (m <= NDGATHERSIZE);
+		FullyDistVec<IT, IT> part(grid);
+		if(!leaf)
+		{
+			SpParMat < IT, double, SpDCCols<IT, double> > S = A(ind, ind);
+			FullyDistVec<IT, double> vw(grid, m, 1.0);
+			part = Bisect(S, vw);
+			VertexSeparator(S, part);
+			IT n0 = part.Count([](IT p){return p == 0;});
+			IT n1 = part.Count([](IT p){return p == 1;});
+			leaf = (n0 == 0 || n1 == 0);	// nothing to gain from a split (e.g. a clique)
+		}
+		if(leaf)
+		{
+			FullyDistVec<IT, IT> leafid(grid, m, static_cast<IT>(leafstart.size()));
+			dom.Set(FullyDistSpVec<IT, IT>(n, ind, leafid));
+			leafstart.push_back(start);
+			continue;
+		}
+		++nsplits;
+		FullyDistVec<IT, IT> i0 = part.FindInds([](IT p){return p == 0;});
+		FullyDistVec<IT, IT> i1 = part.FindInds([](IT p){return p == 1;});
+		FullyDistVec<IT, IT> is = part.FindInds([](IT p){return p == 2;});
+		IT n0 = i0.TotalLength();
+		IT n1 = i1.TotalLength();
+		FullyDistVec<IT, IT> seppos(grid);
+		seppos.iota(is.TotalLength(), start + n0 + n1);
+		order.Set(FullyDistSpVec<IT, IT>(n, ind(is), seppos));
+		jobs.push_back(std::make_pair(ind(i1), start + n0));
+		jobs.push_back(std::make_pair(ind(i0), start));
+	}
+	OrderLeaves(A, dom, leafstart, order);
+#ifdef ND_DEBUG
+	std::ostringstream outs;
+	outs << "Nested dissection: " << nsplits << " distributed separators, " << leafstart.size() << " leaf subgraphs" << std::endl;
+	SpParHelper::Print(outs.str());
+#endif
+	return order;
+}
+
+} /* namespace combblas */
+
+#endif
@@ -14,10 +14,15 @@
 #include <vector>
 #include <string>
 #include <sstream>
+#include <fstream>
 
 
 #define EDGEFACTOR 16
 
+#ifndef RCMGATHERLEVEL
+#define RCMGATHERLEVEL 8192	// BFS levels with at most this many vertices are sorted redundantly on every process
+#endif
+
 #ifdef DETERMINISTIC
 MTRand GlobalMT(1);
 #else
@@ -48,10 +53,7 @@ void Symmetricize(PARMAT & A)
 {
     // boolean addition is practically a "logical or"
     // therefore this doesn't destruct any links
-    PARMAT AT = A;
-    AT.Transpose();
-    AT.RemoveLoops(); // not needed for boolean matrices, but no harm in keeping it
-    A += AT;
+    A.Symmetrize();
 }
 
 
@@ -124,8 +126,106 @@ typedef SpParMat < int64_t, bool, SpCCols<int64_t,bool> > Par_CSC_Bool;
 
 
 
-FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &fringeRow, int64_t startLabel, int64_t endLabel)
+/**
+ * Sorts the vertices of a level by (parent order, degree, vertex index)
+ * @pre tosort is sorted by vertex index, so a stable sort by (parent order, degree) suffices
+ * Long levels use the threaded radix sort
+ */
+void SortLevel(vector< tuple<int64_t,int64_t,int64_t> > & tosort, int64_t nparents, int64_t maxdegree)
+{
+    int64_t n = tosort.size();
+    uint64_t radix = static_cast<uint64_t>(maxdegree) + 1;
+    if(n < RADIXSORTTHRESHOLD || static_cast<uint64_t>(nparents) > numeric_limits<uint64_t>::max() / radix)
+    {
+        stable_sort(tosort.begin(), tosort.end(), [](const tuple<int64_t,int64_t,int64_t> & a, const tuple<int64_t,int64_t,int64_t> & b)
+                    { return get<0>(a) < get<0>(b) || (get<0>(a) == get<0>(b) && get<1>(a) < get<1>(b)); });
+        return;
+    }
+    vector<uint64_t> keys(n);
+    vector<int64_t> perm(n);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int64_t i=0; i<n; ++i)
+    {
+        keys[i] = static_cast<uint64_t>(get<0>(tosort[i])) * radix + static_cast<uint64_t>(get<1>(tosort[i]));
+        perm[i] = i;
+    }
+    intSort::parallelKeySort(keys.data(), perm.data(), n, static_cast<uint64_t>(nparents) * radix - 1);
+    vector< tuple<int64_t,int64_t,int64_t> > sorted(n);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+    for(int64_t i=0; i<n; ++i)
+        sorted[i] = tosort[perm[i]];
+    tosort.swap(sorted);
+}
+
+
+int64_t replicatedLevels = 0, distributedLevels = 0;
+
+/**
+ * Labels the vertices of a short level: every process gathers the whole level, sorts it and
+ * keeps the labels of its own vertices, which costs one Allgatherv instead of two rounds of all-to-all
+ */
+FullyDistSpVec<int64_t, int64_t> getOrderReplicated(FullyDistSpVec<int64_t, VertexType> &fringeRow, int64_t startLabel, int64_t endLabel, int64_t maxdegree)
+{
+    int myrank, nprocs;
+    MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+    MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+
+    vector<int64_t> lind = fringeRow.GetLocalInd ();
+    vector<VertexType> lnum = fringeRow.GetLocalNum ();
+    int64_t offset = fringeRow.LengthUntil();
+    int ploclen = lind.size();
+    vector<int64_t> sendbuf(3*ploclen);
+    for(int k=0; k < ploclen; ++k)
+    {
+        sendbuf[3*k] = lnum[k].order-startLabel;
+        sendbuf[3*k+1] = lnum[k].degree;
+        sendbuf[3*k+2] = lind[k] + offset;
+    }
+    vector<int> recvcnt(nprocs), rdispls(nprocs+1, 0);
+    int sendcnt = 3*ploclen;
+    MPI_Allgather(&sendcnt, 1, MPI_INT, recvcnt.data(), 1, MPI_INT, MPI_COMM_WORLD);
+    partial_sum(recvcnt.begin(), recvcnt.end(), rdispls.begin()+1);
+    vector<int64_t> recvbuf(rdispls[nprocs]);
+    MPI_Allgatherv(sendbuf.data(), sendcnt, MPIType<int64_t>(), recvbuf.data(), recvcnt.data(), rdispls.data(), MPIType<int64_t>(), MPI_COMM_WORLD);
+
+    // pieces arrive in rank order, hence sorted by vertex index
+    int64_t nlevel = rdispls[nprocs] / 3;
+    vector< tuple<int64_t,int64_t,int64_t> > tosort(nlevel);
+    for(int64_t k=0; k < nlevel; ++k)
+        tosort[k] = make_tuple(recvbuf[3*k], recvbuf[3*k+1], recvbuf[3*k+2]);
+    SortLevel(tosort, endLabel - startLabel + 1, maxdegree);
+
+    vector<int64_t> inds, labels;
+    for(int64_t k=0; k < nlevel; ++k)
+    {
+        int64_t locind;
+        if(fringeRow.Owner(get<2>(tosort[k]), locind) == myrank)
+        {
+            inds.push_back(locind);
+            labels.push_back(endLabel + 1 + k);
+        }
+    }
+    return FullyDistSpVec<int64_t, int64_t>(fringeRow.getcommgrid(), fringeRow.TotalLength(), inds, labels, false, false);
+}
+
+
+/**
+ * Labels the vertices of the next level: vertices are sorted by (parent order, degree, index)
+ * and numbered consecutively from endLabel+1. Short levels are sorted redundantly on every process;
+ * long levels are bucketed by parent order across processes and sorted locally.
+ */
+FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &fringeRow, int64_t startLabel, int64_t endLabel, int64_t maxdegree)
 {
+    if(fringeRow.getnnz() <= RCMGATHERLEVEL)
+    {
+        ++replicatedLevels;
+        return getOrderReplicated(fringeRow, startLabel, endLabel, maxdegree);
+    }
+    ++distributedLevels;
 
     int myrank, nprocs;
     MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
@@ -145,29 +245,20 @@ FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &f
     int * sendcnt = new int[nprocs](); // initialize to 0
     int * sdispls = new int[nprocs+1];
 
-    MPI_Barrier(MPI_COMM_WORLD);
-  
+    vector<int> owners(ploclen);
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
     for(int64_t k=0; k < ploclen; ++k)
     {
         int64_t temp = lnum[k].order-startLabel;
-        int owner;
         if(perproc==0 || temp/perproc > nprocs-1)
-            owner = nprocs-1;
+            owners[k] = nprocs-1;
         else
-            owner = temp/perproc;
-        
-#ifdef _OPENMP
-        __sync_fetch_and_add(&sendcnt[owner], 1);
-#else
-        sendcnt[owner]++;
-#endif
+            owners[k] = temp/perproc;
     }
-    
-    MPI_Barrier(MPI_COMM_WORLD);
-
+    for(int64_t k=0; k < ploclen; ++k)
+        sendcnt[owners[k]]++;
     
     MPI_Alltoall(sendcnt, 1, MPI_INT, recvcnt, 1, MPI_INT, MPI_COMM_WORLD);  // share the request counts
     
@@ -184,29 +275,14 @@ FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &f
     int64_t * datbuf2 = new int64_t[ploclen];
     int64_t * indbuf = new int64_t[ploclen];
     int *count = new int[nprocs](); //current position
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
+    // sequential packing keeps every bucket sorted by vertex index
     for(int64_t i=0; i < ploclen; ++i)
     {
-        
-        int64_t temp = lnum[i].order-startLabel;
-        int owner;
-        if(perproc==0 || temp/perproc > nprocs-1)
-            owner = nprocs-1;
-        else
-            owner = temp/perproc;
-        
-        
-        int id;
-#ifdef _OPENMP
-        id = sdispls[owner] + __sync_fetch_and_add(&count[owner], 1);
-#else
-        id = sdispls[owner] + count[owner];
+        int owner = owners[i];
+        int id = sdispls[owner] + count[owner];
         count[owner]++;
-#endif
         
-        datbuf1[id] = temp;
+        datbuf1[id] = lnum[i].order-startLabel;
         datbuf2[id] = lnum[i].degree;
         indbuf[id] = lind[i] + fringeRow.LengthUntil();
     }
@@ -224,22 +300,15 @@ FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &f
     MPI_Alltoallv(indbuf, sendcnt, sdispls, MPIType<int64_t>(), recvindbuf, recvcnt, rdispls, MPIType<int64_t>(), MPI_COMM_WORLD);
     delete [] indbuf;
     
-   tuple<int64_t,int64_t, int64_t>* tosort = static_cast<tuple<int64_t,int64_t, int64_t>*> (::operator new (sizeof(tuple<int64_t,int64_t, int64_t>)*totrecv));
-    
+    vector< tuple<int64_t,int64_t,int64_t> > tosort(totrecv);
 #ifdef _OPENMP
 #pragma omp parallel for
 #endif
-    for(int i=0; i<totrecv; ++i)
+    for(int64_t i=0; i<totrecv; ++i)
     {
         tosort[i] = make_tuple(recvdatbuf1[i], recvdatbuf2[i], recvindbuf[i]);
     }
-    
-    
-#if defined(GNU_PARALLEL) && defined(_OPENMP)
-    __gnu_parallel::sort(tosort, tosort+totrecv);
-#else
-    std::sort(tosort, tosort+totrecv);
-#endif
+    SortLevel(tosort, nparents, maxdegree);
     
     // send order back
     int * sendcnt1 = new int[nprocs]();
@@ -321,7 +390,6 @@ FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &f
     FullyDistSpVec<int64_t, int64_t> order(fringeRow.getcommgrid(), fringeRow.TotalLength(), recvindbuf3, recvdatbuf3);
     DeleteAll(recvindbuf, recvdatbuf1, recvdatbuf2);
     DeleteAll(sdispls, rdispls, sendcnt, sendcnt1, recvcnt);
-    ::operator delete(tosort);
     
     return order;
 }
@@ -329,7 +397,7 @@ FullyDistSpVec<int64_t, int64_t> getOrder(FullyDistSpVec<int64_t, VertexType> &f
 double torderSpMV=0, torderSort=0, torderOther=0;
 // perform ordering from a pseudo peripheral vertex
 template <typename PARMAT>
-void RCMOrder(PARMAT & A, int64_t source, FullyDistVec<int64_t, int64_t>& order, int64_t startOrder, FullyDistVec<int64_t, int64_t> degrees, PreAllocatedSPA<int64_t>& SPA)
+void RCMOrder(PARMAT & A, int64_t source, FullyDistVec<int64_t, int64_t>& order, int64_t startOrder, FullyDistVec<int64_t, int64_t> degrees, int64_t maxdegree, PreAllocatedSPA<int64_t>& SPA)
 {
     int myrank;
     MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
@@ -368,7 +436,7 @@ void RCMOrder(PARMAT & A, int64_t source, FullyDistVec<int64_t, int64_t>& order,
                                                                                false, (int64_t) -1);
         
         tsort1 = MPI_Wtime();
-        FullyDistSpVec<int64_t, int64_t> levelOrder = getOrder(fringeRow, startLabel, endLabel);
+        FullyDistSpVec<int64_t, int64_t> levelOrder = getOrder(fringeRow, startLabel, endLabel, maxdegree);
         tsort += MPI_Wtime()-tsort1;
         order.Set(levelOrder);
         startLabel = endLabel + 1;
@@ -379,7 +447,8 @@ void RCMOrder(PARMAT & A, int64_t source, FullyDistVec<int64_t, int64_t>& order,
     tOther = tOrder - tSpMV - tsort;
     if(myrank == 0)
     {
-        cout << "    Total time: " <<  tOrder << " seconds [SpMV: " << tSpMV << ", sorting: " << tsort << ", other: " << tOther << "]" << endl << endl;
+        cout << "    Total time: " <<  tOrder << " seconds [SpMV: " << tSpMV << ", sorting: " << tsort << ", other: " << tOther << "]" << endl;
+        cout << "    Levels sorted redundantly: " << replicatedLevels << ", in parallel: " << distributedLevels << endl << endl;
     }
     
     torderSpMV+=tSpMV; torderSort+=tsort; torderOther+=tOther;
@@ -455,13 +524,6 @@ int64_t PseudoPeripheralVertex(PARMAT & A, FullyDistSpVec<int64_t, pair<int64_t,
         
     }
     
-    // remove vertices in the current connected component
-    //unvisitedVertices = EWiseMult(unvisitedVertices, level, true, (int64_t) -1);
-    unvisitedVertices = EWiseApply<pair<int64_t, int64_t>>(unvisitedVertices, level,
-                                                           [](pair<int64_t, int64_t> vtx, int64_t visited){return vtx;},
-                                                           [](pair<int64_t, int64_t> vtx, int64_t visited){return visited==-1;},
-                                                           false, make_pair((int64_t)-1, (int64_t)0));
-    
     tOther = MPI_Wtime() - tstart - tSpMV;
     tpvSpMV += tSpMV;
     tpvOther += tOther;
@@ -476,8 +538,12 @@ int64_t PseudoPeripheralVertex(PARMAT & A, FullyDistSpVec<int64_t, pair<int64_t,
   
 }
 
+/**
+ * @param[in,out] ppvCache: starting vertices of the connected components from an earlier run on the same
+ * graph, used instead of searching for pseudo-peripheral vertices; the vertices found here are appended
+ */
 template <typename PARMAT>
-FullyDistVec<int64_t, int64_t> RCM(PARMAT & A, FullyDistVec<int64_t, int64_t> degrees, PreAllocatedSPA<int64_t>& SPA)
+FullyDistVec<int64_t, int64_t> RCM(PARMAT & A, FullyDistVec<int64_t, int64_t> degrees, PreAllocatedSPA<int64_t>& SPA, vector<int64_t> & ppvCache)
 {
     
 #ifdef TIMING
@@ -504,19 +570,37 @@ FullyDistVec<int64_t, int64_t> RCM(PARMAT & A, FullyDistVec<int64_t, int64_t> de
     // The RCM order will be stored here
     FullyDistVec<int64_t, int64_t> rcmorder ( A.getcommgrid(),  A.getnrow(), (int64_t) -1);
     
+    int64_t maxdegree = degrees.Reduce(maximum<int64_t>(), (int64_t) 0);
     int cc = 1; // current connected component
+    size_t nextCached = 0, ncached = ppvCache.size();
     int64_t numUnvisited = unvisitedVertices.getnnz();
     while(numUnvisited>0) // for each connected component
     {
         
         if(myrank==0) cout << "Connected component: " << cc++ << endl;
-        // Get a pseudo-peripheral vertex to start the RCM algorithm
-        int64_t source = PseudoPeripheralVertex(A, unvisitedVertices, degrees,SPA);
+        // Start from a cached vertex of an unvisited component, or search for a pseudo-peripheral vertex
+        int64_t source = -1;
+        while(source == -1 && nextCached < ncached)
+        {
+            int64_t v = ppvCache[nextCached++];
+            if(v >= 0 && v < A.getnrow() && rcmorder.GetElement(v) == -1) source = v;
+        }
+        if(source == -1)
+        {
+            source = PseudoPeripheralVertex(A, unvisitedVertices, degrees,SPA);
+            ppvCache.push_back(source);
+        }
+        else if(myrank == 0) cout << "    vertex " << source << " is taken from the pseudo-peripheral vertex cache" << endl;
         
         // Get the RCM ordering in this connected component
         int64_t curOrder =  A.getnrow() - numUnvisited;
-        RCMOrder(A, source, rcmorder, curOrder, degrees, SPA);
+        RCMOrder(A, source, rcmorder, curOrder, degrees, maxdegree, SPA);
         
+        // remove vertices in the current connected component
+        unvisitedVertices = EWiseApply<pair<int64_t, int64_t>>(unvisitedVertices, rcmorder,
+                                                               [](pair<int64_t, int64_t> vtx, int64_t ord){return vtx;},
+                                                               [](pair<int64_t, int64_t> vtx, int64_t ord){return ord==-1;},
+                                                               false, make_pair((int64_t)-1, (int64_t)0));
         numUnvisited = unvisitedVertices.getnnz();
     }
     
@@ -626,13 +710,15 @@ int main(int argc, char* argv[])
         if(myrank == 0)
         {
             
-            cout << "Usage: ./rcm <rmat|er|input> <scale|filename> " << "-permute" << " -savercm" << endl;
+            cout << "Usage: ./rcm <rmat|er|input> <scale|filename> " << "-permute" << " -savercm" << " -ppvcache <file>" << endl;
             cout << "Example with a user supplied matrix:" << endl;
             cout << "    mpirun -np 4 ./rcm input a.mtx" << endl;
             cout << "Example with a user supplied matrix (pre-permute the input matrix for load balance):" << endl;
             cout << "    mpirun -np 4 ./rcm input a.mtx  -permute " << endl;
             cout << "Example with a user supplied matrix (pre-permute the input matrix for load balance) & save rcm order to input_file_name.rcm.txt file:" << endl;
             cout << "    mpirun -np 4 ./rcm input a.mtx -permute -savercm" << endl;
+            cout << "Example that reuses the pseudo-peripheral vertices of an earlier run (the file is created if it does not exist):" << endl;
+            cout << "    mpirun -np 4 ./rcm input a.mtx -ppvcache a.ppv" << endl;
             cout << "Example with RMAT matrix: mpirun -np 4 ./rcm rmat 20" << endl;
             cout << "Example with an Erdos-Renyi matrix: mpirun -np 4 ./rcm er 20" << endl;
             
@@ -645,12 +731,15 @@ int main(int argc, char* argv[])
         string filename="";
         bool randpermute = false;
         bool savercm = false;
+        string ppvfile = "";
         for (int i = 1; i < argc; i++)
         {
             if (strcmp(argv[i],"-permute")==0)
                 randpermute = true;
             if (strcmp(argv[i],"-savercm")==0)
                 savercm = true;
+            if (strcmp(argv[i],"-ppvcache")==0 && i+1 < argc)
+                ppvfile = argv[++i];
         }
         
         
@@ -760,8 +849,48 @@ int main(int argc, char* argv[])
         
         // create Pre allocated SPA for SpMSpV
         PreAllocatedSPA<int64_t> SPA(ABoolCSC->seq(), nthreads*4);
+        // pseudo-peripheral vertices found by an earlier run
+        // the file holds original vertex ids, as the random permutation differs from run to run
+        bool permuted = (randpermute==true && randp.TotalLength() >0);
+        vector<int64_t> ppvCache, ppvOriginal;
+        if(ppvfile != "")
+        {
+            int64_t ncached = 0, nrow = ABool->getnrow();
+            if(myrank == 0)
+            {
+                ifstream ppvin(ppvfile.c_str());
+                int64_t v;
+                while(ppvin >> v)
+                    if(v >= 0 && v < nrow) ppvOriginal.push_back(v);
+                ncached = ppvOriginal.size();
+            }
+            MPI_Bcast(&ncached, 1, MPIType<int64_t>(), 0, MPI_COMM_WORLD);
+            ppvOriginal.resize(ncached);
+            MPI_Bcast(ppvOriginal.data(), ncached, MPIType<int64_t>(), 0, MPI_COMM_WORLD);
+            if(permuted)
+            {
+                FullyDistVec<int64_t, int64_t> newids = randp;
+                newids = newids.sort();     // newids[original] = permuted id
+                ppvCache = newids.GetElements(ppvOriginal);
+            }
+            else ppvCache = ppvOriginal;
+        }
+        size_t ncachedBefore = ppvCache.size();
+        
         // Compute the RCM ordering
-        FullyDistVec<int64_t, int64_t> rcmorder = RCM(*ABoolCSC, degrees, SPA);
+        FullyDistVec<int64_t, int64_t> rcmorder = RCM(*ABoolCSC, degrees, SPA, ppvCache);
+        
+        if(ppvfile != "" && ppvCache.size() > ncachedBefore)
+        {
+            vector<int64_t> found(ppvCache.begin() + ncachedBefore, ppvCache.end());
+            if(permuted) found = randp.GetElements(found);  // randp[permuted id] = original
+            ppvOriginal.insert(ppvOriginal.end(), found.begin(), found.end());
+            if(myrank == 0)
+            {
+                ofstream ppvout(ppvfile.c_str());
+                for(size_t i = 0; i < ppvOriginal.size(); ++i) ppvout << ppvOriginal[i] << "\n";
+            }
+        }
 
         
         FullyDistVec<int64_t, int64_t> reverseOrder = rcmorder;
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <functional>
 #include <algorithm>
+#include <numeric>
 #include <vector>
 #include <string>
 #include <sstream>
@@ -252,6 +253,9 @@ int main(int argc, char* argv[])
 		MPI_Bcast(&(loccandints[0]), ITERS, MPIType<int64_t>(),0,MPI_COMM_WORLD);
 		for(int i=0; i<ITERS; ++i)
 			Cands.SetElement(i,loccandints[i]);
+		vector<int64_t> candinds(ITERS);
+		iota(candinds.begin(), candinds.end(), 0);
+		vector<int64_t> sources = Cands.GetElements(candinds);	// one collective instead of a broadcast per Cands[i]
 
         double MTEPS[ITERS]; double INVMTEPS[ITERS]; double TIMES[ITERS]; double EDGES[ITERS];
         for(int i=0; i<ITERS; ++i)
@@ -265,7 +269,7 @@ int main(int argc, char* argv[])
             MPI_Barrier(MPI_COMM_WORLD);
             double t1 = MPI_Wtime();
 
-            fringe.SetElement(Cands[i], Cands[i]);
+            fringe.SetElement(sources[i], sources[i]);
             int iterations = 0;
             
             MPI_Op randreducempiop;
@@ -293,7 +297,7 @@ int main(int argc, char* argv[])
             int64_t nedges = EWiseMult(parentsp, degrees, false, (int64_t) 0).Reduce(plus<int64_t>(), (int64_t) 0);
 	
             ostringstream outnew;
-            outnew << i << "th starting vertex was " << Cands[i] << endl;
+            outnew << i << "th starting vertex was " << sources[i] << endl;
             outnew << "Number iterations: " << iterations << endl;
             outnew << "Number of vertices found: " << parentsp.Reduce(plus<int64_t>(), (int64_t) 0) << endl;
             outnew << "Number of edges traversed: " << nedges << endl;
@@ -0,0 +1,107 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+#include "../Applications/BipartiteMatchings/ApproxWeightPerfectMatching.h"
+
+using namespace std;
+using namespace combblas;
+
+// checks the CSC-style column pointers of AWPM against per-column counts of the tuples
+int CheckColumnPointers(SpDCCols<int64_t,double> & A, const SpTuples<int64_t,double> & tuples)
+{
+	int errors = 0;
+	vector<int64_t> colptr = ColumnPointers(&A);
+	if(colptr.size() != static_cast<size_t>(A.getncol() + 1)) return 1;
+	vector<int64_t> expected(A.getncol() + 1, 0);
+	for(int64_t i=0; i < tuples.getnnz(); ++i)
+		++expected[tuples.colindex(i) + 1];
+	partial_sum(expected.begin(), expected.end(), expected.begin());
+	for(size_t j=0; j < colptr.size(); ++j)
+		if(colptr[j] != expected[j]) ++errors;
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./ColumnPointersTest <Scale>" << endl;
+			cout << "Checks the column pointers of AWPM on empty and random local matrices with 2^Scale columns" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		int64_t ndim = static_cast<int64_t>(1) << atoi(argv[1]);
+
+		// an empty local matrix has no dcsc, all of its column pointers are zero
+		SpTuples<int64_t,double> none(0, ndim / 2, ndim);
+		SpDCCols<int64_t,double> E(0, ndim / 2, ndim, 0);
+		errors += CheckColumnPointers(E, none);
+
+		// random matrix with empty columns at both ends and in between
+		int64_t nnz = ndim / 4;
+		SpTuples<int64_t,double> tuples(nnz, ndim / 2, ndim);
+		for(int64_t i=0; i < nnz; ++i)
+		{
+			uint64_t h = (static_cast<uint64_t>(myrank) << 40 | i) * 0x9E3779B97F4A7C15ULL;
+			tuples.rowindex(i) = static_cast<int64_t>((h >> 13) % (ndim / 2));
+			tuples.colindex(i) = static_cast<int64_t>(1 + (h >> 37) % (ndim - 2));
+			tuples.numvalue(i) = 1.0;
+		}
+		tuples.SortColBased();
+		tuples.RemoveDuplicates(plus<double>());
+		SpDCCols<int64_t,double> A(tuples, false);
+		errors += CheckColumnPointers(A, tuples);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Column pointers are correct" << endl;
+		else cout << "ERROR: " << errors << " wrong column pointers" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,155 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include <cmath>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef SpParMat<int64_t, double, SpDCCols<int64_t,double> > PARDBMAT;
+
+// The unfused MCL steps: normalize, chaos, inflate, normalize
+void MakeColStochastic(PARDBMAT & A)
+{
+	FullyDistVec<int64_t, double> colsums = A.Reduce(Column, plus<double>(), 0.0);
+	colsums.Apply(safemultinv<double>());
+	A.DimApply(Column, colsums, multiplies<double>());
+}
+
+double Chaos(PARDBMAT & A)
+{
+	FullyDistVec<int64_t, double> colssqs = A.Reduce(Column, plus<double>(), 0.0, [](double v){ return v * v; });
+	FullyDistVec<int64_t, double> colmaxs = A.Reduce(Column, maximum<double>(), 0.0);
+	colmaxs -= colssqs;
+	FullyDistVec<int64_t, double> nnzPerColumn = A.Reduce(Column, plus<double>(), 0.0, [](double v){ return 1.0; });
+	colmaxs.EWiseApply(nnzPerColumn, multiplies<double>());
+	return colmaxs.Reduce(maximum<double>(), 0.0);
+}
+
+/**
+ * Runs one round of MCL bookkeeping both ways
+ * @return the number of differing results
+ */
+int CompareColumnOps(const PARDBMAT & A, double power)
+{
+	int errors = 0;
+	PARDBMAT R = A;
+	MakeColStochastic(R);
+	double chaos = Chaos(R);
+	R.Apply([power](double v){ return pow(v, power); });
+	MakeColStochastic(R);
+
+	// fused: one pass with one allreduce for the statistics and the inflation, one pass for the scaling
+	PARDBMAT F = A;
+	vector< ColumnStats<double> > stats = F.ColumnStatsApply([power](double v){ return pow(v, power); });
+	double fchaos = 0;
+	vector<double> scale(stats.size());
+	for(size_t j=0; j < stats.size(); ++j)
+	{
+		if(stats[j].nnz > 0 && stats[j].sum > 0)
+			fchaos = max(fchaos, (stats[j].max / stats[j].sum - stats[j].sumsq / (stats[j].sum * stats[j].sum)) * stats[j].nnz);
+		scale[j] = safemultinv<double>()(stats[j].appliedsum);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &fchaos, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+	F.ColumnApply(scale, multiplies<double>());
+
+	if(fabs(chaos - fchaos) > 1e-9 * max(1.0, fabs(chaos))) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	if(F.getnnz() != R.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	FullyDistVec<int64_t, int64_t> ri(A.getcommgrid()), ci(A.getcommgrid()), fri(A.getcommgrid()), fci(A.getcommgrid());
+	FullyDistVec<int64_t, double> rv(A.getcommgrid()), fv(A.getcommgrid());
+	R.Find(ri, ci, rv);
+	F.Find(fri, fci, fv);
+	rv.EWiseApply(fv, [](double r, double f){ return fabs(r - f); });
+	if(rv.Reduce(maximum<double>(), 0.0) > 1e-12) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// sums, maxima and counts also match the separate reductions
+	FullyDistVec<int64_t, double> colsums = A.Reduce(Column, plus<double>(), 0.0);
+	PARDBMAT S = A;
+	stats = S.ColumnStatsApply([](double v){ return v; });
+	vector<double> sums(stats.size());
+	for(size_t j=0; j < stats.size(); ++j)
+		sums[j] = stats[j].sum;
+	if(!(S == A)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	S.ColumnApply(sums, [](double v, double s){ return s; });	// every nonzero becomes its column sum
+	PARDBMAT T = A;
+	T.DimApply(Column, colsums, [](double v, double s){ return s; });
+	if(!(S == T)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./ColumnStatsTest <Scale>" << endl;
+			cout << "Compares fused and separate MCL column operations on a weighted R-MAT matrix of size 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 8, true, false);
+		PARDBMAT A(*DEL, false);
+		delete DEL;
+
+		FullyDistVec<int64_t, int64_t> ri(A.getcommgrid()), ci(A.getcommgrid());
+		FullyDistVec<int64_t, double> w(A.getcommgrid());
+		A.Find(ri, ci, w);
+		w.iota(ri.TotalLength(), 0);
+		w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 1000 + 1) / 1000.0; });
+		PARDBMAT W(A.getnrow(), A.getncol(), ri, ci, w, false);
+		errors += CompareColumnOps(W, 2.0);
+		errors += CompareColumnOps(W, 1.5);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Fused column operations are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between fused and separate column operations" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+// checks every column id of [0,ndim) against a binary search of jc
+int CheckIndex(const vector<int64_t> & jc, int64_t ndim, DcscColIndex<int64_t>::IndexKind expected)
+{
+	int errors = 0;
+	DcscColIndex<int64_t> colindex(jc.data(), jc.size(), ndim);
+	if(colindex.Kind() != expected) ++errors;
+	for(int64_t c=0; c < ndim; ++c)
+	{
+		bool found;
+		int64_t pos = colindex.Find(c, found);
+		auto itr = lower_bound(jc.begin(), jc.end(), c);
+		bool exists = (itr != jc.end() && *itr == c);
+		if(found != exists || (exists && pos != itr - jc.begin())) ++errors;
+	}
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./DcscColIndexTest <Scale>" << endl;
+			cout << "Checks the column lookup index of Dcsc blocks with 2^Scale columns at several densities" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		int64_t ndim = static_cast<int64_t>(1) << atoi(argv[1]);
+		// every column is nonempty with probability 1/stride
+		int64_t strides[3] = {2, 32, 4096};
+		DcscColIndex<int64_t>::IndexKind kinds[3] = {DcscColIndex<int64_t>::DENSE, DcscColIndex<int64_t>::BITMAP, DcscColIndex<int64_t>::HASH};
+		for(int k=0; k < 3; ++k)
+		{
+			vector<int64_t> jc;
+			for(int64_t c=0; c < ndim; ++c)
+			{
+				uint64_t h = (static_cast<uint64_t>(myrank * 3 + k) << 40 | c) * 0x9E3779B97F4A7C15ULL;
+				if((h >> 20) % strides[k] == 0)
+					jc.push_back(c);
+			}
+			errors += CheckIndex(jc, ndim, kinds[k]);
+		}
+
+		// the index built from a local matrix has to follow its mutations
+		int64_t nnz = ndim / 16;
+		SpTuples<int64_t,double> tuples(nnz, ndim / 2, ndim);
+		for(int64_t i=0; i < nnz; ++i)
+		{
+			uint64_t h = (static_cast<uint64_t>(myrank) << 40 | i) * 0x9E3779B97F4A7C15ULL;
+			tuples.rowindex(i) = static_cast<int64_t>((h >> 13) % (ndim / 2));
+			tuples.colindex(i) = static_cast<int64_t>((h >> 37) % ndim);
+			tuples.numvalue(i) = 1.0;
+		}
+		tuples.SortColBased();
+		tuples.RemoveDuplicates(plus<double>());
+		SpDCCols<int64_t,double> A(tuples, false);
+		for(int round=0; round < 2; ++round)
+		{
+			Dcsc<int64_t,double> * dcsc = A.GetDCSC();
+			DcscColIndex<int64_t> colindex = A.ColumnIndex();
+			for(int64_t c=0; c < A.getncol(); ++c)
+			{
+				bool found;
+				int64_t pos = colindex.Find(c, found);
+				int64_t * itr = lower_bound(dcsc->jc, dcsc->jc + dcsc->nzc, c);
+				bool exists = (itr != dcsc->jc + dcsc->nzc && *itr == c);
+				if(found != exists || (exists && pos != itr - dcsc->jc)) ++errors;
+			}
+			A.Transpose();
+		}
+
+		// a matrix without a dcsc gets an index on which every lookup misses
+		SpDCCols<int64_t,double> E(0, ndim / 2, ndim, 0);
+		DcscColIndex<int64_t> emptyindex = E.ColumnIndex();
+		for(int64_t c=0; c < ndim; c += 7)
+		{
+			bool found = true;
+			emptyindex.Find(c, found);
+			if(found) ++errors;
+		}
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Column lookups are correct" << endl;
+		else cout << "ERROR: " << errors << " wrong column lookups" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.5 -------------------------------------------------*/
+/* date: 10/09/2015 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc, Adam Lugowski ------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2015, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+#define EDGEFACTOR 8
+
+typedef SpParMat <int64_t, double, SpDCCols<int64_t,double> > PARDBMAT;
+
+PARDBMAT MakeMatrix(shared_ptr<CommGrid> grid, int64_t n, const vector<int64_t> & rows, const vector<int64_t> & cols, const vector<double> & vals)
+{
+	FullyDistVec<int64_t,int64_t> ri(rows, grid);
+	FullyDistVec<int64_t,int64_t> ci(cols, grid);
+	FullyDistVec<int64_t,double> vi(vals, grid);
+	return PARDBMAT(n, n, ri, ci, vi);
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./DynamicUpdateTest <Scale>" << endl;
+			cout << "Builds an Erdos-Renyi matrix of the given scale with batched insertions and deletions" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		unsigned scale = static_cast<unsigned>(atoi(argv[1]));
+		double initiator[4] = {.25, .25, .25, .25};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, scale, EDGEFACTOR, true, false);
+		PARDBMAT G(*DEL, false);
+		delete DEL;
+		shared_ptr<CommGrid> fullWorld = G.getcommgrid();
+		int64_t n = G.getnrow();
+
+		FullyDistVec<int64_t,int64_t> ri(fullWorld), ci(fullWorld);
+		FullyDistVec<int64_t,double> vi(fullWorld);
+		G.Find(ri, ci, vi);
+		vector<int64_t> rows(ri.GetLocArr(), ri.GetLocArr() + ri.LocArrSize());
+		vector<int64_t> cols(ci.GetLocArr(), ci.GetLocArr() + ci.LocArrSize());
+		vector<double> vals(rows.size());
+		for(size_t k=0; k<rows.size(); ++k)
+			vals[k] = static_cast<double>((rows[k] * 31 + cols[k]) % 17 + 1);
+		PARDBMAT A = MakeMatrix(fullWorld, n, rows, cols, vals);
+
+		// Insert everything in two batches, issued from wherever Find left the triples
+		DynamicSpParMat<int64_t, double, SpDCCols<int64_t,double> > D(fullWorld, n, n, 0.5);
+		size_t half = rows.size() / 2;
+		D.Insert(vector<int64_t>(rows.begin(), rows.begin()+half), vector<int64_t>(cols.begin(), cols.begin()+half), vector<double>(vals.begin(), vals.begin()+half));
+		D.Insert(vector<int64_t>(rows.begin()+half, rows.end()), vector<int64_t>(cols.begin()+half, cols.end()), vector<double>(vals.begin()+half, vals.end()));
+		if (D.Mat() == A)
+		{
+			SpParHelper::Print("Batched insertions working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in batched insertions, go fix it!\n");	
+			++errors;
+		}
+
+		// Delete a third of the entries, overwrite another third, and delete-then-reinsert the rest
+		vector<int64_t> delrows, delcols, insrows, inscols, crows, ccols;
+		vector<double> insvals, cvals;
+		for(size_t k=0; k<rows.size(); ++k)
+		{
+			int64_t bucket = (rows[k] + cols[k]) % 3;
+			if(bucket != 1)
+			{
+				delrows.push_back(rows[k]);
+				delcols.push_back(cols[k]);
+			}
+			if(bucket != 0)
+			{
+				double newval = (bucket == 1) ? vals[k] + 100 : vals[k];
+				insrows.push_back(rows[k]);
+				inscols.push_back(cols[k]);
+				insvals.push_back(newval);
+				crows.push_back(rows[k]);
+				ccols.push_back(cols[k]);
+				cvals.push_back(newval);
+			}
+		}
+		D.Delete(delrows, delcols);
+		D.Insert(insrows, inscols, insvals);
+		PARDBMAT Control = MakeMatrix(fullWorld, n, crows, ccols, cvals);
+		if (D.Mat() == Control)
+		{
+			SpParHelper::Print("Batched deletions and overwrites working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in batched deletions, go fix it!\n");	
+			++errors;
+		}
+
+		// Deleting everything that is left leaves empty local matrices behind
+		D.Delete(crows, ccols);
+		if (D.Mat().getnnz() == 0 && D.getpending() == 0)
+		{
+			SpParHelper::Print("Deleting all entries working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in deleting all entries, go fix it!\n");	
+			++errors;
+		}
+	}
+	MPI_Finalize();
+	return (errors > 0);
+}
@@ -0,0 +1,136 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <future>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./ElementBatchTest <Scale>" << endl;
+			cout << "Compares batched element accesses with per-element ones on vectors of length 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		shared_ptr<CommGrid> fullWorld(new CommGrid(MPI_COMM_WORLD, 0, 0));
+		int64_t n = static_cast<int64_t>(1) << atoi(argv[1]);
+		FullyDistVec<int64_t, int64_t> v(fullWorld);
+		v.iota(n, 0);
+		v.Apply([n](int64_t x){ return (x * 7919) % n; });
+
+		// every process asks for a different list, including duplicates and the last entry
+		vector<int64_t> mine;
+		for(int64_t k = 0; k < 64; ++k)
+			mine.push_back((k * 131 + myrank * 977) % n);
+		mine.push_back(n-1);
+		mine.push_back(mine.front());
+		vector<int64_t> got = v.GetElements(mine);
+		vector<int64_t> gotasync = v.GetElementsAsync(mine).get();
+		for(size_t k = 0; k < mine.size(); ++k)
+			if(got[k] != (mine[k] * 7919) % n || gotasync[k] != got[k]) { ++errors; cout << "fail line " << __LINE__ << endl; break; }
+
+		// replicated list, as in the BFS drivers: compare with GetElement
+		vector<int64_t> same = {0, n/3, n/2, n-1};
+		got = v.GetElements(same);
+		for(size_t k = 0; k < same.size(); ++k)
+			if(got[k] != v.GetElement(same[k])) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// an empty batch on some processes
+		vector<int64_t> none;
+		got = v.GetElements(myrank % 2 ? none : same);
+		if(got.size() != (myrank % 2 ? 0 : same.size())) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// disjoint writes from all processes
+		FullyDistVec<int64_t, int64_t> w(fullWorld, n, -1), expected(fullWorld, n, -1);
+		vector<int64_t> inds, vals;
+		for(int64_t i = 3 * myrank; i < n; i += 3 * nprocs)
+		{
+			inds.push_back(n - 1 - i);
+			vals.push_back(i);
+		}
+		w.SetElements(inds, vals);
+		for(int64_t i = 0; i < n; i += 3)
+			expected.SetElement(n - 1 - i, i);
+		if(!(w == expected)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// sparse vectors: insert, overwrite, look up and delete
+		FullyDistSpVec<int64_t, int64_t> s(fullWorld, n), sexp(fullWorld, n);
+		s.SetElements(inds, vals);
+		for(int64_t i = 0; i < n; i += 3)
+			sexp.SetElement(n - 1 - i, i);
+		vector<int64_t> over = {0, 1, n-1};
+		vector<int64_t> overvals = {5, 6, 7};
+		s.SetElements(myrank == nprocs-1 ? over : none, myrank == nprocs-1 ? overvals : none);
+		for(size_t k = 0; k < over.size(); ++k)
+			sexp.SetElement(over[k], overvals[k]);
+		if(s.getnnz() != sexp.getnnz() || !(FullyDistVec<int64_t, int64_t>(s) == FullyDistVec<int64_t, int64_t>(sexp))) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		vector<bool> found;
+		vector<int64_t> probe = {0, 2, n-1, n/2, n-2};
+		got = s.GetElements(probe, found);
+		for(size_t k = 0; k < probe.size(); ++k)
+		{
+			int64_t val = sexp[probe[k]];
+			if(found[k] != sexp.WasFound() || got[k] != val) { ++errors; cout << "fail line " << __LINE__ << endl; }
+		}
+
+		vector<int64_t> dels = {n-1, 2, 3, 0};
+		s.DelElements(myrank == 0 ? dels : none);
+		for(size_t k = 0; k < dels.size(); ++k)
+			sexp.DelElement(dels[k]);
+		if(s.getnnz() != sexp.getnnz() || !(FullyDistVec<int64_t, int64_t>(s) == FullyDistVec<int64_t, int64_t>(sexp))) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Batched element accesses are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between batched and per-element accesses" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
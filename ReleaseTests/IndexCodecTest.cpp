@@ -0,0 +1,203 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+//! Encodes and decodes inds, checks the round trip and the chosen format
+int RoundTrip(const vector<int32_t> & inds, int expected)
+{
+	int errors = 0;
+	int32_t nnz = static_cast<int32_t>(inds.size());
+	IndexCodec::Format format;
+	int bytes = IndexCodec::EncodedSize(inds.data(), nnz, format);
+	vector<uint8_t> buf(bytes);
+	if(IndexCodec::Encode(inds.data(), nnz, buf.data()) != bytes) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	if(nnz > 0 && (bytes > 1 + 4 * nnz || buf[0] != expected)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	vector<int32_t> back(nnz, -1);
+	if(IndexCodec::Decode(buf.data(), nnz, back.data()) != bytes) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	if(back != inds) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors;
+}
+
+//! A sorted index list over [0, universe) where each index is present with the given probability
+vector<int32_t> RandomList(int32_t universe, double density, MTRand & M)
+{
+	vector<int32_t> inds;
+	for(int32_t i=0; i<universe; ++i)
+		if(M.rand() < density) inds.push_back(i);
+	return inds;
+}
+
+//! Compares the encoded collectives with their plain MPI counterparts
+int CompareCollectives(MPI_Comm comm)
+{
+	int errors = 0;
+	int nprocs, myrank;
+	MPI_Comm_size(comm, &nprocs);
+	MPI_Comm_rank(comm, &myrank);
+	MTRand M(myrank + 1);
+	double densities[4] = {0.0, 0.001, 0.2, 0.9};
+
+	// alltoallv: the list for each destination has a different density
+	vector<int32_t> sendinds;
+	vector<int> sendcnt(nprocs), sdispls(nprocs, 0);
+	for(int i=0; i<nprocs; ++i)
+	{
+		vector<int32_t> piece = RandomList(20000, densities[(i + myrank) % 4], M);
+		sendcnt[i] = static_cast<int>(piece.size());
+		sendinds.insert(sendinds.end(), piece.begin(), piece.end());
+	}
+	partial_sum(sendcnt.begin(), sendcnt.end()-1, sdispls.begin()+1);
+	vector<int> recvcnt(nprocs), rdispls(nprocs, 0);
+	MPI_Alltoall(sendcnt.data(), 1, MPI_INT, recvcnt.data(), 1, MPI_INT, comm);
+	partial_sum(recvcnt.begin(), recvcnt.end()-1, rdispls.begin()+1);
+	int totrecv = rdispls.back() + recvcnt.back();
+	vector<int32_t> plain(totrecv), coded(totrecv);
+	MPI_Alltoallv(sendinds.data(), sendcnt.data(), sdispls.data(), MPI_INT32_T, plain.data(), recvcnt.data(), rdispls.data(), MPI_INT32_T, comm);
+	IndexCodec::Alltoallv(sendinds.data(), sendcnt.data(), sdispls.data(), coded.data(), recvcnt.data(), rdispls.data(), comm);
+	if(plain != coded) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// allgatherv of lists that start at different offsets
+	vector<int32_t> mine = RandomList(30000, densities[myrank % 4], M);
+	for(auto & ind : mine) ind += 30000 * myrank;
+	int mynnz = static_cast<int>(mine.size());
+	vector<int> cnts(nprocs), dpls(nprocs, 0);
+	MPI_Allgather(&mynnz, 1, MPI_INT, cnts.data(), 1, MPI_INT, comm);
+	partial_sum(cnts.begin(), cnts.end()-1, dpls.begin()+1);
+	plain.resize(dpls.back() + cnts.back());
+	coded.resize(dpls.back() + cnts.back());
+	MPI_Allgatherv(mine.data(), mynnz, MPI_INT32_T, plain.data(), cnts.data(), dpls.data(), MPI_INT32_T, comm);
+	IndexCodec::Allgatherv(mine.data(), mynnz, coded.data(), cnts.data(), dpls.data(), comm);
+	if(plain != coded) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// sendrecv with the mirror rank
+	int partner = nprocs - 1 - myrank;
+	int partnernnz;
+	MPI_Sendrecv(&mynnz, 1, MPI_INT, partner, 0, &partnernnz, 1, MPI_INT, partner, 0, comm, MPI_STATUS_IGNORE);
+	plain.resize(partnernnz);
+	coded.resize(partnernnz);
+	MPI_Sendrecv(mine.data(), mynnz, MPI_INT32_T, partner, 1, plain.data(), partnernnz, MPI_INT32_T, partner, 1, comm, MPI_STATUS_IGNORE);
+	IndexCodec::Sendrecv(mine.data(), mynnz, partner, coded.data(), partnernnz, partner, 2, comm);
+	if(plain != coded) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors;
+}
+
+//! Sparse SpMV (encoded messages) against dense SpMV for frontiers of the given density
+int CompareSpMV(const SpParMat<int64_t, double, SpDCCols<int64_t,double> > & A, double density)
+{
+	typedef PlusTimesSRing<double, double> PTRing;
+	int errors = 0;
+	FullyDistVec<int64_t, double> x(A.getcommgrid(), A.getncol(), 0.0);
+	x.iota(A.getncol(), 0.0);
+	int64_t keep = static_cast<int64_t>(density * 1000);
+	x.Apply([keep](double v){ return ((static_cast<uint64_t>(v) * 2654435761ULL) % 1000 < static_cast<uint64_t>(keep)) ? static_cast<double>(static_cast<int64_t>(v) % 7 + 1) : 0.0; });
+	FullyDistSpVec<int64_t, double> sx(x, [](double v){ return v > 0; });
+
+	FullyDistVec<int64_t, double> y = SpMV<PTRing>(A, x);
+	FullyDistSpVec<int64_t, double> sy(A.getcommgrid(), A.getnrow());
+	SpMV<PTRing>(A, sx, sy, false);
+	FullyDistVec<int64_t, double> dy(A.getcommgrid(), A.getnrow(), 0.0);
+	dy.Set(sy);
+	if(!(y == dy)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// BFS flavour: values are the indices themselves
+	FullyDistSpVec<int64_t, int64_t> fringe(x, [](double v){ return v > 0; });
+	fringe.setNumToInd();
+	SpParMat<int64_t, bool, SpDCCols<int64_t,bool> > B = A;
+	FullyDistSpVec<int64_t, int64_t> parents(A.getcommgrid(), A.getnrow());
+	SpMV< Select2ndSRing<bool, int64_t, int64_t> >(B, fringe, parents, true);
+	FullyDistSpVec<int64_t, int64_t> parentsref(A.getcommgrid(), A.getnrow());
+	SpMV< Select2ndSRing<bool, int64_t, int64_t> >(B, fringe, parentsref, false);
+	if(!(parents == parentsref) || parents.getnnz() != sy.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./IndexCodecTest <Scale>" << endl;
+			cout << "Checks the adaptive index encodings and the sparse SpMV on an R-MAT matrix of size 2^Scale that uses them" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		MTRand M(1);
+		errors += RoundTrip(vector<int32_t>(), IndexCodec::LIST);
+		errors += RoundTrip(vector<int32_t>(1, 7), IndexCodec::DELTA);
+		errors += RoundTrip(RandomList(100000, 0.5, M), IndexCodec::BITMAP);
+		errors += RoundTrip(RandomList(100000, 0.05, M), IndexCodec::DELTA);
+		vector<int32_t> wide;
+		for(int32_t i=0; i<1000; ++i) wide.push_back((i+1) * 2100000);	// four byte varints tie with the list
+		errors += RoundTrip(wide, IndexCodec::LIST);
+		vector<int32_t> unsorted = {5, 3, 9, 100};
+		errors += RoundTrip(unsorted, IndexCodec::LIST);
+		vector<int32_t> block(5000);
+		iota(block.begin(), block.end(), numeric_limits<int32_t>::max() - 5000);
+		errors += RoundTrip(block, IndexCodec::BITMAP);
+
+		errors += CompareCollectives(MPI_COMM_WORLD);
+
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 16, true, false);
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A(*DEL, false);
+		delete DEL;
+		double densities[4] = {0.002, 0.05, 0.5, 1.0};
+		for(double density : densities)
+			errors += CompareSpMV(A, density);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Index encodings are correct" << endl;
+		else cout << "ERROR: " << errors << " index encoding errors" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,515 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/stat.h>
+#include <cstdio>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <string>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef SpParMat < int64_t, double, SpDCCols<int64_t,double> > PSpMat_Double;
+typedef PlusTimesSRing<double, double> PTDOUBLEDOUBLE;
+
+#define BYTESPERNZ 16	// index and value of a nonzero sent between processes
+#define BENCHIOFILE "kernelbench_io.mtx"
+
+/**
+ * Inputs shared by the kernels of one (generator, scale) configuration
+ */
+struct BenchInput
+{
+	string generator;
+	int scale;
+	int edgefactor;
+	int layers;
+	PSpMat_Double A;
+};
+
+/**
+ * One timed kernel: prepare() runs before every repetition and is not timed
+ * flops and bytes are per repetition; bytes is a model of the data exchanged between processes
+ */
+struct KernelRun
+{
+	function<void()> prepare;
+	function<void()> run;
+	double flops;
+	double bytes;
+	bool supported;
+	KernelRun(): prepare([](){}), flops(0), bytes(0), supported(true) {}
+};
+
+typedef function<KernelRun(BenchInput &)> KernelFactory;
+
+
+//! (pr-1) + (pc-1): number of process row/column neighbors a piece of a vector is sent to
+double FanOut(const shared_ptr<CommGrid> & grid)
+{
+	return (grid->GetGridRows() - 1) + (grid->GetGridCols() - 1);
+}
+
+//! Multiplications of A*B: sum over k of nnz(A(:,k)) * nnz(B(k,:))
+double SpGEMMFlops(const PSpMat_Double & A, const PSpMat_Double & B)
+{
+	FullyDistVec<int64_t, double> colcnt = A.Reduce(Column, plus<double>(), 0.0, [](double v){ return 1.0; });
+	FullyDistVec<int64_t, double> rowcnt = B.Reduce(Row, plus<double>(), 0.0, [](double v){ return 1.0; });
+	colcnt.EWiseApply(rowcnt, multiplies<double>());
+	return colcnt.Reduce(plus<double>(), 0.0);
+}
+
+//! Every other vertex, used as the row and column index set of SubsRef and SpAsgn
+FullyDistVec<int64_t, int64_t> EvenIndices(const PSpMat_Double & A)
+{
+	FullyDistVec<int64_t, int64_t> ind(A.getcommgrid());
+	ind.iota(A.getnrow() / 2, 0);
+	ind.Apply([](int64_t i){ return 2*i; });
+	return ind;
+}
+
+
+/**
+ * Registry of the benchmarked kernels, in the order they are run
+ * Each factory builds its operands (untimed) and returns the timed kernel
+ */
+vector< pair<string, KernelFactory> > KernelRegistry()
+{
+	vector< pair<string, KernelFactory> > kernels;
+
+	kernels.push_back(make_pair(string("spgemm2d"), [](BenchInput & in)
+	{
+		KernelRun k;
+		auto A = make_shared<PSpMat_Double>(in.A);
+		auto B = make_shared<PSpMat_Double>(in.A);
+		k.run = [A, B](){ PSpMat_Double C = PSpGEMM<PTDOUBLEDOUBLE>(*A, *B); };
+		k.flops = 2 * SpGEMMFlops(*A, *B);
+		k.bytes = static_cast<double>(A->getnnz() + B->getnnz()) * BYTESPERNZ * (A->getcommgrid()->GetGridCols() - 1);
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("spgemm3d"), [](BenchInput & in)
+	{
+		KernelRun k;
+		int nprocs = in.A.getcommgrid()->GetSize();
+		int layerprocs = (in.layers > 0 && nprocs % in.layers == 0) ? nprocs / in.layers : 0;
+		int side = static_cast<int>(sqrt(static_cast<double>(layerprocs)) + 0.5);
+		if(in.layers < 2 || side * side != layerprocs)
+		{
+			k.supported = false;	// needs p/layers to be a perfect square
+			return k;
+		}
+		typedef SpParMat3D < int64_t, double, SpDCCols<int64_t,double> > PSpMat3D;
+		auto A = make_shared<PSpMat3D>(in.A, in.layers, true, false);
+		auto B = make_shared<PSpMat3D>(in.A, in.layers, false, false);
+		k.run = [A, B](){ PSpMat3D C = Mult_AnXBn_SUMMA3D<PTDOUBLEDOUBLE, double, SpDCCols<int64_t,double> >(*A, *B); };
+		k.flops = 2 * SpGEMMFlops(in.A, in.A);
+		// broadcasts within a layer, then partial products are merged across layers
+		k.bytes = 2.0 * in.A.getnnz() * BYTESPERNZ * (side - 1) + k.flops / 2 * BYTESPERNZ * (in.layers - 1) / in.layers;
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("spmv"), [](BenchInput & in)
+	{
+		KernelRun k;
+		PSpMat_Double * A = &in.A;
+		auto x = make_shared< FullyDistVec<int64_t, double> >(A->getcommgrid(), A->getncol(), 1.0);
+		k.run = [A, x](){ FullyDistVec<int64_t, double> y = SpMV<PTDOUBLEDOUBLE>(*A, *x); };
+		k.flops = 2.0 * A->getnnz();
+		k.bytes = static_cast<double>(A->getncol()) * sizeof(double) * FanOut(A->getcommgrid());
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("spmspv"), [](BenchInput & in)
+	{
+		KernelRun k;
+		PSpMat_Double * A = &in.A;
+		// one percent of the columns
+		FullyDistVec<int64_t, double> dense(A->getcommgrid());
+		dense.iota(A->getncol(), 0.0);
+		auto x = make_shared< FullyDistSpVec<int64_t, double> >(dense, [](double i){ return static_cast<int64_t>(i) % 100 == 0; });
+		x->Apply([](double i){ return 1.0; });
+		auto y = make_shared< FullyDistSpVec<int64_t, double> >(A->getcommgrid(), A->getnrow());
+		k.run = [A, x, y](){ SpMV<PTDOUBLEDOUBLE>(*A, *x, *y, false); };
+		k.run();
+		FullyDistVec<int64_t, double> colcnt = A->Reduce(Column, plus<double>(), 0.0, [](double v){ return 1.0; });
+		FullyDistVec<int64_t, double> xdense(A->getcommgrid(), A->getncol(), 0.0);
+		xdense.Set(*x);
+		colcnt.EWiseApply(xdense, multiplies<double>());
+		k.flops = 2 * colcnt.Reduce(plus<double>(), 0.0);
+		k.bytes = static_cast<double>(x->getnnz() + y->getnnz()) * BYTESPERNZ * FanOut(A->getcommgrid()) / 2;
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("spmspv_bucket"), [](BenchInput & in)
+	{
+		// same product as spmspv, but through the CSC bucket kernel used by BFS-like traversals
+		KernelRun k;
+		typedef SpParMat < int64_t, double, SpCCols<int64_t,double> > PSpMat_CSC;
+		auto A = make_shared<PSpMat_CSC>(in.A);
+		int nthreads = 1;
+#ifdef THREADED
+#pragma omp parallel
+		{
+			nthreads = omp_get_num_threads();
+		}
+#endif
+		auto SPA = make_shared< PreAllocatedSPA<double> >(A->seq(), nthreads * 4);
+		FullyDistVec<int64_t, double> dense(A->getcommgrid());
+		dense.iota(A->getncol(), 0.0);
+		auto x = make_shared< FullyDistSpVec<int64_t, double> >(dense, [](double i){ return static_cast<int64_t>(i) % 100 == 0; });
+		x->Apply([](double i){ return 1.0; });
+		auto y = make_shared< FullyDistSpVec<int64_t, double> >(A->getcommgrid(), A->getnrow());
+		k.run = [A, x, y, SPA](){ SpMV<PTDOUBLEDOUBLE>(*A, *x, *y, false, *SPA); };
+		k.run();
+		FullyDistVec<int64_t, double> colcnt = in.A.Reduce(Column, plus<double>(), 0.0, [](double v){ return 1.0; });
+		FullyDistVec<int64_t, double> xdense(A->getcommgrid(), A->getncol(), 0.0);
+		xdense.Set(*x);
+		colcnt.EWiseApply(xdense, multiplies<double>());
+		k.flops = 2 * colcnt.Reduce(plus<double>(), 0.0);
+		k.bytes = static_cast<double>(x->getnnz() + y->getnnz()) * BYTESPERNZ * FanOut(A->getcommgrid()) / 2;
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("transpose"), [](BenchInput & in)
+	{
+		KernelRun k;
+		auto A = make_shared<PSpMat_Double>(in.A);
+		k.run = [A](){ A->Transpose(); };
+		int p = A->getcommgrid()->GetSize();
+		k.bytes = static_cast<double>(A->getnnz()) * BYTESPERNZ * (p - A->getcommgrid()->GetGridRows()) / p;	// off-diagonal blocks
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("subsref"), [](BenchInput & in)
+	{
+		KernelRun k;
+		PSpMat_Double * A = &in.A;
+		auto ind = make_shared< FullyDistVec<int64_t, int64_t> >(EvenIndices(*A));
+		k.run = [A, ind](){ PSpMat_Double S = (*A)(*ind, *ind); };
+		// SubsRef_SR still forms P*A*Q with selection matrices (two SpGEMMs); only SpAsgn and Prune scatter directly
+		k.bytes = static_cast<double>(A->getnnz()) * BYTESPERNZ * (A->getcommgrid()->GetGridCols() - 1) * 3 / 2;
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("spasgn"), [](BenchInput & in)
+	{
+		KernelRun k;
+		auto ind = make_shared< FullyDistVec<int64_t, int64_t> >(EvenIndices(in.A));
+		auto B = make_shared<PSpMat_Double>(in.A(*ind, *ind));
+		auto A = make_shared<PSpMat_Double>(in.A.getcommgrid());
+		PSpMat_Double * orig = &in.A;
+		k.prepare = [A, orig](){ *A = *orig; };
+		k.run = [A, B, ind](){ A->SpAsgn(*ind, *ind, *B); };
+		// Prune (LocalIndexMask) and the target lookup (LocalIndexValues) send ri and ci to their owners and replicate
+		// them along processor rows/columns; the nonzeros of B are then sent once to their owners with one alltoallv
+		shared_ptr<CommGrid> grid = in.A.getcommgrid();
+		int p = grid->GetSize();
+		double indexbytes = 2.0 * ind->TotalLength() * sizeof(int64_t);	// ri and ci
+		k.bytes = indexbytes * (grid->GetGridRows() + grid->GetGridCols()) + static_cast<double>(B->getnnz()) * BYTESPERNZ * (p - 1) / p;
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("ewiseapply"), [](BenchInput & in)
+	{
+		KernelRun k;
+		PSpMat_Double * A = &in.A;
+		auto B = make_shared<PSpMat_Double>(in.A);
+		B->Apply([](double v){ return v + 1; });
+		k.run = [A, B](){ PSpMat_Double C = EWiseApply<double, SpDCCols<int64_t,double> >(*A, *B, [](double a, double b){ return a * b; }, false, 0.0); };
+		k.flops = static_cast<double>(A->getnnz());
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("kselect"), [](BenchInput & in)
+	{
+		KernelRun k;
+		PSpMat_Double * A = &in.A;
+		k.run = [A](){ FullyDistVec<int64_t, double> kth(A->getcommgrid()); A->Kselect(kth, static_cast<int64_t>(4), 1); };
+		k.bytes = static_cast<double>(A->getnnz()) * sizeof(double);	// column pieces are gathered along process columns
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("io"), [](BenchInput & in)
+	{
+		KernelRun k;
+		PSpMat_Double * A = &in.A;
+		int myrank = A->getcommgrid()->GetRank();
+		MPI_Comm World = A->getcommgrid()->GetWorld();
+		k.prepare = [myrank, World](){ if(myrank == 0) remove(BENCHIOFILE); MPI_Barrier(World); };
+		k.run = [A](){ A->ParallelWriteMM(BENCHIOFILE, true); PSpMat_Double R(A->getcommgrid()); R.ParallelReadMM(BENCHIOFILE, true, maximum<double>()); };
+		k.prepare();
+		k.run();
+		double filebytes = 0;
+		struct stat st;
+		if(myrank == 0 && stat(BENCHIOFILE, &st) == 0) filebytes = static_cast<double>(st.st_size);
+		MPI_Bcast(&filebytes, 1, MPI_DOUBLE, 0, World);
+		k.bytes = 2 * filebytes;	// written and read back
+		return k;
+	}));
+
+	kernels.push_back(make_pair(string("sort"), [](BenchInput & in)
+	{
+		KernelRun k;
+		int64_t n = in.A.getnrow();
+		auto keys = make_shared< FullyDistVec<int64_t, double> >(in.A.getcommgrid());
+		keys->iota(n, 0.0);
+		keys->Apply([](double i){ return static_cast<double>((static_cast<uint64_t>(i) * 2654435761ULL) % 1000003); });
+		auto v = make_shared< FullyDistVec<int64_t, double> >(in.A.getcommgrid());
+		k.prepare = [v, keys](){ *v = *keys; };
+		k.run = [v](){ FullyDistVec<int64_t, int64_t> perm = v->sort(); };
+		int p = in.A.getcommgrid()->GetSize();
+		k.bytes = static_cast<double>(n) * BYTESPERNZ * (p - 1) / p;
+		return k;
+	}));
+
+	return kernels;
+}
+
+
+struct BenchResult
+{
+	string kernel;
+	vector<double> times;	// slowest process, per repetition
+	double imbalance;	// max over average of the per-process time
+	double flops;
+	double bytes;
+	vector<KernelProfile> profile;	// local kernels inside the timed repetitions, with -DKERNELPROFILE
+};
+
+BenchResult RunKernel(const string & name, KernelRun & k, int warmup, int reps, MPI_Comm World)
+{
+	int nprocs;
+	MPI_Comm_size(World, &nprocs);
+	BenchResult res;
+	res.kernel = name;
+	res.flops = k.flops;
+	res.bytes = k.bytes;
+	double mytotal = 0;
+	for(int r = 0; r < warmup + reps; ++r)
+	{
+		k.prepare();
+		if(r == warmup) KernelProfiler::Reset();
+		MPI_Barrier(World);
+		double t1 = MPI_Wtime();
+		k.run();
+		double mytime = MPI_Wtime() - t1;
+		double maxtime;
+		MPI_Allreduce(&mytime, &maxtime, 1, MPI_DOUBLE, MPI_MAX, World);
+		if(r >= warmup)
+		{
+			res.times.push_back(maxtime);
+			mytotal += mytime;
+		}
+	}
+	double maxtotal, sumtotal;
+	MPI_Allreduce(&mytotal, &maxtotal, 1, MPI_DOUBLE, MPI_MAX, World);
+	MPI_Allreduce(&mytotal, &sumtotal, 1, MPI_DOUBLE, MPI_SUM, World);
+	res.imbalance = (sumtotal > 0) ? maxtotal * nprocs / sumtotal : 1.0;
+#ifdef KERNELPROFILE
+	res.profile = KernelProfiler::Summarize(World);
+#endif
+	return res;
+}
+
+
+vector<string> SplitList(const string & list)
+{
+	vector<string> items;
+	stringstream ss(list);
+	string item;
+	while(getline(ss, item, ',')) if(!item.empty()) items.push_back(item);
+	return items;
+}
+
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	vector< pair<string, KernelFactory> > registry = KernelRegistry();
+	string generator = "rmat", jsonfile = "";
+	vector<string> scales(1, "14"), selected;
+	int edgefactor = 16, reps = 5, warmup = 1, layers = 4;
+	bool badargs = false;
+	for(int i = 1; i < argc; ++i)
+	{
+		string arg = argv[i];
+		bool hasval = (i+1 < argc);
+		if(arg == "-gen" && hasval) generator = argv[++i];
+		else if(arg == "-scales" && hasval) scales = SplitList(argv[++i]);
+		else if(arg == "-ef" && hasval) edgefactor = atoi(argv[++i]);
+		else if(arg == "-reps" && hasval) reps = atoi(argv[++i]);
+		else if(arg == "-warmup" && hasval) warmup = atoi(argv[++i]);
+		else if(arg == "-layers" && hasval) layers = atoi(argv[++i]);
+		else if(arg == "-kernels" && hasval) selected = SplitList(argv[++i]);
+		else if(arg == "-json" && hasval) jsonfile = argv[++i];
+		else badargs = true;
+	}
+	for(size_t i = 0; i < selected.size(); ++i)
+	{
+		bool known = false;
+		for(size_t j = 0; j < registry.size(); ++j) known = known || (registry[j].first == selected[i]);
+		if(!known) badargs = true;
+	}
+	if(badargs || (generator != "rmat" && generator != "er") || reps < 1)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./KernelBench [-gen rmat|er] [-scales 12,14,...] [-ef edgefactor] [-reps n] [-warmup n] [-layers l] [-kernels k1,k2,...] [-json file]" << endl;
+			cout << "Kernels:";
+			for(size_t j = 0; j < registry.size(); ++j) cout << " " << registry[j].first;
+			cout << endl << "Times are those of the slowest process; bytes is a model of the data exchanged between processes (or read and written for io)" << endl;
+			cout << "Configure with -DCMAKE_BUILD_TYPE=Release to get optimized timings" << endl;
+			cout << "KernelBenchProfile (built with -DKERNELPROFILE) adds the roofline profile of the local kernels" << endl;
+		}
+		MPI_Finalize();
+		return -1;
+	}
+	int nthreads = 1;
+#ifdef THREADED
+#pragma omp parallel
+	{
+		nthreads = omp_get_num_threads();
+	}
+#endif
+
+	ostringstream json;
+	json.precision(6);
+	bool optimized = false;	// timings of unoptimized builds (e.g. CMake without a build type) are not comparable
+#ifdef __OPTIMIZE__
+	optimized = true;
+#endif
+	json << "{\n  \"library\": \"CombBLAS\",\n  \"optimized\": " << (optimized ? "true" : "false") << ",\n  \"nprocs\": " << nprocs << ",\n  \"threads\": " << nthreads << ",\n";
+	json << "  \"generator\": \"" << generator << "\",\n  \"edgefactor\": " << edgefactor << ",\n  \"reps\": " << reps << ",\n  \"warmup\": " << warmup << ",\n";
+#ifdef KERNELPROFILE
+	KernelProfiler::Calibrate(MPI_COMM_WORLD);
+	json << "  \"roofline\": {\"peak_gflops\": " << nprocs * KernelProfiler::PeakGFlops() << ", \"peak_gbytes_per_sec\": " << nprocs * KernelProfiler::PeakGBs();
+	json << ", \"counters\": \"" << ThreadCounters::Backend() << "\"},\n";
+#endif
+	json << "  \"results\": [";
+	bool first = true;
+	for(size_t s = 0; s < scales.size(); ++s)
+	{
+		BenchInput in;
+		in.generator = generator;
+		in.scale = atoi(scales[s].c_str());
+		in.edgefactor = edgefactor;
+		in.layers = layers;
+		{
+			double rmat[4] = {.57, .19, .19, .05};
+			double er[4] = {.25, .25, .25, .25};
+			DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+			DEL->GenGraph500Data(generator == "er" ? er : rmat, in.scale, edgefactor, true, false);
+			in.A = PSpMat_Double(*DEL, false);
+			delete DEL;
+		}
+		in.A.Apply([](double v){ return 1.0; });
+		shared_ptr<CommGrid> grid = in.A.getcommgrid();
+		int64_t nnz = in.A.getnnz();
+		float nnzimbalance = in.A.LoadImbalance();
+
+		for(size_t j = 0; j < registry.size(); ++j)
+		{
+			const string & name = registry[j].first;
+			if(!selected.empty() && find(selected.begin(), selected.end(), name) == selected.end()) continue;
+			KernelRun k = registry[j].second(in);
+			if(!k.supported)
+			{
+				SpParHelper::Print(name + " is not supported on this process count, skipped\n");
+				continue;
+			}
+			BenchResult res = RunKernel(name, k, warmup, reps, grid->GetWorld());
+			vector<double> sorted = res.times;
+			sort(sorted.begin(), sorted.end());
+			double median = sorted[sorted.size() / 2];
+			double mean = accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+
+			ostringstream outs;
+			outs << "scale " << in.scale << " " << name << ": median " << median << " s";
+			if(res.flops > 0) outs << ", " << res.flops / median / 1e9 << " GFLOPS";
+			outs << ", time imbalance " << res.imbalance << endl;
+			for(size_t p = 0; p < res.profile.size(); ++p)
+			{
+				const KernelProfile & kp = res.profile[p];
+				outs << "    " << kp.name << ": " << kp.calls << " calls, " << kp.seconds << " s, " << kp.achieved << (kp.flops > 0 ? " GFLOPS" : " GB/s");
+				outs << " of " << kp.bound << " (" << 100 * kp.efficiency << "%, " << (kp.memorybound ? "memory" : "compute") << " bound)" << endl;
+			}
+			SpParHelper::Print(outs.str());
+
+			json << (first ? "\n" : ",\n") << "    {\"kernel\": \"" << name << "\", \"scale\": " << in.scale;
+			json << ", \"nrows\": " << in.A.getnrow() << ", \"nnz\": " << nnz;
+			json << ", \"grid\": [" << grid->GetGridRows() << ", " << grid->GetGridCols() << "]";
+			if(name == "spgemm3d") json << ", \"layers\": " << layers;
+			json << ", \"time_min\": " << sorted.front() << ", \"time_median\": " << median << ", \"time_mean\": " << mean << ", \"time_max\": " << sorted.back();
+			json << ", \"flops\": " << res.flops << ", \"gflops\": " << (res.flops > 0 ? res.flops / median / 1e9 : 0.0);
+			json << ", \"bytes\": " << res.bytes << ", \"gbytes_per_sec\": " << res.bytes / median / 1e9;
+			json << ", \"time_imbalance\": " << res.imbalance << ", \"nnz_imbalance\": " << nnzimbalance;
+			if(!res.profile.empty())
+			{
+				json << ", \"profile\": [";
+				for(size_t p = 0; p < res.profile.size(); ++p)
+				{
+					const KernelProfile & kp = res.profile[p];
+					json << (p ? ", " : "") << "{\"kernel\": \"" << kp.name << "\", \"calls\": " << kp.calls << ", \"seconds\": " << kp.seconds;
+					json << ", \"flops\": " << kp.flops << ", \"bytes\": " << kp.bytes << ", \"intensity\": " << kp.intensity;
+					if(kp.counters) json << ", \"cycles\": " << kp.cycles << ", \"llc_misses\": " << kp.llcmisses << ", \"measured_intensity\": " << kp.measuredintensity;
+					json << ", \"achieved\": " << kp.achieved << ", \"bound\": " << kp.bound << ", \"efficiency\": " << kp.efficiency;
+					json << ", \"limit\": \"" << (kp.memorybound ? "memory" : "compute") << "\"}";
+				}
+				json << "]";
+			}
+			json << "}";
+			first = false;
+		}
+	}
+	json << "\n  ]\n}\n";
+	if(myrank == 0)
+	{
+		remove(BENCHIOFILE);
+		if(jsonfile.empty()) cout << json.str();
+		else
+		{
+			ofstream out(jsonfile.c_str());
+			out << json.str();
+		}
+	}
+	MPI_Finalize();
+	return 0;
+}
@@ -0,0 +1,118 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef SpParMat<int64_t, double, SpDCCols<int64_t,double> > PARDBMAT;
+
+// Largest share of the row nonzeros held by a block row of the processor grid, relative to the average
+double BlockRowImbalance(const PARDBMAT & A)
+{
+	int nblocks = A.getcommgrid()->GetGridRows();
+	int64_t n = A.getnrow();
+	FullyDistVec<int64_t, double> rownnz = A.Reduce(Row, plus<double>(), 0.0, [](double){ return 1.0; });
+	vector<double> blocknnz(nblocks, 0.0);
+	int64_t offset = rownnz.LengthUntil();
+	const double * counts = rownnz.GetLocArr();
+	for(int64_t i = 0; i < rownnz.LocArrSize(); ++i)
+		blocknnz[min(static_cast<int>((offset + i) / (n / nblocks)), nblocks-1)] += counts[i];
+	MPI_Allreduce(MPI_IN_PLACE, blocknnz.data(), nblocks, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+	double total = accumulate(blocknnz.begin(), blocknnz.end(), 0.0);
+	return (total == 0) ? 1.0 : *max_element(blocknnz.begin(), blocknnz.end()) * nblocks / total;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./NnzBalanceTest <Scale>" << endl;
+			cout << "Balances an unscrambled (skewed) R-MAT matrix of size 2^Scale with NnzBalancedPermutation" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 16, false, false);	// no scrambling: low vertex ids have the highest degrees
+		PARDBMAT A(*DEL, false);
+		delete DEL;
+		A.Symmetrize(plus<double>());	// a symmetric permutation balances block rows and block columns together only on symmetric matrices
+
+		FullyDistVec<int64_t, int64_t> p = A.NnzBalancedPermutation();
+		FullyDistVec<int64_t, int64_t> labels = p;
+		labels.sort();	// sorted values of a permutation are 0...n-1
+		FullyDistVec<int64_t, int64_t> identity(A.getcommgrid());
+		identity.iota(A.getnrow(), 0);
+		if(!(labels == identity)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		PARDBMAT B = A(p, p);
+		if(B.getnnz() != A.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+		double before = BlockRowImbalance(A), after = BlockRowImbalance(B);
+		if(after > 1.25 || (before > 1.25 && after >= before)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+		if(B.LoadImbalance() > A.LoadImbalance()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// most vertices keep their relative order
+		int64_t inorder = 0;
+		const int64_t * old = p.GetLocArr();
+		for(int64_t i = 1; i < p.LocArrSize(); ++i)
+			if(old[i] > old[i-1]) ++inorder;
+		MPI_Allreduce(MPI_IN_PLACE, &inorder, 1, MPIType<int64_t>(), MPI_SUM, MPI_COMM_WORLD);
+
+		ostringstream outs;
+		outs << "Block row imbalance " << before << " -> " << after << ", load imbalance " << A.LoadImbalance() << " -> " << B.LoadImbalance();
+		outs << ", " << inorder << " of " << A.getnrow() << " consecutive labels in original order" << endl;
+		SpParHelper::Print(outs.str());
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Nnz-balanced permutation is correct" << endl;
+		else cout << "ERROR: " << errors << " failed checks of the nnz-balanced permutation" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,146 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+/**
+ * Multiplies A and its packed copy with the same dense and sparse vectors
+ * @return the number of differing results
+ */
+template <typename NT>
+int CompareMultiplications(SpParMat<int64_t, NT, SpDCCols<int64_t,NT> > & A, typename PackedDcsc<int64_t,NT>::ValueEncoding expected)
+{
+	typedef PlusTimesSRing<NT, double> PTRing;
+	int errors = 0;
+	SpParMat<int64_t, NT, SpPackedCols<int64_t,NT> > P = A;
+	if(P.getnnz() != A.getnnz()) ++errors;
+	if(P.seqptr()->getnnz() > 0 && P.seqptr()->GetPackedDcsc()->GetValueEncoding() != expected) ++errors;
+
+	FullyDistVec<int64_t, double> x(A.getcommgrid(), A.getncol(), 0.0);
+	x.iota(A.getncol(), 0.0);
+	x.Apply([](double v){ return static_cast<double>(static_cast<int64_t>(v) % 13); });
+	FullyDistVec<int64_t, double> y = SpMV<PTRing>(A, x);
+	FullyDistVec<int64_t, double> yp = SpMV<PTRing>(P, x);
+	if(!(y == yp)) ++errors;
+
+	FullyDistSpVec<int64_t, double> sx(x, [](double v){ return v > 9; });
+	FullyDistSpVec<int64_t, double> sy(A.getcommgrid(), A.getnrow());
+	FullyDistSpVec<int64_t, double> syp(A.getcommgrid(), A.getnrow());
+	SpMV<PTRing>(A, sx, sy, false);
+	SpMV<PTRing>(P, sx, syp, false);
+	if(sy.getnnz() != syp.getnnz()) ++errors;
+	FullyDistVec<int64_t, double> dy(A.getcommgrid(), A.getnrow(), -1.0), dyp(A.getcommgrid(), A.getnrow(), -1.0);
+	dy.Set(sy);
+	dyp.Set(syp);
+	if(!(dy == dyp)) ++errors;
+
+	// the preallocated accumulator is reused across calls and must come back clean each time
+	PreAllocatedSPA<double> SPA(P.seq());
+	for(int k = 0; k < 2; ++k)
+	{
+		FullyDistSpVec<int64_t, double> fx(x, [k](double v){ return static_cast<int64_t>(v) % 2 == k; });
+		FullyDistSpVec<int64_t, double> fy(A.getcommgrid(), A.getnrow()), fyp(A.getcommgrid(), A.getnrow());
+		SpMV<PTRing>(A, fx, fy, false);
+		SpMV<PTRing>(P, fx, fyp, false, SPA);
+		FullyDistVec<int64_t, double> dfy(A.getcommgrid(), A.getnrow(), -1.0), dfyp(A.getcommgrid(), A.getnrow(), -1.0);
+		dfy.Set(fy);
+		dfyp.Set(fyp);
+		if(fy.getnnz() != fyp.getnnz() || !(dfy == dfyp)) ++errors;
+	}
+
+	int64_t bytes = static_cast<int64_t>(P.seqptr()->GetBytes());
+	int64_t dcscbytes = A.seqptr()->getnnz() * (sizeof(int64_t) + sizeof(NT)) + A.seqptr()->getnzc() * 2 * sizeof(int64_t);
+	MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPIType<int64_t>(), MPI_SUM, MPI_COMM_WORLD);
+	MPI_Allreduce(MPI_IN_PLACE, &dcscbytes, 1, MPIType<int64_t>(), MPI_SUM, MPI_COMM_WORLD);
+	ostringstream outs;
+	outs << "Packed matrix uses " << bytes << " bytes instead of " << dcscbytes << endl;
+	SpParHelper::Print(outs.str());
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./PackedColsTest <Scale>" << endl;
+			cout << "Compares SpMV and SpMSpV on packed and regular copies of an R-MAT matrix of size 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 16, true, false);
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A(*DEL, false);
+		delete DEL;
+
+		// pattern matrix, few distinct integral weights, arbitrary weights
+		SpParMat<int64_t, bool, SpDCCols<int64_t,bool> > B = A;
+		errors += CompareMultiplications(B, PackedDcsc<int64_t,bool>::CONSTANT);
+
+		FullyDistVec<int64_t, int64_t> ri(A.getcommgrid()), ci(A.getcommgrid());
+		FullyDistVec<int64_t, double> w(A.getcommgrid());
+		A.Find(ri, ci, w);
+		w.iota(ri.TotalLength(), 0);
+		w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 64 + 1); });
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > W(A.getnrow(), A.getncol(), ri, ci, w, false);
+		errors += CompareMultiplications(W, PackedDcsc<int64_t,double>::DICTIONARY);
+
+		w.iota(ri.TotalLength(), 0.25);
+		w.Apply([](double x){ return x / 4; });	// distinct, but products and sums stay exact
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > R(A.getnrow(), A.getncol(), ri, ci, w, false);
+		errors += CompareMultiplications(R, PackedDcsc<int64_t,double>::RAWVALUES);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Packed matrix products are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between packed and regular products" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
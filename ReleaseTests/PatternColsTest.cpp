@@ -0,0 +1,152 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef SpParMat<int64_t, bool, SpDCCols<int64_t,bool> > BoolMat;
+typedef SpParMat<int64_t, bool, SpPatternCols<int64_t> > PatternMat;
+typedef SpParMat<int64_t, int64_t, SpDCCols<int64_t,int64_t> > IntMat;
+
+template <typename NT, typename DER>
+bool SameMatrix(SpParMat<int64_t, NT, DER> & A, SpParMat<int64_t, NT, DER> & B)
+{
+	return (A.getnnz() == B.getnnz()) && (A == B);
+}
+
+/**
+ * Multiplies the valued boolean matrix B and its pattern copy P with the same vectors and matrices
+ * @return the number of differing results
+ */
+int CompareMultiplications(BoolMat & B, PatternMat & P, IntMat & W)
+{
+	typedef PlusTimesSRing<bool, int64_t> PTRing;
+	typedef PlusTimesSRing<int64_t, int64_t> PTIntRing;
+	int errors = 0;
+	if(P.getnnz() != B.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// dense SpMV
+	FullyDistVec<int64_t, int64_t> x(B.getcommgrid(), B.getncol(), 0);
+	x.iota(B.getncol(), 0);
+	x.Apply([](int64_t v){ return v % 13; });
+	FullyDistVec<int64_t, int64_t> y = SpMV<PTRing>(B, x);
+	FullyDistVec<int64_t, int64_t> yp = SpMV<PTRing>(P, x);
+	if(!(y == yp)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// sparse SpMV, one BFS step
+	FullyDistSpVec<int64_t, int64_t> fringe(x, [](int64_t v){ return v > 9; });
+	FullyDistSpVec<int64_t, int64_t> sy(B.getcommgrid(), B.getnrow());
+	FullyDistSpVec<int64_t, int64_t> syp(B.getcommgrid(), B.getnrow());
+	SpMV<SelectMaxSRing<bool, int64_t> >(B, fringe, sy, false);
+	SpMV<SelectMaxSRing<bool, int64_t> >(P, fringe, syp, false);
+	if(sy.getnnz() != syp.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	FullyDistVec<int64_t, int64_t> dy(B.getcommgrid(), B.getnrow(), -1), dyp(B.getcommgrid(), B.getnrow(), -1);
+	dy.Set(sy);
+	dyp.Set(syp);
+	if(!(dy == dyp)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// SUMMA with the pattern on either or both sides
+	BoolMat B2(B);
+	PatternMat P2(P);
+	BoolMat BB = Mult_AnXBn_Synch<PlusTimesSRing<bool,bool>, bool, SpDCCols<int64_t,bool> >(B, B2);
+	BoolMat PP = Mult_AnXBn_Synch<PlusTimesSRing<bool,bool>, bool, SpDCCols<int64_t,bool> >(P, P2);
+	if(!SameMatrix(BB, PP)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	IntMat BW = Mult_AnXBn_Synch<PTIntRing, int64_t, SpDCCols<int64_t,int64_t> >(B, W);
+	IntMat PW = Mult_AnXBn_Synch<PTIntRing, int64_t, SpDCCols<int64_t,int64_t> >(P, W);
+	if(!SameMatrix(BW, PW)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	IntMat WB = Mult_AnXBn_Synch<PTIntRing, int64_t, SpDCCols<int64_t,int64_t> >(W, B);
+	IntMat WP = Mult_AnXBn_Synch<PTIntRing, int64_t, SpDCCols<int64_t,int64_t> >(W, P);
+	if(!SameMatrix(WB, WP)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	int64_t bytes = static_cast<int64_t>(P.seqptr()->GetBytes());
+	int64_t dcscbytes = B.seqptr()->getnnz() * (sizeof(int64_t) + sizeof(bool)) + B.seqptr()->getnzc() * 2 * sizeof(int64_t);
+	MPI_Allreduce(MPI_IN_PLACE, &bytes, 1, MPIType<int64_t>(), MPI_SUM, MPI_COMM_WORLD);
+	MPI_Allreduce(MPI_IN_PLACE, &dcscbytes, 1, MPIType<int64_t>(), MPI_SUM, MPI_COMM_WORLD);
+	ostringstream outs;
+	outs << "Pattern matrix uses " << bytes << " bytes instead of " << dcscbytes << endl;
+	SpParHelper::Print(outs.str());
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./PatternColsTest <Scale>" << endl;
+			cout << "Compares SpMV, SpMSpV and SpGEMM on pattern-only and boolean copies of an R-MAT matrix of size 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 8, true, false);
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A(*DEL, false);
+		delete DEL;
+
+		BoolMat B = A;
+		PatternMat P = B;
+		IntMat W = A;
+		W.Apply([](int64_t v){ return static_cast<int64_t>(3); });
+		errors += CompareMultiplications(B, P, W);
+
+		// an empty pattern matrix
+		BoolMat E(B);
+		E.Prune([](bool v){ return true; });
+		PatternMat EP = E;
+		errors += CompareMultiplications(E, EP, W);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Pattern matrix products are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between pattern and boolean products" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
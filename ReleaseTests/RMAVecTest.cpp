@@ -0,0 +1,128 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.5 -------------------------------------------------*/
+/* date: 10/09/2015 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc, Adam Lugowski ------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2015, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./RMAVecTest <Scale>" << endl;
+			cout << "Accumulates into and fetches from a persistent RMA vector of length 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		shared_ptr<CommGrid> fullWorld;
+		fullWorld.reset( new CommGrid(MPI_COMM_WORLD, 0, 0) );
+		int64_t n = static_cast<int64_t>(1) << atoi(argv[1]);
+
+		// every process issues several batches of updates, with many duplicate indices
+		FullyDistRMAVec<int64_t,int64_t> counts(fullWorld, n, 0);
+		FullyDistRMAVec<int64_t,int64_t> mins(fullWorld, n, n);
+		FullyDistVec<int64_t,int64_t> allinds(fullWorld);
+		vector<int64_t> myinds;
+		for(int batch = 0; batch < 4; ++batch)
+		{
+			vector<int64_t> inds(n / 4);
+			for(size_t i=0; i < inds.size(); ++i)
+			{
+				uint64_t h = (static_cast<uint64_t>(myrank * 4 + batch) << 32 | i) * 0x9E3779B97F4A7C15ULL;
+				inds[i] = static_cast<int64_t>((h >> 17) % (i % 2 ? n : 64));
+			}
+			vector<int64_t> ones(inds.size(), 1);
+			counts.Accumulate(inds, ones, plus<int64_t>(), MPI_SUM);
+			vector<int64_t> vals(inds.size(), myrank * 4 + batch);
+			mins.Accumulate(inds, vals, [](int64_t a, int64_t b){ return std::min(a,b); }, MPI_MIN);
+			myinds.insert(myinds.end(), inds.begin(), inds.end());
+		}
+		counts.Sync();
+		mins.Sync();
+
+		// reference: a two-sided scatter-reduce of the same updates
+		FullyDistVec<int64_t,int64_t> indvec(myinds, fullWorld);
+		FullyDistVec<int64_t,int64_t> onevec(fullWorld, indvec.TotalLength(), 1);
+		FullyDistSpVec<int64_t,int64_t> refsp(n, indvec, onevec, plus<int64_t>());
+		FullyDistVec<int64_t,int64_t> ref(fullWorld, n, 0);
+		ref.Set(refsp);
+		if (counts.ToFullyDistVec() == ref)
+		{
+			SpParHelper::Print("RMA accumulate working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in RMA accumulate, go fix it!\n");	
+			++errors;
+		}
+
+		// every touched index of mins holds the smallest batch id that touched it
+		vector<int64_t> probe(myinds.begin(), myinds.begin() + n / 4);
+		vector<int64_t> fetched, fetchedcounts;
+		mins.Fetch(probe, fetched);
+		counts.Fetch(probe, fetchedcounts);
+		mins.Flush();
+		counts.Flush();
+		int correct = 1;
+		for(size_t i=0; i < probe.size(); ++i)
+		{
+			if(fetched[i] > myrank * 4 || fetchedcounts[i] < 1) correct = 0;
+		}
+		int64_t zero = 0;
+		if(myrank == 0 && mins.GetLocArr()[0] != zero) correct = 0;
+		MPI_Allreduce(MPI_IN_PLACE, &correct, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+		if (correct)
+		{
+			SpParHelper::Print("RMA fetch working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in RMA fetch, go fix it!\n");	
+			++errors;
+		}
+	}
+	MPI_Finalize();
+	return errors > 0;
+}
@@ -0,0 +1,146 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+/**
+ * Order independent checksum of a set of edges
+ */
+uint64_t EdgeHash(int64_t row, int64_t col)
+{
+	return RMatMix(static_cast<uint64_t>(row) * 0x100000001B3ULL + static_cast<uint64_t>(col));
+}
+
+int CheckFeistel()
+{
+	int errors = 0;
+	int widths[5] = {0, 1, 5, 10, 11};
+	for(int w = 0; w < 5; ++w)
+	{
+		FeistelPermutation perm(widths[w], 12345);
+		uint64_t n = static_cast<uint64_t>(1) << widths[w];
+		vector<bool> seen(n, false);
+		for(uint64_t x = 0; x < n; ++x)
+		{
+			uint64_t y = perm.Permute(x);
+			if(y >= n || seen[y] || perm.Invert(y) != x) { ++errors; break; }
+			seen[y] = true;
+		}
+	}
+	if(errors) cout << "Feistel network is not a bijection" << endl;
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./RMatGeneratorTest <Scale>" << endl;
+			cout << "Generates an R-MAT matrix of size 2^Scale in place and compares it with a serially generated copy" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = CheckFeistel();
+	{
+		int scale = atoi(argv[1]);
+		double initiator[4] = {.57, .19, .19, .05};
+		RMatGenerator gen(initiator, scale, 16);
+		shared_ptr<CommGrid> grid(new CommGrid(MPI_COMM_WORLD, 0, 0));
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A(grid);
+		gen.Generate(grid, A);
+		A.PrintInfo();
+
+		ostringstream outs;
+		outs << "Load imbalance: " << A.LoadImbalance() << endl;
+		SpParHelper::Print(outs.str());
+
+		// each process regenerates the whole graph on its own and compares it with the distributed one
+		int64_t n = gen.getGlobalV();
+		vector<int64_t> all;
+		gen.BlockEdges(0, n, 0, n, true, true, all);
+		SpTuples<int64_t,double> serial(static_cast<int64_t>(all.size()/2), n, n, all, false);
+		uint64_t serialhash = 0;
+		for(int64_t i = 0; i < serial.getnnz(); ++i)
+			serialhash += EdgeHash(serial.rowindex(i), serial.colindex(i));
+
+		int64_t roffset = grid->GetRankInProcCol() * (n / grid->GetGridRows());
+		int64_t coffset = grid->GetRankInProcRow() * (n / grid->GetGridCols());
+		SpTuples<int64_t,double> local(*A.seqptr());
+		uint64_t disthash = 0;
+		double weight = 0;
+		for(int64_t i = 0; i < local.getnnz(); ++i)
+		{
+			disthash += EdgeHash(local.rowindex(i) + roffset, local.colindex(i) + coffset);
+			weight += local.numvalue(i);
+		}
+		MPI_Allreduce(MPI_IN_PLACE, &disthash, 1, MPIType<uint64_t>(), MPI_SUM, MPI_COMM_WORLD);
+		MPI_Allreduce(MPI_IN_PLACE, &weight, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+
+		if(A.getnnz() != serial.getnnz() || disthash != serialhash) { ++errors; cout << "fail line " << __LINE__ << endl; }
+		// every generated edge (and its reverse) is accounted for, apart from the removed loops
+		if(weight > 2 * gen.getExpectedEdges() * 1.01 || weight < 2 * gen.getExpectedEdges() * 0.9) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > AT = A;
+		AT.Transpose();
+		if(!(AT == A)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// renaming keeps the power-law degree distribution
+		FullyDistVec<int64_t, double> degrees = A.Reduce(Row, plus<double>(), 0.0, [](double){ return 1.0; });
+		double maxdeg = degrees.Reduce(maximum<double>(), 0.0);
+		if(maxdeg < 10.0 * A.getnnz() / n) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		for(int64_t v = 0; v < n; v += 7)
+			if(gen.Unrename(gen.Rename(v)) != v) { ++errors; cout << "fail line " << __LINE__ << endl; break; }
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Locally generated R-MAT matrix is correct" << endl;
+		else cout << "ERROR: " << errors << " checks of the locally generated R-MAT matrix failed" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+/**
+ * Checks that the row splits of the local matrix cover all rows and nonzeros,
+ * and that no split carries much more than its share of nonzeros
+ * @return the number of violations
+ */
+template <typename DER>
+int CheckSplits(DER & local, int64_t nnz)
+{
+	int errors = 0;
+	const vector<int64_t> & offsets = local.GetSplitOffsets();
+	int splits = local.getnsplit();
+	if(static_cast<int>(offsets.size()) != splits+1 || offsets.front() != 0 || offsets.back() != local.getnrow())
+		return 1;
+
+	int64_t totalweight = nnz + local.getnrow();	// a split weighs its nonzeros plus its rows
+	int64_t splitnnz = 0;
+	int64_t maxrowweight = 1;
+	vector<int64_t> rownnz(local.getnrow(), 0);
+	for(int i=0; i<splits; ++i)
+	{
+		if(offsets[i+1] <= offsets[i]) ++errors;	// every split has at least one row
+		int64_t weight = offsets[i+1] - offsets[i];
+		for(auto colit = local.begcol(i); colit != local.endcol(i); ++colit)
+		{
+			for(auto nzit = local.begnz(colit,i); nzit != local.endnz(colit,i); ++nzit)
+			{
+				++rownnz[offsets[i] + nzit.rowid()];
+				++weight;
+				++splitnnz;
+			}
+		}
+		if(weight > totalweight / splits + 2 * (*max_element(rownnz.begin(), rownnz.end()) + 1))
+			++errors;
+	}
+	if(splitnnz != nnz) ++errors;
+	return errors;
+}
+
+/**
+ * Multiplies the unsplit matrix A and its split copy S with the same sparse vector,
+ * with and without a preallocated SPA
+ * @return the number of differing results
+ */
+template <typename PARMAT>
+int CompareSparseMultiplications(const SpParMat<int64_t, double, SpDCCols<int64_t,double> > & A, PARMAT & S, const FullyDistVec<int64_t, double> & x)
+{
+	typedef PlusTimesSRing<double, double> PTRing;
+	int errors = 0;
+	FullyDistSpVec<int64_t, double> sx(x, [](double v){ return v > 9; });
+	FullyDistSpVec<int64_t, double> sy(A.getcommgrid(), A.getnrow());
+	FullyDistSpVec<int64_t, double> sys(A.getcommgrid(), A.getnrow());
+	FullyDistSpVec<int64_t, double> sysspa(A.getcommgrid(), A.getnrow());
+	SpMV<PTRing>(A, sx, sy, false);
+	SpMV<PTRing>(S, sx, sys, false);
+	PreAllocatedSPA<double> SPA(S.seq());
+	SpMV<PTRing>(S, sx, sysspa, false, SPA);
+	FullyDistVec<int64_t, double> dy(A.getcommgrid(), A.getnrow(), -1.0), dys(A.getcommgrid(), A.getnrow(), -1.0), dysspa(A.getcommgrid(), A.getnrow(), -1.0);
+	dy.Set(sy);
+	dys.Set(sys);
+	dysspa.Set(sysspa);
+	if(sy.getnnz() != sys.getnnz() || !(dy == dys)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	if(sy.getnnz() != sysspa.getnnz() || !(dy == dysspa)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors;
+}
+
+//! Same as CompareSparseMultiplications, plus a dense SpMV (only available for DCSC)
+int CompareMultiplications(const SpParMat<int64_t, double, SpDCCols<int64_t,double> > & A, SpParMat<int64_t, double, SpDCCols<int64_t,double> > & S,
+			   const FullyDistVec<int64_t, double> & x)
+{
+	int errors = 0;
+	FullyDistVec<int64_t, double> y = SpMV< PlusTimesSRing<double, double> >(A, x);
+	FullyDistVec<int64_t, double> ys = SpMV< PlusTimesSRing<double, double> >(S, x);
+	if(!(y == ys)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors + CompareSparseMultiplications(A, S, x);
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./RowSplitTest <Scale> [splits]" << endl;
+			cout << "Compares multithreaded SpMV and SpMSpV on a row split R-MAT matrix of size 2^Scale with the unsplit products" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		int splits = (argc > 2) ? atoi(argv[2]) : 8;
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 16, true, false);
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > G(*DEL, false);
+		delete DEL;
+
+		// integral weights keep the sums exact regardless of the order of accumulation
+		FullyDistVec<int64_t, int64_t> ri(G.getcommgrid()), ci(G.getcommgrid());
+		FullyDistVec<int64_t, double> w(G.getcommgrid());
+		G.Find(ri, ci, w);
+		w.iota(ri.TotalLength(), 0);
+		w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 64 + 1); });
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A(G.getnrow(), G.getncol(), ri, ci, w, false);
+
+		FullyDistVec<int64_t, double> x(A.getcommgrid(), A.getncol(), 0.0);
+		x.iota(A.getncol(), 0.0);
+		x.Apply([](double v){ return static_cast<double>(static_cast<int64_t>(v) % 13); });
+
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > S = A;
+		S.ActivateThreading(splits);
+		errors += CheckSplits(S.seq(), A.seq().getnnz());
+		errors += CompareMultiplications(A, S, x);
+
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > Scopy(S);	// split matrices are deep copied
+		S = A;
+		errors += CompareMultiplications(A, Scopy, x);
+
+		SpParMat<int64_t, double, SpCCols<int64_t,double> > C(A);
+		C.ActivateThreading(splits);
+		errors += CheckSplits(C.seq(), A.seq().getnnz());
+		errors += CompareSparseMultiplications(A, C, x);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Row split products are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between split and unsplit matrices" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
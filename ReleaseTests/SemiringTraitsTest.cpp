@@ -0,0 +1,185 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+/**
+ * Forwards to SR without declaring any trait, so the kernels take their generic paths
+ */
+template <class SR, class T1, class T2, class OUT>
+struct Untagged
+{
+	static OUT id() { return SR::id(); }
+	static bool returnedSAID() { return false; }
+	static MPI_Op mpi_op() { return SR::mpi_op(); }
+	static OUT add(const OUT & arg1, const OUT & arg2) { return SR::add(arg1, arg2); }
+	static OUT multiply(const T1 & arg1, const T2 & arg2) { return SR::multiply(arg1, arg2); }
+	static void axpy(T1 a, const T2 & x, OUT & y) { SR::axpy(a, x, y); }
+};
+
+//! Sums x over the nonzeros of each row, ignoring the matrix values
+struct PatternSumSRing
+{
+	static constexpr bool is_commutative = true;
+	static constexpr bool pattern_only = true;
+	static double id() { return 0; }
+	static bool returnedSAID() { return false; }
+	static MPI_Op mpi_op() { return MPI_SUM; }
+	static double add(const double & arg1, const double & arg2) { return arg1 + arg2; }
+	static double multiply(const double & arg1, const int64_t & arg2) { return static_cast<double>(arg2); }
+	static void axpy(double a, const int64_t & x, double & y) { y += static_cast<double>(x); }
+};
+
+typedef PlusTimesSRing<int64_t, int64_t> PTRing;
+typedef MinPlusSRing<int64_t, int64_t> MPRing;
+typedef LogicalOrAndSRing<bool, int64_t> ORRing;
+typedef Select2ndSRing<double, int64_t, int64_t> S2Ring;
+typedef Select2ndSRing<double, double, double> S2DRing;
+
+static_assert(SemiringTraits<PTRing>::is_commutative && SemiringTraits<PTRing>::has_annihilator && !SemiringTraits<PTRing>::is_idempotent, "plus-times");
+static_assert(!SemiringTraits< PlusTimesSRing<double, double> >::has_annihilator, "0 * inf is not 0");
+static_assert(SemiringTraits<MPRing>::is_idempotent && SemiringTraits<MPRing>::has_annihilator && !SemiringTraits<MPRing>::simd_mul, "min-plus");
+static_assert(SemiringTraits<ORRing>::has_annihilator && SemiringTraits<ORRing>::simd_add && SemiringTraits<ORRing>::simd_mul, "or-and");
+static_assert(SemiringTraits<ORRing>::saturation_tag::value && !SemiringTraits<MPRing>::saturation_tag::value, "only or-and declares an absorbing element");
+static_assert(SemiringTraits<PatternSumSRing>::pattern_only && !SemiringTraits<PatternSumSRing>::simd_add, "declared by the semiring");
+static_assert(SemiringTraits<S2Ring>::pattern_only && !SemiringTraits<S2Ring>::is_commutative, "select2nd");
+static_assert(!SemiringTraits< Untagged<PTRing, int64_t, int64_t, int64_t> >::is_commutative && !SemiringTraits< Untagged<S2Ring, double, int64_t, int64_t> >::pattern_only, "undeclared traits are false");
+
+//! Dense SpMV with a traited semiring and its untagged twin
+template <class SR, class NT, class DER, class XT, class YT>
+int CompareDense(SpParMat<int64_t, NT, DER> & A, const FullyDistVec<int64_t, XT> & x, int line)
+{
+	FullyDistVec<int64_t, YT> y = SpMV<SR>(A, x);
+	FullyDistVec<int64_t, YT> yref = SpMV< Untagged<SR, NT, XT, YT> >(A, x);
+	if(!(y == yref)) { cout << "fail line " << line << endl; return 1; }
+	return 0;
+}
+
+//! Sparse SpMV with a traited semiring and its untagged twin
+template <class SR, class NT, class DER, class XT, class YT>
+int CompareSparse(SpParMat<int64_t, NT, DER> & A, const FullyDistSpVec<int64_t, XT> & x, int line)
+{
+	FullyDistSpVec<int64_t, YT> y(A.getcommgrid(), A.getnrow());
+	FullyDistSpVec<int64_t, YT> yref(A.getcommgrid(), A.getnrow());
+	SpMV<SR>(A, x, y, false);
+	SpMV< Untagged<SR, NT, XT, YT> >(A, x, yref, false);
+	if(!(y == yref) || y.getnnz() != yref.getnnz()) { cout << "fail line " << line << endl; return 1; }
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./SemiringTraitsTest <Scale>" << endl;
+			cout << "Compares the kernels specialized on semiring traits with their generic paths on an R-MAT matrix of size 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 16, true, false);
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > G(*DEL, false);
+		delete DEL;
+
+		// integral weights keep the sums exact regardless of the order of accumulation
+		FullyDistVec<int64_t, int64_t> ri(G.getcommgrid()), ci(G.getcommgrid());
+		FullyDistVec<int64_t, double> w(G.getcommgrid());
+		G.Find(ri, ci, w);
+		w.iota(ri.TotalLength(), 0);
+		w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 64 + 1); });
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A(G.getnrow(), G.getncol(), ri, ci, w, false);
+		SpParMat<int64_t, int64_t, SpDCCols<int64_t,int64_t> > I = A;
+		SpParMat<int64_t, bool, SpDCCols<int64_t,bool> > B = A;
+
+		// two thirds of the entries are the additive identity
+		FullyDistVec<int64_t, int64_t> x(A.getcommgrid(), A.getncol(), 0);
+		x.iota(A.getncol(), 0);
+		x.Apply([](int64_t v){ return (v % 3 == 0) ? v % 11 + 1 : 0; });
+		errors += CompareDense<PTRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(I, x, __LINE__);
+		FullyDistVec<int64_t, int64_t> xinf = x;
+		xinf.Apply([](int64_t v){ return (v == 0) ? numeric_limits<int64_t>::max() : v; });
+		errors += CompareDense<MPRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(I, xinf, __LINE__);
+		errors += CompareDense<ORRing, bool, SpDCCols<int64_t,bool>, int64_t, int64_t>(B, x, __LINE__);
+
+		SpParMat<int64_t, int64_t, SpDCCols<int64_t,int64_t> > S = I;
+		S.ActivateThreading(7);
+		errors += CompareDense<PTRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(S, x, __LINE__);
+		errors += CompareDense<MPRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(S, xinf, __LINE__);
+		SpParMat<int64_t, bool, SpDCCols<int64_t,bool> > SB = B;
+		SB.ActivateThreading(7);
+		errors += CompareDense<ORRing, bool, SpDCCols<int64_t,bool>, int64_t, int64_t>(SB, x, __LINE__);
+
+		// commutative semirings merge the contributions of a dense frontier without the heap
+		FullyDistSpVec<int64_t, int64_t> sx(x, [](int64_t v){ return v > 0; });
+		errors += CompareSparse<PTRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(I, sx, __LINE__);
+		errors += CompareSparse<MPRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(I, sx, __LINE__);
+		errors += CompareSparse<ORRing, bool, SpDCCols<int64_t,bool>, int64_t, int64_t>(B, sx, __LINE__);	// stops at the first true contribution
+		FullyDistSpVec<int64_t, int64_t> thin(x, [](int64_t v){ return v == 5; });
+		errors += CompareSparse<PTRing, int64_t, SpDCCols<int64_t,int64_t>, int64_t, int64_t>(I, thin, __LINE__);
+
+		// pattern only semirings do not decode the values of packed matrices
+		SpParMat<int64_t, double, SpPackedCols<int64_t,double> > P = A;
+		errors += CompareSparse<S2Ring, double, SpPackedCols<int64_t,double>, int64_t, int64_t>(P, sx, __LINE__);
+		errors += CompareDense<PatternSumSRing, double, SpPackedCols<int64_t,double>, int64_t, double>(P, x, __LINE__);
+
+		// ... nor load the values of the left operand of SpGEMM
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > A2 = A;
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > C = Mult_AnXBn_Synch<S2DRing, double, SpDCCols<int64_t,double> >(A, A2);
+		SpParMat<int64_t, double, SpDCCols<int64_t,double> > Cref = Mult_AnXBn_Synch<Untagged<S2DRing, double, double, double>, double, SpDCCols<int64_t,double> >(A, A2);
+		if(!(C == Cref)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Semiring trait specializations are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between specialized and generic kernels" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
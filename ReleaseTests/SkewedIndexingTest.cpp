@@ -0,0 +1,135 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.5 -------------------------------------------------*/
+/* date: 10/09/2015 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc, Adam Lugowski ------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2015, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./SkewedIndexingTest <Scale>" << endl;
+			cout << "Gathers from and scatters into a vector of length 2^Scale with power-law skewed indices" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		shared_ptr<CommGrid> fullWorld;
+		fullWorld.reset( new CommGrid(MPI_COMM_WORLD, 0, 0) );
+		int64_t n = static_cast<int64_t>(1) << atoi(argv[1]);
+
+		// half of the requests go to index 0, a quarter to index 1, ... the rest are uniform
+		FullyDistVec<int64_t,int64_t> ri(fullWorld);
+		ri.iota(4*n, 0);
+		ri.Apply([n](int64_t i){
+			uint64_t h = static_cast<uint64_t>(i) * 0x9E3779B97F4A7C15ULL;
+			int64_t level = __builtin_ctzll((h >> 20) | (1ULL << 40));
+			return level < 8 ? level : static_cast<int64_t>((h >> 24) % n); });
+
+		FullyDistVec<int64_t,int64_t> dense(fullWorld);
+		dense.iota(n, 0);
+		dense.Apply([](int64_t i){ return 3*i + 1; });
+
+		std::unordered_map<int64_t,int64_t> hot;
+		int64_t nhot = dense.ReplicateHot(ri, hot);
+		ostringstream outs;
+		outs << nhot << " hot entries are replicated" << endl;
+		SpParHelper::Print(outs.str());
+		if(nhot == 0)
+		{
+			SpParHelper::Print("ERROR: skewed requests are not detected\n");
+			++errors;
+		}
+
+		FullyDistVec<int64_t,int64_t> gathered = dense(ri, true);
+		FullyDistVec<int64_t,int64_t> expected = ri;
+		expected.Apply([](int64_t i){ return 3*i + 1; });
+		if (gathered == expected && dense(ri) == expected)
+		{
+			SpParHelper::Print("Skewed gather working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in skewed gather, go fix it!\n");	
+			++errors;
+		}
+
+		// scatter-reduce with sum and min, checked against a (non-skewed) dense accumulation
+		FullyDistVec<int64_t,int64_t> ones(fullWorld, ri.TotalLength(), 1);
+		FullyDistSpVec<int64_t,int64_t> counts(n, ri, ones, plus<int64_t>());
+		FullyDistSpVec<int64_t,int64_t> mins(n, ri, expected, [](int64_t a, int64_t b){ return std::min(a,b); });
+
+		vector<int64_t> loccounts(n, 0);
+		const int64_t * pri = ri.GetLocArr();
+		for(int64_t i=0; i < ri.LocArrSize(); ++i)
+			loccounts[pri[i]]++;
+		MPI_Allreduce(MPI_IN_PLACE, loccounts.data(), n, MPIType<int64_t>(), MPI_SUM, MPI_COMM_WORLD);
+		FullyDistVec<int64_t,int64_t> densecounts(fullWorld, n, 0);
+		FullyDistVec<int64_t,int64_t> densemins(fullWorld, n, -1);
+		densecounts.Set(counts);
+		densemins.Set(mins);
+		int correct = (counts.getnnz() == mins.getnnz());
+		const int64_t * pc = densecounts.GetLocArr();
+		const int64_t * pm = densemins.GetLocArr();
+		int64_t offset = densecounts.LengthUntil();
+		for(int64_t i=0; i < densecounts.LocArrSize(); ++i)
+		{
+			if(pc[i] != loccounts[i+offset]) correct = 0;
+			if(pm[i] != (loccounts[i+offset] > 0 ? 3*(i+offset)+1 : -1)) correct = 0;
+		}
+		MPI_Allreduce(MPI_IN_PLACE, &correct, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+		if (correct)
+		{
+			SpParHelper::Print("Skewed scatter-reduce working correctly\n");	
+		}
+		else
+		{
+			SpParHelper::Print("ERROR in skewed scatter-reduce, go fix it!\n");	
+			++errors;
+		}
+	}
+	MPI_Finalize();
+	return errors > 0;
+}
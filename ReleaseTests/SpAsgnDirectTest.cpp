@@ -0,0 +1,168 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef SpParMat < int64_t, double, SpDCCols<int64_t,double> > PSpMat_Double;
+typedef PlusTimesSRing<double, double> PTDOUBLEDOUBLE;
+
+/**
+ * R-MAT matrix of size 2^scale with integral weights that do not depend on the process count
+ */
+PSpMat_Double WeightedRMat(unsigned scale, int64_t seed)
+{
+	double initiator[4] = {.57, .19, .19, .05};
+	DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+	DEL->GenGraph500Data(initiator, scale, 8, true, false);
+	PSpMat_Double G(*DEL, false);
+	delete DEL;
+
+	FullyDistVec<int64_t, int64_t> ri(G.getcommgrid()), ci(G.getcommgrid());
+	FullyDistVec<int64_t, double> w(G.getcommgrid());
+	G.Find(ri, ci, w);
+	w.iota(ri.TotalLength(), 0);
+	w.Apply([seed](double x){ return static_cast<double>(((static_cast<uint64_t>(x) + seed) * 2654435761ULL) % 64 + 1); });
+	return PSpMat_Double(G.getnrow(), G.getncol(), ri, ci, w, false);
+}
+
+/**
+ * A(ri,ci) = B through permutation matrices: hole = S*A*T, then A += R*B*Q
+ */
+void TripleProductSpAsgn(PSpMat_Double & A, const FullyDistVec<int64_t,int64_t> & ri, const FullyDistVec<int64_t,int64_t> & ci, PSpMat_Double & B)
+{
+	int64_t m = A.getnrow(), n = A.getncol();
+	PSpMat_Double S(m, m, ri, ri, 1);
+	PSpMat_Double SA = Mult_AnXBn_DoubleBuff<PTDOUBLEDOUBLE, double, SpDCCols<int64_t,double> >(S, A, true, false);
+	PSpMat_Double T(n, n, ci, ci, 1);
+	PSpMat_Double SAT = Mult_AnXBn_DoubleBuff<PTDOUBLEDOUBLE, double, SpDCCols<int64_t,double> >(SA, T, true, true);
+	A.EWiseMult(SAT, true);
+
+	FullyDistVec<int64_t,int64_t> rvec(ri.getcommgrid());
+	rvec.iota(B.getnrow(), 0);
+	PSpMat_Double R(m, B.getnrow(), ri, rvec, 1);
+	PSpMat_Double RB = Mult_AnXBn_DoubleBuff<PTDOUBLEDOUBLE, double, SpDCCols<int64_t,double> >(R, B, true, false);
+	FullyDistVec<int64_t,int64_t> qvec(ci.getcommgrid());
+	qvec.iota(B.getncol(), 0);
+	PSpMat_Double Q(B.getncol(), n, qvec, ci, 1);
+	PSpMat_Double RBQ = Mult_AnXBn_DoubleBuff<PTDOUBLEDOUBLE, double, SpDCCols<int64_t,double> >(RB, Q, true, true);
+	A += RBQ;
+}
+
+int CompareAssignment(const PSpMat_Double & A, const FullyDistVec<int64_t,int64_t> & ri, const FullyDistVec<int64_t,int64_t> & ci, PSpMat_Double & B, const string & label)
+{
+	PSpMat_Double direct = A;
+	PSpMat_Double reference = A;
+	double t1 = MPI_Wtime();
+	direct.SpAsgn(ri, ci, B);
+	double t2 = MPI_Wtime();
+	TripleProductSpAsgn(reference, ri, ci, B);
+	double t3 = MPI_Wtime();
+
+	ostringstream outs;
+	outs << label << ": " << direct.getnnz() << " nonzeros, direct " << t2 - t1 << " s, triple product " << t3 - t2 << " s";
+	int errors = 0;
+	if(direct.getnnz() != reference.getnnz() || !(direct == reference))
+	{
+		outs << " MISMATCH (" << reference.getnnz() << " nonzeros expected)";
+		errors = 1;
+	}
+	outs << endl;
+	SpParHelper::Print(outs.str());
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./SpAsgnDirectTest <Scale>" << endl;
+			cout << "Compares the direct SpAsgn with the permutation matrix formulation on R-MAT matrices of size 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}
+	int errors = 0;
+	{
+		unsigned scale = static_cast<unsigned>(atoi(argv[1]));
+		PSpMat_Double A = WeightedRMat(scale, 0);
+		PSpMat_Double B = WeightedRMat(scale - 3, 7);
+		PSpMat_Double C = WeightedRMat(scale - 3, 11);
+		int64_t m = A.getnrow(), n = A.getncol();
+		int64_t mb = B.getnrow();
+
+		// scattered distinct rows and columns
+		FullyDistVec<int64_t,int64_t> ri(A.getcommgrid()), ci(A.getcommgrid());
+		ri.iota(mb, 0);
+		ri.Apply([m](int64_t i){ return (i * 37 + 5) % m; });
+		ci.iota(mb, 0);
+		ci.Apply([n](int64_t i){ return (i * 101 + 3) % n; });
+		errors += CompareAssignment(A, ri, ci, B, "scattered block");
+
+		// a contiguous block in the top left corner
+		FullyDistVec<int64_t,int64_t> rc(A.getcommgrid()), cc(A.getcommgrid());
+		rc.iota(mb, 0);
+		cc.iota(mb, 0);
+		errors += CompareAssignment(A, rc, cc, C, "contiguous block");
+
+		// repeated target rows add up the colliding entries
+		FullyDistVec<int64_t,int64_t> rd(A.getcommgrid());
+		rd.iota(mb, 0);
+		rd.Apply([m](int64_t i){ return ((i / 2) * 13 + 1) % m; });
+		errors += CompareAssignment(A, rd, ci, B, "repeated rows");
+
+		// an empty block only prunes
+		PSpMat_Double E(mb, mb, rc, cc, 0.0);
+		E.Prune([](double v){ return v == 0.0; });
+		errors += CompareAssignment(A, ri, ci, E, "empty block");
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Direct SpAsgn matches the triple product formulation" << endl;
+		else cout << "ERROR: " << errors << " assignments differ" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
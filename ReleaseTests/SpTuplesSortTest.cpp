@@ -0,0 +1,122 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.5 -------------------------------------------------*/
+/* date: 10/09/2015 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc, Adam Lugowski ------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2015, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./SpTuplesSortTest <Scale>" << endl;
+			cout << "Sorts 2^Scale random local tuples with the radix sort and checks them against a comparison sort" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		int64_t nnz = static_cast<int64_t>(1) << atoi(argv[1]);
+		int64_t m = nnz / 8 + myrank;	// rectangular and different on every process
+		int64_t n = nnz / 4 + 3;
+
+		SpTuples<int64_t,double> tuples(nnz, m, n);
+		for(int64_t i=0; i < nnz; ++i)
+		{
+			uint64_t h = (static_cast<uint64_t>(myrank) << 40 | i) * 0x9E3779B97F4A7C15ULL;
+			tuples.rowindex(i) = static_cast<int64_t>((h >> 13) % m);
+			tuples.colindex(i) = static_cast<int64_t>((h >> 37) % n);
+			tuples.numvalue(i) = static_cast<double>(i % 7);
+		}
+		SpTuplesSoA<int64_t,double> soa(tuples);
+		vector< tuple<int64_t,int64_t,double> > reference(tuples.tuples, tuples.tuples + nnz);
+
+		// row-major order, with a stable comparison sort as the reference
+		stable_sort(reference.begin(), reference.end(), RowLexiCompare<int64_t,double>());
+		tuples.SortRowBased();
+		soa.SortRowBased();
+		for(int64_t i=0; i < nnz; ++i)
+		{
+			if(!(tuples.tuples[i] == reference[i])) ++errors;
+			if(soa.rows[i] != get<0>(reference[i]) || soa.cols[i] != get<1>(reference[i]) || soa.vals[i] != get<2>(reference[i])) ++errors;
+		}
+
+		// column-major order, then the local matrices built from both layouts must agree
+		stable_sort(reference.begin(), reference.end(), ColLexiCompare<int64_t,double>());
+		tuples.SortColBased();
+		soa.SortColBased();
+		for(int64_t i=0; i < nnz; ++i)
+		{
+			if(!(tuples.tuples[i] == reference[i])) ++errors;
+			if(soa.rows[i] != get<0>(reference[i]) || soa.cols[i] != get<1>(reference[i])) ++errors;
+		}
+		tuples.RemoveDuplicates(plus<double>());
+		soa.RemoveDuplicates(plus<double>());
+		SpDCCols<int64_t,double> fromaos(tuples, false);
+		SpDCCols<int64_t,double> fromsoa(soa);
+		if(!(fromaos == fromsoa) || soa.getnnz() != 0 || soa.rows != NULL) ++errors;
+
+		// unsorted input with duplicates: the conversion sorts and keeps the last of each duplicate
+		SpTuplesSoA<int64_t,double> unsorted(4, m, n);
+		int64_t ur[4] = {2, 0, 2, 1}, uc[4] = {1, 1, 1, 0};
+		double uv[4] = {1.0, 2.0, 3.0, 4.0};
+		copy(ur, ur+4, unsorted.rows);
+		copy(uc, uc+4, unsorted.cols);
+		copy(uv, uv+4, unsorted.vals);
+		SpDCCols<int64_t,double> fromunsorted(unsorted);
+		SpTuples<int64_t,double> expected(3, m, n);
+		expected.tuples[0] = make_tuple(1, 0, 4.0);
+		expected.tuples[1] = make_tuple(0, 1, 2.0);
+		expected.tuples[2] = make_tuple(2, 1, 3.0);
+		if(!(fromunsorted == SpDCCols<int64_t,double>(expected, false))) ++errors;
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Radix sorted tuples are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches in sorted tuples" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef SpParMat<int64_t, double, SpDCCols<int64_t,double> > PARDBMAT;
+
+// EWiseApply instantiates the extended (with null flags) calls as well
+struct MaxOp
+{
+	double operator()(double a, double b) const { return std::max(a, b); }
+	double operator()(double a, double b, bool anull, bool bnull) const { return std::max(a, b); }
+};
+
+struct AlwaysTrue
+{
+	bool operator()(double a, double b) const { return true; }
+	bool operator()(double a, double b, bool anull, bool bnull) const { return true; }
+};
+
+struct DiffOp
+{
+	double operator()(double a, double b) const { return a - b; }
+	double operator()(double a, double b, bool anull, bool bnull) const { return a - b; }
+};
+
+/**
+ * Compares A.Symmetrize() with the transposed-copy formulations it replaces
+ * @return the number of differing results
+ */
+int CompareSymmetrize(const PARDBMAT & A)
+{
+	int errors = 0;
+	PARDBMAT AT = A;
+	AT.Transpose();
+
+	// A += A'
+	PARDBMAT S = A;
+	S.Symmetrize();
+	PARDBMAT R = A;
+	R += AT;
+	if(S.getnnz() != R.getnnz() || !(S == R)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	PARDBMAT ST = S;
+	ST.Transpose();
+	if(!(S == ST)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// A += A' without the loops of A', which keeps the diagonal as it is
+	PARDBMAT L = A;
+	L.Symmetrize(std::plus<double>(), false);
+	PARDBMAT ATL = AT;
+	ATL.RemoveLoops();
+	PARDBMAT RL = A;
+	RL += ATL;
+	if(L.getnnz() != RL.getnnz() || !(L == RL)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	if(A.getnnz() == 0)	// EWiseApply needs nonempty local matrices
+		return errors;
+
+	// max(A, A') on the union of the patterns, values are positive so a missing entry acts as zero
+	PARDBMAT M = A;
+	M.Symmetrize(MaxOp());
+	PARDBMAT RM = EWiseApply<double, SpDCCols<int64_t,double> >(A, AT, MaxOp(), AlwaysTrue(), true, true, 0.0, 0.0, true, false);
+	if(M.getnnz() != RM.getnnz() || !(M == RM)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+	// the operands are passed in (A(i,j), A(j,i)) order: keeping the first operand leaves A's own entries untouched
+	PARDBMAT F = A;
+	F.Symmetrize([](double a, double b){ return a; });
+	PARDBMAT FA = EWiseApply<double, SpDCCols<int64_t,double> >(F, A, DiffOp(), AlwaysTrue(), false, false, 0.0, 0.0, true, false);
+	FA.Prune([](double v){ return v == 0; });
+	if(FA.getnnz() != 0 || F.getnnz() != R.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	return errors;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./SymmetrizeTest <Scale>" << endl;
+			cout << "Compares Symmetrize with A + A' on a weighted directed R-MAT matrix of size 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		double initiator[4] = {.57, .19, .19, .05};
+		DistEdgeList<int64_t> * DEL = new DistEdgeList<int64_t>();
+		DEL->GenGraph500Data(initiator, atoi(argv[1]), 8, true, false);
+		PARDBMAT A(*DEL, false);
+		delete DEL;
+
+		FullyDistVec<int64_t, int64_t> ri(A.getcommgrid()), ci(A.getcommgrid());
+		FullyDistVec<int64_t, double> w(A.getcommgrid());
+		A.Find(ri, ci, w);
+		w.iota(ri.TotalLength(), 0);
+		w.Apply([](double x){ return static_cast<double>((static_cast<uint64_t>(x) * 2654435761ULL) % 1000 + 1); });
+		PARDBMAT W(A.getnrow(), A.getncol(), ri, ci, w, false);
+		errors += CompareSymmetrize(W);
+
+		PARDBMAT E(W);
+		E.Prune([](double v){ return true; });
+		errors += CompareSymmetrize(E);
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Symmetrize results are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between Symmetrize and A + A'" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
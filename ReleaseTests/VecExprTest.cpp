@@ -0,0 +1,139 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include <mpi.h>
+#include <sys/time.h> 
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <vector>
+#include <sstream>
+#include "CombBLAS/CombBLAS.h"
+
+using namespace std;
+using namespace combblas;
+
+typedef FullyDistVec<int64_t, int64_t> DenseVec;
+typedef FullyDistSpVec<int64_t, int64_t> SparseVec;
+
+// Dense view of a sparse vector, with -1 for the missing entries
+DenseVec Densify(const SparseVec & s)
+{
+	DenseVec d(s.getcommgrid(), s.TotalLength(), -1);
+	d.Set(s);
+	return d;
+}
+
+int main(int argc, char* argv[])
+{
+	int nprocs, myrank;
+	MPI_Init(&argc, &argv);
+	MPI_Comm_size(MPI_COMM_WORLD,&nprocs);
+	MPI_Comm_rank(MPI_COMM_WORLD,&myrank);
+
+	if(argc < 2)
+	{
+		if(myrank == 0)
+		{
+			cout << "Usage: ./VecExprTest <Scale>" << endl;
+			cout << "Compares lazy vector expressions with the equivalent Apply/EWiseApply chains on vectors of length 2^Scale" << endl;
+		}
+		MPI_Finalize(); 
+		return -1;
+	}				
+	int errors = 0;
+	{
+		shared_ptr<CommGrid> fullWorld(new CommGrid(MPI_COMM_WORLD, 0, 0));
+		int64_t n = static_cast<int64_t>(1) << atoi(argv[1]);
+		DenseVec a(fullWorld), b(fullWorld), c(fullWorld);
+		a.iota(n, 0);
+		b.iota(n, 0);
+		c.iota(n, 0);
+		a.Apply([](int64_t x){ return static_cast<int64_t>((static_cast<uint64_t>(x) * 2654435761ULL) % 1000); });
+		b.Apply([](int64_t x){ return static_cast<int64_t>((static_cast<uint64_t>(x) * 40503ULL + 7) % 1000); });
+		c.Apply([](int64_t x){ return x % 17; });
+
+		// dense chain: min(a,b) + c
+		DenseVec expected = a;
+		expected.EWiseApply(b, minimum<int64_t>());
+		expected.EWiseApply(c, plus<int64_t>());
+		DenseVec fused(Zip(Zip(Lazy(a), Lazy(b), minimum<int64_t>()), Lazy(c), plus<int64_t>()));
+		if(!(fused == expected)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// the target may appear in its own expression
+		DenseVec aliased = a;
+		aliased = Map(Zip(Lazy(aliased), Lazy(b), minimum<int64_t>()), [](int64_t x){ return 2 * x + 1; });
+		expected = a;
+		expected.EWiseApply(b, minimum<int64_t>());
+		expected.Apply([](int64_t x){ return 2 * x + 1; });
+		if(!(aliased == expected)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// global indices, as in ApplyInd
+		DenseVec indexed(Zip(Lazy(a), LazyIndex(a), [](int64_t x, int64_t i){ return x == i % 1000 ? -1 : x; }));
+		expected = a;
+		expected.ApplyInd([](int64_t x, int64_t i){ return x == i % 1000 ? -1 : x; });
+		if(!(indexed == expected)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// masked conversion to sparse: b where a < 300
+		SparseVec masked(Lazy(b), Map(Lazy(a), [](int64_t x){ return x < 300; }));
+		SparseVec sa(a, [](int64_t x){ return x < 300; });
+		SparseVec unfused = EWiseApply<int64_t>(sa, b, [](int64_t x, int64_t y){ return y; }, [](int64_t x, int64_t y){ return true; }, false, static_cast<int64_t>(0));
+		if(masked.getnnz() != unfused.getnnz() || !(Densify(masked) == Densify(unfused))) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// sparse domain: sa + b at the nonzeros of sa, then scattered into c
+		SparseVec sparsesum(Zip(Lazy(sa), Lazy(b), plus<int64_t>()));
+		unfused = EWiseApply<int64_t>(sa, b, plus<int64_t>(), [](int64_t x, int64_t y){ return true; }, false, static_cast<int64_t>(0));
+		if(sparsesum.getnnz() != sa.getnnz() || !(Densify(sparsesum) == Densify(unfused))) { ++errors; cout << "fail line " << __LINE__ << endl; }
+		SparseVec sparseodd(Lazy(sparsesum), Map(Zip(Lazy(sparsesum), Lazy(sa), minus<int64_t>()), [](int64_t x){ return x % 2 == 1; }));
+		if(sparseodd.getnnz() != Count(Map(Zip(Lazy(sparsesum), Lazy(sa), minus<int64_t>()), [](int64_t x){ return x % 2 == 1; }))) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		DenseVec scattered = c;
+		scattered.Set(Map(Zip(Lazy(sa), Lazy(b), plus<int64_t>()), [](int64_t x){ return -x; }));
+		expected = c;
+		unfused.Apply([](int64_t x){ return -x; });
+		expected.Set(unfused);
+		if(!(scattered == expected)) { ++errors; cout << "fail line " << __LINE__ << endl; }
+
+		// reductions
+		expected = a;
+		expected.EWiseApply(b, [](int64_t x, int64_t y){ return static_cast<int64_t>(x != y); });
+		if(Reduce(Zip(Lazy(a), Lazy(b), [](int64_t x, int64_t y){ return static_cast<int64_t>(x != y); }), plus<int64_t>(), static_cast<int64_t>(0)) != expected.Reduce(plus<int64_t>(), static_cast<int64_t>(0)))
+			{ ++errors; cout << "fail line " << __LINE__ << endl; }
+		if(Reduce(Lazy(sparsesum), maximum<int64_t>(), static_cast<int64_t>(0)) != unfused.Reduce(minimum<int64_t>(), static_cast<int64_t>(0)) * -1)
+			{ ++errors; cout << "fail line " << __LINE__ << endl; }
+		if(Count(Map(Lazy(a), [](int64_t x){ return x < 300; })) != sa.getnnz()) { ++errors; cout << "fail line " << __LINE__ << endl; }
+	}
+	MPI_Allreduce(MPI_IN_PLACE, &errors, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	if(myrank == 0)
+	{
+		if(errors == 0) cout << "Lazy vector expressions are correct" << endl;
+		else cout << "ERROR: " << errors << " mismatches between lazy and eager vector operations" << endl;
+	}
+	MPI_Finalize();
+	return (errors == 0) ? 0 : 1;
+}
@@ -36,6 +36,7 @@
 #include "MPIType.h"
 #include "Friends.h"
 #include "OptBuf.h"
+#include "IndexCodec.h"
 #include "ParFriends.h"
 #include "BitMap.h"
 #include "BitMapCarousel.h"
@@ -68,17 +69,14 @@ void dcsc_gespmv_threaded_setbuffers (const SpDCCols<IT, bool> & A, const int32_
 			std::vector< std::vector<int32_t> > indy(splits);
 			std::vector< std::vector< VT > > numy(splits);
 			int32_t nlocrows = static_cast<int32_t>(A.getnrow());
-			int32_t perpiece = nlocrows / splits;
+			const std::vector<IT> & offsets = A.GetSplitOffsets();
 			
 			#ifdef _OPENMP
-			#pragma omp parallel for 
+			#pragma omp parallel for schedule(static)
 			#endif
 			for(int i=0; i<splits; ++i)
 			{
-				if(i != splits-1)
-					SpMXSpV_ForThreading<BFSsring>(*(A.GetDCSC(i)), perpiece, indx, numx, nnzx, indy[i], numy[i], i*perpiece);
-				else
-					SpMXSpV_ForThreading<BFSsring>(*(A.GetDCSC(i)), nlocrows - perpiece*i, indx, numx, nnzx, indy[i], numy[i], i*perpiece);
+				SpMXSpV_ForThreading<BFSsring>(*(A.GetDCSC(i)), static_cast<int32_t>(offsets[i+1] - offsets[i]), indx, numx, nnzx, indy[i], numy[i], static_cast<int32_t>(offsets[i]));
 			}
 			
 			int32_t perproc = nlocrows / p_c;	
@@ -376,7 +374,7 @@ FullyDistSpVec<IT,VT>  SpMV (const SpParMat<IT,bool,UDER> & A, const FullyDistSp
 #endif
 	if(optbuf.totmax > 0 )	// graph500 optimization enabled
 	{
-        MPI_Alltoallv(optbuf.inds, sendcnt, optbuf.dspls, MPIType<int32_t>(), recvindbuf, recvcnt, rdispls, MPIType<int32_t>(), RowWorld);  
+        IndexCodec::Alltoallv(optbuf.inds, sendcnt, optbuf.dspls, recvindbuf, recvcnt, rdispls, RowWorld);
 		MPI_Alltoallv(optbuf.nums, sendcnt, optbuf.dspls, MPIType<VT>(), recvnumbuf, recvcnt, rdispls, MPIType<VT>(), RowWorld);  
 		delete [] sendcnt;
 	}
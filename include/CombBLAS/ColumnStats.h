@@ -0,0 +1,98 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _COLUMN_STATS_H_
+#define _COLUMN_STATS_H_
+
+#include <mpi.h>
+#include <stdint.h>
+#include <algorithm>
+#include <limits>
+
+namespace combblas {
+
+/**
+ * Statistics of one matrix column gathered in a single pass, see SpParMat::ColumnStatsApply
+ * sum, sumsq, max and nnz describe the values before the pass, appliedsum is the sum of the values it wrote
+ */
+template <class NT>
+struct ColumnStats
+{
+	NT sum;
+	NT sumsq;
+	NT max;
+	NT appliedsum;
+	int64_t nnz;
+
+	ColumnStats(): sum(0), sumsq(0), max(std::numeric_limits<NT>::lowest()), appliedsum(0), nnz(0) {}
+
+	void Add(const NT & before, const NT & after)
+	{
+		sum += before;
+		sumsq += before * before;
+		max = std::max(max, before);
+		appliedsum += after;
+		++nnz;
+	}
+
+	void Merge(const ColumnStats<NT> & rhs)
+	{
+		sum += rhs.sum;
+		sumsq += rhs.sumsq;
+		max = std::max(max, rhs.max);
+		appliedsum += rhs.appliedsum;
+		nnz += rhs.nnz;
+	}
+
+	static MPI_Op mpi_op()
+	{
+		static MPI_Op mpiop;
+		static bool exists = false;
+		if (exists)
+			return mpiop;
+		else
+		{
+			MPI_Op_create(MPI_func, true, &mpiop);
+			exists = true;
+			return mpiop;
+		}
+	}
+
+	static void MPI_func(void * invec, void * inoutvec, int * len, MPI_Datatype *datatype)
+	{
+		const ColumnStats<NT> * in = static_cast<const ColumnStats<NT> *>(invec);
+		ColumnStats<NT> * inout = static_cast<ColumnStats<NT> *>(inoutvec);
+		for (int i = 0; i < *len; ++i)
+			inout[i].Merge(in[i]);
+	}
+};
+
+}
+
+#endif
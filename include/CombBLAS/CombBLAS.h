@@ -117,21 +117,29 @@ class EWiseExtToPlainAdapter
 };
 
 #include "SpDefs.h"
+#include "KernelProfiler.h"
 #include "BitMap.h"
 #include "SpTuples.h"
+#include "SpTuplesSoA.h"
 #include "SpDCCols.h"
 #include "SpCCols.h"
+#include "SpPackedCols.h"
+#include "SpPatternCols.h"
 #include "SpParMat.h"
 #include "SpParMat3D.h"
 #include "FullyDistVec.h"
 #include "FullyDistSpVec.h"
+#include "FullyDistRMAVec.h"
+#include "DynamicSpParMat.h"
 #include "VecIterator.h"
 #include "PreAllocatedSPA.h"
 #include "ParFriends.h"
 #include "BlockSpGEMM.h"
 #include "BFSFriends.h"
 #include "DistEdgeList.h"
+#include "RMatGenerator.h"
 #include "Semirings.h"
+#include "SemiringTraits.h"
 #include "Operations.h"
 #include "MPIOp.h"
 #include "MPIType.h"
@@ -0,0 +1,157 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _DCSC_COL_INDEX_H_
+#define _DCSC_COL_INDEX_H_
+
+#include <stdint.h>
+#include <vector>
+#include "SpDefs.h"
+
+namespace combblas {
+
+/**
+ * O(1) lookup of a column id in the jc array of a Dcsc, replacing the chunked aux array (ConstructAux/AuxIndex)
+ * The representation is chosen by the fraction of nonempty columns:
+ *	- dense jump table (one entry per column) when at least 1/COLINDEXDENSE of the columns are nonempty
+ *	- bitmap over the columns plus a rank count per 64-bit word when at least 1/COLINDEXBITMAP of them are
+ *	- open addressing hash table of positions into jc otherwise (hypersparse blocks)
+ * The index refers to jc and has to be rebuilt whenever the Dcsc changes (see SpDCCols::ColumnIndex)
+ */
+template <class IT>
+class DcscColIndex
+{
+public:
+	enum IndexKind { DENSE, BITMAP, HASH };
+
+	//! Index of an empty (NULL) Dcsc, every lookup misses
+	DcscColIndex(): jc(NULL), nzc(0), ndim(0), kind(HASH), hashbits(0) {}
+
+	DcscColIndex(const IT * jc, IT nzc, IT ndim): jc(jc), nzc(nzc), ndim(ndim), hashbits(0)
+	{
+		if(static_cast<double>(nzc) * COLINDEXDENSE >= static_cast<double>(ndim))
+		{
+			kind = DENSE;
+			positions.assign(ndim, nzc);
+			for(IT i=0; i< nzc; ++i)
+				positions[jc[i]] = i;
+		}
+		else if(static_cast<double>(nzc) * COLINDEXBITMAP >= static_cast<double>(ndim))
+		{
+			kind = BITMAP;
+			IT nwords = (ndim + 63) / 64;
+			bits.assign(nwords, 0);
+			ranks.resize(nwords);
+			for(IT i=0; i< nzc; ++i)
+				bits[jc[i] >> 6] |= (static_cast<uint64_t>(1) << (jc[i] & 63));
+			IT rank = 0;
+			for(IT w=0; w< nwords; ++w)
+			{
+				ranks[w] = rank;
+				rank += static_cast<IT>(__builtin_popcountll(bits[w]));
+			}
+		}
+		else
+		{
+			kind = HASH;
+			IT tablesize = 1;
+			while(tablesize < 2*nzc)
+			{
+				tablesize <<= 1;
+				++hashbits;
+			}
+			positions.assign(tablesize, nzc);	// nzc marks an empty slot
+			for(IT i=0; i< nzc; ++i)
+			{
+				IT slot = Hash(jc[i]);
+				while(positions[slot] != nzc)
+					slot = (slot + 1) & (tablesize - 1);
+				positions[slot] = i;
+			}
+		}
+	}
+
+	//! Returns the position of colind in jc, found is false if the column is empty
+	IT Find(IT colind, bool & found) const
+	{
+		IT pos = nzc;
+		if(nzc == 0)
+		{
+			found = false;
+			return pos;
+		}
+		if(kind == DENSE)
+		{
+			pos = positions[colind];
+		}
+		else if(kind == BITMAP)
+		{
+			uint64_t word = bits[colind >> 6];
+			uint64_t bit = static_cast<uint64_t>(1) << (colind & 63);
+			if(word & bit)
+				pos = ranks[colind >> 6] + static_cast<IT>(__builtin_popcountll(word & (bit - 1)));
+		}
+		else
+		{
+			IT mask = static_cast<IT>(positions.size()) - 1;
+			for(IT slot = Hash(colind); positions[slot] != nzc; slot = (slot + 1) & mask)
+			{
+				if(jc[positions[slot]] == colind)
+				{
+					pos = positions[slot];
+					break;
+				}
+			}
+		}
+		found = (pos != nzc);
+		return pos;
+	}
+
+	IndexKind Kind() const { return kind; }
+
+private:
+	IT Hash(IT colind) const
+	{
+		if(hashbits == 0) return 0;
+		return static_cast<IT>((static_cast<uint64_t>(colind) * 0x9E3779B97F4A7C15ULL) >> (64 - hashbits));
+	}
+
+	const IT * jc;
+	IT nzc;
+	IT ndim;
+	IndexKind kind;
+	int hashbits;
+	std::vector<IT> positions;	// DENSE: indexed by column id, HASH: slots, nzc means absent
+	std::vector<uint64_t> bits;
+	std::vector<IT> ranks;		// number of nonempty columns before each word of bits
+};
+
+}
+
+#endif
@@ -0,0 +1,189 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "DynamicSpParMat.h"
+
+namespace combblas {
+
+template <class IT, class NT, class DER>
+DynamicSpParMat<IT,NT,DER>::DynamicSpParMat (const SpParMat<IT,NT,DER> & rhs, double thres)
+: A(rhs), threshold(thres)
+{
+	total_m = A.getnrow();
+	total_n = A.getncol();
+}
+
+//! Start from an empty total_m x total_n matrix
+template <class IT, class NT, class DER>
+DynamicSpParMat<IT,NT,DER>::DynamicSpParMat (std::shared_ptr<CommGrid> grid, IT nrow, IT ncol, double thres)
+: A(nrow, ncol, FullyDistVec<IT,IT>(grid), FullyDistVec<IT,IT>(grid), FullyDistVec<IT,NT>(grid)), total_m(nrow), total_n(ncol), threshold(thres)
+{
+}
+
+
+/**
+ * Ships the updates to their owners and appends the received ones to the local delta
+ * Compacts if the local delta grew beyond the threshold
+ * @param[in,out] data {updates bucketed by owner processor, cleared upon exit}
+ **/
+template <class IT, class NT, class DER>
+void DynamicSpParMat<IT,NT,DER>::Exchange(std::vector< std::vector<DeltaEntry> > & data)
+{
+	std::shared_ptr<CommGrid> commGrid = A.getcommgrid();
+	int nprocs = commGrid->GetSize();
+	int * sendcnt = new int[nprocs];
+	int * recvcnt = new int[nprocs];
+	for(int i=0; i<nprocs; ++i)
+		sendcnt[i] = data[i].size();
+
+	MPI_Alltoall(sendcnt, 1, MPI_INT, recvcnt, 1, MPI_INT, commGrid->GetWorld()); // share the counts
+	int * sdispls = new int[nprocs]();
+	int * rdispls = new int[nprocs]();
+	std::partial_sum(sendcnt, sendcnt+nprocs-1, sdispls+1);
+	std::partial_sum(recvcnt, recvcnt+nprocs-1, rdispls+1);
+	IT totrecv = std::accumulate(recvcnt,recvcnt+nprocs, static_cast<IT>(0));
+	IT totsent = std::accumulate(sendcnt,sendcnt+nprocs, static_cast<IT>(0));
+	assert((totsent < std::numeric_limits<int>::max()));
+	assert((totrecv < std::numeric_limits<int>::max()));
+
+	DeltaEntry * senddata = new DeltaEntry[totsent];
+	for(int i=0; i<nprocs; ++i)
+	{
+		std::copy(data[i].begin(), data[i].end(), senddata+sdispls[i]);
+		std::vector<DeltaEntry>().swap(data[i]);	// clear memory
+	}
+	MPI_Datatype MPI_delta;
+	MPI_Type_contiguous(sizeof(DeltaEntry), MPI_CHAR, &MPI_delta);
+	MPI_Type_commit(&MPI_delta);
+
+	// received updates are ordered by the sending processor, which defines the order of conflicting updates
+	size_t oldsize = delta.size();
+	delta.resize(oldsize + totrecv);
+	MPI_Alltoallv(senddata, sendcnt, sdispls, MPI_delta, delta.data() + oldsize, recvcnt, rdispls, MPI_delta, commGrid->GetWorld());
+
+	DeleteAll(senddata, sendcnt, recvcnt, sdispls, rdispls);
+	MPI_Type_free(&MPI_delta);
+
+	if(static_cast<double>(delta.size()) > threshold * static_cast<double>(A.getlocalnnz()))
+		Compact();
+}
+
+//! Updates are validated when they are buffered, since Compact() merges them without further checks
+template <class IT, class NT, class DER>
+void DynamicSpParMat<IT,NT,DER>::CheckIndex(IT row, IT col) const
+{
+	if(row < 0 || row >= total_m || col < 0 || col >= total_n)
+	{
+		std::cout << "Update (" << row << "," << col << ") is outside the " << total_m << " x " << total_n << " dynamic matrix" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+	}
+}
+
+/**
+ * Insert a batch of (rows[k], cols[k], vals[k]) triples, which can be different on every processor
+ * \remarks Collective call, every processor must participate (possibly with an empty batch)
+ **/
+template <class IT, class NT, class DER>
+void DynamicSpParMat<IT,NT,DER>::Insert(const std::vector<IT> & rows, const std::vector<IT> & cols, const std::vector<NT> & vals)
+{
+	assert(rows.size() == cols.size() && cols.size() == vals.size());
+	int nprocs = A.getcommgrid()->GetSize();
+	std::vector< std::vector<DeltaEntry> > data(nprocs);
+	for(size_t k=0; k<rows.size(); ++k)
+	{
+		CheckIndex(rows[k], cols[k]);
+		DeltaEntry entry;
+		int owner = A.Owner(total_m, total_n, rows[k], cols[k], entry.row, entry.col);
+		entry.val = vals[k];
+		entry.remove = false;
+		data[owner].push_back(entry);
+	}
+	Exchange(data);
+}
+
+/**
+ * Delete a batch of (rows[k], cols[k]) entries, which can be different on every processor
+ * \remarks Collective call, every processor must participate (possibly with an empty batch)
+ **/
+template <class IT, class NT, class DER>
+void DynamicSpParMat<IT,NT,DER>::Delete(const std::vector<IT> & rows, const std::vector<IT> & cols)
+{
+	assert(rows.size() == cols.size());
+	int nprocs = A.getcommgrid()->GetSize();
+	std::vector< std::vector<DeltaEntry> > data(nprocs);
+	for(size_t k=0; k<rows.size(); ++k)
+	{
+		CheckIndex(rows[k], cols[k]);
+		DeltaEntry entry;
+		int owner = A.Owner(total_m, total_n, rows[k], cols[k], entry.row, entry.col);
+		entry.val = NT();
+		entry.remove = true;
+		data[owner].push_back(entry);
+	}
+	Exchange(data);
+}
+
+
+/**
+ * Merge the local delta into the local matrix
+ * The delta is sorted (stably, so that later updates win), reduced to the last update of each entry,
+ * and merged straight into the local matrix: insertions overwrite, deletions drop the matching nonzero
+ **/
+template <class IT, class NT, class DER>
+void DynamicSpParMat<IT,NT,DER>::Compact()
+{
+	if(delta.empty()) return;
+
+	std::stable_sort(delta.begin(), delta.end(), [](const DeltaEntry & a, const DeltaEntry & b)
+		{ return (a.col < b.col) || (a.col == b.col && a.row < b.row); });
+
+	// only the last update to each entry matters
+	std::vector< std::tuple<LocalIT,LocalIT,NT> > updates;
+	std::unique_ptr<bool[]> remove(new bool[delta.size()]);
+	for(size_t i=0; i<delta.size(); ++i)
+	{
+		if(i+1 < delta.size() && delta[i+1].col == delta[i].col && delta[i+1].row == delta[i].row)
+			continue;
+		remove[updates.size()] = delta[i].remove;
+		updates.push_back(std::make_tuple(delta[i].row, delta[i].col, delta[i].val));
+	}
+	std::vector<DeltaEntry>().swap(delta);
+
+	A.spSeq->MergeSortedTuples(updates.data(), static_cast<LocalIT>(updates.size()), [](NT oldval, NT newval){ return newval; }, remove.get());
+}
+
+template <class IT, class NT, class DER>
+IT DynamicSpParMat<IT,NT,DER>::getpending() const
+{
+	IT locpending = delta.size();
+	IT totpending = 0;
+	MPI_Allreduce( &locpending, &totpending, 1, MPIType<IT>(), MPI_SUM, A.getcommgrid()->GetWorld());
+	return totpending;
+}
+
+}
@@ -0,0 +1,100 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#ifndef _DYNAMIC_SP_PAR_MAT_H_
+#define _DYNAMIC_SP_PAR_MAT_H_
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include <mpi.h>
+
+#include "SpParMat.h"
+#include "SpTuples.h"
+#include "CommGrid.h"
+#include "MPIType.h"
+#include "CombBLAS.h"
+
+namespace combblas {
+
+/**
+  * A 2D distributed sparse matrix that accepts batches of edge insertions and deletions
+  * Updates can be issued from any processor. They are routed to the owner of the (i,j) block with
+  * a single all-to-all per batch and logged in a small per-processor delta (an unsorted COO log).
+  * The delta is merged into the local DER lazily, which is a purely local operation:
+  *    - eagerly, once the local delta exceeds threshold * (local nonzeros)
+  *    - on demand, whenever the base matrix is read through Mat()
+  * Therefore, all existing kernels (SpMV, SpGEMM, ...) work on Mat() unchanged and always see base plus delta.
+  * Semantics: an insertion of an existing entry overwrites its value, a deletion of a missing entry is a no-op
+  * Within a batch, updates to the same entry are applied in the order of (sending processor, position in the batch)
+  */
+template <class IT, class NT, class DER>
+class DynamicSpParMat
+{
+public:
+	typedef typename DER::LocalIT LocalIT;
+
+	DynamicSpParMat (const SpParMat<IT,NT,DER> & A, double threshold = 0.1);
+	DynamicSpParMat (std::shared_ptr<CommGrid> grid, IT total_m, IT total_n, double threshold = 0.1);
+
+	void Insert(const std::vector<IT> & rows, const std::vector<IT> & cols, const std::vector<NT> & vals);
+	void Delete(const std::vector<IT> & rows, const std::vector<IT> & cols);
+
+	void Compact();		//!< merges the local delta into the local matrix (no communication)
+	SpParMat<IT,NT,DER> & Mat() { if(!delta.empty()) Compact(); return A; }	//!< the up-to-date matrix (compacts only if updates are pending)
+
+	IT getnrow() const { return total_m; }
+	IT getncol() const { return total_n; }
+	IT getpending() const;		//!< global number of updates that are not merged yet
+
+	void SetThreshold(double thres) { threshold = thres; }
+
+private:
+	struct DeltaEntry
+	{
+		LocalIT row;
+		LocalIT col;
+		NT val;
+		bool remove;
+	};
+
+	void Exchange(std::vector< std::vector<DeltaEntry> > & data);
+	void CheckIndex(IT row, IT col) const;
+
+	SpParMat<IT,NT,DER> A;
+	IT total_m;
+	IT total_n;
+	double threshold;
+	std::vector<DeltaEntry> delta;
+};
+
+}
+
+#include "DynamicSpParMat.cpp"
+
+#endif
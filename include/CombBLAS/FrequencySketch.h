@@ -0,0 +1,129 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _FREQUENCY_SKETCH_H_
+#define _FREQUENCY_SKETCH_H_
+
+#include <mpi.h>
+#include <stdint.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "MPIType.h"
+#include "SpDefs.h"
+
+namespace combblas {
+
+/**
+ * Count-min sketch over global vector indices, used to find the hot indices of
+ * skewed gathers and scatters (e.g. the root of a giant component in label propagation).
+ * Estimates never underestimate the true count. Index spaces that fit into the sketch
+ * are counted exactly.
+ */
+template <class IT>
+class CountMinSketch
+{
+public:
+	CountMinSketch(IT universe, IT maxwidth = HOTSKETCHWIDTH, int maxdepth = 2)
+	{
+		exact = (universe <= maxwidth);
+		width = exact ? std::max(universe, static_cast<IT>(1)) : maxwidth;
+		depth = exact ? 1 : maxdepth;
+		counters.resize(width * depth, 0);
+	}
+
+	void Add(IT key, IT count = 1)
+	{
+		for(int r = 0; r < depth; ++r)
+			counters[r * width + Hash(key, r)] += count;
+	}
+
+	//! Sums the counters of all processes, after which Estimate() reports global counts
+	void AllReduce(MPI_Comm World)
+	{
+		MPI_Allreduce(MPI_IN_PLACE, counters.data(), static_cast<int>(counters.size()), MPIType<IT>(), MPI_SUM, World);
+	}
+
+	IT Estimate(IT key) const
+	{
+		IT est = counters[Hash(key, 0)];
+		for(int r = 1; r < depth; ++r)
+			est = std::min(est, counters[r * width + Hash(key, r)]);
+		return est;
+	}
+
+	IT Width() const { return width; }
+
+private:
+	IT Hash(IT key, int row) const
+	{
+		if(exact) return key;
+		static const uint64_t mult[4] = {0x9E3779B97F4A7C15ULL, 0xC2B2AE3D27D4EB4FULL, 0x165667B19E3779F9ULL, 0xD6E8FEB86659FD93ULL};
+		uint64_t h = static_cast<uint64_t>(key) * mult[row & 3];
+		return static_cast<IT>((h >> 32) % static_cast<uint64_t>(width));
+	}
+
+	bool exact;
+	IT width;
+	int depth;
+	std::vector<IT> counters;
+};
+
+
+/**
+ * Finds the owners that serve far more than their share of a gather or scatter
+ * @param[in] sendcnt: number of requests this process sends to each owner
+ * @param[out] load: total number of requests served by each owner
+ * @return the number of overloaded owners (more than HOTOWNERFACTOR times the average and at least HOTMINLOAD requests)
+ */
+template <class IT>
+int OverloadedOwners(MPI_Comm World, const std::vector<IT> & sendcnt, std::vector<IT> & load, std::vector<bool> & overloaded)
+{
+	int nprocs = static_cast<int>(sendcnt.size());
+	load = sendcnt;
+	MPI_Allreduce(MPI_IN_PLACE, load.data(), nprocs, MPIType<IT>(), MPI_SUM, World);
+	IT total = std::accumulate(load.begin(), load.end(), static_cast<IT>(0));
+	double average = static_cast<double>(total) / nprocs;
+
+	int noverloaded = 0;
+	overloaded.assign(nprocs, false);
+	for(int i = 0; i < nprocs; ++i)
+	{
+		if(load[i] >= HOTMINLOAD && load[i] > HOTOWNERFACTOR * average)
+		{
+			overloaded[i] = true;
+			++noverloaded;
+		}
+	}
+	return noverloaded;
+}
+
+}
+
+#endif
@@ -41,6 +41,7 @@
 #include "Compare.h"
 #include "CombBLAS.h"
 #include "PreAllocatedSPA.h"
+#include "SemiringTraits.h"
 
 namespace combblas {
 
@@ -53,6 +54,12 @@ class SpDCCols;
 template <class IU, class NU>	
 class Dcsc;
 
+template <class IU, class NU>	
+class SpPackedCols;
+
+template <class IU>	
+class SpPatternCols;
+
 /*************************************************************************************************/
 /**************************** SHARED ADDRESS SPACE FRIEND FUNCTIONS ******************************/
 /****************************** MULTITHREADED LOGIC ALSO GOES HERE *******************************/
@@ -68,11 +75,9 @@ void dcsc_gespmv (const SpDCCols<IU, NU> & A, const RHS * x, LHS * y)
 		for(IU j =0; j<A.dcsc->nzc; ++j)	// for all nonzero columns
 		{
 			IU colid = A.dcsc->jc[j];
-			for(IU i = A.dcsc->cp[j]; i< A.dcsc->cp[j+1]; ++i)
-			{
-				IU rowid = A.dcsc->ir[i];
-				SR::axpy(A.dcsc->numx[i], x[colid], y[rowid]);
-			}
+			if(IsAnnihilator<SR>(x[colid])) continue;
+			IU beg = A.dcsc->cp[j];
+			ColumnAxpy<SR>(A.dcsc->ir + beg, A.dcsc->numx + beg, A.dcsc->cp[j+1] - beg, x[colid], y);
 		}
 	}
 }
@@ -111,17 +116,15 @@ void dcsc_gespmv_threaded_nosplit (const SpDCCols<IU, NU> & A, const RHS * x, LH
 			LHS * loc2merge = tomerge[curthread];
 
 			IU colid = A.dcsc->jc[j];
-			for(IU i = A.dcsc->cp[j]; i< A.dcsc->cp[j+1]; ++i)
-			{
-				IU rowid = A.dcsc->ir[i];
-				SR::axpy(A.dcsc->numx[i], x[colid], loc2merge[rowid]);
-			}
+			if(IsAnnihilator<SR>(x[colid])) continue;
+			IU beg = A.dcsc->cp[j];
+			ColumnAxpy<SR>(A.dcsc->ir + beg, A.dcsc->numx + beg, A.dcsc->cp[j+1] - beg, x[colid], loc2merge);
 		}
 
 		#pragma omp parallel for
 		for(IU j=0; j < nlocrows; ++j)
 		{
-			for(int i=0; i< nthreads; ++i)
+			for(int i=0; i< nthreads && !IsSaturated<SR>(y[j]); ++i)
 			{
 				y[j] = SR::add(y[j], tomerge[i][j]);
 			}
@@ -141,28 +144,27 @@ void dcsc_gespmv_threaded_nosplit (const SpDCCols<IU, NU> & A, const RHS * x, LH
     {
         if(A.nnz > 0)
         {
+            KERNELPROFILE_SCOPE("dcsc_gespmv_threaded");
+            // every nonzero is read once, x is read at most once and y is updated in place
+            KERNELPROFILE_WORK(2.0 * A.nnz, static_cast<double>(A.nnz) * (sizeof(IU) + sizeof(NU)) + static_cast<double>(A.getncol()) * sizeof(RHS)
+                               + 2.0 * A.getnrow() * sizeof(LHS));
             int splits = A.getnsplit();
             if(splits > 0)
             {
-                IU nlocrows = A.getnrow();
-                IU perpiece = nlocrows / splits;
-                std::vector<int> disp(splits, 0);
-                for(int i=1; i<splits; ++i)
-                    disp[i] = disp[i-1] + perpiece;
+                const std::vector<IU> & disp = A.GetSplitOffsets();
 #ifdef _OPENMP
-#pragma omp parallel for
+#pragma omp parallel for schedule(static)	// same schedule as RowSplit, so threads touch their own pages
 #endif
                 for(int s=0; s<splits; ++s)
                 {
                     Dcsc<IU, NU> * dcsc = A.GetInternal(s);
+                    LHS * ysplit = y + disp[s];
                     for(IU j =0; j<dcsc->nzc; ++j)    // for all nonzero columns
                     {
                         IU colid = dcsc->jc[j];
-                        for(IU i = dcsc->cp[j]; i< dcsc->cp[j+1]; ++i)
-                        {
-                            IU rowid = dcsc->ir[i] + disp[s];
-                            SR::axpy(dcsc->numx[i], x[colid], y[rowid]);
-                        }
+                        if(IsAnnihilator<SR>(x[colid])) continue;
+                        IU beg = dcsc->cp[j];
+                        ColumnAxpy<SR>(dcsc->ir + beg, dcsc->numx + beg, dcsc->cp[j+1] - beg, x[colid], ysplit);
                     }
                 }
             }
@@ -174,6 +176,148 @@ void dcsc_gespmv_threaded_nosplit (const SpDCCols<IU, NU> & A, const RHS * x, LH
     }
 
 
+//! SpMV with dense vector on a packed matrix
+template <typename SR, typename IU, typename NU, typename RHS, typename LHS>
+void dcsc_gespmv (const SpPackedCols<IU, NU> & A, const RHS * x, LHS * y)
+{
+	if(A.getnnz() > 0)
+	{
+		auto pdcsc = A.GetPackedDcsc();
+		for(IU j =0; j<pdcsc->nzc; ++j)	// for all nonzero columns
+		{
+			const RHS & xval = x[pdcsc->jc[j]];
+			if(IsAnnihilator<SR>(xval)) continue;
+			pdcsc->ForColumn(j, [&](IU rowid, NU aval){ SR::axpy(aval, xval, y[rowid]); }, typename SemiringTraits<SR>::pattern_tag());
+		}
+	}
+}
+
+//! SpMV with dense vector on a packed matrix (multithreaded version)
+template <typename SR, typename IU, typename NU, typename RHS, typename LHS>
+void dcsc_gespmv_threaded (const SpPackedCols<IU, NU> & A, const RHS * x, LHS * y)
+{
+	if(A.getnnz() > 0)
+	{
+		int nthreads=1;
+		#ifdef _OPENMP
+		#pragma omp parallel
+		{
+			nthreads = omp_get_num_threads();
+		}
+		#endif
+		if(nthreads == 1)
+		{
+			dcsc_gespmv<SR>(A, x, y);
+			return;
+		}
+
+		IU nlocrows =  A.getnrow();
+		LHS ** tomerge = SpHelper::allocate2D<LHS>(nthreads, nlocrows);
+		auto id = SR::id();
+		for(int i=0; i<nthreads; ++i)
+		{
+			std::fill_n(tomerge[i], nlocrows, id);
+		}
+
+		auto pdcsc = A.GetPackedDcsc();
+		#pragma omp parallel for schedule(dynamic, 64)
+		for(IU j =0; j<pdcsc->nzc; ++j)	// for all nonzero columns
+		{
+			int curthread = 0;
+			#ifdef _OPENMP
+			curthread = omp_get_thread_num();
+			#endif
+			LHS * loc2merge = tomerge[curthread];
+			const RHS & xval = x[pdcsc->jc[j]];
+			if(IsAnnihilator<SR>(xval)) continue;
+			pdcsc->ForColumn(j, [&](IU rowid, NU aval){ SR::axpy(aval, xval, loc2merge[rowid]); }, typename SemiringTraits<SR>::pattern_tag());
+		}
+
+		#pragma omp parallel for
+		for(IU j=0; j < nlocrows; ++j)
+		{
+			for(int i=0; i< nthreads && !IsSaturated<SR>(y[j]); ++i)
+			{
+				y[j] = SR::add(y[j], tomerge[i][j]);
+			}
+		}
+		SpHelper::deallocate2D(tomerge, nthreads);
+	}
+}
+
+
+//! SpMV with dense vector on a pattern matrix, every nonzero is an implicit true
+template <typename SR, typename IU, typename RHS, typename LHS>
+void dcsc_gespmv (const SpPatternCols<IU> & A, const RHS * x, LHS * y)
+{
+	if(A.getnnz() > 0)
+	{
+		auto dcsc = A.GetDCSC();
+		for(IU j =0; j<dcsc->nzc; ++j)	// for all nonzero columns
+		{
+			const RHS & xval = x[dcsc->jc[j]];
+			if(IsAnnihilator<SR>(xval)) continue;
+			for(IU k = dcsc->cp[j]; k < dcsc->cp[j+1]; ++k)
+				SR::axpy(true, xval, y[dcsc->ir[k]]);
+		}
+	}
+}
+
+//! SpMV with dense vector on a pattern matrix (multithreaded version)
+template <typename SR, typename IU, typename RHS, typename LHS>
+void dcsc_gespmv_threaded (const SpPatternCols<IU> & A, const RHS * x, LHS * y)
+{
+	if(A.getnnz() > 0)
+	{
+		int nthreads=1;
+		#ifdef _OPENMP
+		#pragma omp parallel
+		{
+			nthreads = omp_get_num_threads();
+		}
+		#endif
+		if(nthreads == 1)
+		{
+			dcsc_gespmv<SR>(A, x, y);
+			return;
+		}
+
+		IU nlocrows =  A.getnrow();
+		LHS ** tomerge = SpHelper::allocate2D<LHS>(nthreads, nlocrows);
+		auto id = SR::id();
+		for(int i=0; i<nthreads; ++i)
+		{
+			std::fill_n(tomerge[i], nlocrows, id);
+		}
+
+		auto dcsc = A.GetDCSC();
+		#pragma omp parallel for schedule(dynamic, 64)
+		for(IU j =0; j<dcsc->nzc; ++j)	// for all nonzero columns
+		{
+			int curthread = 0;
+			#ifdef _OPENMP
+			curthread = omp_get_thread_num();
+			#endif
+			LHS * loc2merge = tomerge[curthread];
+			const RHS & xval = x[dcsc->jc[j]];
+			if(IsAnnihilator<SR>(xval)) continue;
+			for(IU k = dcsc->cp[j]; k < dcsc->cp[j+1]; ++k)
+				SR::axpy(true, xval, loc2merge[dcsc->ir[k]]);
+		}
+
+		#pragma omp parallel for
+		for(IU j=0; j < nlocrows; ++j)
+		{
+			for(int i=0; i< nthreads && !IsSaturated<SR>(y[j]); ++i)
+			{
+				y[j] = SR::add(y[j], tomerge[i][j]);
+			}
+		}
+		SpHelper::deallocate2D(tomerge, nthreads);
+	}
+}
+
+
 /** 
   * Multithreaded SpMV with sparse vector
   * the assembly of outgoing buffers sendindbuf/sendnumbuf are done here
@@ -193,30 +337,22 @@ int generic_gespmv_threaded (const SpMat<IU,NUM,DER> & A, const int32_t * indx,
 		if(splits > 0)
 		{
 			int32_t nlocrows = static_cast<int32_t>(A.getnrow());
-			int32_t perpiece = nlocrows / splits;
+			const auto & offsets = A.GetSplitOffsets();
 			std::vector< std::vector< int32_t > > indy(splits);
 			std::vector< std::vector< OVT > > numy(splits);
 
 			// Parallelize with OpenMP
 			#ifdef _OPENMP
-			#pragma omp parallel for // num_threads(6)
+			#pragma omp parallel for schedule(static)
 			#endif
 			for(int i=0; i<splits; ++i)
 			{
+                int32_t rowoffset = static_cast<int32_t>(offsets[i]);
+                int32_t splitrows = static_cast<int32_t>(offsets[i+1] - offsets[i]);
                 if(SPA.initialized)
-                {
-                    if(i != splits-1)
-                         SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), perpiece, indx, numx, nnzx, indy[i], numy[i], i*perpiece, SPA.V_localy[i], SPA.V_isthere[i], SPA.V_inds[i]);
-                    else
-                        SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), nlocrows - perpiece*i, indx, numx, nnzx, indy[i], numy[i], i*perpiece, SPA.V_localy[i], SPA.V_isthere[i], SPA.V_inds[i]);
-                }
+                    SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), splitrows, indx, numx, nnzx, indy[i], numy[i], rowoffset, SPA.V_localy[i], SPA.V_isthere[i], SPA.V_inds[i]);
                 else
-                {
-                    if(i != splits-1)
-                        SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), perpiece, indx, numx, nnzx, indy[i], numy[i], i*perpiece);
-                    else
-                        SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), nlocrows - perpiece*i, indx, numx, nnzx, indy[i], numy[i], i*perpiece);
-                }
+                    SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), splitrows, indx, numx, nnzx, indy[i], numy[i], rowoffset);
 			}
 
 			std::vector<int> accum(splits+1, 0);
@@ -331,17 +467,14 @@ void generic_gespmv_threaded_setbuffers (const SpMat<IU,NUM,DER> & A, const int3
 			std::vector< std::vector<int32_t> > indy(splits);
 			std::vector< std::vector< OVT > > numy(splits);
 			int32_t nlocrows = static_cast<int32_t>(A.getnrow());
-			int32_t perpiece = nlocrows / splits;
+			const auto & offsets = A.GetSplitOffsets();
 			
 			#ifdef _OPENMP
-			#pragma omp parallel for 
+			#pragma omp parallel for schedule(static)
 			#endif
 			for(int i=0; i<splits; ++i)
 			{
-				if(i != splits-1)
-					SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), perpiece, indx, numx, nnzx, indy[i], numy[i], i*perpiece);
-				else
-					SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), nlocrows - perpiece*i, indx, numx, nnzx, indy[i], numy[i], i*perpiece);
+				SpMXSpV_ForThreading<SR>(*(A.GetInternal(i)), static_cast<int32_t>(offsets[i+1] - offsets[i]), indx, numx, nnzx, indy[i], numy[i], static_cast<int32_t>(offsets[i]));
 			}
 			
 			int32_t perproc = nlocrows / p_c;	
@@ -478,83 +611,6 @@ void generic_gespmv (const SpMat<IU,NUM,DER> & A, const int32_t * indx, const IV
 }
 
 
-template<typename IU>
-void BooleanRowSplit(SpDCCols<IU, bool> & A, int numsplits)
-{
-    if(A.m < numsplits)
-    {
-        std::cerr<< "Warning: Matrix is too small to be splitted for multithreading" << std::endl;
-        return;
-    }
-	A.splits = numsplits;
-	IU perpiece = A.m / A.splits;
-	std::vector<IU> prevcolids(A.splits, -1);	// previous column id's are set to -1
-	std::vector<IU> nzcs(A.splits, 0);
-	std::vector<IU> nnzs(A.splits, 0);
-	std::vector < std::vector < std::pair<IU,IU> > > colrowpairs(A.splits);
-	if(A.nnz > 0 && A.dcsc != NULL)
-	{
-		for(IU i=0; i< A.dcsc->nzc; ++i)
-		{
-			for(IU j = A.dcsc->cp[i]; j< A.dcsc->cp[i+1]; ++j)
-			{
-				IU colid = A.dcsc->jc[i];
-				IU rowid = A.dcsc->ir[j];
-				IU owner = std::min(rowid / perpiece, static_cast<IU>(A.splits-1));
-				colrowpairs[owner].push_back(std::make_pair(colid, rowid - owner*perpiece));
-
-				if(prevcolids[owner] != colid)
-				{
-					prevcolids[owner] = colid;
-					++nzcs[owner];
-				}
-				++nnzs[owner];
-			}
-		}
-	}
-	delete A.dcsc;	// claim memory
-	//copy(nzcs.begin(), nzcs.end(), ostream_iterator<IU>(cout," " )); cout << endl;
-	//copy(nnzs.begin(), nnzs.end(), ostream_iterator<IU>(cout," " )); cout << endl;	
-	A.dcscarr = new Dcsc<IU,bool>*[A.splits];	
-	
-	// To be parallelized with OpenMP
-	for(int i=0; i< A.splits; ++i)
-	{
-		sort(colrowpairs[i].begin(), colrowpairs[i].end());	// sort w.r.t. columns
-        if(nzcs[i]>0)
-        {
-            A.dcscarr[i] = new Dcsc<IU,bool>(nnzs[i],nzcs[i]);
-            std::fill(A.dcscarr[i]->numx, A.dcscarr[i]->numx+nnzs[i], static_cast<bool>(1));
-            IU curnzc = 0;                // number of nonzero columns constructed so far
-            IU cindex = colrowpairs[i][0].first;
-            IU rindex = colrowpairs[i][0].second;
-            
-            A.dcscarr[i]->ir[0] = rindex;
-            A.dcscarr[i]->jc[curnzc] = cindex;
-            A.dcscarr[i]->cp[curnzc++] = 0;
-            
-            for(IU j=1; j<nnzs[i]; ++j)
-            {
-                cindex = colrowpairs[i][j].first;
-                rindex = colrowpairs[i][j].second;
-                
-                A.dcscarr[i]->ir[j] = rindex;
-                if(cindex != A.dcscarr[i]->jc[curnzc-1])
-                {
-                    A.dcscarr[i]->jc[curnzc] = cindex;
-                    A.dcscarr[i]->cp[curnzc++] = j;
-                }
-            }
-            A.dcscarr[i]->cp[curnzc] = nnzs[i];
-        }
-        else
-        {
-            A.dcscarr[i] = new Dcsc<IU,bool>();
-        }
-	}
-}
-
-
 /**
  * SpTuples(A*B') (Using OuterProduct Algorithm)
  * Returns the tuples for efficient merging later
@@ -1048,12 +1104,12 @@ template <typename RETT, typename IU, typename NU1, typename NU2, typename _Bina
 Dcsc<IU, RETT> EWiseApply(const Dcsc<IU,NU1> * Ap, const Dcsc<IU,NU2> * Bp, _BinaryOperation __binary_op, _BinaryPredicate do_op, bool allowANulls, bool allowBNulls, const NU1& ANullVal, const NU2& BNullVal, const bool allowIntersect)
 {
 	if (Ap == NULL && Bp == NULL)
-		return Dcsc<IU,RETT>(0, 0);
+		return Dcsc<IU,RETT>();	// empty, Dcsc(0,0) would allocate (and assert)
 	
 	if (Ap == NULL && Bp != NULL)
 	{
 		if (!allowANulls)
-			return Dcsc<IU,RETT>(0, 0);
+			return Dcsc<IU,RETT>();	// empty, Dcsc(0,0) would allocate (and assert)
 			
 		const Dcsc<IU,NU2> & B = *Bp;
 		IU estnzc = B.nzc;
@@ -1089,7 +1145,7 @@ Dcsc<IU, RETT> EWiseApply(const Dcsc<IU,NU1> * Ap, const Dcsc<IU,NU2> * Bp, _Bin
 	if (Ap != NULL && Bp == NULL)
 	{
 		if (!allowBNulls)
-			return Dcsc<IU,RETT>(0, 0);
+			return Dcsc<IU,RETT>();	// empty, Dcsc(0,0) would allocate (and assert)
 
 		const Dcsc<IU,NU1> & A = *Ap;
 		IU estnzc = A.nzc;
@@ -1282,6 +1338,11 @@ SpDCCols<IU,RETT> EWiseApply (const SpDCCols<IU,NU1> & A, const SpDCCols<IU,NU2>
 	assert(A.n == B.n);
 
 	Dcsc<IU, RETT> * tdcsc = new Dcsc<IU, RETT>(EWiseApply<RETT>(A.dcsc, B.dcsc, __binary_op, do_op, allowANulls, allowBNulls, ANullVal, BNullVal, allowIntersect));
+	if(tdcsc->nz == 0)
+	{
+		delete tdcsc;	// an empty SpDCCols has no dcsc
+		tdcsc = NULL;
+	}
 	return 	SpDCCols<IU, RETT> (A.m , A.n, tdcsc);
 }
 
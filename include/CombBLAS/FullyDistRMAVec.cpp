@@ -0,0 +1,197 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+#include "FullyDistRMAVec.h"
+
+namespace combblas {
+
+template <class IT, class NT>
+FullyDistRMAVec<IT,NT>::FullyDistRMAVec (std::shared_ptr<CommGrid> grid, IT globallen, NT initval)
+: FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>(grid, globallen)
+{
+	Allocate(initval);
+}
+
+template <class IT, class NT>
+FullyDistRMAVec<IT,NT>::FullyDistRMAVec (const FullyDistVec<IT,NT> & rhs)
+: FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>(rhs.getcommgrid(), rhs.TotalLength())
+{
+	Allocate(NT());
+	std::copy(rhs.GetLocArr(), rhs.GetLocArr() + loclen, arr);
+	MPI_Win_sync(win);
+	MPI_Barrier(commGrid->GetWorld());
+}
+
+//! Allocates the window and opens the passive-target epoch that lasts until destruction
+template <class IT, class NT>
+void FullyDistRMAVec<IT,NT>::Allocate(NT initval)
+{
+	loclen = MyLocLength();
+	MPI_Win_allocate(static_cast<MPI_Aint>(loclen * sizeof(NT)), sizeof(NT), MPI_INFO_NULL, commGrid->GetWorld(), &arr, &win);
+	std::fill(arr, arr + loclen, initval);
+	MPI_Win_lock_all(MPI_MODE_NOCHECK, win);
+	MPI_Win_sync(win);
+	MPI_Barrier(commGrid->GetWorld());
+}
+
+template <class IT, class NT>
+FullyDistRMAVec<IT,NT>::~FullyDistRMAVec ()
+{
+	Flush();
+	MPI_Win_unlock_all(win);
+	MPI_Win_free(&win);		// collective
+}
+
+//! Buckets the requested global indices by owner, as (local index, position in globinds) pairs sorted by local index
+template <class IT, class NT>
+void FullyDistRMAVec<IT,NT>::GroupByTarget(const std::vector<IT> & globinds, std::vector< std::vector< std::pair<IT,IT> > > & bytarget) const
+{
+	bytarget.resize(commGrid->GetSize());
+	for(IT i=0; i < static_cast<IT>(globinds.size()); ++i)
+	{
+		if(globinds[i] < 0 || globinds[i] >= glen)
+		{
+			std::cout << "Index " << globinds[i] << " is out of bounds for FullyDistRMAVec of length " << glen << std::endl;
+			MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+		}
+		IT locind;
+		int owner = Owner(globinds[i], locind);
+		bytarget[owner].push_back(std::make_pair(locind, i));
+	}
+	for(size_t i=0; i < bytarget.size(); ++i)
+		std::stable_sort(bytarget[i].begin(), bytarget[i].end(), [](const std::pair<IT,IT> & a, const std::pair<IT,IT> & b){ return a.first < b.first; });
+}
+
+//! An indexed datatype that addresses the (distinct, sorted) displacements of one target, freed by the caller
+template <class IT, class NT>
+MPI_Datatype FullyDistRMAVec<IT,NT>::TargetType(const std::vector<int> & displs) const
+{
+	MPI_Datatype type;
+	MPI_Type_create_indexed_block(static_cast<int>(displs.size()), 1, displs.data(), MPIType<NT>(), &type);
+	MPI_Type_commit(&type);
+	return type;
+}
+
+/**
+ * this[globinds[i]] = op(this[globinds[i]], vals[i]) for all i, issued without waiting for completion
+ * @param[in] __binop: the local equivalent of op, used to combine duplicate indices before sending
+ * Completion is only guaranteed after Flush()/Sync()
+ **/
+template <class IT, class NT>
+template <typename _BinaryOperation>
+void FullyDistRMAVec<IT,NT>::Accumulate(const std::vector<IT> & globinds, const std::vector<NT> & vals, _BinaryOperation __binop, MPI_Op op)
+{
+	std::vector< std::vector< std::pair<IT,IT> > > bytarget;
+	GroupByTarget(globinds, bytarget);
+	for(int t=0; t < static_cast<int>(bytarget.size()); ++t)
+	{
+		if(bytarget[t].empty()) continue;
+		std::vector<int> displs;
+		pendingsends.push_back(std::vector<NT>());
+		std::vector<NT> & combined = pendingsends.back();
+		for(auto it = bytarget[t].begin(); it != bytarget[t].end(); ++it)
+		{
+			if(!displs.empty() && displs.back() == static_cast<int>(it->first))
+			{
+				combined.back() = __binop(combined.back(), vals[it->second]);
+			}
+			else
+			{
+				displs.push_back(static_cast<int>(it->first));
+				combined.push_back(vals[it->second]);
+			}
+		}
+		MPI_Datatype type = TargetType(displs);
+		MPI_Accumulate(combined.data(), static_cast<int>(combined.size()), MPIType<NT>(), t, 0, 1, type, op, win);
+		MPI_Type_free(&type);
+	}
+}
+
+/**
+ * vals[i] = this[globinds[i]] for all i, issued without waiting for completion
+ * Reads are atomic with respect to concurrent Accumulate() calls. vals is resized here,
+ * but it only holds the fetched values after the next Flush()/Sync(), and it must outlive that call
+ **/
+template <class IT, class NT>
+void FullyDistRMAVec<IT,NT>::Fetch(const std::vector<IT> & globinds, std::vector<NT> & vals)
+{
+	vals.resize(globinds.size());
+	std::vector< std::vector< std::pair<IT,IT> > > bytarget;
+	GroupByTarget(globinds, bytarget);
+	for(int t=0; t < static_cast<int>(bytarget.size()); ++t)
+	{
+		if(bytarget[t].empty()) continue;
+		std::vector<int> displs;
+		pendingfetches.push_back(PendingFetch());
+		PendingFetch & pending = pendingfetches.back();
+		pending.out = &vals;
+		for(auto it = bytarget[t].begin(); it != bytarget[t].end(); ++it)
+		{
+			if(displs.empty() || displs.back() != static_cast<int>(it->first))
+				displs.push_back(static_cast<int>(it->first));
+			pending.positions.push_back(it->second);
+			pending.slots.push_back(static_cast<int>(displs.size()) - 1);
+		}
+		pending.buffer.resize(displs.size());
+		MPI_Datatype type = TargetType(displs);
+		MPI_Get_accumulate(NULL, 0, MPIType<NT>(), pending.buffer.data(), static_cast<int>(displs.size()), MPIType<NT>(),
+				t, 0, 1, type, MPI_NO_OP, win);
+		MPI_Type_free(&type);
+	}
+}
+
+template <class IT, class NT>
+void FullyDistRMAVec<IT,NT>::Flush()
+{
+	MPI_Win_flush_all(win);
+	for(auto it = pendingfetches.begin(); it != pendingfetches.end(); ++it)
+		for(size_t i=0; i < it->positions.size(); ++i)
+			(*(it->out))[it->positions[i]] = it->buffer[it->slots[i]];
+	pendingfetches.clear();
+	pendingsends.clear();
+}
+
+template <class IT, class NT>
+void FullyDistRMAVec<IT,NT>::Sync()
+{
+	Flush();
+	MPI_Win_sync(win);
+	MPI_Barrier(commGrid->GetWorld());
+	MPI_Win_sync(win);
+}
+
+template <class IT, class NT>
+FullyDistVec<IT,NT> FullyDistRMAVec<IT,NT>::ToFullyDistVec()
+{
+	Sync();
+	FullyDistVec<IT,NT> dense(commGrid, glen, NT());
+	for(IT i=0; i < loclen; ++i)
+		dense.SetLocalElement(i, arr[i]);
+	return dense;
+}
+
+}
@@ -0,0 +1,113 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#ifndef _FULLY_DIST_RMA_VEC_H_
+#define _FULLY_DIST_RMA_VEC_H_
+
+#include <iostream>
+#include <vector>
+#include <list>
+#include <mpi.h>
+
+#include "CommGrid.h"
+#include "FullyDist.h"
+#include "FullyDistVec.h"
+#include "MPIType.h"
+#include "CombBLAS.h"
+
+namespace combblas {
+
+/**
+  * A dense distributed vector whose local pieces live in an MPI window for its whole lifetime
+  * The window is allocated once at construction (MPI_Win_allocate) and kept in a passive-target
+  * epoch (MPI_Win_lock_all), so that remote reads and reductions need neither window creation
+  * nor collective synchronization per operation:
+  *    - Accumulate() and Fetch() group the requests by target, combine duplicates locally,
+  *      and issue one MPI_Accumulate / MPI_Get_accumulate per target with an indexed datatype
+  *    - the operations complete asynchronously; Flush() waits for the ones issued by this process,
+  *      Sync() (collective) makes all updates of all processes visible in the local arrays
+  * Concurrent Accumulate() calls with the same MPI_Op and Fetch() calls are atomic per element.
+  * Distribution is identical to FullyDistVec, so conversions do not communicate.
+  */
+template <class IT, class NT>
+class FullyDistRMAVec: public FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>
+{
+public:
+	FullyDistRMAVec (std::shared_ptr<CommGrid> grid, IT globallen, NT initval);
+	FullyDistRMAVec (const FullyDistVec<IT,NT> & rhs);
+	~FullyDistRMAVec ();
+
+	FullyDistRMAVec (const FullyDistRMAVec<IT,NT> & rhs) = delete;
+	FullyDistRMAVec<IT,NT> & operator=(const FullyDistRMAVec<IT,NT> & rhs) = delete;
+
+	template <typename _BinaryOperation>
+	void Accumulate(const std::vector<IT> & globinds, const std::vector<NT> & vals, _BinaryOperation __binop, MPI_Op op);
+	void Fetch(const std::vector<IT> & globinds, std::vector<NT> & vals);
+
+	void Flush();	//!< completes the operations issued by this process, and fills the Fetch() outputs
+	void Sync();	//!< collective: after it returns, every update is visible in every local array
+
+	FullyDistVec<IT,NT> ToFullyDistVec();	//!< collective
+	const NT * GetLocArr() const { return arr; }
+	IT LocArrSize() const { return loclen; }
+	std::shared_ptr<CommGrid> getcommgrid() const { return commGrid; }
+
+	using FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>::LengthUntil;
+	using FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>::TotalLength;
+	using FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>::Owner;
+	using FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>::MyLocLength;
+
+protected:
+	using FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>::glen;
+	using FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>::commGrid;
+
+private:
+	struct PendingFetch
+	{
+		std::vector<NT> * out;
+		std::vector<NT> buffer;		// one entry per distinct index requested from the target
+		std::vector<IT> positions;	// positions in *out ...
+		std::vector<int> slots;		// ... and where their values are in buffer
+	};
+
+	void Allocate(NT initval);
+	void GroupByTarget(const std::vector<IT> & globinds, std::vector< std::vector< std::pair<IT,IT> > > & bytarget) const;
+	MPI_Datatype TargetType(const std::vector<int> & displs) const;
+
+	NT * arr;
+	IT loclen;
+	MPI_Win win;
+	std::list< std::vector<NT> > pendingsends;	// origin buffers that must live until the next flush
+	std::list< PendingFetch > pendingfetches;
+};
+
+}
+
+#include "FullyDistRMAVec.cpp"
+
+#endif
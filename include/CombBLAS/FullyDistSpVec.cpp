@@ -108,6 +108,78 @@ FullyDistSpVec<IT,NT>::FullyDistSpVec (const FullyDistVec<IT,NT> & rhs, _UnaryOp
 
 
 
+//! Evaluates a lazy expression at every entry of its domain (see VecExpr.h)
+template <class IT, class NT>
+template <class DERIVED>
+FullyDistSpVec<IT,NT>::FullyDistSpVec (const VecExpr<DERIVED> & vals)
+: FullyDistSpVec(vals, Map(vals, [](const typename DERIVED::value_type &){ return true; }))
+{ }
+
+/**
+ * Evaluates a lazy expression at the entries of its domain where the mask expression holds.
+ * Replaces chains like Apply -> EWiseApply -> FullyDistSpVec(dense, pred) by a single threaded pass.
+ */
+template <class IT, class NT>
+template <class DERIVED, class MASK>
+FullyDistSpVec<IT,NT>::FullyDistSpVec (const VecExpr<DERIVED> & vals, const VecExpr<MASK> & mask)
+: FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>(GetDomain(vals).commGrid)
+{
+	const DERIVED & expr = vals.self();
+	const MASK & pred = mask.self();
+	VecDomain<IT> dom = GetDomain(vals);
+	pred.Domain(dom);
+	glen = dom.glen;
+
+	int nthreads = 1;
+#ifdef _OPENMP
+#pragma omp parallel
+	{
+		nthreads = omp_get_num_threads();
+	}
+#endif
+	std::vector< std::vector<IT> > tind(nthreads);
+	std::vector< std::vector<NT> > tnum(nthreads);
+	IT perthread = dom.size / nthreads;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	{
+		int curthread = 0;
+#ifdef _OPENMP
+		curthread = omp_get_thread_num();
+#endif
+		IT tstart = perthread * curthread;
+		IT tend = (curthread == nthreads-1) ? dom.size : perthread * (curthread+1);
+		for(IT k = tstart; k < tend; ++k)
+		{
+			IT i = dom.LocalIndex(k);
+			if(pred(k, i))
+			{
+				tind[curthread].push_back(i);
+				tnum[curthread].push_back(static_cast<NT>(expr(k, i)));
+			}
+		}
+	}
+
+	std::vector<IT> tdisp(nthreads+1, 0);
+	for(int t = 0; t < nthreads; ++t)
+		tdisp[t+1] = tdisp[t] + tind[t].size();
+	ind.resize(tdisp[nthreads]);
+	num.resize(tdisp[nthreads]);
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	{
+		int curthread = 0;
+#ifdef _OPENMP
+		curthread = omp_get_thread_num();
+#endif
+		std::copy(tind[curthread].begin(), tind[curthread].end(), ind.begin() + tdisp[curthread]);
+		std::copy(tnum[curthread].begin(), tnum[curthread].end(), num.begin() + tdisp[curthread]);
+	}
+}
+
+
 // create a sparse vector from local vectors
 template <class IT, class NT>
 FullyDistSpVec<IT,NT>::FullyDistSpVec (std::shared_ptr<CommGrid> grid, IT globallen, const std::vector<IT>& indvec, const std::vector<NT> & numvec, bool SumDuplicates, bool sorted)
@@ -323,6 +395,147 @@ FullyDistSpVec<IT,NT>::FullyDistSpVec (IT globallen, const FullyDistVec<IT,IT> &
 }
 
 
+/************************************************************************
+ * Scatter-reduce: this[inds[i]] = __binop-reduction of all vals[i] that share the same index
+ * Skewed scatters (a few owners receiving most of the entries) are detected with a frequency sketch.
+ * Entries with hot indices are combined locally before they are sent, so that each owner receives
+ * at most one entry per process for each of its hot indices.
+ ************************************************************************/
+template <class IT, class NT>
+template <typename _BinaryOperation>
+FullyDistSpVec<IT,NT>::FullyDistSpVec (IT globallen, const FullyDistVec<IT,IT> & inds,  const FullyDistVec<IT,NT> & vals, _BinaryOperation __binop)
+: FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>(inds.commGrid,globallen)
+{
+    if(*(inds.commGrid) != *(vals.commGrid))
+    {
+        SpParHelper::Print("Grids are not comparable, FullyDistSpVec() fails !");
+        MPI_Abort(MPI_COMM_WORLD, GRIDMISMATCH);
+    }
+    if(inds.TotalLength() != vals.TotalLength())
+    {
+        SpParHelper::Print("Index and value vectors have different sizes, FullyDistSpVec() fails !");
+        MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+    }
+    IT maxind = inds.Reduce(maximum<IT>(), (IT) 0);
+    if(maxind>=globallen)
+    {
+        SpParHelper::Print("At least one index is greater than globallen, FullyDistSpVec() fails !");
+        MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+    }
+
+    MPI_Comm World = commGrid->GetWorld();
+    int nprocs = commGrid->GetSize();
+    IT locsize = inds.LocArrSize();
+
+    std::vector<IT> owncnt(nprocs, 0);
+    for(IT i=0; i<locsize; ++i)
+    {
+        IT locind;
+        owncnt[Owner(inds.arr[i], locind)]++;
+    }
+    std::vector<IT> load;
+    std::vector<bool> overloaded;
+    std::vector<bool> ishot(locsize, false);
+    std::unordered_map<IT,NT> combined;    // locally reduced entries with hot indices
+    if(OverloadedOwners(World, owncnt, load, overloaded) > 0)
+    {
+        CountMinSketch<IT> sketch(globallen);
+        IT hotrequests = 0;
+        for(IT i=0; i<locsize; ++i)
+        {
+            IT locind;
+            if(overloaded[Owner(inds.arr[i], locind)])
+                sketch.Add(inds.arr[i]);
+        }
+        sketch.AllReduce(World);
+        for(int i=0; i<nprocs; ++i)
+            if(overloaded[i]) hotrequests += load[i];
+        IT threshold = std::max(static_cast<IT>(nprocs), 2 * hotrequests / sketch.Width());
+        for(IT i=0; i<locsize; ++i)
+        {
+            IT locind;
+            if(overloaded[Owner(inds.arr[i], locind)] && sketch.Estimate(inds.arr[i]) > threshold)
+            {
+                ishot[i] = true;
+                auto it = combined.find(inds.arr[i]);
+                if(it == combined.end())
+                    combined.insert(std::make_pair(inds.arr[i], vals.arr[i]));
+                else
+                    it->second = __binop(it->second, vals.arr[i]);
+            }
+        }
+    }
+
+    std::vector< std::vector<IT> > indBuf(nprocs);
+    std::vector< std::vector<NT> > valBuf(nprocs);
+    for(IT i=0; i<locsize; ++i)
+    {
+        if(ishot[i]) continue;
+        IT locind;
+        int owner = Owner(inds.arr[i], locind);
+        indBuf[owner].push_back(locind);
+        valBuf[owner].push_back(vals.arr[i]);
+    }
+    for(auto it = combined.begin(); it != combined.end(); ++it)
+    {
+        IT locind;
+        int owner = Owner(it->first, locind);
+        indBuf[owner].push_back(locind);
+        valBuf[owner].push_back(it->second);
+    }
+
+    int * sendcnt = new int[nprocs];
+    int * recvcnt = new int[nprocs];
+    int * sdispls = new int[nprocs]();
+    int * rdispls = new int[nprocs]();
+    for(int i=0; i<nprocs; ++i)
+        sendcnt[i] = static_cast<int>(indBuf[i].size());
+    MPI_Alltoall(sendcnt, 1, MPI_INT, recvcnt, 1, MPI_INT, World);
+    for(int i=0; i<nprocs-1; ++i)
+    {
+        sdispls[i+1] = sdispls[i] + sendcnt[i];
+        rdispls[i+1] = rdispls[i] + recvcnt[i];
+    }
+    IT totsend = std::accumulate(sendcnt, sendcnt+nprocs, static_cast<IT>(0));
+    IT totrecv = std::accumulate(recvcnt, recvcnt+nprocs, static_cast<IT>(0));
+
+    std::vector<IT> sendind(totsend);
+    std::vector<NT> sendnum(totsend);
+    for(int i=0; i<nprocs; ++i)
+    {
+        std::copy(indBuf[i].begin(), indBuf[i].end(), sendind.begin()+sdispls[i]);
+        std::vector<IT>().swap(indBuf[i]);
+        std::copy(valBuf[i].begin(), valBuf[i].end(), sendnum.begin()+sdispls[i]);
+        std::vector<NT>().swap(valBuf[i]);
+    }
+    std::vector<IT> recvind(totrecv);
+    std::vector<NT> recvnum(totrecv);
+    MPI_Alltoallv(sendind.data(), sendcnt, sdispls, MPIType<IT>(), recvind.data(), recvcnt, rdispls, MPIType<IT>(), World);
+    MPI_Alltoallv(sendnum.data(), sendcnt, sdispls, MPIType<NT>(), recvnum.data(), recvcnt, rdispls, MPIType<NT>(), World);
+    DeleteAll(sdispls, rdispls, sendcnt, recvcnt);
+
+    std::vector< std::pair<IT,NT> > tosort(totrecv);
+    for(IT i=0; i<totrecv; ++i)
+        tosort[i] = std::make_pair(recvind[i], recvnum[i]);
+    std::stable_sort(tosort.begin(), tosort.end(), [](const std::pair<IT,NT> & a, const std::pair<IT,NT> & b){ return a.first < b.first; });
+
+    ind.reserve(totrecv);
+    num.reserve(totrecv);
+    for(auto itr = tosort.begin(); itr != tosort.end(); ++itr)
+    {
+        if(ind.empty() || ind.back() != itr->first)
+        {
+            ind.push_back(itr->first);
+            num.push_back(itr->second);
+        }
+        else
+        {
+            num.back() = __binop(num.back(), itr->second);
+        }
+    }
+}
+
+
 //! Returns a dense vector of nonzero values
 //! for which the predicate is satisfied on values
 template <class IT, class NT>
@@ -553,6 +766,113 @@ void FullyDistSpVec<IT,NT>::DelElement (IT indx)
 	}
 }
 
+/**
+ * Batched operator[]: each process fetches the entries at its own list of global indices,
+ * with one all-to-all for the requests and one for the answers. Collective.
+ * found[k] tells whether indices[k] is a nonzero; missing entries are returned as NT().
+ */
+template <class IT, class NT>
+std::vector<NT> FullyDistSpVec<IT,NT>::GetElements (const std::vector<IT> & indices, std::vector<bool> & found) const
+{
+	OwnerExchange<IT> exchange(*this, indices);
+	std::vector<IT> requested;
+	exchange.Forward(exchange.LocalIndices(), requested);
+	std::vector< std::pair<NT,int> > answers(requested.size(), std::make_pair(NT(), 0));
+	for(size_t i = 0; i < requested.size(); ++i)
+	{
+		typename std::vector<IT>::const_iterator it = std::lower_bound(ind.begin(), ind.end(), requested[i]);	// ind is a sorted vector
+		if(it != ind.end() && requested[i] == (*it))
+			answers[i] = std::make_pair(num[it-ind.begin()], 1);
+	}
+
+	std::vector< std::pair<NT,int> > results;
+	exchange.Reply(answers, results);
+	std::vector<NT> values(results.size());
+	found.resize(results.size());
+	for(size_t k = 0; k < results.size(); ++k)
+	{
+		values[k] = results[k].first;
+		found[k] = (results[k].second != 0);
+	}
+	return values;
+}
+
+template <class IT, class NT>
+std::vector<NT> FullyDistSpVec<IT,NT>::GetElements (const std::vector<IT> & indices) const
+{
+	std::vector<bool> found;
+	return GetElements(indices, found);
+}
+
+/**
+ * Batched SetElement: each process inserts or overwrites its own (index, value) pairs, with one all-to-all.
+ * The received updates are merged into the local nonzeros in one pass instead of one insertion each.
+ * If several processes write the same index, the one with the highest rank wins.
+ */
+template <class IT, class NT>
+void FullyDistSpVec<IT,NT>::SetElements (const std::vector<IT> & indices, const std::vector<NT> & values)
+{
+	if(indices.size() != values.size())
+	{
+		std::cout << "FullyDistSpVec::SetElements needs one value per index" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+	}
+	OwnerExchange<IT> exchange(*this, indices);
+	std::vector< std::pair<IT,NT> > updates(indices.size());
+	for(size_t k = 0; k < indices.size(); ++k)
+		updates[k] = std::make_pair(exchange.LocalIndices()[k], values[k]);
+
+	std::vector< std::pair<IT,NT> > received;
+	exchange.Forward(updates, received);
+	// received is grouped by sender rank, so a stable sort keeps the last writer last
+	std::stable_sort(received.begin(), received.end(), [](const std::pair<IT,NT> & a, const std::pair<IT,NT> & b){ return a.first < b.first; });
+
+	std::vector<IT> mergedind;
+	std::vector<NT> mergednum;
+	mergedind.reserve(ind.size() + received.size());
+	mergednum.reserve(ind.size() + received.size());
+	size_t i = 0, j = 0;
+	while(i < ind.size() || j < received.size())
+	{
+		if(j == received.size() || (i < ind.size() && ind[i] < received[j].first))
+		{
+			mergedind.push_back(ind[i]);
+			mergednum.push_back(num[i++]);
+		}
+		else
+		{
+			IT locind = received[j].first;
+			while(j+1 < received.size() && received[j+1].first == locind) ++j;
+			mergedind.push_back(locind);
+			mergednum.push_back(received[j++].second);
+			if(i < ind.size() && ind[i] == locind) ++i;	// overwritten
+		}
+	}
+	ind.swap(mergedind);
+	num.swap(mergednum);
+}
+
+//! Batched DelElement: each process removes its own list of indices, with one all-to-all
+template <class IT, class NT>
+void FullyDistSpVec<IT,NT>::DelElements (const std::vector<IT> & indices)
+{
+	OwnerExchange<IT> exchange(*this, indices);
+	std::vector<IT> received;
+	exchange.Forward(exchange.LocalIndices(), received);
+	std::sort(received.begin(), received.end());
+
+	size_t kept = 0, j = 0;
+	for(size_t i = 0; i < ind.size(); ++i)
+	{
+		while(j < received.size() && received[j] < ind[i]) ++j;
+		if(j < received.size() && received[j] == ind[i]) continue;
+		ind[kept] = ind[i];
+		num[kept++] = num[i];
+	}
+	ind.resize(kept);
+	num.resize(kept);
+}
+
 /**
  * The distribution and length are inherited from ri
  * Its zero is inherited from *this (because ri is of type IT)
@@ -38,7 +38,10 @@
 #include "SpParMat.h"
 #include "FullyDist.h"
 #include "Exception.h"
+#include "FrequencySketch.h"
 #include "OptBuf.h"
+#include "VecExpr.h"
+#include "OwnerExchange.h"
 #include "CombBLAS.h"
 
 namespace combblas {
@@ -82,7 +85,13 @@ public:
     FullyDistSpVec (const FullyDistVec<IT,NT> & rhs, _UnaryOperation unop);
 	FullyDistSpVec (const FullyDistVec<IT,NT> & rhs);					// Conversion copy-constructor
     FullyDistSpVec (IT globalsize, const FullyDistVec<IT,IT> & inds,  const FullyDistVec<IT,NT> & vals, bool SumDuplicates = false);
+    template <typename _BinaryOperation>
+    FullyDistSpVec (IT globalsize, const FullyDistVec<IT,IT> & inds,  const FullyDistVec<IT,NT> & vals, _BinaryOperation __binop);	//!< scatter-reduce (combines hot indices locally)
     FullyDistSpVec (std::shared_ptr<CommGrid> grid, IT globallen, const std::vector<IT>& indvec, const std::vector<NT> & numvec, bool SumDuplicates = false, bool sorted=false);
+    template <class DERIVED>
+    explicit FullyDistSpVec (const VecExpr<DERIVED> & vals);	//!< evaluates a lazy vector expression over its domain (see VecExpr.h)
+    template <class DERIVED, class MASK>
+    FullyDistSpVec (const VecExpr<DERIVED> & vals, const VecExpr<MASK> & mask);	//!< ... keeping only the entries where mask holds
     
     IT NnzUntil() const;
 
@@ -187,6 +196,10 @@ public:
 	void SetElement (IT indx, NT numx);	// element-wise assignment
 	void DelElement (IT indx); // element-wise deletion
 	NT operator[](IT indx);
+	std::vector<NT> GetElements (const std::vector<IT> & indices) const;	//!< batched operator[], one all-to-all for all indices
+	std::vector<NT> GetElements (const std::vector<IT> & indices, std::vector<bool> & found) const;
+	void SetElements (const std::vector<IT> & indices, const std::vector<NT> & values);	//!< batched SetElement
+	void DelElements (const std::vector<IT> & indices);	//!< batched DelElement
 	bool WasFound() const { return wasFound; }
 
 	//! sort the vector itself, return the permutation vector (0-based)
@@ -315,6 +328,9 @@ private:
 	template <class IU, class NU>
 	friend class SparseVectorLocalIterator;
 
+	template <class IU, class NU>
+	friend class VecSparseLeaf;
+
 	template <typename SR, typename IU, typename NUM, typename NUV, typename UDER> 
 	friend FullyDistSpVec<IU,typename promote_trait<NUM,NUV>::T_promote> 
 	SpMV (const SpParMat<IU,NUM,UDER> & A, const FullyDistSpVec<IU,NUV> & x );
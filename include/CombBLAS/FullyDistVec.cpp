@@ -285,6 +285,63 @@ FullyDistVec< IT,NT > &  FullyDistVec<IT,NT>::operator=(const FullyDistSpVec< IT
 	return *this;
 }
 
+template <class IT, class NT>
+template <class DERIVED>
+FullyDistVec<IT,NT>::FullyDistVec (const VecExpr<DERIVED> & expr)
+: FullyDist<IT,NT,typename combblas::disable_if< combblas::is_boolean<NT>::value, NT >::type>(GetDomain(expr).commGrid)
+{
+	*this = expr;
+}
+
+/**
+ * Evaluates all operations of the expression in one pass over the local array
+ * The vector may appear in the expression itself (e.g. v = Map(Lazy(v), op)), 
+ * as every entry is only read before it is written.
+ */
+template <class IT, class NT>
+template <class DERIVED>
+FullyDistVec<IT,NT> & FullyDistVec<IT,NT>::operator=(const VecExpr<DERIVED> & e)
+{
+	const DERIVED & expr = e.self();
+	VecDomain<IT> dom = GetDomain(e);
+	if(dom.IsSparse())
+	{
+		std::cout << "Sparse vector expressions can not be assigned to a dense vector, use Set() instead" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+	}
+	commGrid = dom.commGrid;
+	glen = dom.glen;
+	arr.resize(dom.size);	// no-op if this vector is an operand, so the cached operand arrays stay valid
+	NT * out = arr.data();
+	IT size = dom.size;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(IT i=0; i < size; ++i)
+		out[i] = static_cast<NT>(expr(i, i));
+	return *this;
+}
+
+//! Overwrites the entries in the domain of a sparse expression, fused version of Set(FullyDistSpVec)
+template <class IT, class NT>
+template <class DERIVED>
+void FullyDistVec<IT,NT>::Set(const VecExpr<DERIVED> & e)
+{
+	const DERIVED & expr = e.self();
+	VecDomain<IT> dom = GetDomain(e);
+	dom.Add(commGrid, glen, LocArrSize(), false, NULL);
+	NT * out = arr.data();
+	IT size = dom.size;
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(IT k=0; k < size; ++k)
+	{
+		IT i = dom.LocalIndex(k);
+		out[i] = static_cast<NT>(expr(k, i));
+	}
+}
+
 
 
 /**
@@ -593,6 +650,83 @@ NT FullyDistVec<IT,NT>::GetElement (IT indx) const
 	return ret;
 }
 
+/**
+ * Batched GetElement: each process fetches the entries at its own list of global indices
+ * (the lists may differ between processes) with one all-to-all for the requests and one for the answers.
+ * Collective, replaces a loop of GetElement calls that broadcast one entry each.
+ */
+template <class IT, class NT>
+std::vector<NT> FullyDistVec<IT,NT>::GetElements (const std::vector<IT> & indices) const
+{
+	OwnerExchange<IT> exchange(*this, indices);
+	std::vector<IT> requested;
+	exchange.Forward(exchange.LocalIndices(), requested);
+	std::vector<NT> answers(requested.size());
+	for(size_t i = 0; i < requested.size(); ++i)
+		answers[i] = arr[requested[i]];
+
+	std::vector<NT> results;
+	exchange.Reply(answers, results);
+	return results;
+}
+
+/**
+ * Nonblocking version of GetElements: the requests are in flight when this returns, and
+ * get() on the future serves them and collects the answers.
+ * get() is collective; all processes have to call it, in the same order for multiple outstanding batches,
+ * and the vector must not be modified or destroyed before that.
+ */
+template <class IT, class NT>
+std::future< std::vector<NT> > FullyDistVec<IT,NT>::GetElementsAsync (const std::vector<IT> & indices) const
+{
+	struct PendingRequests
+	{
+		PendingRequests(const FullyDistVec<IT,NT> & vec, const std::vector<IT> & indices): exchange(vec, indices) {}
+		OwnerExchange<IT> exchange;
+		std::vector<IT> sendbuf;
+		std::vector<IT> requested;
+		MPI_Request request;
+	};
+	std::shared_ptr<PendingRequests> pending = std::make_shared<PendingRequests>(*this, indices);
+	pending->exchange.Pack(pending->exchange.LocalIndices(), pending->sendbuf);
+	pending->exchange.IForward(pending->sendbuf, pending->requested, pending->request);
+
+	return std::async(std::launch::deferred, [this, pending]()
+	{
+		MPI_Wait(&(pending->request), MPI_STATUS_IGNORE);
+		std::vector<NT> answers(pending->requested.size());
+		for(size_t i = 0; i < pending->requested.size(); ++i)
+			answers[i] = arr[pending->requested[i]];
+		std::vector<NT> results;
+		pending->exchange.Reply(answers, results);
+		return results;
+	});
+}
+
+/**
+ * Batched SetElement: each process writes its own (index, value) pairs, with one all-to-all.
+ * Unlike SetElement, the processes do not have to pass the same arguments; if several
+ * processes write the same index, the one with the highest rank wins.
+ */
+template <class IT, class NT>
+void FullyDistVec<IT,NT>::SetElements (const std::vector<IT> & indices, const std::vector<NT> & values)
+{
+	if(indices.size() != values.size())
+	{
+		std::cout << "FullyDistVec::SetElements needs one value per index" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+	}
+	OwnerExchange<IT> exchange(*this, indices);
+	std::vector< std::pair<IT,NT> > updates(indices.size());
+	for(size_t k = 0; k < indices.size(); ++k)
+		updates[k] = std::make_pair(exchange.LocalIndices()[k], values[k]);
+
+	std::vector< std::pair<IT,NT> > received;
+	exchange.Forward(updates, received);
+	for(size_t i = 0; i < received.size(); ++i)	// grouped by sender rank
+		arr[received[i].first] = received[i].second;
+}
+
 // Write to file using MPI-2
 template <class IT, class NT>
 void FullyDistVec<IT,NT>::DebugPrint()
@@ -940,8 +1074,13 @@ void FullyDistVec<IT,NT>::iota(IT globalsize, NT first)
 	SpHelper::iota(arr.begin(), arr.end(), LengthUntil() + first);	// global across processors
 }
 
+/**
+ * Gather: Indexed[i] = this[ri[i]]
+ * @param[in] handleskew: first look for owners that would serve most of the requests and replicate their hot entries
+ * (see ReplicateHot). This costs an Allreduce of p words on every call, so it is off unless the caller expects skew
+ **/
 template <class IT, class NT>
-FullyDistVec<IT,NT> FullyDistVec<IT,NT>::operator() (const FullyDistVec<IT,IT> & ri) const
+FullyDistVec<IT,NT> FullyDistVec<IT,NT>::operator() (const FullyDistVec<IT,IT> & ri, bool handleskew) const
 {
 	if(!(*commGrid == *ri.commGrid))
 	{
@@ -956,13 +1095,26 @@ FullyDistVec<IT,NT> FullyDistVec<IT,NT>::operator() (const FullyDistVec<IT,IT> &
 	std::vector< std::vector< IT > > revr_map(nprocs);	// to put the incoming data to the correct location	
 
 	IT riloclen = ri.LocArrSize();
+	std::unordered_map<IT,NT> hot;	// replicated entries that are served locally
+	if(handleskew)
+		ReplicateHot(ri, hot);
 	for(IT i=0; i < riloclen; ++i)
 	{
+		if(!hot.empty())
+		{
+			auto it = hot.find(ri.arr[i]);
+			if(it != hot.end())
+			{
+				Indexed.arr[i] = it->second;
+				continue;
+			}
+		}
 		IT locind;
 		int owner = Owner(ri.arr[i], locind);	// numerical values in ri are 0-based
 		data_req[owner].push_back(locind);
 		revr_map[owner].push_back(i);
 	}
+	riloclen = std::accumulate(data_req.begin(), data_req.end(), static_cast<IT>(0), [](IT sum, const std::vector<IT> & req){ return sum + static_cast<IT>(req.size()); });
 	IT * sendbuf = new IT[riloclen];
 	int * sendcnt = new int[nprocs];
 	int * sdispls = new int[nprocs];
@@ -1030,6 +1182,77 @@ FullyDistVec<IT,NT> FullyDistVec<IT,NT>::operator() (const FullyDistVec<IT,IT> &
 }
 
 
+/**
+ * Skew handling for gathers: if a few owners would serve most of the requests in ri,
+ * the hot entries of those owners (found with a frequency sketch) are replicated to all processes
+ * @param[out] hot: (global index, value) pairs that can be served locally; empty if there is no skew
+ * @return the number of replicated entries
+ **/
+template <class IT, class NT>
+IT FullyDistVec<IT,NT>::ReplicateHot(const FullyDistVec<IT,IT> & ri, std::unordered_map<IT,NT> & hot) const
+{
+	MPI_Comm World = commGrid->GetWorld();
+	int nprocs = commGrid->GetSize();
+	int myrank = commGrid->GetRank();
+
+	IT riloclen = ri.LocArrSize();
+	std::vector<IT> sendcnt(nprocs, 0);
+	for(IT i=0; i < riloclen; ++i)
+	{
+		IT locind;
+		sendcnt[Owner(ri.arr[i], locind)]++;
+	}
+	std::vector<IT> load;
+	std::vector<bool> overloaded;
+	if(OverloadedOwners(World, sendcnt, load, overloaded) == 0)
+		return 0;
+
+	CountMinSketch<IT> sketch(glen);
+	IT hotrequests = 0;
+	for(IT i=0; i < riloclen; ++i)
+	{
+		IT locind;
+		if(overloaded[Owner(ri.arr[i], locind)])
+			sketch.Add(ri.arr[i]);
+	}
+	sketch.AllReduce(World);
+	for(int i=0; i < nprocs; ++i)
+		if(overloaded[i]) hotrequests += load[i];
+
+	// replicating an entry costs about nprocs words, serving it point-to-point costs one word per request
+	IT threshold = std::max(static_cast<IT>(nprocs), 2 * hotrequests / sketch.Width());
+	std::vector<IT> hotind;
+	std::vector<NT> hotnum;
+	if(overloaded[myrank])
+	{
+		IT offset = LengthUntil();
+		for(IT i=0; i < static_cast<IT>(arr.size()); ++i)
+		{
+			if(sketch.Estimate(i + offset) > threshold)
+			{
+				hotind.push_back(i + offset);
+				hotnum.push_back(arr[i]);
+			}
+		}
+	}
+
+	int nlochot = static_cast<int>(hotind.size());
+	std::vector<int> recvcnt(nprocs), rdispls(nprocs+1, 0);
+	MPI_Allgather(&nlochot, 1, MPI_INT, recvcnt.data(), 1, MPI_INT, World);
+	for(int i=0; i < nprocs; ++i)
+		rdispls[i+1] = rdispls[i] + recvcnt[i];
+	std::vector<IT> allind(rdispls[nprocs]);
+	std::vector<NT> allnum(rdispls[nprocs]);
+	MPI_Allgatherv(hotind.data(), nlochot, MPIType<IT>(), allind.data(), recvcnt.data(), rdispls.data(), MPIType<IT>(), World);
+	MPI_Allgatherv(hotnum.data(), nlochot, MPIType<NT>(), allnum.data(), recvcnt.data(), rdispls.data(), MPIType<NT>(), World);
+
+	hot.reserve(allind.size());
+	for(size_t i=0; i < allind.size(); ++i)
+		hot[allind[i]] = allnum[i];
+	return static_cast<IT>(allind.size());
+}
+
+
 template <class IT, class NT>
 void FullyDistVec<IT,NT>::PrintInfo(std::string vectorname) const
 {
@@ -36,10 +36,14 @@
 #include <utility>
 #include <iterator>
 #include <random>
+#include <future>
 #include "CombBLAS.h"
 #include "CommGrid.h"
 #include "FullyDist.h"
 #include "Exception.h"
+#include "FrequencySketch.h"
+#include "VecExpr.h"
+#include "OwnerExchange.h"
 
 namespace combblas {
 
@@ -71,6 +75,8 @@ public:
 
 	template <class ITRHS, class NTRHS>
 	FullyDistVec ( const FullyDistVec<ITRHS, NTRHS>& rhs ); // type converter constructor
+	template <class DERIVED>
+	explicit FullyDistVec ( const VecExpr<DERIVED> & expr );	// evaluates a lazy vector expression (see VecExpr.h)
 
 	class ScalarReadSaveHandler
 	{
@@ -122,6 +128,8 @@ public:
 	FullyDistVec<IT,NT> & operator=(const FullyDistVec< ITRHS,NTRHS > & rhs);	// assignment with type conversion
 	FullyDistVec<IT,NT> & operator=(const FullyDistVec<IT,NT> & rhs);	//!< Actual assignment operator
 	FullyDistVec<IT,NT> & operator=(const FullyDistSpVec<IT,NT> & rhs);		//!< FullyDistSpVec->FullyDistVec conversion operator
+	template <class DERIVED>
+	FullyDistVec<IT,NT> & operator=(const VecExpr<DERIVED> & expr);	//!< evaluates a lazy vector expression in one pass
     
     FullyDistVec<IT,NT> &  operator=(NT fixedval) // assign fixed value
     {
@@ -132,7 +140,8 @@ public:
             arr[i] = fixedval;
         return *this;
     }
-	FullyDistVec<IT,NT> operator() (const FullyDistVec<IT,IT> & ri) const;	//<! subsref
+	FullyDistVec<IT,NT> operator() (const FullyDistVec<IT,IT> & ri, bool handleskew = false) const;	//<! subsref (handleskew: replicate hot entries of skewed requests)
+	IT ReplicateHot(const FullyDistVec<IT,IT> & ri, std::unordered_map<IT,NT> & hot) const;	//<! hot entries requested by ri, replicated everywhere
 	
 	FullyDistVec<IT,NT> & operator+=(const FullyDistSpVec<IT,NT> & rhs);		
 	FullyDistVec<IT,NT> & operator+=(const FullyDistVec<IT,NT> & rhs);
@@ -147,8 +156,13 @@ public:
 	{
 		return GetElement(indx);
 	}
+	std::vector<NT> GetElements (const std::vector<IT> & indices) const;	//!< batched GetElement, one all-to-all for all indices
+	std::future< std::vector<NT> > GetElementsAsync (const std::vector<IT> & indices) const;	//!< ... completed by get() on the future
+	void SetElements (const std::vector<IT> & indices, const std::vector<NT> & values);	//!< batched SetElement
 
 	void Set(const FullyDistSpVec< IT,NT > & rhs);
+	template <class DERIVED>
+	void Set(const VecExpr<DERIVED> & expr);	//!< overwrites the entries in the domain of a (sparse) lazy expression
     template <class NT1, typename _BinaryOperationIdx, typename _BinaryOperationVal>
     void GSet (const FullyDistSpVec<IT,NT1> & spVec, _BinaryOperationIdx __binopIdx, _BinaryOperationVal __binopVal, MPI_Win win);
     template <class NT1, typename _BinaryOperationIdx>
@@ -0,0 +1,338 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _INDEX_CODEC_H_
+#define _INDEX_CODEC_H_
+
+#include <mpi.h>
+#include <stdint.h>
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include "SpDefs.h"
+
+namespace combblas {
+
+/**
+ * Adaptive encoding of the sorted int32_t index lists that sparse vectors travel with.
+ * Each message starts with one header byte that selects the smallest of
+ * - LIST: the raw indices
+ * - DELTA: the first index and the gaps between consecutive indices as varints
+ * - BITMAP: the first index as a varint and one bit per index in [first, last]
+ * Values are sent separately in the order of the indices, so they are identical for all three forms.
+ * Empty lists are encoded with zero bytes. Unsorted lists always use LIST.
+ * The collectives below never exchange byte counts: both sides know the number of indices of every message,
+ * so messages shorter than ENCODEMINNNZ indices go out as plain lists with the usual collective, and longer ones
+ * are encoded and received point-to-point into buffers of the largest possible encoded size.
+ */
+class IndexCodec
+{
+public:
+	enum Format { LIST = 0, DELTA = 1, BITMAP = 2 };
+
+	//! Number of bytes Encode() will write for these indices (at most 1 + 4*nnz)
+	static int EncodedSize(const int32_t * inds, int32_t nnz)
+	{
+		Format format;
+		return EncodedSize(inds, nnz, format);
+	}
+
+	static int EncodedSize(const int32_t * inds, int32_t nnz, Format & format)
+	{
+		format = LIST;
+		if(nnz == 0) return 0;
+		int64_t listbytes = 4 * static_cast<int64_t>(nnz);
+		if(!ENCODESPVECINDICES) return static_cast<int>(1 + listbytes);
+
+		int64_t deltabytes = VarintSize(static_cast<uint32_t>(inds[0]));
+		for(int32_t i=1; i<nnz; ++i)
+		{
+			if(inds[i] <= inds[i-1]) return static_cast<int>(1 + listbytes);	// not strictly increasing
+			deltabytes += VarintSize(static_cast<uint32_t>(inds[i] - inds[i-1]));
+		}
+		int64_t bitmapbytes = VarintSize(static_cast<uint32_t>(inds[0])) + (static_cast<int64_t>(inds[nnz-1]) - inds[0]) / 8 + 1;
+
+		int64_t best = listbytes;
+		if(deltabytes < best) { best = deltabytes; format = DELTA; }
+		if(bitmapbytes < best) { best = bitmapbytes; format = BITMAP; }
+		return static_cast<int>(1 + best);
+	}
+
+	//! Writes the encoding of inds to buf, which must hold EncodedSize(inds, nnz) bytes
+	//! \return number of bytes written
+	static int Encode(const int32_t * inds, int32_t nnz, uint8_t * buf)
+	{
+		Format format;
+		int bytes = EncodedSize(inds, nnz, format);
+		if(nnz == 0) return 0;
+		uint8_t * out = buf;
+		*out++ = static_cast<uint8_t>(format);
+		if(format == LIST)
+		{
+			std::copy(reinterpret_cast<const uint8_t*>(inds), reinterpret_cast<const uint8_t*>(inds + nnz), out);
+		}
+		else if(format == DELTA)
+		{
+			out = PutVarint(static_cast<uint32_t>(inds[0]), out);
+			for(int32_t i=1; i<nnz; ++i)
+				out = PutVarint(static_cast<uint32_t>(inds[i] - inds[i-1]), out);
+		}
+		else
+		{
+			out = PutVarint(static_cast<uint32_t>(inds[0]), out);
+			std::fill(out, buf + bytes, 0);
+			for(int32_t i=0; i<nnz; ++i)
+			{
+				int32_t bit = inds[i] - inds[0];
+				out[bit >> 3] |= static_cast<uint8_t>(1u << (bit & 7));
+			}
+		}
+		return bytes;
+	}
+
+	//! Recovers nnz indices from their encoding (the receiver always knows nnz from the value counts)
+	//! \return number of bytes consumed
+	static int Decode(const uint8_t * buf, int32_t nnz, int32_t * inds)
+	{
+		if(nnz == 0) return 0;
+		const uint8_t * in = buf;
+		Format format = static_cast<Format>(*in++);
+		if(format == LIST)
+		{
+			std::copy(in, in + 4 * static_cast<int64_t>(nnz), reinterpret_cast<uint8_t*>(inds));
+			in += 4 * static_cast<int64_t>(nnz);
+		}
+		else if(format == DELTA)
+		{
+			uint32_t value;
+			in = GetVarint(in, value);
+			inds[0] = static_cast<int32_t>(value);
+			for(int32_t i=1; i<nnz; ++i)
+			{
+				in = GetVarint(in, value);
+				inds[i] = inds[i-1] + static_cast<int32_t>(value);
+			}
+		}
+		else
+		{
+			uint32_t first;
+			in = GetVarint(in, first);
+			int32_t found = 0;
+			for(int32_t byte = 0; found < nnz; ++byte)
+			{
+				unsigned bits = in[byte];
+				while(bits)
+				{
+					int bit = __builtin_ctz(bits);
+					inds[found++] = static_cast<int32_t>(first) + (byte << 3) + bit;
+					bits &= bits - 1;
+				}
+			}
+			in += (inds[nnz-1] - static_cast<int32_t>(first)) / 8 + 1;
+		}
+		return static_cast<int>(in - buf);
+	}
+
+	//! Drop-in replacement for MPI_Sendrecv of two index lists whose lengths are known on both sides
+	static void Sendrecv(const int32_t * sendinds, int32_t sendnnz, int dest, int32_t * recvinds, int32_t recvnnz, int source, int tag, MPI_Comm comm)
+	{
+		std::vector<uint8_t> sendbuf, recvbuf;
+		const void * sendptr = sendinds;
+		int sendbytes = 4 * sendnnz;
+		if(!Plain(sendnnz))
+		{
+			sendbuf.resize(EncodedSize(sendinds, sendnnz));
+			Encode(sendinds, sendnnz, sendbuf.data());
+			sendptr = sendbuf.data();
+			sendbytes = static_cast<int>(sendbuf.size());
+		}
+		void * recvptr = recvinds;
+		int recvbytes = 4 * recvnnz;
+		if(!Plain(recvnnz))
+		{
+			recvbuf.resize(MaxEncodedSize(recvnnz));	// the actual message can be shorter
+			recvptr = recvbuf.data();
+			recvbytes = static_cast<int>(recvbuf.size());
+		}
+		MPI_Sendrecv(sendptr, sendbytes, MPI_UNSIGNED_CHAR, dest, tag,
+					 recvptr, recvbytes, MPI_UNSIGNED_CHAR, source, tag, comm, MPI_STATUS_IGNORE);
+		if(!Plain(recvnnz))
+			Decode(recvbuf.data(), recvnnz, recvinds);
+	}
+
+	//! Drop-in replacement for MPI_Allgatherv of index lists, recvcnts and displs are in indices
+	static void Allgatherv(const int32_t * sendinds, int32_t sendnnz, int32_t * recvinds, const int * recvcnts, const int * displs, MPI_Comm comm)
+	{
+		int nprocs, myrank;
+		MPI_Comm_size(comm, &nprocs);
+		MPI_Comm_rank(comm, &myrank);
+		std::vector<int> plaincnts(nprocs), rbytedispls(nprocs+1, 0);
+		for(int i=0; i<nprocs; ++i)
+		{
+			bool plain = Plain(recvcnts[i]) || i == myrank;
+			plaincnts[i] = plain ? recvcnts[i] : 0;
+			rbytedispls[i+1] = rbytedispls[i] + (plain ? 0 : MaxEncodedSize(recvcnts[i]));
+		}
+		std::vector<uint8_t> recvbuf(rbytedispls[nprocs]);
+		std::vector<uint8_t> sendbuf;
+		std::vector<MPI_Request> requests;
+		for(int i=0; i<nprocs; ++i)
+		{
+			if(rbytedispls[i+1] > rbytedispls[i])
+			{
+				requests.push_back(MPI_REQUEST_NULL);
+				MPI_Irecv(recvbuf.data() + rbytedispls[i], rbytedispls[i+1] - rbytedispls[i], MPI_UNSIGNED_CHAR, i, IDXCODED, comm, &requests.back());
+			}
+		}
+		int mycnt = sendnnz;
+		if(!Plain(sendnnz))
+		{
+			sendbuf.resize(EncodedSize(sendinds, sendnnz));
+			Encode(sendinds, sendnnz, sendbuf.data());
+			for(int i=0; i<nprocs; ++i)
+			{
+				if(i == myrank) continue;
+				requests.push_back(MPI_REQUEST_NULL);
+				MPI_Isend(sendbuf.data(), static_cast<int>(sendbuf.size()), MPI_UNSIGNED_CHAR, i, IDXCODED, comm, &requests.back());
+			}
+			mycnt = 0;	// only this process' own copy is left, done below
+		}
+		plaincnts[myrank] = mycnt;
+		MPI_Allgatherv(sendinds, mycnt, MPI_INT32_T, recvinds, plaincnts.data(), displs, MPI_INT32_T, comm);
+		MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+		if(mycnt != sendnnz)
+			std::copy(sendinds, sendinds + sendnnz, recvinds + displs[myrank]);
+
+#ifdef THREADED
+#pragma omp parallel for
+#endif
+		for(int i=0; i<nprocs; ++i)
+			if(rbytedispls[i+1] > rbytedispls[i])
+				Decode(recvbuf.data() + rbytedispls[i], recvcnts[i], recvinds + displs[i]);
+	}
+
+	//! Drop-in replacement for MPI_Alltoallv of index lists, counts and displacements are in indices
+	static void Alltoallv(const int32_t * sendinds, const int * sendcnts, const int * sdispls,
+						  int32_t * recvinds, const int * recvcnts, const int * rdispls, MPI_Comm comm)
+	{
+		int nprocs;
+		MPI_Comm_size(comm, &nprocs);
+		std::vector<int> plainsend(nprocs), plainrecv(nprocs), sendbytes(nprocs);
+		std::vector<int> sbytedispls(nprocs+1, 0), rbytedispls(nprocs+1, 0);
+#ifdef THREADED
+#pragma omp parallel for
+#endif
+		for(int i=0; i<nprocs; ++i)
+		{
+			plainsend[i] = Plain(sendcnts[i]) ? sendcnts[i] : 0;
+			plainrecv[i] = Plain(recvcnts[i]) ? recvcnts[i] : 0;
+			sendbytes[i] = Plain(sendcnts[i]) ? 0 : EncodedSize(sendinds + sdispls[i], sendcnts[i]);
+		}
+		for(int i=0; i<nprocs; ++i)
+		{
+			sbytedispls[i+1] = sbytedispls[i] + sendbytes[i];
+			rbytedispls[i+1] = rbytedispls[i] + (Plain(recvcnts[i]) ? 0 : MaxEncodedSize(recvcnts[i]));
+		}
+		std::vector<uint8_t> sendbuf(sbytedispls[nprocs]), recvbuf(rbytedispls[nprocs]);
+#ifdef THREADED
+#pragma omp parallel for
+#endif
+		for(int i=0; i<nprocs; ++i)
+			if(sendbytes[i] > 0)
+				Encode(sendinds + sdispls[i], sendcnts[i], sendbuf.data() + sbytedispls[i]);
+
+		std::vector<MPI_Request> requests;
+		for(int i=0; i<nprocs; ++i)
+		{
+			if(rbytedispls[i+1] > rbytedispls[i])
+			{
+				requests.push_back(MPI_REQUEST_NULL);
+				MPI_Irecv(recvbuf.data() + rbytedispls[i], rbytedispls[i+1] - rbytedispls[i], MPI_UNSIGNED_CHAR, i, IDXCODED, comm, &requests.back());
+			}
+		}
+		for(int i=0; i<nprocs; ++i)
+		{
+			if(sendbytes[i] > 0)
+			{
+				requests.push_back(MPI_REQUEST_NULL);
+				MPI_Isend(sendbuf.data() + sbytedispls[i], sendbytes[i], MPI_UNSIGNED_CHAR, i, IDXCODED, comm, &requests.back());
+			}
+		}
+		MPI_Alltoallv(sendinds, plainsend.data(), sdispls, MPI_INT32_T, recvinds, plainrecv.data(), rdispls, MPI_INT32_T, comm);
+		MPI_Waitall(static_cast<int>(requests.size()), requests.data(), MPI_STATUSES_IGNORE);
+
+#ifdef THREADED
+#pragma omp parallel for
+#endif
+		for(int i=0; i<nprocs; ++i)
+			if(rbytedispls[i+1] > rbytedispls[i])
+				Decode(recvbuf.data() + rbytedispls[i], recvcnts[i], recvinds + rdispls[i]);
+	}
+
+private:
+	//! Lists that are sent as they are, decided from the number of indices alone so that both sides agree
+	static bool Plain(int32_t nnz) { return !ENCODESPVECINDICES || nnz < ENCODEMINNNZ; }
+
+	static int MaxEncodedSize(int32_t nnz) { return (nnz == 0) ? 0 : 1 + 4 * nnz; }
+
+	static int VarintSize(uint32_t value)
+	{
+		int bytes = 1;
+		while(value >= 128) { value >>= 7; ++bytes; }
+		return bytes;
+	}
+
+	static uint8_t * PutVarint(uint32_t value, uint8_t * out)
+	{
+		while(value >= 128)
+		{
+			*out++ = static_cast<uint8_t>(value | 128);
+			value >>= 7;
+		}
+		*out++ = static_cast<uint8_t>(value);
+		return out;
+	}
+
+	static const uint8_t * GetVarint(const uint8_t * in, uint32_t & value)
+	{
+		value = 0;
+		int shift = 0;
+		while(*in & 128)
+		{
+			value |= static_cast<uint32_t>(*in++ & 127) << shift;
+			shift += 7;
+		}
+		value |= static_cast<uint32_t>(*in++) << shift;
+		return in;
+	}
+};
+
+}
+
+#endif
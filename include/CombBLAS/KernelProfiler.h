@@ -0,0 +1,550 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+
+#ifndef _KERNEL_PROFILER_H_
+#define _KERNEL_PROFILER_H_
+
+#include <mpi.h>
+#include <stdint.h>
+#include <cstdlib>
+#include <cstring>
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#ifdef KERNELPROFILE
+#ifdef USE_PAPI
+#include <papi.h>
+#include <pthread.h>
+#elif defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+#endif
+
+/**
+ * Opt-in roofline profiling of the hot local kernels (compile with -DKERNELPROFILE).
+ * A kernel opens a scope with KERNELPROFILE_SCOPE("name") and states its work with
+ * KERNELPROFILE_WORK(flops, bytes), where bytes models the compulsory memory traffic.
+ * Scopes accumulate wall time and, where the hardware allows, cycles and last level
+ * cache misses of all threads (PAPI with -DUSE_PAPI, perf_event otherwise).
+ * KernelProfiler::Report() compares the achieved throughput of each kernel with the
+ * roofline bound min(peak GFLOPS, intensity * peak GB/s) of the processes involved.
+ * Without KERNELPROFILE the macros expand to nothing.
+ */
+#ifdef KERNELPROFILE
+#define KERNELPROFILE_SCOPE(name) combblas::KernelProfileScope kernelprofile_scope(name)
+#define KERNELPROFILE_WORK(flops, bytes) kernelprofile_scope.SetWork(flops, bytes)
+#else
+#define KERNELPROFILE_SCOPE(name)
+#define KERNELPROFILE_WORK(flops, bytes)
+#endif
+
+namespace combblas {
+
+#ifndef KERNELPROFILE_PEAKGFLOPS
+#define KERNELPROFILE_PEAKGFLOPS 0	// peak GFLOPS of one process, 0 measures it (COMBBLAS_PEAK_GFLOPS overrides at run time)
+#endif
+
+#ifndef KERNELPROFILE_PEAKGBS
+#define KERNELPROFILE_PEAKGBS 0	// memory bandwidth of one process while all of them stream, 0 measures it (COMBBLAS_PEAK_GBS overrides)
+#endif
+
+#ifndef KERNELPROFILE_LINESIZE
+#define KERNELPROFILE_LINESIZE 64	// bytes read from memory per last level cache miss
+#endif
+
+#ifndef KERNELPROFILE_STREAMSIZE
+#define KERNELPROFILE_STREAMSIZE (1 << 21)	// doubles per array of the bandwidth probe, should exceed the last level cache
+#endif
+
+#ifndef KERNELPROFILE_MAXDEPTH
+#define KERNELPROFILE_MAXDEPTH 8	// profiled kernels nested deeper than this are not recorded
+#endif
+
+
+/**
+ * Cycles and last level cache misses of the calling thread
+ */
+class ThreadCounters
+{
+public:
+	static const int NEVENTS = 2;
+
+	ThreadCounters(): valid(false)
+	{
+		std::fill_n(started, KERNELPROFILE_MAXDEPTH, false);
+#if defined(KERNELPROFILE) && defined(USE_PAPI)
+		eventset = PAPI_NULL;
+		int events[NEVENTS] = {PAPI_TOT_CYC, PAPI_L3_TCM};
+		valid = PapiInit() && PAPI_register_thread() == PAPI_OK && PAPI_create_eventset(&eventset) == PAPI_OK
+			&& PAPI_add_events(eventset, events, NEVENTS) == PAPI_OK && PAPI_start(eventset) == PAPI_OK;
+#elif defined(KERNELPROFILE) && defined(__linux__)
+		uint64_t configs[NEVENTS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES};
+		valid = true;
+		for(int i = 0; i < NEVENTS; ++i)
+		{
+			struct perf_event_attr attr;
+			memset(&attr, 0, sizeof(attr));
+			attr.size = sizeof(attr);
+			attr.type = PERF_TYPE_HARDWARE;
+			attr.config = configs[i];
+			attr.exclude_kernel = 1;
+			attr.exclude_hv = 1;
+			fds[i] = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0));
+			valid = valid && (fds[i] >= 0);
+		}
+#endif
+	}
+
+	~ThreadCounters()
+	{
+#if defined(KERNELPROFILE) && defined(USE_PAPI)
+		if(valid)
+		{
+			long long values[NEVENTS];
+			PAPI_stop(eventset, values);
+			PAPI_cleanup_eventset(eventset);
+			PAPI_destroy_eventset(&eventset);
+		}
+#elif defined(KERNELPROFILE) && defined(__linux__)
+		for(int i = 0; i < NEVENTS; ++i)
+			if(fds[i] >= 0) close(fds[i]);
+#endif
+	}
+
+	//! Current counts, false if the counters are not available
+	bool Read(uint64_t * values)
+	{
+		if(!valid) return false;
+#if defined(KERNELPROFILE) && defined(USE_PAPI)
+		long long counts[NEVENTS];
+		if(PAPI_read(eventset, counts) != PAPI_OK) return false;
+		for(int i = 0; i < NEVENTS; ++i) values[i] = static_cast<uint64_t>(counts[i]);
+#elif defined(KERNELPROFILE) && defined(__linux__)
+		for(int i = 0; i < NEVENTS; ++i)
+			if(read(fds[i], &values[i], sizeof(uint64_t)) != sizeof(uint64_t)) return false;
+#endif
+		return true;
+	}
+
+	bool Valid() const { return valid; }
+
+	static ThreadCounters & Local()
+	{
+		static thread_local ThreadCounters counters;
+		return counters;
+	}
+
+	static const char * Backend()
+	{
+#if defined(KERNELPROFILE) && defined(USE_PAPI)
+		return "papi";
+#elif defined(KERNELPROFILE) && defined(__linux__)
+		return "perf_event";
+#else
+		return "none";
+#endif
+	}
+
+	uint64_t start[KERNELPROFILE_MAXDEPTH][NEVENTS];	// counts when the scope at that depth began
+	bool started[KERNELPROFILE_MAXDEPTH];
+
+private:
+#if defined(KERNELPROFILE) && defined(USE_PAPI)
+	static unsigned long ThreadId() { return static_cast<unsigned long>(pthread_self()); }
+	static bool PapiInit()
+	{
+		static bool ok = (PAPI_library_init(PAPI_VER_CURRENT) == PAPI_VER_CURRENT) && (PAPI_thread_init(ThreadId) == PAPI_OK);
+		return ok;
+	}
+	int eventset;
+#else
+	int fds[NEVENTS];
+#endif
+	bool valid;
+};
+
+
+/**
+ * Profile of one kernel, aggregated over all processes by KernelProfiler::Summarize
+ */
+struct KernelProfile
+{
+	std::string name;
+	int64_t calls;
+	double seconds;		// accumulated time of the slowest process
+	double flops;		// model, summed over processes
+	double bytes;		// model of the memory traffic, summed over processes
+	double cycles;		// hardware counts summed over processes, valid only if counters is true
+	double llcmisses;
+	bool counters;		// every call on every process was counted by the hardware
+
+	double intensity;	// flops per modeled byte
+	double measuredintensity;	// flops per byte missed in the last level cache, 0 without counters
+	double achieved;	// GFLOPS, or GB/s for kernels without flops (e.g. merging)
+	double bound;		// roofline bound in the same unit
+	double efficiency;	// achieved / bound
+	bool memorybound;
+};
+
+
+class KernelProfiler
+{
+public:
+	//! Whether kernels should record at the given nesting depth (never inside a parallel region)
+	static bool Active()
+	{
+#ifdef _OPENMP
+		if(omp_in_parallel()) return false;
+#endif
+		return Depth() < KERNELPROFILE_MAXDEPTH;
+	}
+
+	static int & Depth()
+	{
+		static int depth = 0;
+		return depth;
+	}
+
+	//! Snapshots the counters of all threads for the scope at the given depth
+	static void StartCounters(int depth)
+	{
+		if(!CountersAvailable()) return;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+		{
+			ThreadCounters & tc = ThreadCounters::Local();
+			tc.started[depth] = tc.Read(tc.start[depth]);
+		}
+	}
+
+	//! Cycles and misses of all threads since StartCounters(depth), false if some thread was not counted
+	static bool StopCounters(int depth, double & cycles, double & misses)
+	{
+		cycles = 0;
+		misses = 0;
+		if(!CountersAvailable()) return false;
+		int uncounted = 0;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:cycles,misses,uncounted)
+#endif
+		{
+			ThreadCounters & tc = ThreadCounters::Local();
+			uint64_t now[ThreadCounters::NEVENTS];
+			if(tc.started[depth] && tc.Read(now))
+			{
+				cycles += static_cast<double>(now[0] - tc.start[depth][0]);
+				misses += static_cast<double>(now[1] - tc.start[depth][1]);
+			}
+			else
+			{
+				uncounted += 1;
+			}
+			tc.started[depth] = false;
+		}
+		return (uncounted == 0);
+	}
+
+	static void Record(const char * name, double seconds, double flops, double bytes, bool counted, double cycles, double misses)
+	{
+		Entry & e = Registry()[name];
+		e.values[CALLS] += 1;
+		e.values[FLOPS] += flops;
+		e.values[BYTES] += bytes;
+		e.values[CYCLES] += cycles;
+		e.values[MISSES] += misses;
+		e.values[UNCOUNTED] += counted ? 0 : 1;
+		e.seconds += seconds;
+	}
+
+	static void Reset()
+	{
+		Registry().clear();
+	}
+
+	/**
+	 * Sets the per-process peaks of the roofline. Peaks that are not configured through
+	 * KERNELPROFILE_PEAKGFLOPS/KERNELPROFILE_PEAKGBS or COMBBLAS_PEAK_GFLOPS/COMBBLAS_PEAK_GBS are
+	 * measured with all processes of comm running the probes at the same time.
+	 * Collective; the most conservative process determines the peaks.
+	 */
+	static void Calibrate(MPI_Comm comm)
+	{
+		double peaks[2] = {KERNELPROFILE_PEAKGFLOPS, KERNELPROFILE_PEAKGBS};
+		if(getenv("COMBBLAS_PEAK_GFLOPS")) peaks[0] = atof(getenv("COMBBLAS_PEAK_GFLOPS"));
+		if(getenv("COMBBLAS_PEAK_GBS")) peaks[1] = atof(getenv("COMBBLAS_PEAK_GBS"));
+		MPI_Barrier(comm);
+		if(peaks[1] <= 0) peaks[1] = MeasureBandwidth();
+		MPI_Barrier(comm);
+		if(peaks[0] <= 0) peaks[0] = MeasureFlops();
+		MPI_Allreduce(MPI_IN_PLACE, peaks, 2, MPI_DOUBLE, MPI_MIN, comm);
+		Peaks()[0] = peaks[0];
+		Peaks()[1] = peaks[1];
+	}
+
+	static double PeakGFlops() { return Peaks()[0]; }
+	static double PeakGBs() { return Peaks()[1]; }
+
+	//! Collective, returns the same profiles on all processes, sorted by kernel name
+	static std::vector<KernelProfile> Summarize(MPI_Comm comm)
+	{
+		int nprocs;
+		MPI_Comm_size(comm, &nprocs);
+		if(PeakGFlops() <= 0 || PeakGBs() <= 0)
+			Calibrate(comm);
+
+		// kernels recorded anywhere
+		std::string mynames;
+		for(auto it = Registry().begin(); it != Registry().end(); ++it)
+			mynames += it->first + '\n';
+		int mylen = static_cast<int>(mynames.size());
+		std::vector<int> lens(nprocs), dpls(nprocs, 0);
+		MPI_Allgather(&mylen, 1, MPI_INT, lens.data(), 1, MPI_INT, comm);
+		for(int i = 1; i < nprocs; ++i) dpls[i] = dpls[i-1] + lens[i-1];
+		std::vector<char> allnames(dpls[nprocs-1] + lens[nprocs-1] + 1);
+		MPI_Allgatherv(mynames.data(), mylen, MPI_CHAR, allnames.data(), lens.data(), dpls.data(), MPI_CHAR, comm);
+		std::set<std::string> names;
+		std::istringstream iss(std::string(allnames.begin(), allnames.end() - 1));
+		std::string name;
+		while(std::getline(iss, name)) names.insert(name);
+
+		int nkernels = static_cast<int>(names.size());
+		std::vector<double> sums(nkernels * NVALUES, 0.0), maxtimes(nkernels, 0.0);
+		int k = 0;
+		for(auto it = names.begin(); it != names.end(); ++it, ++k)
+		{
+			auto found = Registry().find(*it);
+			if(found == Registry().end()) continue;
+			std::copy(found->second.values, found->second.values + NVALUES, sums.begin() + k * NVALUES);
+			maxtimes[k] = found->second.seconds;
+		}
+		MPI_Allreduce(MPI_IN_PLACE, sums.data(), nkernels * NVALUES, MPI_DOUBLE, MPI_SUM, comm);
+		MPI_Allreduce(MPI_IN_PLACE, maxtimes.data(), nkernels, MPI_DOUBLE, MPI_MAX, comm);
+
+		double peakgflops = nprocs * PeakGFlops(), peakgbs = nprocs * PeakGBs();
+		std::vector<KernelProfile> profiles;
+		k = 0;
+		for(auto it = names.begin(); it != names.end(); ++it, ++k)
+		{
+			const double * v = sums.data() + k * NVALUES;
+			KernelProfile p;
+			p.name = *it;
+			p.calls = static_cast<int64_t>(v[CALLS]);
+			p.seconds = maxtimes[k];
+			p.flops = v[FLOPS];
+			p.bytes = v[BYTES];
+			p.cycles = v[CYCLES];
+			p.llcmisses = v[MISSES];
+			p.counters = (v[UNCOUNTED] == 0);
+			p.intensity = (p.bytes > 0) ? p.flops / p.bytes : 0;
+			p.measuredintensity = (p.counters && p.llcmisses > 0) ? p.flops / (p.llcmisses * KERNELPROFILE_LINESIZE) : 0;
+
+			// the measured traffic is what the kernel actually moved, the model only bounds it from below
+			double intensity = (p.measuredintensity > 0) ? p.measuredintensity : p.intensity;
+			if(p.flops > 0)
+			{
+				p.achieved = (p.seconds > 0) ? p.flops / p.seconds / 1e9 : 0;
+				p.bound = std::min(peakgflops, intensity * peakgbs);
+				p.memorybound = (intensity * peakgbs < peakgflops);
+			}
+			else
+			{
+				double bytes = (p.counters && p.llcmisses > 0) ? p.llcmisses * KERNELPROFILE_LINESIZE : p.bytes;
+				p.achieved = (p.seconds > 0) ? bytes / p.seconds / 1e9 : 0;
+				p.bound = peakgbs;
+				p.memorybound = true;
+			}
+			p.efficiency = (p.bound > 0) ? p.achieved / p.bound : 0;
+			profiles.push_back(p);
+		}
+		return profiles;
+	}
+
+	//! Collective, the first process of comm prints the roofline table
+	static void Report(MPI_Comm comm, std::ostream & os = std::cout)
+	{
+		int myrank, nprocs;
+		MPI_Comm_rank(comm, &myrank);
+		MPI_Comm_size(comm, &nprocs);
+		std::vector<KernelProfile> profiles = Summarize(comm);
+		if(myrank != 0) return;
+
+		std::ostringstream outs;
+		outs << "Roofline of " << nprocs << " processes: " << nprocs * PeakGFlops() << " GFLOPS, " << nprocs * PeakGBs() << " GB/s, counters: " << ThreadCounters::Backend() << std::endl;
+		outs << std::left << std::setw(20) << "kernel" << std::right << std::setw(8) << "calls" << std::setw(12) << "seconds" << std::setw(12) << "achieved"
+			<< std::setw(12) << "bound" << std::setw(10) << "%bound" << std::setw(10) << "AI" << std::setw(12) << "AI(llc)" << std::setw(12) << "Gcycles" << "  limit" << std::endl;
+		for(size_t i = 0; i < profiles.size(); ++i)
+		{
+			const KernelProfile & p = profiles[i];
+			outs << std::left << std::setw(20) << p.name << std::right << std::setw(8) << p.calls << std::setw(12) << p.seconds
+				<< std::setw(12) << p.achieved << std::setw(12) << p.bound << std::setw(10) << 100 * p.efficiency << std::setw(10) << p.intensity;
+			if(p.counters) outs << std::setw(12) << p.measuredintensity << std::setw(12) << p.cycles / 1e9;
+			else outs << std::setw(12) << "-" << std::setw(12) << "-";
+			outs << "  " << (p.flops > 0 ? (p.memorybound ? "memory" : "compute") : "memory (GB/s)") << std::endl;
+		}
+		os << outs.str();
+	}
+
+private:
+	enum { CALLS, FLOPS, BYTES, CYCLES, MISSES, UNCOUNTED, NVALUES };
+	struct Entry
+	{
+		Entry(): seconds(0) { std::fill_n(values, static_cast<int>(NVALUES), 0.0); }
+		double values[NVALUES];
+		double seconds;
+	};
+
+	static std::map<std::string, Entry> & Registry()
+	{
+		static std::map<std::string, Entry> registry;
+		return registry;
+	}
+
+	static double * Peaks()
+	{
+		static double peaks[2] = {0, 0};
+		return peaks;
+	}
+
+	static bool CountersAvailable()
+	{
+		static bool available = ThreadCounters::Local().Valid();
+		return available;
+	}
+
+	//! Best triad bandwidth of this process in GB/s
+	static double MeasureBandwidth()
+	{
+		const int64_t n = KERNELPROFILE_STREAMSIZE;
+		std::vector<double> a(n), b(n), c(n);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+		for(int64_t i = 0; i < n; ++i) { a[i] = 0; b[i] = 1; c[i] = 2; }
+		double best = 0;
+		for(int r = 0; r < 4; ++r)
+		{
+			double t = MPI_Wtime();
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+			for(int64_t i = 0; i < n; ++i) a[i] = b[i] + 3.0 * c[i];
+			t = MPI_Wtime() - t;
+			if(t > 0) best = std::max(best, 3.0 * sizeof(double) * n / t / 1e9);
+		}
+		volatile double keep = a[n/2];	// keeps the triad alive
+		(void) keep;
+		return best;
+	}
+
+	//! Multiply-add throughput of this process in GFLOPS, with independent chains on every thread
+	static double MeasureFlops()
+	{
+		const int chains = 16;
+		const int64_t iters = 1 << 22;
+		double sink = 0;
+		double t = MPI_Wtime();
+		int nthreads = 1;
+#ifdef _OPENMP
+#pragma omp parallel reduction(+:sink)
+#endif
+		{
+#ifdef _OPENMP
+#pragma omp master
+			nthreads = omp_get_num_threads();
+#endif
+			double acc[chains];
+			for(int j = 0; j < chains; ++j) acc[j] = 1.0 + j * 1e-3;
+			for(int64_t i = 0; i < iters; ++i)
+				for(int j = 0; j < chains; ++j)
+					acc[j] = acc[j] * 0.999999 + 1e-7;
+			for(int j = 0; j < chains; ++j) sink += acc[j];
+		}
+		t = MPI_Wtime() - t;
+		volatile double keep = sink;
+		(void) keep;
+		return (t > 0) ? 2.0 * chains * iters * nthreads / t / 1e9 : 0;
+	}
+};
+
+
+/**
+ * Times (and counts) the enclosing block as one call of the named kernel
+ */
+class KernelProfileScope
+{
+public:
+	KernelProfileScope(const char * kernel): name(kernel), flops(0), bytes(0)
+	{
+		active = KernelProfiler::Active();
+		if(!active) return;
+		depth = KernelProfiler::Depth()++;
+		KernelProfiler::StartCounters(depth);
+		t0 = MPI_Wtime();
+	}
+
+	//! Modeled work of this call: floating point operations and bytes of compulsory memory traffic
+	void SetWork(double f, double b)
+	{
+		flops = f;
+		bytes = b;
+	}
+
+	~KernelProfileScope()
+	{
+		if(!active) return;
+		double seconds = MPI_Wtime() - t0;
+		double cycles, misses;
+		bool counted = KernelProfiler::StopCounters(depth, cycles, misses);
+		--KernelProfiler::Depth();
+		KernelProfiler::Record(name, seconds, flops, bytes, counted, cycles, misses);
+	}
+
+private:
+	const char * name;
+	double flops, bytes, t0;
+	int depth;
+	bool active;
+};
+
+}
+
+#endif
@@ -382,6 +382,7 @@ SpTuples<IT, NT>* MultiwayMerge( std::vector<SpTuples<IT,NT> *> & ArrSpTups, IT
         }
     }
     
+    KERNELPROFILE_SCOPE("MultiwayMerge");
     int nthreads = 1;	
 #ifdef THREADED
 #pragma omp parallel
@@ -421,6 +422,8 @@ SpTuples<IT, NT>* MultiwayMerge( std::vector<SpTuples<IT,NT> *> & ArrSpTups, IT
     for(int i=0; i<nsplits; ++i)
         mdisp[i+1] = mdisp[i] + mergedNnzPerSplit[i];
     IT mergedNnzAll = mdisp[nsplits];
+    // no flops: the inputs are read by the counting and the merging pass, the output is written once
+    KERNELPROFILE_WORK(0, (2.0 * std::accumulate(inputNnzPerSplit.begin(), inputNnzPerSplit.end(), 0.0) + mergedNnzAll) * sizeof(std::tuple<IT,IT,NT>));
     
     
 #ifdef COMBBLAS_DEBUG
@@ -508,6 +511,7 @@ SpTuples<IT, NT>* MultiwayMerge( std::vector<SpTuples<IT,NT> *> & ArrSpTups, IT
             }
         }
         
+        KERNELPROFILE_SCOPE("MultiwayMergeHash");
         int nthreads = 1;
 #ifdef THREADED
 #pragma omp parallel
@@ -570,6 +574,8 @@ SpTuples<IT, NT>* MultiwayMerge( std::vector<SpTuples<IT,NT> *> & ArrSpTups, IT
         for(int i=0; i<nsplits; ++i)
             mdisp[i+1] = mdisp[i] + mergedNnzPerSplit[i];
         IT mergedNnzAll = mdisp[nsplits];
+        KERNELPROFILE_WORK(0, (2.0 * std::accumulate(ArrSpTups.begin(), ArrSpTups.end(), 0.0, [](double sum, SpTuples<IT,NT> * t){ return sum + t->getnnz(); })
+                              + mergedNnzAll) * sizeof(std::tuple<IT,IT,NT>));
         
    
 
@@ -0,0 +1,156 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _OWNER_EXCHANGE_H_
+#define _OWNER_EXCHANGE_H_
+
+#include <mpi.h>
+#include <iostream>
+#include <vector>
+#include "MPIType.h"
+#include "SpDefs.h"
+
+namespace combblas {
+
+/**
+ * Routes a batch of element requests on a distributed vector to the owners of the elements.
+ * Each process brings its own list of global indices (lists may differ and be empty).
+ * The constructor groups them by owner and exchanges the counts; Forward() then ships one
+ * item per request (local indices, or index/value pairs) with a single all-to-all, and
+ * Reply() returns one answer per received request back to the requesters, in request order.
+ * Used by the batched GetElements/SetElements of FullyDistVec and FullyDistSpVec.
+ **/
+template <class IT>
+class OwnerExchange
+{
+public:
+	template <class VEC>
+	OwnerExchange(const VEC & vec, const std::vector<IT> & gind)
+	{
+		World = vec.getcommgrid()->GetWorld();
+		int nprocs;
+		MPI_Comm_size(World, &nprocs);
+		IT glen = vec.TotalLength();
+		size_t nreqs = gind.size();
+		std::vector<int> owner(nreqs);
+		locind.resize(nreqs);
+		int outofrange = 0;
+		sendcnt.assign(nprocs, 0);
+		for(size_t k = 0; k < nreqs; ++k)
+		{
+			if(gind[k] < 0 || gind[k] >= glen)
+			{
+				outofrange = 1;
+				owner[k] = 0;
+				locind[k] = 0;
+			}
+			else
+				owner[k] = vec.Owner(gind[k], locind[k]);
+			++sendcnt[owner[k]];
+		}
+		MPI_Allreduce(MPI_IN_PLACE, &outofrange, 1, MPI_INT, MPI_MAX, World);
+		if(outofrange)
+		{
+			int myrank;
+			MPI_Comm_rank(World, &myrank);
+			if(myrank == 0) std::cout << "Batched element access with an index outside of [0," << glen << ")" << std::endl;
+			MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+		}
+
+		sdispls.assign(nprocs+1, 0);
+		for(int i = 0; i < nprocs; ++i)
+			sdispls[i+1] = sdispls[i] + sendcnt[i];
+		slot.resize(nreqs);	// counting sort by owner, stable within an owner
+		std::vector<int> next(sdispls.begin(), sdispls.end()-1);
+		for(size_t k = 0; k < nreqs; ++k)
+			slot[k] = next[owner[k]]++;
+
+		recvcnt.resize(nprocs);
+		MPI_Alltoall(sendcnt.data(), 1, MPI_INT, recvcnt.data(), 1, MPI_INT, World);
+		rdispls.assign(nprocs+1, 0);
+		for(int i = 0; i < nprocs; ++i)
+			rdispls[i+1] = rdispls[i] + recvcnt[i];
+	}
+
+	//! Local indices (within the owner) of the requests, in request order
+	const std::vector<IT> & LocalIndices() const { return locind; }
+	//! Number of requests this process has to serve
+	int ReceivedCount() const { return rdispls.back(); }
+
+	//! Arranges one item per request in the order of the send buffer
+	template <class T>
+	void Pack(const std::vector<T> & items, std::vector<T> & sendbuf) const
+	{
+		sendbuf.resize(slot.size());
+		for(size_t k = 0; k < slot.size(); ++k)
+			sendbuf[slot[k]] = items[k];
+	}
+
+	//! Ships a packed buffer to the owners without blocking, sendbuf and recvbuf have to stay untouched until completion
+	template <class T>
+	void IForward(const std::vector<T> & sendbuf, std::vector<T> & recvbuf, MPI_Request & request) const
+	{
+		recvbuf.resize(ReceivedCount());
+		MPI_Ialltoallv(sendbuf.data(), sendcnt.data(), sdispls.data(), MPIType<T>(), recvbuf.data(), recvcnt.data(), rdispls.data(), MPIType<T>(), World, &request);
+	}
+
+	//! Ships one item per request to its owner, recvbuf is grouped by requesting process
+	template <class T>
+	void Forward(const std::vector<T> & items, std::vector<T> & recvbuf) const
+	{
+		std::vector<T> sendbuf;
+		Pack(items, sendbuf);
+		recvbuf.resize(ReceivedCount());
+		MPI_Alltoallv(sendbuf.data(), sendcnt.data(), sdispls.data(), MPIType<T>(), recvbuf.data(), recvcnt.data(), rdispls.data(), MPIType<T>(), World);
+	}
+
+	//! Returns one answer per received request (in the order of Forward's recvbuf) to the requesters
+	template <class T>
+	void Reply(const std::vector<T> & answers, std::vector<T> & results) const
+	{
+		std::vector<T> recvbuf(slot.size());
+		MPI_Alltoallv(answers.data(), recvcnt.data(), rdispls.data(), MPIType<T>(), recvbuf.data(), sendcnt.data(), sdispls.data(), MPIType<T>(), World);
+		results.resize(slot.size());
+		for(size_t k = 0; k < slot.size(); ++k)
+			results[k] = recvbuf[slot[k]];
+	}
+
+private:
+	MPI_Comm World;
+	std::vector<IT> locind;
+	std::vector<int> slot;	// position of each request in the send buffer
+	std::vector<int> sendcnt;
+	std::vector<int> sdispls;
+	std::vector<int> recvcnt;
+	std::vector<int> rdispls;
+};
+
+}
+
+#endif
@@ -27,6 +27,9 @@
 #include <algorithm>
 #include <math.h>
 #include "utils.h"
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 
 
 
@@ -103,6 +106,83 @@ namespace intSort {
 
     free(B); free(Tmp); free(counts);
   }
+
+  // CombBLAS: stable LSD radix sort of 64-bit keys that carries a payload along
+  // Multithreaded with OpenMP: each thread histograms and scatters its own contiguous chunk
+  // Passes in which all keys share the same digit are skipped
+  template <class P>
+  void parallelKeySort(uint64_t *keys, P *payload, int64_t n, uint64_t maxkey) {
+    int bits = 0;
+    while (bits < 64 && (maxkey >> bits) != 0) bits++;
+    if (n < 2 || bits == 0) return;
+
+    uint64_t *K2 = new uint64_t[n];
+    P *P2 = new P[n];
+    uint64_t *srcK = keys, *dstK = K2;
+    P *srcP = payload, *dstP = P2;
+    int maxthreads = 1;
+#ifdef _OPENMP
+    maxthreads = omp_get_max_threads();
+#endif
+    int64_t *counts = new int64_t[(int64_t) maxthreads * BUCKETS];
+    bool skip = false;
+
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+    {
+      int nthr = 1, t = 0;
+#ifdef _OPENMP
+      nthr = omp_get_num_threads();
+      t = omp_get_thread_num();
+#endif
+      int64_t lo = n * t / nthr, hi = n * (t+1) / nthr;
+      int64_t *mycnt = counts + (int64_t) t * BUCKETS;
+      for (int shift = 0; shift < bits; shift += MAX_RADIX) {
+        for (int b = 0; b < BUCKETS; b++) mycnt[b] = 0;
+        for (int64_t j = lo; j < hi; j++) mycnt[(srcK[j] >> shift) & (BUCKETS-1)]++;
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+        {
+          // exclusive prefix sum in (bucket, thread) order keeps the sort stable
+          int64_t s = 0;
+          skip = false;
+          for (int b = 0; b < BUCKETS; b++) {
+            int64_t total = 0;
+            for (int th = 0; th < nthr; th++) total += counts[(int64_t) th * BUCKETS + b];
+            if (total == n) skip = true;
+            for (int th = 0; th < nthr; th++) {
+              int64_t c = counts[(int64_t) th * BUCKETS + b];
+              counts[(int64_t) th * BUCKETS + b] = s;
+              s += c;
+            }
+          }
+        }
+        if (!skip) {
+          for (int64_t j = lo; j < hi; j++) {
+            int64_t x = mycnt[(srcK[j] >> shift) & (BUCKETS-1)]++;
+            dstK[x] = srcK[j];
+            dstP[x] = srcP[j];
+          }
+#ifdef _OPENMP
+#pragma omp barrier
+#pragma omp single
+#endif
+          {
+            std::swap(srcK, dstK);
+            std::swap(srcP, dstP);
+          }
+        }
+      }
+    }
+    if (srcK != keys) {
+      std::copy(srcK, srcK + n, keys);
+      std::copy(srcP, srcP + n, payload);
+    }
+    delete [] K2; delete [] P2; delete [] counts;
+  }
 }
 
 // ADAM: added inline to remove "defined but not used" warning
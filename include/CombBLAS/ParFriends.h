@@ -39,6 +39,8 @@
 #include "MPIType.h"
 #include "Friends.h"
 #include "OptBuf.h"
+#include "IndexCodec.h"
+#include "SemiringTraits.h"
 #include "mtSpGEMM.h"
 #include "MultiwayMerge.h"
 #include <unistd.h>
@@ -1573,7 +1575,7 @@ void TransposeVector(MPI_Comm & World, const FullyDistSpVec<IU,NV> & x, int32_t
 #endif
 	for(int i=0; i< xlocnz; ++i)
         temp_xind[i] = (int32_t) x.ind[i];
-	MPI_Sendrecv(temp_xind, xlocnz, MPIType<int32_t>(), diagneigh, TRI, trxinds, trxlocnz, MPIType<int32_t>(), diagneigh, TRI, World, &status);
+	IndexCodec::Sendrecv(temp_xind, xlocnz, diagneigh, trxinds, trxlocnz, diagneigh, TRI, World);	// dense frontiers travel as bitmaps
 	delete [] temp_xind;
 	if(!indexisvalue)
 	{
@@ -1618,7 +1620,7 @@ void AllGatherVector(MPI_Comm & ColWorld, int trxlocnz, IU lenuntil, int32_t * &
 #ifdef TIMING
 	double t0=MPI_Wtime();
 #endif
-	MPI_Allgatherv(trxinds, trxlocnz, MPIType<int32_t>(), indacc, colnz, dpls, MPIType<int32_t>(), ColWorld);
+	IndexCodec::Allgatherv(trxinds, trxlocnz, indacc, colnz, dpls, ColWorld);
 	
 	delete [] trxinds;
 	if(indexisvalue)
@@ -1791,6 +1793,49 @@ void MergeContributions(int*  listSizes, std::vector<int32_t *> & indsvec, std::
 
 
 
+/**
+ * Merges lists with indices in [lo,hi) in a dense accumulator instead of a heap
+ * The lists are added in list order and the result is read back in index order from the bitmap, so nothing is sorted
+ * \pre {SR::add is commutative, since contributions to an index are not combined in heap order}
+ */
+template <typename SR, typename IU, typename OVT>
+void MergeContributionsSPA(int* listSizes, std::vector<int32_t *> & indsvec, std::vector<OVT *> & numsvec, std::vector<IU>& mergedind, std::vector<OVT>& mergednum, int32_t lo, int32_t hi)
+{
+    int32_t range = hi - lo;
+    std::vector<OVT> spa(range);
+    BitMap isthere(range);
+    int nlists = indsvec.size();
+    for(int i=0; i< nlists; ++i)
+    {
+        for(int k=0; k< listSizes[i]; ++k)
+        {
+            int32_t loc = indsvec[i][k] - lo;
+            if(isthere.get_bit(loc))
+            {
+                if(!IsSaturated<SR>(spa[loc]))
+                    spa[loc] = SR::add(spa[loc], numsvec[i][k]);
+            }
+            else
+            {
+                isthere.set_bit(loc);
+                spa[loc] = numsvec[i][k];
+            }
+        }
+    }
+    uint64_t * words = isthere.data();
+    int32_t nwords = (range + 63) / 64;
+    for(int32_t w=0; w< nwords; ++w)
+    {
+        for(uint64_t bits = words[w]; bits != 0; bits &= bits - 1)
+        {
+            int32_t loc = w * 64 + __builtin_ctzll(bits);
+            mergedind.push_back(static_cast<IU>(loc + lo));
+            mergednum.push_back(spa[loc]);
+        }
+    }
+}
+
+
 template <typename SR, typename IU, typename OVT>
 void MergeContributions_threaded(int * & listSizes, std::vector<int32_t *> & indsvec, std::vector<OVT *> & numsvec, std::vector<IU> & mergedind, std::vector<OVT> & mergednum, IU maxindex)
 {
@@ -1857,7 +1902,14 @@ void MergeContributions_threaded(int * & listSizes, std::vector<int32_t *> & ind
             tLengths[j]= splitters[j][i+1] - splitters[j][i];
             
         }
-        MergeContributions<SR>(tLengths.data(), tIndsVec, tNumsVec, indsBuf[i], numsBuf[i]);
+        // commutative semirings accumulate dense pieces without the heap
+        int32_t lo = static_cast<int32_t>(i * (maxindex/nsplits));
+        int32_t hi = (i == nsplits-1) ? static_cast<int32_t>(maxindex) : static_cast<int32_t>((i+1) * (maxindex/nsplits));
+        int64_t tsize = std::accumulate(tLengths.begin(), tLengths.end(), static_cast<int64_t>(0));
+        if(SemiringTraits<SR>::is_commutative && tsize * SPAMERGEFACTOR >= static_cast<int64_t>(hi - lo))
+            MergeContributionsSPA<SR>(tLengths.data(), tIndsVec, tNumsVec, indsBuf[i], numsBuf[i], lo, hi);
+        else
+            MergeContributions<SR>(tLengths.data(), tIndsVec, tNumsVec, indsBuf[i], numsBuf[i]);
     }
 
     // ------ concatenate merged tuples processed by threads ------
@@ -1925,6 +1977,12 @@ void SpMV (const SpParMat<IU,NUM,UDER> & A, const FullyDistSpVec<IU,IVT> & x, Fu
         accnz = trxlocnz;
         indacc = trxinds;   // aliasing ptr
         numacc = trxnums;   // aliasing ptr
+        if(indexisvalue)    // TransposeVector did not ship any values
+        {
+            numacc = new IVT[accnz];
+            for(int i=0; i< accnz; ++i)
+                numacc[i] = indacc[i] + lenuntil;
+        }
     }
 	
 	int rowneighs;
@@ -1998,13 +2056,13 @@ void SpMV (const SpParMat<IU,NUM,UDER> & A, const FullyDistSpVec<IU,IVT> & x, Fu
 #endif
 	if(optbuf.totmax > 0 )	// graph500 optimization enabled
 	{
-		MPI_Alltoallv(optbuf.inds, sendcnt, optbuf.dspls, MPIType<int32_t>(), recvindbuf, recvcnt, rdispls, MPIType<int32_t>(), RowWorld);
+		IndexCodec::Alltoallv(optbuf.inds, sendcnt, optbuf.dspls, recvindbuf, recvcnt, rdispls, RowWorld);
 		MPI_Alltoallv(optbuf.nums, sendcnt, optbuf.dspls, MPIType<OVT>(), recvnumbuf, recvcnt, rdispls, MPIType<OVT>(), RowWorld);
 		delete [] sendcnt;
 	}
 	else
     {
-		MPI_Alltoallv(sendindbuf, sendcnt, sdispls, MPIType<int32_t>(), recvindbuf, recvcnt, rdispls, MPIType<int32_t>(), RowWorld);
+		IndexCodec::Alltoallv(sendindbuf, sendcnt, sdispls, recvindbuf, recvcnt, rdispls, RowWorld);
 		MPI_Alltoallv(sendnumbuf, sendcnt, sdispls, MPIType<OVT>(), recvnumbuf, recvcnt, rdispls, MPIType<OVT>(), RowWorld);
 		DeleteAll(sendindbuf, sendnumbuf, sendcnt, sdispls);
 	}
@@ -33,60 +33,62 @@
 
 namespace combblas {
 
+template <class IT, class NT>
+class SpPackedCols;
+
 /**
   * This special data structure is used for optimizing BFS iterations
   * by providing a pre-allocated SPA data structure
   */
-
 template <class OVT > // output value type
 class PreAllocatedSPA
 {
 public:
     PreAllocatedSPA():initialized(false) {};   // hide default constructor
 
+    //! Packed matrices are never split and have no nonzero iterators: only the SPA buffers are allocated, the index list grows on demand
+    template <class IT, class NT>
+    PreAllocatedSPA(SpPackedCols<IT,NT> & A):initialized(true)
+    {
+        int64_t mA = A.getnrow();
+        V_isthere.push_back(BitMap(mA));
+        V_localy.push_back(std::vector<OVT>(mA));
+        V_inds.push_back(std::vector<uint32_t>());
+    };
+
     template <class LMAT>
     PreAllocatedSPA(LMAT & A):initialized(true)  // the one and only constructor
 	{
         int64_t mA = A.getnrow();
         if( A.getnsplit() > 0)  // multithreaded
         {
-            int64_t perpiece =  mA / A.getnsplit();
-            for(int i=0; i<A.getnsplit(); ++i)
+            int nsplits = A.getnsplit();
+            const auto & offsets = A.GetSplitOffsets();
+            V_isthere.resize(nsplits);
+            V_localy.resize(nsplits);
+            V_inds.resize(nsplits);
+            
+            // buffers of a split are allocated and first touched by the thread that multiplies with it
+            #ifdef _OPENMP
+            #pragma omp parallel for schedule(static)
+            #endif
+            for(int i=0; i<nsplits; ++i)
             {
-                if(i != A.getnsplit()-1)
-                {
-                    V_isthere.push_back(BitMap(perpiece));
-                    V_localy.push_back(std::vector<OVT>(perpiece));
-                    
-                    std::vector<bool> isthere(perpiece, false);
-                    for(auto colit = A.begcol(i); colit != A.endcol(i); ++colit)
-                    {
-                        for(auto nzit = A.begnz(colit,i); nzit != A.endnz(colit,i); ++nzit)
-                        {
-                            size_t rowid = nzit.rowid();
-                            if(!isthere[rowid])     isthere[rowid] = true;
-                        }
-                    }
-                    size_t maxvector = std::count(isthere.begin(), isthere.end(), true);
-                    V_inds.push_back(std::vector<uint32_t>(maxvector));
-                }
-                else
+                int64_t splitrows = offsets[i+1] - offsets[i];
+                V_isthere[i] = BitMap(splitrows);
+                std::vector<OVT>(splitrows).swap(V_localy[i]);
+                
+                std::vector<bool> isthere(splitrows, false);
+                for(auto colit = A.begcol(i); colit != A.endcol(i); ++colit)
                 {
-                    V_isthere.push_back(BitMap(mA - i*perpiece));
-                    V_localy.push_back(std::vector<OVT>(mA - i*perpiece));
-                    
-                    std::vector<bool> isthere(mA - i*perpiece, false);
-                    for(auto colit = A.begcol(i); colit != A.endcol(i); ++colit)
+                    for(auto nzit = A.begnz(colit,i); nzit != A.endnz(colit,i); ++nzit)
                     {
-                        for(auto nzit = A.begnz(colit,i); nzit != A.endnz(colit,i); ++nzit)
-                        {
-                            size_t rowid = nzit.rowid();
-                            if(!isthere[rowid])     isthere[rowid] = true;
-                        }
+                        size_t rowid = nzit.rowid();
+                        if(!isthere[rowid])     isthere[rowid] = true;
                     }
-                    size_t maxvector = std::count(isthere.begin(), isthere.end(), true);
-                    V_inds.push_back(std::vector<uint32_t>(maxvector));
                 }
+                size_t maxvector = std::count(isthere.begin(), isthere.end(), true);
+                std::vector<uint32_t>(maxvector).swap(V_inds[i]);
             }
         }
         else    // single threaded
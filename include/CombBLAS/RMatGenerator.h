@@ -0,0 +1,329 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _RMAT_GENERATOR_H_
+#define _RMAT_GENERATOR_H_
+
+#include <mpi.h>
+#include <stdint.h>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "SpDefs.h"
+#include "CommGrid.h"
+#include "SpTuples.h"
+#include "SpParMat.h"
+
+namespace combblas {
+
+//! SplitMix64 finalizer, used as the stateless (counter-based) random number generator of the R-MAT generator
+inline uint64_t RMatMix(uint64_t z)
+{
+	z += 0x9E3779B97F4A7C15ULL;
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+//! Uniform double in [0,1) that only depends on (key, counter)
+inline double RMatUniform(uint64_t key, uint64_t counter)
+{
+	return static_cast<double>(RMatMix(key ^ RMatMix(counter)) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+
+/**
+ * Keyed bijection on [0, 2^bits) built from a balanced Feistel network over 2*ceil(bits/2) bits.
+ * Odd widths are handled by cycle walking, which needs two encryptions on average.
+ * Unlike a random permutation it needs no storage and no communication to evaluate or invert.
+ */
+class FeistelPermutation
+{
+public:
+	FeistelPermutation(int bits = 0, uint64_t key = 0): bits(bits)
+	{
+		half = (bits + 1) / 2;
+		mask = (static_cast<uint64_t>(1) << half) - 1;
+		for(int i = 0; i < FEISTELROUNDS; ++i)
+			keys[i] = RMatMix(key + i);
+	}
+
+	uint64_t Permute(uint64_t x) const
+	{
+		if(bits == 0) return x;
+		do { x = Encrypt(x); } while(x >> bits);
+		return x;
+	}
+
+	uint64_t Invert(uint64_t y) const
+	{
+		if(bits == 0) return y;
+		do { y = Decrypt(y); } while(y >> bits);
+		return y;
+	}
+
+private:
+	uint64_t Encrypt(uint64_t x) const
+	{
+		uint64_t l = x >> half;
+		uint64_t r = x & mask;
+		for(int i = 0; i < FEISTELROUNDS; ++i)
+		{
+			uint64_t t = l ^ (RMatMix(r ^ keys[i]) & mask);
+			l = r;
+			r = t;
+		}
+		return (l << half) | r;
+	}
+
+	uint64_t Decrypt(uint64_t y) const
+	{
+		uint64_t l = y >> half;
+		uint64_t r = y & mask;
+		for(int i = FEISTELROUNDS-1; i >= 0; --i)
+		{
+			uint64_t t = r ^ (RMatMix(l ^ keys[i]) & mask);
+			r = l;
+			l = t;
+		}
+		return (l << half) | r;
+	}
+
+	int bits;
+	int half;
+	uint64_t mask;
+	uint64_t keys[FEISTELROUNDS];
+};
+
+
+/**
+ * R-MAT (Kronecker) generator that writes every process' block of the 2D layout directly,
+ * without generating a global edge list, permuting it, and redistributing it with all-to-all.
+ *
+ * The top RMATTILELEVELS levels of the recursion split the adjacency matrix into tiles. The number of
+ * edges of each tile pair is fixed by its exact R-MAT probability, and the edges inside a tile pair are
+ * drawn with a counter-based generator keyed on the pair, so any process can regenerate any tile pair
+ * independently. Vertices are renamed with a bijection that
+ *  - places tiles so that heavy ones are spread evenly over the vertex range (bit reversal of their weight rank)
+ *  - scrambles the vertices inside each tile with a keyed Feistel network.
+ * A process therefore only visits the tile pairs whose renamed range intersects its block.
+ * The generated graph only depends on (initiator, scale, edgefactor, seed), not on the process grid.
+ */
+class RMatGenerator
+{
+public:
+	RMatGenerator(const double initiator[4], int scale, int edgefactor, uint64_t seed = 1):
+		scale(scale), edgefactor(edgefactor), seed(seed)
+	{
+		std::copy(initiator, initiator+4, init);
+		double sum = init[0] + init[1] + init[2] + init[3];
+		for(int i = 0; i < 4; ++i) init[i] /= sum;
+
+		tilelevels = std::min(scale, RMATTILELEVELS);
+		lowlevels = scale - tilelevels;
+		ntiles = static_cast<int64_t>(1) << tilelevels;
+
+		// expected degree (in + out) of the vertices of each tile
+		std::vector< std::pair<double, int64_t> > weights(ntiles);
+		for(int64_t t = 0; t < ntiles; ++t)
+		{
+			double w = 1.0;
+			for(int l = 0; l < tilelevels; ++l)
+				w *= ((t >> l) & 1) ? (init[1] + init[2] + 2*init[3]) : (2*init[0] + init[1] + init[2]);
+			weights[t] = std::make_pair(-w, t);
+		}
+		std::sort(weights.begin(), weights.end());
+
+		tilepos.resize(ntiles);
+		tileat.resize(ntiles);
+		scramblers.resize(ntiles);
+		for(int64_t k = 0; k < ntiles; ++k)
+		{
+			int64_t pos = 0;
+			for(int l = 0; l < tilelevels; ++l)
+				pos |= ((k >> l) & 1) << (tilelevels - 1 - l);
+			tilepos[weights[k].second] = pos;
+			tileat[pos] = weights[k].second;
+		}
+		for(int64_t t = 0; t < ntiles; ++t)
+			scramblers[t] = FeistelPermutation(lowlevels, RMatMix(seed ^ RMatMix(t)));
+	}
+
+	int64_t getGlobalV() const { return static_cast<int64_t>(1) << scale; }
+	int64_t getExpectedEdges() const { return static_cast<int64_t>(edgefactor) << scale; }
+
+	//! Maps an R-MAT vertex identifier to its scrambled identifier
+	int64_t Rename(int64_t v) const
+	{
+		int64_t t = v >> lowlevels;
+		uint64_t off = static_cast<uint64_t>(v) & ((static_cast<uint64_t>(1) << lowlevels) - 1);
+		return (tilepos[t] << lowlevels) | static_cast<int64_t>(scramblers[t].Permute(off));
+	}
+
+	//! Inverse of Rename
+	int64_t Unrename(int64_t v) const
+	{
+		int64_t t = tileat[v >> lowlevels];
+		uint64_t off = static_cast<uint64_t>(v) & ((static_cast<uint64_t>(1) << lowlevels) - 1);
+		return (t << lowlevels) | static_cast<int64_t>(scramblers[t].Invert(off));
+	}
+
+	/**
+	 * Generates the (renamed) edges whose endpoints fall into [rowbegin,rowend) x [colbegin,colend)
+	 * @param[in] symmetric: also generate the reverse of every edge
+	 * @param[out] edges: pairs of local indices (row - rowbegin, col - colbegin), duplicates included
+	 */
+	template <typename LIT>
+	void BlockEdges(int64_t rowbegin, int64_t rowend, int64_t colbegin, int64_t colend, bool symmetric, bool removeloops, std::vector<LIT> & edges) const
+	{
+		std::vector< std::tuple<int64_t,int64_t,bool> > pairs;	// (row tile, column tile, transposed)
+		AddPairs(rowbegin, rowend, colbegin, colend, false, pairs);
+		if(symmetric)
+			AddPairs(colbegin, colend, rowbegin, rowend, true, pairs);
+
+		int nthreads = 1;
+#ifdef THREADED
+#pragma omp parallel
+		{
+			nthreads = omp_get_num_threads();
+		}
+#endif
+		std::vector< std::vector<LIT> > tedges(nthreads);
+#ifdef THREADED
+#pragma omp parallel for schedule(dynamic)
+#endif
+		for(size_t i = 0; i < pairs.size(); ++i)
+		{
+			int myThread = 0;
+#ifdef THREADED
+			myThread = omp_get_thread_num();
+#endif
+			int64_t t = std::get<0>(pairs[i]);
+			int64_t s = std::get<1>(pairs[i]);
+			bool transposed = std::get<2>(pairs[i]);
+			uint64_t key = RMatMix(seed ^ RMatMix((static_cast<uint64_t>(t) << 32) | static_cast<uint64_t>(s)));
+			int64_t count = PairEdges(t, s, key);
+			for(int64_t k = 0; k < count; ++k)
+			{
+				int64_t u = t, v = s;
+				uint64_t counter = (static_cast<uint64_t>(k) + 1) << 6;
+				for(int l = 0; l < lowlevels; ++l)
+				{
+					double r = RMatUniform(key, counter + l);
+					int quadrant = (r < init[0]) ? 0 : ((r < init[0] + init[1]) ? 1 : ((r < init[0] + init[1] + init[2]) ? 2 : 3));
+					u = (u << 1) | (quadrant >> 1);
+					v = (v << 1) | (quadrant & 1);
+				}
+				int64_t row = Rename(u), col = Rename(v);
+				if(transposed) std::swap(row, col);
+				if(row >= rowbegin && row < rowend && col >= colbegin && col < colend && !(removeloops && row == col))
+				{
+					tedges[myThread].push_back(static_cast<LIT>(row - rowbegin));
+					tedges[myThread].push_back(static_cast<LIT>(col - colbegin));
+				}
+			}
+		}
+		size_t total = edges.size();
+		for(int i = 0; i < nthreads; ++i) total += tedges[i].size();
+		edges.reserve(total);
+		for(int i = 0; i < nthreads; ++i)
+		{
+			edges.insert(edges.end(), tedges[i].begin(), tedges[i].end());
+			std::vector<LIT>().swap(tedges[i]);
+		}
+	}
+
+	/**
+	 * Generates the local block of every process of grid; duplicate edges are summed as in SpParMat(DistEdgeList)
+	 */
+	template <class IT, class NT, class DER>
+	void Generate(std::shared_ptr<CommGrid> grid, SpParMat<IT,NT,DER> & A, bool symmetric = true, bool removeloops = true) const
+	{
+		typedef typename DER::LocalIT LIT;
+		int gridrows = grid->GetGridRows();
+		int gridcols = grid->GetGridCols();
+		int myprocrow = grid->GetRankInProcCol();
+		int myproccol = grid->GetRankInProcRow();
+		int64_t globalv = getGlobalV();
+		int64_t m_perproc = globalv / gridrows;
+		int64_t n_perproc = globalv / gridcols;
+
+		int64_t rowbegin = myprocrow * m_perproc;
+		int64_t rowend = (myprocrow != gridrows-1) ? rowbegin + m_perproc : globalv;
+		int64_t colbegin = myproccol * n_perproc;
+		int64_t colend = (myproccol != gridcols-1) ? colbegin + n_perproc : globalv;
+
+		std::vector<LIT> edges;
+		BlockEdges(rowbegin, rowend, colbegin, colend, symmetric, removeloops, edges);
+		int64_t nlocal = static_cast<int64_t>(edges.size() / 2);
+		// loops are already gone; SpTuples would drop the local diagonal of off-diagonal blocks as well
+		SpTuples<LIT,NT> tuples(nlocal, static_cast<LIT>(rowend - rowbegin), static_cast<LIT>(colend - colbegin), edges, false);
+		A = SpParMat<IT,NT,DER>(new DER(tuples, false), grid);
+	}
+
+private:
+	//! Adds the tile pairs whose renamed tiles intersect [rowbegin,rowend) x [colbegin,colend)
+	void AddPairs(int64_t rowbegin, int64_t rowend, int64_t colbegin, int64_t colend, bool transposed, std::vector< std::tuple<int64_t,int64_t,bool> > & pairs) const
+	{
+		if(rowbegin >= rowend || colbegin >= colend) return;
+		for(int64_t rp = rowbegin >> lowlevels; rp <= ((rowend-1) >> lowlevels); ++rp)
+			for(int64_t cp = colbegin >> lowlevels; cp <= ((colend-1) >> lowlevels); ++cp)
+				pairs.push_back(std::make_tuple(tileat[rp], tileat[cp], transposed));
+	}
+
+	//! Number of edges of tile pair (t,s): its expected count, rounded up or down at random
+	int64_t PairEdges(int64_t t, int64_t s, uint64_t key) const
+	{
+		double p = 1.0;
+		for(int l = 0; l < tilelevels; ++l)
+			p *= init[2 * ((t >> l) & 1) + ((s >> l) & 1)];
+		double expected = p * static_cast<double>(getExpectedEdges());
+		int64_t count = static_cast<int64_t>(std::floor(expected));
+		if(RMatUniform(key, 0) < expected - static_cast<double>(count))
+			++count;
+		return count;
+	}
+
+	double init[4];
+	int scale;
+	int edgefactor;
+	uint64_t seed;
+	int tilelevels;
+	int lowlevels;
+	int64_t ntiles;
+	std::vector<int64_t> tilepos;	// position of each R-MAT tile in the renamed vertex range
+	std::vector<int64_t> tileat;	// inverse of tilepos
+	std::vector<FeistelPermutation> scramblers;
+};
+
+}
+
+#endif
@@ -0,0 +1,171 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _SEMIRING_TRAITS_H_
+#define _SEMIRING_TRAITS_H_
+
+#include <type_traits>
+
+namespace combblas {
+
+template <typename T>
+struct semiring_void { typedef void type; };
+
+// semiring_<property><SR> is SR::<property> if the semiring declares it, false otherwise
+#define COMBBLAS_SEMIRING_PROPERTY(property) \
+template <class SR, class = void> \
+struct semiring_##property : std::false_type {}; \
+template <class SR> \
+struct semiring_##property<SR, typename semiring_void<decltype(SR::property)>::type> : std::integral_constant<bool, SR::property> {};
+
+COMBBLAS_SEMIRING_PROPERTY(is_idempotent)
+COMBBLAS_SEMIRING_PROPERTY(is_commutative)
+COMBBLAS_SEMIRING_PROPERTY(has_annihilator)
+COMBBLAS_SEMIRING_PROPERTY(pattern_only)
+COMBBLAS_SEMIRING_PROPERTY(simd_add)
+COMBBLAS_SEMIRING_PROPERTY(simd_mul)
+
+#undef COMBBLAS_SEMIRING_PROPERTY
+
+// semiring_has_absorbing<SR> is true if the semiring declares "static T absorbing()"
+template <class SR, class = void>
+struct semiring_has_absorbing : std::false_type {};
+template <class SR>
+struct semiring_has_absorbing<SR, typename semiring_void<decltype(SR::absorbing())>::type> : std::true_type {};
+
+/**
+ * Compile-time properties of a semiring that the local kernels specialize on.
+ * A semiring opts in by declaring a static constexpr bool member of the same name
+ * (e.g. "static constexpr bool is_commutative = true;"), or by specializing this class.
+ * Undeclared properties are false, which is always correct but never faster.
+ *	- is_idempotent: add(a,a) == a; if the semiring also declares absorbing(), with add(absorbing(), a) == absorbing(),
+ *	  an accumulator that has reached absorbing() takes no more contributions (e.g. a true entry under logical or)
+ *	- is_commutative: add(a,b) == add(b,a), so contributions can be accumulated in any order
+ *	- has_annihilator: id() is the identity of add and multiply(a, id()) == id() for every a,
+ *	  so products with an id() valued vector entry can be skipped when the output is dense
+ *	- pattern_only: multiply ignores its first (matrix) operand, so matrix values need not be loaded or decoded
+ *	- simd_add, simd_mul: add and multiply are branch free on arithmetic types, so column updates can be vectorized
+ */
+template <class SR>
+struct SemiringTraits
+{
+	static constexpr bool is_idempotent = semiring_is_idempotent<SR>::value;
+	static constexpr bool is_commutative = semiring_is_commutative<SR>::value;
+	static constexpr bool has_annihilator = semiring_has_annihilator<SR>::value;
+	static constexpr bool pattern_only = semiring_pattern_only<SR>::value;
+	static constexpr bool simd_add = semiring_simd_add<SR>::value;
+	static constexpr bool simd_mul = semiring_simd_mul<SR>::value;
+
+	// tags for overload based dispatch
+	typedef std::integral_constant<bool, has_annihilator> annihilator_tag;
+	typedef std::integral_constant<bool, pattern_only> pattern_tag;
+	typedef std::integral_constant<bool, simd_add && simd_mul> simd_tag;
+	typedef std::integral_constant<bool, is_idempotent && semiring_has_absorbing<SR>::value> saturation_tag;
+};
+
+template <class SR> constexpr bool SemiringTraits<SR>::is_idempotent;
+template <class SR> constexpr bool SemiringTraits<SR>::is_commutative;
+template <class SR> constexpr bool SemiringTraits<SR>::has_annihilator;
+template <class SR> constexpr bool SemiringTraits<SR>::pattern_only;
+template <class SR> constexpr bool SemiringTraits<SR>::simd_add;
+template <class SR> constexpr bool SemiringTraits<SR>::simd_mul;
+
+
+template <class SR, class T>
+inline bool IsAnnihilator(const T & x, std::true_type) { return x == SR::id(); }
+
+template <class SR, class T>
+inline bool IsAnnihilator(const T & x, std::false_type) { return false; }
+
+//! True if every product with the vector entry x is SR::id(), so it does not change a dense output
+template <class SR, class T>
+inline bool IsAnnihilator(const T & x)
+{
+	return IsAnnihilator<SR>(x, typename SemiringTraits<SR>::annihilator_tag());
+}
+
+
+template <class SR, class T>
+inline bool IsSaturated(const T & y, std::true_type) { return y == SR::absorbing(); }
+
+template <class SR, class T>
+inline bool IsSaturated(const T & y, std::false_type) { return false; }
+
+//! True if no further contribution can change the accumulated value y
+template <class SR, class T>
+inline bool IsSaturated(const T & y)
+{
+	return IsSaturated<SR>(y, typename SemiringTraits<SR>::saturation_tag());
+}
+
+
+template <class SR, class IT, class NT>
+inline NT MatrixOperand(const NT * numx, IT pos, std::true_type) { return NT(); }
+
+template <class SR, class IT, class NT>
+inline NT MatrixOperand(const NT * numx, IT pos, std::false_type) { return numx[pos]; }
+
+//! The matrix value to multiply with, not loaded at all if the semiring ignores it
+template <class SR, class IT, class NT>
+inline NT MatrixOperand(const NT * numx, IT pos)
+{
+	return MatrixOperand<SR>(numx, pos, typename SemiringTraits<SR>::pattern_tag());
+}
+
+
+template <class SR, class IT, class NT, class XT, class YT>
+inline void ColumnAxpy(const IT * ir, const NT * num, IT len, const XT & x, YT * y, std::true_type)
+{
+	// row indices are distinct within a column, so the scatter has no conflicts
+#ifdef _OPENMP
+#pragma omp simd
+#endif
+	for(IT i=0; i< len; ++i)
+		SR::axpy(num[i], x, y[ir[i]]);
+}
+
+// skips saturated entries; the vectorized overload above does not test them, as the branch would cost more than the update
+template <class SR, class IT, class NT, class XT, class YT>
+inline void ColumnAxpy(const IT * ir, const NT * num, IT len, const XT & x, YT * y, std::false_type)
+{
+	for(IT i=0; i< len; ++i)
+		if(!IsSaturated<SR>(y[ir[i]]))
+			SR::axpy(num[i], x, y[ir[i]]);
+}
+
+//! y[ir[i]] = y[ir[i]] + num[i]*x for the len nonzeros of a column, vectorized if the semiring allows it
+template <class SR, class IT, class NT, class XT, class YT>
+inline void ColumnAxpy(const IT * ir, const NT * num, IT len, const XT & x, YT * y)
+{
+	ColumnAxpy<SR>(ir, num, len, x, y, typename SemiringTraits<SR>::simd_tag());
+}
+
+}
+
+#endif
@@ -33,6 +33,8 @@
 #include <utility>
 #include <climits>
 #include <cmath>
+#include <limits>
+#include <type_traits>
 #include "promote.h"
 
 namespace combblas {
@@ -50,6 +52,7 @@ const T inf_plus(const T& a, const T& b) {
 template <class OUT>
 struct BoolCopy2ndSRing
 {
+	static constexpr bool pattern_only = true;
 	static OUT id() { return OUT(); }
 	static bool returnedSAID() { return false; }
 	static OUT add(const OUT & arg1, const OUT & arg2)
@@ -143,6 +146,8 @@ struct BoolCopy1stSRing
 template <class T1, class T2, class OUT>
 struct Select2ndSRing
 {
+	static constexpr bool is_idempotent = true;
+	static constexpr bool pattern_only = true;
 	static OUT id() { return OUT(); }
 	static bool returnedSAID() { return false; }
 	static MPI_Op mpi_op() { return MPI_MAX; };
@@ -166,6 +171,10 @@ template <class T1, class T2>
 struct SelectMaxSRing
 {
 	typedef typename promote_trait<T1,T2>::T_promote T_promote;
+	static constexpr bool is_idempotent = true;
+	static constexpr bool is_commutative = true;
+	static constexpr bool simd_add = std::is_arithmetic<T_promote>::value;
+	static constexpr bool simd_mul = std::is_arithmetic<T_promote>::value;
 	static T_promote id() {  return -1; };
 	static bool returnedSAID() { return false; }
 	static MPI_Op mpi_op() { return MPI_MAX; };
@@ -192,6 +201,11 @@ template <class T2>
 struct SelectMaxSRing<bool, T2>
 {
 	typedef T2 T_promote;
+	static constexpr bool is_idempotent = true;
+	static constexpr bool is_commutative = true;
+	static constexpr bool pattern_only = true;
+	static constexpr bool simd_add = std::is_arithmetic<T_promote>::value;
+	static constexpr bool simd_mul = true;
 	static T_promote id(){ return -1; };
 	static bool returnedSAID() { return false; }
 	static MPI_Op mpi_op() { return MPI_MAX; };
@@ -213,6 +227,10 @@ template <class T1, class T2>
 struct PlusTimesSRing
 {
 	typedef typename promote_trait<T1,T2>::T_promote T_promote;
+	static constexpr bool is_commutative = true;
+	static constexpr bool has_annihilator = std::is_integral<T_promote>::value;	// 0 * inf is not 0 in floating point
+	static constexpr bool simd_add = std::is_arithmetic<T_promote>::value;
+	static constexpr bool simd_mul = std::is_arithmetic<T_promote>::value;
 	static T_promote id(){ return 0; }
 	static bool returnedSAID() { return false; }
 	static MPI_Op mpi_op() { return MPI_SUM; };
@@ -236,6 +254,10 @@ template <class T1, class T2>
 struct MinPlusSRing
 {
 	typedef typename promote_trait<T1,T2>::T_promote T_promote;
+	static constexpr bool is_idempotent = true;
+	static constexpr bool is_commutative = true;
+	static constexpr bool has_annihilator = true;	// inf_plus(a, inf) == inf
+	static constexpr bool simd_add = std::is_arithmetic<T_promote>::value;
 	static T_promote id() { return  std::numeric_limits<T_promote>::max(); };
 	static bool returnedSAID() { return false; }
 	static MPI_Op mpi_op() { return MPI_MIN; };
@@ -254,6 +276,34 @@ struct MinPlusSRing
 	}
 };
 
+// Reachability: y[i] is 1 if some nonzero A(i,j) meets a nonzero x[j], and 0 otherwise
+template <class T1, class T2>
+struct LogicalOrAndSRing
+{
+	typedef typename promote_trait<T1,T2>::T_promote T_promote;
+	static constexpr bool is_idempotent = true;
+	static constexpr bool is_commutative = true;
+	static constexpr bool has_annihilator = true;	// a zero x[j] cannot set any y[i]
+	static constexpr bool simd_add = true;
+	static constexpr bool simd_mul = true;
+	static T_promote id() { return 0; }
+	static T_promote absorbing() { return 1; }	// a reached y[i] stays reached
+	static bool returnedSAID() { return false; }
+	static MPI_Op mpi_op() { return MPI_LOR; };
+	static T_promote add(const T_promote & arg1, const T_promote & arg2)
+	{
+		return static_cast<T_promote>(arg1 || arg2);
+	}
+	static T_promote multiply(const T1 & arg1, const T2 & arg2)
+	{
+		return static_cast<T_promote>(arg1 && arg2);
+	}
+	static void axpy(T1 a, const T2 & x, T_promote & y)
+	{
+		y = static_cast<T_promote>(y || (a && x));
+	}
+};
+
 }
 
 #endif
@@ -64,21 +64,15 @@ SpCCols<IT,NT>::SpCCols(IT size, IT nRow, IT nCol)
 template <class IT, class NT>
 SpCCols<IT,NT>::~SpCCols()
 {
-	if(nnz > 0)
+	if(splits > 0)	// a split matrix owns its pieces even if they are all empty
 	{
-		if(csc != NULL)
-		{	
-			if(splits > 0)
-			{
-				for(int i=0; i<splits; ++i)
-					delete cscarr[i];
-				delete [] cscarr;
-			}
-			else
-			{
-				delete csc;
-			}
-		}
+		for(int i=0; i<splits; ++i)
+			delete cscarr[i];
+		delete [] cscarr;
+	}
+	else if(nnz > 0 && csc != NULL)
+	{
+		delete csc;
 	}
 }
 
@@ -86,12 +80,13 @@ SpCCols<IT,NT>::~SpCCols()
 // Derived's copy constructor can safely call Base's default constructor as base has no data members 
 template <class IT, class NT>
 SpCCols<IT,NT>::SpCCols(const SpCCols<IT,NT> & rhs)
-: m(rhs.m), n(rhs.n), nnz(rhs.nnz), splits(rhs.splits)
+: m(rhs.m), n(rhs.n), nnz(rhs.nnz), splits(rhs.splits), rowsplits(rhs.rowsplits)
 {
 	if(splits > 0)
 	{
+		cscarr = new Csc<IT,NT>*[splits];
 		for(int i=0; i<splits; ++i)
-			CopyCsc(rhs.cscarr[i]);
+			cscarr[i] = new Csc<IT,NT>(*(rhs.cscarr[i]));
 	}
 	else
 	{
@@ -209,11 +204,24 @@ SpCCols<IT,NT> & SpCCols<IT,NT>::operator=(const SpCCols<IT,NT> & rhs)
     // check for self assignment using address comparison
     if(this != &rhs)
     {
-        if(csc != NULL && nnz > 0)
+        if(splits > 0)
+        {
+            for(int i=0; i<splits; ++i)
+                delete cscarr[i];
+            delete [] cscarr;
+        }
+        else if(csc != NULL && nnz > 0)
         {
             delete csc;
         }
-        if(rhs.csc != NULL)
+        if(rhs.splits > 0)
+        {
+            cscarr = new Csc<IT,NT>*[rhs.splits];
+            for(int i=0; i<rhs.splits; ++i)
+                cscarr[i] = new Csc<IT,NT>(*(rhs.cscarr[i]));
+            nnz = rhs.nnz;
+        }
+        else if(rhs.csc != NULL)
         {
             csc = new Csc<IT,NT>(*(rhs.csc));
             nnz = rhs.nnz;
@@ -227,16 +235,37 @@ SpCCols<IT,NT> & SpCCols<IT,NT>::operator=(const SpCCols<IT,NT> & rhs)
         m = rhs.m; 
         n = rhs.n;
         splits = rhs.splits;
+        rowsplits = rhs.rowsplits;
     }
     return *this;
 }
 
 
+/**
+ * Splits the matrix into numsplits row blocks for the multithreaded SpMV kernels
+ * Same nnz-balanced boundaries as SpDCCols::RowSplit, and each block is built by the thread that later uses it
+ */
 template <class IT, class NT>
 void SpCCols<IT,NT>::RowSplit(int numsplits)
 {
+    if(m < numsplits || splits > 0)
+    {
+        std::cerr<< "Warning: Matrix is too small or already split for multithreading" << std::endl;
+        return;
+    }
+    std::vector<IT> rowweights(m, 1);
+    if(nnz > 0 && csc != NULL)
+    {
+        for(IT j=0; j< csc->nz; ++j)
+            ++rowweights[csc->ir[j]];
+    }
+    rowsplits = SpHelper::BalancedSplits<IT>(rowweights, numsplits);
+    std::vector<IT>().swap(rowweights);
+    std::vector<int> rowowner(m);
+    for(int s=0; s< numsplits; ++s)
+        std::fill(rowowner.begin() + rowsplits[s], rowowner.begin() + rowsplits[s+1], s);
+
     splits = numsplits;
-    IT perpiece = m / splits;
     std::vector<IT> nnzs(splits, 0);
     std::vector < std::vector < std::tuple<IT,IT,NT> > > colrowpairs(splits);
     std::vector< std::vector<IT> > colcnts(splits);
@@ -250,19 +279,19 @@ void SpCCols<IT,NT>::RowSplit(int numsplits)
             for(IT j = csc->jc[i]; j< csc->jc[i+1]; ++j)
             {
                 IT rowid = csc->ir[j];  // colid=i
-                IT owner = std::min(rowid / perpiece, static_cast<IT>(splits-1));
-                colrowpairs[owner].push_back(std::make_tuple(i, rowid - owner*perpiece, csc->num[i]));
+                int owner = rowowner[rowid];
+                colrowpairs[owner].push_back(std::make_tuple(i, rowid - rowsplits[owner], csc->num[j]));
                 
                 ++(colcnts[owner][i]);
                 ++(nnzs[owner]);
             }
         }
+        delete csc;	// claim memory
     }
-    delete csc;	// claim memory
     cscarr = new Csc<IT,NT>*[splits];
     
     #ifdef _OPENMP
-    #pragma omp parallel for
+    #pragma omp parallel for schedule(static)	// the thread that uses a split under a static schedule also first touches it
     #endif
     for(int i=0; i< splits; ++i)    // i iterates over splits
     {
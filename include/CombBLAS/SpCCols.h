@@ -76,6 +76,7 @@ public:
     IT getncol() const { return n; }
     IT getnnz() const { return nnz; }
     int getnsplit() const { return splits; }
+    const std::vector<IT> & GetSplitOffsets() const { return rowsplits; }	//!< first local row of each split, followed by getnrow()
     
     
     auto GetInternal() const    { return GetCSC(); }
@@ -274,6 +275,7 @@ private:
     IT nnz;
     
     int splits;	// for multithreading
+    std::vector<IT> rowsplits;	// row boundaries of the splits (splits+1 entries)
 
 	template <class IU, class NU>
 	friend class SpTuples;
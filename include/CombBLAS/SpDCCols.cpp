@@ -34,6 +34,7 @@
 #include <vector>
 #include <climits>
 #include <iomanip>
+#include <numeric>
 #include <cassert>
 
 namespace combblas {
@@ -64,21 +65,15 @@ SpDCCols<IT,NT>::SpDCCols(IT size, IT nRow, IT nCol, IT nzc)
 template <class IT, class NT>
 SpDCCols<IT,NT>::~SpDCCols()
 {
-	if(nnz > 0)
+	if(splits > 0)	// a split matrix owns its pieces even if they are all empty
 	{
-		if(dcsc != NULL) 
-		{	
-			if(splits > 0)
-			{
-				for(int i=0; i<splits; ++i)
-					delete dcscarr[i];
-				delete [] dcscarr;
-			}
-			else
-			{
-				delete dcsc;	
-			}
-		}
+		for(int i=0; i<splits; ++i)
+			delete dcscarr[i];
+		delete [] dcscarr;
+	}
+	else if(nnz > 0 && dcsc != NULL)
+	{
+		delete dcsc;
 	}
 }
 
@@ -86,12 +81,13 @@ SpDCCols<IT,NT>::~SpDCCols()
 // Derived's copy constructor can safely call Base's default constructor as base has no data members 
 template <class IT, class NT>
 SpDCCols<IT,NT>::SpDCCols(const SpDCCols<IT,NT> & rhs)
-: m(rhs.m), n(rhs.n), nnz(rhs.nnz), splits(rhs.splits)
+: m(rhs.m), n(rhs.n), nnz(rhs.nnz), splits(rhs.splits), rowsplits(rhs.rowsplits)
 {
 	if(splits > 0)
 	{
+		dcscarr = new Dcsc<IT,NT>*[splits];
 		for(int i=0; i<splits; ++i)
-			CopyDcsc(rhs.dcscarr[i]);
+			dcscarr[i] = new Dcsc<IT,NT>(*(rhs.dcscarr[i]));
 	}
 	else
 	{
@@ -186,6 +182,59 @@ SpDCCols<IT,NT>::SpDCCols(const SpTuples<IT, NT> & rhs, bool transpose)
 
 
 
+/**
+ * Constructor for converting a SpTuplesSoA -> SpDCCols without copying the nonzeros
+ * rhs.rows and rhs.vals become dcsc->ir and dcsc->numx; only the column pointers are computed
+ * rhs is sorted by columns first unless it already is, and of duplicate entries the last one is kept
+ * rhs is left empty
+ **/
+template <class IT, class NT>
+SpDCCols<IT,NT>::SpDCCols(SpTuplesSoA<IT,NT> & rhs)
+: m(rhs.m), n(rhs.n), splits(0)
+{
+	rhs.SortColBased();	// only checks if already sorted (the sort is stable)
+	bool unique = true;
+	for(int64_t i=1; i< rhs.nnz && unique; ++i)
+		unique = (rhs.cols[i] != rhs.cols[i-1] || rhs.rows[i] != rhs.rows[i-1]);
+	if(!unique)
+		rhs.RemoveDuplicates([](const NT & first, const NT & second){ return second; });
+
+	nnz = rhs.nnz;
+	if(nnz == 0)
+	{
+		dcsc = NULL;
+		return;
+	}
+	IT localnzc = 1;
+	for(IT i=1; i< nnz; ++i)
+	{
+		if(rhs.cols[i] != rhs.cols[i-1])
+			++localnzc;
+	}
+	IT * cp = new IT[localnzc+1];
+	IT * jc = new IT[localnzc];
+	jc[0] = rhs.cols[0];
+	cp[0] = 0;
+	IT jspos = 1;
+	for(IT i=1; i< nnz; ++i)
+	{
+		if(rhs.cols[i] != jc[jspos-1])
+		{
+			jc[jspos] = rhs.cols[i];
+			cp[jspos++] = i;
+		}
+	}
+	cp[jspos] = nnz;
+	dcsc = new Dcsc<IT,NT>(cp, jc, rhs.rows, rhs.vals, nnz, localnzc);
+
+	rhs.rows = NULL;
+	rhs.vals = NULL;
+	delete [] rhs.cols;
+	rhs.cols = NULL;
+	rhs.nnz = 0;
+}
+
+
 /**
  * Multithreaded Constructor for converting tuples matrix -> SpDCCols
  * @param[in] 	rhs if transpose=true,
@@ -368,11 +417,24 @@ SpDCCols<IT,NT> & SpDCCols<IT,NT>::operator=(const SpDCCols<IT,NT> & rhs)
 	// check for self assignment using address comparison
 	if(this != &rhs)		
 	{
-		if(dcsc != NULL && nnz > 0)
+		if(splits > 0)
+		{
+			for(int i=0; i<splits; ++i)
+				delete dcscarr[i];
+			delete [] dcscarr;
+		}
+		else if(dcsc != NULL && nnz > 0)
 		{
 			delete dcsc;
 		}
-		if(rhs.dcsc != NULL)	
+		if(rhs.splits > 0)
+		{
+			dcscarr = new Dcsc<IT,NT>*[rhs.splits];
+			for(int i=0; i<rhs.splits; ++i)
+				dcscarr[i] = new Dcsc<IT,NT>(*(rhs.dcscarr[i]));
+			nnz = rhs.nnz;
+		}
+		else if(rhs.dcsc != NULL)	
 		{
 			dcsc = new Dcsc<IT,NT>(*(rhs.dcsc));
 			nnz = rhs.nnz;
@@ -386,6 +448,7 @@ SpDCCols<IT,NT> & SpDCCols<IT,NT>::operator=(const SpDCCols<IT,NT> & rhs)
 		m = rhs.m; 
 		n = rhs.n;
 		splits = rhs.splits;
+		rowsplits = rhs.rowsplits;
 	}
 	return *this;
 }
@@ -806,6 +869,111 @@ Arr<IT,NT> SpDCCols<IT,NT>::GetArrays() const
 	return arr;
 }
 
+/**
+ * Splits the matrix into numsplits row blocks for the multithreaded SpMV kernels
+ * The block boundaries balance the nonzeros (plus one per row for the output entry) instead of the rows.
+ * Each block is allocated and first touched by the thread that multiplies with it under a static schedule,
+ * so that its pages are placed on that thread's NUMA node by the default first-touch policy
+ */
+template <class IT, class NT>
+void SpDCCols<IT,NT>::RowSplit(int numsplits)
+{
+	if(m < numsplits)
+	{
+		std::cerr<< "Warning: Matrix is too small to be splitted for multithreading" << std::endl;
+		return;
+	}
+	if(splits > 0)
+	{
+		std::cerr<< "Warning: Matrix is already split for multithreading" << std::endl;
+		return;
+	}
+	bool hasdcsc = (nnz > 0 && dcsc != NULL);
+	std::vector<IT> rowweights(m, 1);
+	if(hasdcsc)
+	{
+		for(IT j=0; j< dcsc->nz; ++j)
+			++rowweights[dcsc->ir[j]];
+	}
+	rowsplits = SpHelper::BalancedSplits<IT>(rowweights, numsplits);
+	std::vector<IT>().swap(rowweights);
+
+	std::vector<int> rowowner(m);
+	for(int s=0; s< numsplits; ++s)
+		std::fill(rowowner.begin() + rowsplits[s], rowowner.begin() + rowsplits[s+1], s);
+
+	std::vector<IT> nzcs(numsplits, 0);
+	std::vector<IT> nnzs(numsplits, 0);
+	std::vector<IT> prevcolids(numsplits, -1);	// previous column id's are set to -1
+	if(hasdcsc)
+	{
+		for(IT i=0; i< dcsc->nzc; ++i)
+		{
+			for(IT j = dcsc->cp[i]; j< dcsc->cp[i+1]; ++j)
+			{
+				int owner = rowowner[dcsc->ir[j]];
+				if(prevcolids[owner] != dcsc->jc[i])
+				{
+					prevcolids[owner] = dcsc->jc[i];
+					++nzcs[owner];
+				}
+				++nnzs[owner];
+			}
+		}
+	}
+
+	Dcsc<IT,NT> ** pieces = new Dcsc<IT,NT>*[numsplits];
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+	for(int s=0; s< numsplits; ++s)
+	{
+		if(nzcs[s] > 0)
+		{
+			pieces[s] = new Dcsc<IT,NT>(nnzs[s], nzcs[s]);
+			std::fill_n(pieces[s]->cp, nzcs[s]+1, 0);	// first touch by the owning thread
+			std::fill_n(pieces[s]->jc, nzcs[s], 0);
+			std::fill_n(pieces[s]->ir, nnzs[s], 0);
+			std::fill_n(pieces[s]->numx, nnzs[s], NT());
+		}
+		else
+		{
+			pieces[s] = new Dcsc<IT,NT>();
+		}
+	}
+
+	// scatter the nonzeros, pages of the pieces stay where they were first touched
+	if(hasdcsc)
+	{
+		std::vector<IT> curnz(numsplits, 0);
+		std::vector<IT> curnzc(numsplits, 0);
+		for(IT i=0; i< dcsc->nzc; ++i)
+		{
+			IT colid = dcsc->jc[i];
+			for(IT j = dcsc->cp[i]; j< dcsc->cp[i+1]; ++j)
+			{
+				int owner = rowowner[dcsc->ir[j]];
+				Dcsc<IT,NT> * piece = pieces[owner];
+				if(curnzc[owner] == 0 || piece->jc[curnzc[owner]-1] != colid)
+				{
+					piece->jc[curnzc[owner]] = colid;
+					piece->cp[curnzc[owner]++] = curnz[owner];
+				}
+				piece->ir[curnz[owner]] = dcsc->ir[j] - rowsplits[owner];
+				piece->numx[curnz[owner]++] = dcsc->numx[j];
+			}
+		}
+		for(int s=0; s< numsplits; ++s)
+		{
+			if(nzcs[s] > 0)
+				pieces[s]->cp[nzcs[s]] = nnzs[s];
+		}
+		delete dcsc;	// claim memory
+	}
+	splits = numsplits;
+	dcscarr = pieces;
+}
+
 /**
   * O(nnz log(nnz)) time Transpose function
   * \remarks Performs a lexicographical sort
@@ -857,6 +1025,202 @@ SpDCCols<IT,NT> * SpDCCols<IT,NT>::TransposeConstPtr() const
 	return new SpDCCols<IT,NT>(Atuples,true);
 }
 
+/**
+  * O(nnz + m) time transpose into tuples, by a counting sort over the rows
+  * \remarks Tuples of the transpose come out sorted by columns, and by rows within a column
+  */
+template <class IT, class NT>
+void SpDCCols<IT,NT>::TransposedTuples(std::vector< std::tuple<IT,IT,NT> > & tuples) const
+{
+	if(splits > 0)
+	{
+		std::cout << "TransposedTuples does not support a matrix split for multithreading" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, SPLITMATRIX);
+	}
+	tuples.resize(nnz);
+	if(nnz == 0) return;
+
+	std::vector<IT> rowptr(m+1, 0);
+	for(IT k=0; k < dcsc->nz; ++k)
+		++rowptr[dcsc->ir[k]+1];
+	std::partial_sum(rowptr.begin(), rowptr.end(), rowptr.begin());
+	for(IT j=0; j < dcsc->nzc; ++j)
+	{
+		for(IT k = dcsc->cp[j]; k < dcsc->cp[j+1]; ++k)
+			tuples[rowptr[dcsc->ir[k]]++] = std::make_tuple(dcsc->jc[j], dcsc->ir[k], dcsc->numx[k]);
+	}
+}
+
+/**
+  * Adds the column sorted, duplicate-free tuples to the matrix, keeping the union of both nonzero sets
+  * Entries present in both become __binary_op(existing value, tuple value)
+  * If remove is given, tuples with remove[k] set delete the matching entry instead (and are ignored if there is none)
+  * Threads merge disjoint column ranges with about the same number of existing nonzeros, first counting, then filling
+  */
+template <class IT, class NT>
+template <typename _BinaryOperation>
+void SpDCCols<IT,NT>::MergeSortedTuples(const std::tuple<IT,IT,NT> * tuples, IT ntuples, _BinaryOperation __binary_op, const bool * remove)
+{
+	if(splits > 0)
+	{
+		std::cout << "MergeSortedTuples does not support a matrix split for multithreading" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, SPLITMATRIX);
+	}
+	if(ntuples == 0) return;
+	if(nnz == 0)
+	{
+		if(remove == NULL)
+		{
+			*this = SpDCCols<IT,NT>(m, n, ntuples, tuples, false);
+		}
+		else
+		{
+			std::vector< std::tuple<IT,IT,NT> > inserted;
+			for(IT k=0; k < ntuples; ++k)
+				if(!remove[k]) inserted.push_back(tuples[k]);
+			if(!inserted.empty())
+				*this = SpDCCols<IT,NT>(m, n, static_cast<IT>(inserted.size()), inserted.data(), false);
+		}
+		return;
+	}
+
+	int nthreads = 1;
+#ifdef _OPENMP
+#pragma omp parallel
+	{
+		nthreads = omp_get_num_threads();
+	}
+#endif
+	// thread t merges columns [colcut[t], colcut[t+1])
+	std::vector<IT> colcut(nthreads+1), apos(nthreads+1), tpos(nthreads+1);
+	colcut[0] = 0;
+	colcut[nthreads] = n;
+	for(int t=1; t < nthreads; ++t)
+	{
+		IT target = static_cast<IT>((static_cast<double>(nnz) * t) / nthreads);
+		IT j = std::upper_bound(dcsc->cp, dcsc->cp + dcsc->nzc + 1, target) - dcsc->cp - 1;
+		colcut[t] = std::max(colcut[t-1], dcsc->jc[std::min(j, dcsc->nzc-1)]);
+	}
+	auto colless = [](const std::tuple<IT,IT,NT> & tup, IT col){ return std::get<1>(tup) < col; };
+	for(int t=0; t <= nthreads; ++t)
+	{
+		apos[t] = std::lower_bound(dcsc->jc, dcsc->jc + dcsc->nzc, colcut[t]) - dcsc->jc;
+		tpos[t] = std::lower_bound(tuples, tuples + ntuples, colcut[t], colless) - tuples;
+	}
+
+	// with fill == false only counts, otherwise writes the merged columns starting at (nzcoff, nzoff)
+	auto mergecols = [&](int t, bool fill, IT nzcoff, IT nzoff, Dcsc<IT,NT> * merged, IT & cnzc, IT & cnz)
+	{
+		IT i = apos[t];
+		IT k = tpos[t];
+		IT c = nzcoff;
+		IT z = nzoff;
+		while(i < apos[t+1] || k < tpos[t+1])
+		{
+			IT acol = (i < apos[t+1]) ? dcsc->jc[i] : n;
+			IT tcol = (k < tpos[t+1]) ? std::get<1>(tuples[k]) : n;
+			IT col = std::min(acol, tcol);
+			IT zstart = z;
+			IT a = (acol == col) ? dcsc->cp[i] : 0;
+			IT aend = (acol == col) ? dcsc->cp[i+1] : 0;
+			while(a < aend || (k < tpos[t+1] && std::get<1>(tuples[k]) == col))
+			{
+				bool hastuple = (k < tpos[t+1] && std::get<1>(tuples[k]) == col);
+				bool removes = hastuple && remove != NULL && remove[k];
+				if(removes)
+				{
+					if(a < aend && dcsc->ir[a] == std::get<0>(tuples[k])) ++a;	// deleted
+					else if(a < aend && dcsc->ir[a] < std::get<0>(tuples[k]))
+					{
+						if(fill)
+						{
+							merged->ir[z] = dcsc->ir[a];
+							merged->numx[z] = dcsc->numx[a];
+						}
+						++a;
+						++z;
+						continue;
+					}
+					++k;
+					continue;
+				}
+				if(a < aend && (!hastuple || dcsc->ir[a] < std::get<0>(tuples[k])))
+				{
+					if(fill)
+					{
+						merged->ir[z] = dcsc->ir[a];
+						merged->numx[z] = dcsc->numx[a];
+					}
+					++a;
+				}
+				else if(a < aend && dcsc->ir[a] == std::get<0>(tuples[k]))
+				{
+					if(fill)
+					{
+						merged->ir[z] = dcsc->ir[a];
+						merged->numx[z] = __binary_op(dcsc->numx[a], std::get<2>(tuples[k]));
+					}
+					++a;
+					++k;
+				}
+				else
+				{
+					if(fill)
+					{
+						merged->ir[z] = std::get<0>(tuples[k]);
+						merged->numx[z] = std::get<2>(tuples[k]);
+					}
+					++k;
+				}
+				++z;
+			}
+			if(acol == col) ++i;
+			if(z > zstart)	// columns whose entries were all deleted disappear
+			{
+				if(fill)
+				{
+					merged->jc[c] = col;
+					merged->cp[c] = zstart;
+				}
+				++c;
+			}
+		}
+		cnzc = c - nzcoff;
+		cnz = z - nzoff;
+	};
+
+	std::vector<IT> nzcdisp(nthreads+1, 0), nzdisp(nthreads+1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+	for(int t=0; t < nthreads; ++t)
+		mergecols(t, false, 0, 0, NULL, nzcdisp[t+1], nzdisp[t+1]);
+	std::partial_sum(nzcdisp.begin(), nzcdisp.end(), nzcdisp.begin());
+	std::partial_sum(nzdisp.begin(), nzdisp.end(), nzdisp.begin());
+	if(nzdisp[nthreads] == 0)	// everything was deleted
+	{
+		delete dcsc;
+		dcsc = NULL;
+		nnz = 0;
+		return;
+	}
+
+	Dcsc<IT,NT> * merged = new Dcsc<IT,NT>(nzdisp[nthreads], nzcdisp[nthreads]);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1)
+#endif
+	for(int t=0; t < nthreads; ++t)
+	{
+		IT cnzc, cnz;
+		mergecols(t, true, nzcdisp[t], nzdisp[t], merged, cnzc, cnz);
+	}
+	merged->cp[merged->nzc] = merged->nz;
+
+	delete dcsc;
+	dcsc = merged;
+	nnz = merged->nz;
+}
+
 /** 
   * Splits the matrix into two parts, simply by cutting along the columns
   * Simple algorithm that doesn't intend to split perfectly, but it should do a pretty good job
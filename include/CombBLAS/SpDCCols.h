@@ -33,6 +33,7 @@
 #include <iostream>
 #include <fstream>
 #include <cmath>
+#include <memory>
 #include "SpMat.h"	// Best to include the base class first
 #include "SpHelper.h"
 #include "StackEntry.h"
@@ -47,6 +48,9 @@
 
 namespace combblas {
 
+template <class IU, class NU>
+class SpTuplesSoA;
+
 template <class IT, class NT>
 class SpDCCols: public SpMat<IT, NT, SpDCCols<IT, NT> >
 {
@@ -59,6 +63,7 @@ public:
 	SpDCCols (IT size, IT nRow, IT nCol, IT nzc);
 	SpDCCols (const SpTuples<IT,NT> & rhs, bool transpose);
     SpDCCols (IT nRow, IT nCol, IT nnz1, const std::tuple<IT, IT, NT> * rhs, bool transpose);
+	SpDCCols (SpTuplesSoA<IT,NT> & rhs);	//!< takes over the row and value arrays of rhs (sorted by columns first if needed)
 
 	SpDCCols (const SpDCCols<IT,NT> & rhs);					// Actual copy constructor		
 	~SpDCCols();
@@ -274,11 +279,12 @@ public:
 	void Transpose();				//!< Mutator version, replaces the calling object 
 	SpDCCols<IT,NT> TransposeConst() const;		//!< Const version, doesn't touch the existing object
 	SpDCCols<IT,NT> * TransposeConstPtr() const;
+	void TransposedTuples(std::vector< std::tuple<IT,IT,NT> > & tuples) const;	//!< Nonzeros of the transpose, sorted by columns
 
-	void RowSplit(int numsplits)
-	{
-		BooleanRowSplit(*this, numsplits);	// only works with boolean arrays
-	}
+	template <typename _BinaryOperation>
+	void MergeSortedTuples(const std::tuple<IT,IT,NT> * tuples, IT ntuples, _BinaryOperation __binary_op, const bool * remove = NULL);	//!< In place union with column sorted tuples (or deletion of those flagged in remove)
+
+	void RowSplit(int numsplits);	//!< Splits into numsplits nnz-balanced row blocks for multithreading
     
     void ColSplit(int parts, std::vector< SpDCCols<IT,NT> > & matrices); //!< \attention Destroys calling object (*this)
     void ColSplit(int parts, std::vector< SpDCCols<IT,NT>* > & matrices); //!< \attention Destroys calling object (*this)
@@ -305,6 +311,7 @@ public:
 	IT getnnz() const { return nnz; }
 	IT getnzc() const { return (nnz == 0) ? 0: dcsc->nzc; }
 	int getnsplit() const { return splits; }
+	const std::vector<IT> & GetSplitOffsets() const { return rowsplits; }	//!< first local row of each split, followed by getnrow()
 	
 	std::ofstream& put(std::ofstream & outfile) const;
 	std::ifstream& get(std::ifstream & infile);
@@ -335,6 +342,13 @@ public:
     
     auto GetInternal() const    { return GetDCSC(); }
     auto GetInternal(int i) const  { return GetDCSC(i); }
+
+	//! Builds the O(1) column lookup index of the (single threaded) dcsc, empty if there is none
+	//! Nothing is cached: callers build it once before their parallel region and drop it when done
+	DcscColIndex<IT> ColumnIndex() const
+	{
+		return (dcsc == NULL) ? DcscColIndex<IT>() : DcscColIndex<IT>(dcsc->jc, dcsc->nzc, n);
+	}
 	
 
 private:
@@ -361,6 +375,7 @@ private:
 	IT nnz;
 	
 	int splits;	// for multithreading
+	std::vector<IT> rowsplits;	// row boundaries of the splits (splits+1 entries)
 
 	template <class IU, class NU>
 	friend class SpDCCols;		// Let other template instantiations (of the same class) access private members
@@ -373,9 +388,6 @@ private:
 	//template <class IU, class NU>
 	//friend class SpDCCols<IU, NU>::SpColIter;
 	
-	template<typename IU>
-	friend void BooleanRowSplit(SpDCCols<IU, bool> & A, int numsplits);
-
 	template<typename IU, typename NU1, typename NU2>
 	friend SpDCCols<IU, typename promote_trait<NU1,NU2>::T_promote > EWiseMult (const SpDCCols<IU,NU1> & A, const SpDCCols<IU,NU2> & B, bool exclude);
 
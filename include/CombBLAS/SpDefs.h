@@ -75,6 +75,7 @@ namespace combblas {
 #define NOFILE 3004
 #define MATRIXALIAS 3005
 #define UNKNOWNMPITYPE 3006
+#define SPLITMATRIX 3007
 
 // Enable bebug prints
 //#define SPREFDEBUG
@@ -86,6 +87,8 @@ namespace combblas {
 //	TR: Transpose
 //	RD: ReadDistribute
 //	RF: Sparse matrix indexing
+//	SYM: Symmetrize
+//	IDX: IndexCodec
 #define TRTAGNZ 121
 #define TRTAGM 122
 #define TRTAGN 123
@@ -108,6 +111,9 @@ namespace combblas {
 #define ROTATE 140
 #define PUPSIZE 141
 #define PUPDATA 142
+#define SYMTAGNZ 143
+#define SYMTAGTUPLES 144
+#define IDXCODED 145
 
 enum Dim
 {
@@ -125,6 +131,64 @@ Row
 #define THRESHOLD 4	// if range1.size() / range2.size() < threshold, use scanning based indexing
 #endif
 
+#ifndef COLINDEXDENSE
+#define COLINDEXDENSE 8		// Dcsc column lookups use a dense jump table if at least 1/COLINDEXDENSE of the columns are nonempty
+#endif
+
+#ifndef COLINDEXBITMAP
+#define COLINDEXBITMAP 128	// ... a bitmap with rank counts if at least 1/COLINDEXBITMAP of them are, and a hash table otherwise
+#endif
+
+#ifndef RADIXSORTTHRESHOLD
+#define RADIXSORTTHRESHOLD 16384	// tuple arrays shorter than this are sorted with std::sort instead of the radix sort
+#endif
+
+/*
+ * Skew detection of FullyDistVec gathers (opt-in, see operator()(ri, handleskew)) and FullyDistSpVec scatters
+ * All three can be overridden at compile time. How they were picked:
+ *	HOTOWNERFACTOR: with uniformly random indices an owner's load is binomial around the average, so twice
+ *		the average is many standard deviations away once the load reaches HOTMINLOAD (sqrt(4096) = 64, i.e. 1.6%)
+ *	HOTMINLOAD: the sketch costs an Allreduce of 2*HOTSKETCHWIDTH words, which only pays off if the hot owner
+ *		serves at least about that many requests
+ *	HOTSKETCHWIDTH: an index is replicated if its estimate exceeds twice the average counter, i.e. 2/HOTSKETCHWIDTH
+ *		of the hot requests. Two rows of 4096 64-bit counters are 64 KB, small next to the gathers worth the effort
+ */
+#ifndef HOTOWNERFACTOR
+#define HOTOWNERFACTOR 2	// an owner serving more than HOTOWNERFACTOR times the average load of a gather/scatter replicates its hot entries
+#endif
+
+#ifndef HOTMINLOAD
+#define HOTMINLOAD 4096	// ... but only if it serves at least that many requests
+#endif
+
+#ifndef HOTSKETCHWIDTH
+#define HOTSKETCHWIDTH 4096	// number of counters per row of the frequency sketch that detects hot indices
+#endif
+
+#ifndef RMATTILELEVELS
+#define RMATTILELEVELS 10	// the local R-MAT generator splits each dimension into 2^RMATTILELEVELS tiles that are dealt to process rows/columns
+#endif
+
+#ifndef FEISTELROUNDS
+#define FEISTELROUNDS 4		// rounds of the Feistel network that scrambles vertex identifiers within a tile
+#endif
+
+#ifndef ENCODESPVECINDICES
+#define ENCODESPVECINDICES 1	// ship the indices of sparse vector messages as the smallest of list, delta-varint and bitmap (0: always a list)
+#endif
+
+#ifndef ENCODEMINNNZ
+#define ENCODEMINNNZ 256	// sparse vector messages with fewer indices are latency bound and go out as plain lists
+#endif
+
+#ifndef SPAMERGEFACTOR
+#define SPAMERGEFACTOR 16	// commutative semirings merge SpMV contributions in a dense accumulator if it is at most SPAMERGEFACTOR times the number of contributions
+#endif
+
+#ifndef NNZBALANCEROUNDS
+#define NNZBALANCEROUNDS 4	// rounds of NnzBalancedPermutation that move split points to account for the nonzeros of spilled vertices
+#endif
+
 #ifndef MEMORYINBYTES
 #define MEMORYINBYTES  (196 * 1048576)	// 196 MB, it is advised to define MEMORYINBYTES to be "at most" (1/4)th of available memory per core
 #endif
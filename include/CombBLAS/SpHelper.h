@@ -32,6 +32,7 @@
 #define _SP_HELPER_H_
 
 #include <vector>
+#include <algorithm>
 #include <limits>
 #include <map>
 #include <string>
@@ -43,6 +44,7 @@
 #include "HeapEntry.h"
 #include "SpImpl.h"
 #include "hash.hpp"
+#include "DcscColIndex.h"
 
 namespace combblas {
 
@@ -253,6 +255,34 @@ public:
 		delete [] array;
 	}
 
+	/**
+	 * Cuts the index range [0, weights.size()) into nparts contiguous pieces of roughly equal total weight
+	 * Every piece gets at least one index as long as there are at least nparts indices
+	 * @return nparts+1 boundaries, piece p is [bounds[p], bounds[p+1])
+	 */
+	template <typename IT, typename WT>
+	static std::vector<IT> BalancedSplits(const std::vector<WT> & weights, int nparts)
+	{
+		IT n = static_cast<IT>(weights.size());
+		std::vector<double> prefix(weights.size()+1, 0.0);
+		for(size_t i=0; i<weights.size(); ++i)
+			prefix[i+1] = prefix[i] + static_cast<double>(weights[i]);
+
+		std::vector<IT> bounds(nparts+1, n);
+		bounds[0] = 0;
+		for(int p=1; p<nparts; ++p)
+		{
+			double target = prefix.back() * p / nparts;
+			IT cut = static_cast<IT>(std::lower_bound(prefix.begin(), prefix.end(), target) - prefix.begin());
+			if(cut > 0 && target - prefix[cut-1] < prefix[cut] - target)
+				--cut;	// the previous boundary is closer to the target
+			IT lo = (n >= nparts) ? bounds[p-1] + 1 : bounds[p-1];
+			IT hi = (n >= nparts) ? n - (nparts - p) : n;
+			bounds[p] = std::min(std::max(cut, lo), hi);
+		}
+		return bounds;
+	}
+
 	
 	template <typename SR, typename NT1, typename NT2, typename IT, typename OVT>
 	static IT Popping(NT1 * numA, NT2 * numB, StackEntry< OVT, std::pair<IT,IT> > * multstack,
@@ -453,11 +483,7 @@ IT SpHelper::SpColByCol(const Dcsc<IT,NT1> & Adcsc, const Dcsc<IT,NT2> & Bdcsc,
 	IT cnzmax = Adcsc.nz + Bdcsc.nz;	// estimate on the size of resulting matrix C
 	multstack = new StackEntry<OVT, std::pair<IT,IT> >[cnzmax];	 
 
-	float cf  = static_cast<float>(nA+1) / static_cast<float>(Adcsc.nzc);
-	IT csize = static_cast<IT>(ceil(cf));   // chunk size
-	IT * aux;
-	//IT auxsize = Adcsc.ConstructAux(nA, aux);
-	Adcsc.ConstructAux(nA, aux);
+	DcscColIndex<IT> colindex(Adcsc.jc, Adcsc.nzc, nA);
 
 	for(IT i=0; i< Bdcsc.nzc; ++i)		// for all the columns of B
 	{
@@ -476,7 +502,7 @@ IT SpHelper::SpColByCol(const Dcsc<IT,NT1> & Adcsc, const Dcsc<IT,NT2> & Bdcsc,
 		std::vector< std::pair<IT,IT> > colinds(nnzcol);		
     std::copy(Bdcsc.ir + Bdcsc.cp[i], Bdcsc.ir + Bdcsc.cp[i+1], colnums.begin());
 		
-		Adcsc.FillColInds(&colnums[0], colnums.size(), colinds, aux, csize);
+		Adcsc.FillColInds(&colnums[0], colnums.size(), colinds, colindex);
 		IT maxnnz = 0;	// max number of nonzeros in C(:,i)	
 		IT hsize = 0;
 		
@@ -533,7 +559,6 @@ IT SpHelper::SpColByCol(const Dcsc<IT,NT1> & Adcsc, const Dcsc<IT,NT2> & Bdcsc,
 		}
 		delete [] wset;
 	}
-	delete [] aux;
 	return cnz;
 }
 
@@ -290,6 +290,7 @@ void SpImpl<SR,IT,bool,IVT,OVT>::SpMXSpV_ForThreading(const Dcsc<IT,bool> & Adcs
 template <typename SR, typename IT, typename IVT, typename OVT>
 void SpImpl<SR,IT,bool,IVT,OVT>::SpMXSpV_ForThreading(const Dcsc<IT,bool> & Adcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen, std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset, std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds)
 {
+	nzinds.clear();	// a preallocated SPA keeps its capacity across calls
 	// The following piece of code is not general, but it's more memory efficient than FillColInds
 	int32_t k = 0; 	// index to indx vector
 	IT i = 0; 	// index to columns of matrix
@@ -324,6 +325,63 @@ void SpImpl<SR,IT,bool,IVT,OVT>::SpMXSpV_ForThreading(const Dcsc<IT,bool> & Adcs
 	{
 		indy[i] = nzinds[i] + offset;	// return column-global index and let gespmv determine the receiver's local index
 		numy[i] = localy[nzinds[i]]; 	
+		isthere.reset_bit(nzinds[i]);	// leave the SPA clean for the next call
+	}
+}
+
+
+template <class SR, class IT, class NUM, class IVT, class OVT>
+void SpImpl<SR,IT,NUM,IVT,OVT>::SpMXSpV_ForThreading(const Dcsc<IT,NUM> & Adcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
+                                                     std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset)
+{
+    std::vector<OVT> localy(mA);
+    BitMap isthere(mA);
+    std::vector<uint32_t> nzinds;	// nonzero indices
+    
+    SpMXSpV_ForThreading(Adcsc, mA, indx, numx, veclen, indy, numy, offset, localy, isthere, nzinds);
+}
+
+//! General semiring version of the boolean SPA kernel above, products annihilated by SR::returnedSAID() are skipped
+template <class SR, class IT, class NUM, class IVT, class OVT>
+void SpImpl<SR,IT,NUM,IVT,OVT>::SpMXSpV_ForThreading(const Dcsc<IT,NUM> & Adcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen, std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset, std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds)
+{
+	nzinds.clear();
+	int32_t k = 0; 	// index to indx vector
+	IT i = 0; 	// index to columns of matrix
+	while(i< Adcsc.nzc && k < veclen)
+	{
+		if(Adcsc.jc[i] < indx[k]) ++i;
+		else if(indx[k] < Adcsc.jc[i]) ++k;
+		else
+		{
+			for(IT j=Adcsc.cp[i]; j < Adcsc.cp[i+1]; ++j)	// for all nonzeros in this column
+			{
+				OVT mrhs = SR::multiply(Adcsc.numx[j], numx[k]);
+				if(SR::returnedSAID()) continue;
+				uint32_t rowid = (uint32_t) Adcsc.ir[j];
+				if(!isthere.get_bit(rowid))
+				{
+					localy[rowid] = mrhs;
+					nzinds.push_back(rowid);
+					isthere.set_bit(rowid);
+				}
+				else
+				{
+					localy[rowid] = SR::add(localy[rowid], mrhs);
+				}	
+			}
+			++i; ++k;
+		}
+	}
+	int nnzy = nzinds.size();
+	integerSort(nzinds.data(), nnzy);
+	indy.resize(nnzy);
+	numy.resize(nnzy);
+	for(int i=0; i< nnzy; ++i)
+	{
+		indy[i] = nzinds[i] + offset;
+		numy[i] = localy[nzinds[i]];
+		isthere.reset_bit(nzinds[i]);
 	}
 }
 
@@ -392,6 +450,7 @@ void SpMXSpV_Bucket(const Csc<IT,NT> & Acsc, int32_t mA, const int32_t * indx, c
 {
     if(veclen==0)
         return;
+    KERNELPROFILE_SCOPE("SpMXSpV_Bucket");
     
     double tstart = MPI_Wtime();
     int nthreads=1;
@@ -487,6 +546,9 @@ void SpMXSpV_Bucket(const Csc<IT,NT> & Acsc, int32_t mA, const int32_t * indx, c
         bSize[rowSplits-1][j] = 0;
         maxBucketSize = std::max(thisBucketSize, maxBucketSize);
     }
+    // the touched columns of A and the input are read, the products are written to and read back from the buckets
+    KERNELPROFILE_WORK(2.0 * disp[rowSplits], static_cast<double>(disp[rowSplits]) * (sizeof(int32_t) + sizeof(NT) + 2 * (sizeof(int32_t) + sizeof(OVT)))
+                       + static_cast<double>(veclen) * (sizeof(int32_t) + sizeof(IVT) + 2 * sizeof(IT)));
     
     
     
@@ -698,4 +760,83 @@ void SpMXSpV_Bucket(const Csc<IT,NT> & Acsc, int32_t mA, const int32_t * indx, c
     
 }
 
+
+/**
+ * SpMXSpV on a PackedDcsc with a dense accumulator (SPA)
+ * Every column is decoded once, straight into the accumulator
+ * localy, isthere and nzinds are preallocated (see PreAllocatedSPA); only the touched entries are
+ * cleared afterwards, so a call costs time proportional to the work, not to mA
+ * offset is the offset of indices in the matrix in case the matrix is split
+ **/
+template <typename SR, typename IT, typename NUM, typename IVT, typename OVT>
+void SpMXSpV_Packed(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen, std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset,
+                    std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds)
+{
+    nzinds.clear();
+    for (int32_t k = 0; k < veclen; ++k)
+    {
+        IT pos = Apdcsc.FindColumn(static_cast<IT>(indx[k]));
+        if(pos < 0) continue;
+        const IVT & xval = numx[k];
+        Apdcsc.ForColumn(pos, [&](IT rowid, NUM aval)	// pattern only semirings skip decoding the values
+        {
+            OVT mrhs = SR::multiply(aval, xval);
+            if(SR::returnedSAID()) return;
+            if(!isthere.get_bit(rowid))
+            {
+                localy[rowid] = mrhs;
+                isthere.set_bit(rowid);
+                nzinds.push_back(static_cast<uint32_t>(rowid));
+            }
+            else
+            {
+                localy[rowid] = SR::add(localy[rowid], mrhs);
+            }
+        }, typename SemiringTraits<SR>::pattern_tag());
+    }
+    int nnzy = nzinds.size();
+    integerSort(nzinds.data(), nnzy);
+    indy.reserve(indy.size() + nnzy);
+    numy.reserve(numy.size() + nnzy);
+    for(int i=0; i < nnzy; ++i)
+    {
+        indy.push_back(static_cast<int32_t>(nzinds[i]) + offset);
+        numy.push_back(localy[nzinds[i]]);
+        isthere.reset_bit(nzinds[i]);	// leave the SPA clean for the next call
+    }
+}
+
+/**
+ * SpMXSpV on a PackedDcsc without preallocated buffers
+ * The contributions are collected and sorted by row (stably, so that they are added in column order)
+ **/
+template <typename SR, typename IT, typename NUM, typename IVT, typename OVT>
+void SpMXSpV_PackedSort(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen, std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset)
+{
+    std::vector< std::pair<int32_t, OVT> > contributions;
+    for (int32_t k = 0; k < veclen; ++k)
+    {
+        IT pos = Apdcsc.FindColumn(static_cast<IT>(indx[k]));
+        if(pos < 0) continue;
+        const IVT & xval = numx[k];
+        Apdcsc.ForColumn(pos, [&](IT rowid, NUM aval)
+        {
+            OVT mrhs = SR::multiply(aval, xval);
+            if(SR::returnedSAID()) return;
+            contributions.push_back(std::make_pair(static_cast<int32_t>(rowid), mrhs));
+        }, typename SemiringTraits<SR>::pattern_tag());
+    }
+    std::stable_sort(contributions.begin(), contributions.end(),
+        [](const std::pair<int32_t, OVT> & a, const std::pair<int32_t, OVT> & b){ return a.first < b.first; });
+    for(size_t i=0; i < contributions.size(); )
+    {
+        int32_t rowid = contributions[i].first;
+        OVT acc = contributions[i].second;
+        for(++i; i < contributions.size() && contributions[i].first == rowid; ++i)
+            acc = SR::add(acc, contributions[i].second);
+        indy.push_back(rowid + offset);
+        numy.push_back(acc);
+    }
+}
+
 }
@@ -34,6 +34,8 @@
 #include <vector>
 #include "PreAllocatedSPA.h"
 #include "Deleter.h"
+#include "KernelProfiler.h"
+#include "SemiringTraits.h"
 
 namespace combblas {
 
@@ -43,6 +45,9 @@ class Dcsc;
 template <class IT, class NT>
 class Csc;
 
+template <class IT, class NT>
+class PackedDcsc;
+
 template <class SR, class IT, class NUM, class IVT, class OVT>
 struct SpImpl;
 
@@ -145,6 +150,54 @@ void SpMXSpV_ForThreading(const Csc<IT,NUM> & Acsc, int32_t mA, const int32_t *
 
 
 
+/*
+ PackedDcsc implementation, all overloaded function calls will be routed to these two functions.
+ The SPA version needs mA-sized buffers, so it only runs on the preallocated ones; otherwise the
+ contributions are sorted, which costs time proportional to the work and not to mA.
+ */
+template <typename SR, typename IT, typename NUM, typename IVT, typename OVT>
+void SpMXSpV_Packed(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen, std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset,
+                    std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds);
+
+template <typename SR, typename IT, typename NUM, typename IVT, typename OVT>
+void SpMXSpV_PackedSort(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen, std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset);
+
+//! Overload #1: PackedDcsc
+template <class SR, class IT, class NUM, class IVT, class OVT>
+void SpMXSpV(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
+             std::vector<int32_t> & indy, std::vector< OVT > & numy, PreAllocatedSPA<OVT> & SPA)
+{
+    if(SPA.initialized)
+        SpMXSpV_Packed<SR>(Apdcsc, mA, indx, numx, veclen, indy, numy, 0, SPA.V_localy[0], SPA.V_isthere[0], SPA.V_inds[0]);
+    else
+        SpMXSpV_PackedSort<SR>(Apdcsc, mA, indx, numx, veclen, indy, numy, 0);
+};
+
+//! Overload #2: PackedDcsc
+template <class SR, class IT, class NUM, class IVT, class OVT>
+void SpMXSpV(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
+             int32_t * indy, OVT * numy, int * cnts, int * dspls, int p_c)
+{
+    std::cout << "Optbuf enabled version is not yet supported with packed matrices" << std::endl;
+};
+
+//! Overload #3: PackedDcsc
+template <class SR, class IT, class NUM, class IVT, class OVT>
+void SpMXSpV_ForThreading(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
+                          std::vector<int32_t> & indy, std::vector< OVT > & numy, int32_t offset)
+{
+    SpMXSpV_PackedSort<SR>(Apdcsc, mA, indx, numx, veclen, indy, numy, offset);
+};
+
+//! Overload #4: PackedDcsc w/ preallocated SPA
+template <class SR, class IT, class NUM, class IVT, class OVT>
+void SpMXSpV_ForThreading(const PackedDcsc<IT,NUM> & Apdcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
+                          std::vector<int32_t> & indy, std::vector< OVT > & numy, int32_t offset, std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds)
+{
+    SpMXSpV_Packed<SR>(Apdcsc, mA, indx, numx, veclen, indy, numy, offset, localy, isthere, nzinds);
+};
+
+
 /**
  * IT: The sparse matrix index type. Sparse vector index type is fixed to be int32_t
  * It is the caller function's (inside ParFriends/Friends) job to convert any different types
@@ -165,16 +218,12 @@ struct SpImpl
     };
 
 
+    //! Dcsc and vector index types do not need to match
     static void SpMXSpV_ForThreading(const Dcsc<IT,NUM> & Adcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
-                                     std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset)
-    {
-        std::cout << "Threaded version is not yet supported with general (non-boolean) matrices" << std::endl;
-    };
-	static void SpMXSpV_ForThreading(const Dcsc<IT,NUM> & Acsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
-									 std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset, std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds)
-	{
-		std::cout << "Threaded version is not yet supported with general (non-boolean) matrices" << std::endl;
-	};
+                                     std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset);
+    //! Dcsc and vector index types do not need to match
+    static void SpMXSpV_ForThreading(const Dcsc<IT,NUM> & Adcsc, int32_t mA, const int32_t * indx, const IVT * numx, int32_t veclen,
+                                     std::vector<int32_t> & indy, std::vector<OVT> & numy, int32_t offset, std::vector<OVT> & localy, BitMap & isthere, std::vector<uint32_t> & nzinds);
 };
 
 
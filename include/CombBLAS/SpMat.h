@@ -100,6 +100,10 @@ public:
     {
         return static_cast<const DER*>(this)->getnsplit();
     }
+    const auto & GetSplitOffsets() const    // row boundaries of the splits, only for split (multithreaded) matrices
+    {
+        return static_cast<const DER*>(this)->GetSplitOffsets();
+    }
 
 	void Transpose()
 	{
@@ -0,0 +1,59 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include "SpPackedCols.h"
+
+namespace combblas {
+
+template <class IT, class NT>
+SpPackedCols<IT,NT>::SpPackedCols(const SpDCCols<IT,NT> & rhs): m(rhs.getnrow()), n(rhs.getncol()), nnz(rhs.getnnz())
+{
+	assert(rhs.getnsplit() == 0);
+	if(nnz > 0)
+		pdcsc = PackedDcsc<IT,NT>(*(rhs.GetDCSC()), n);
+}
+
+template <class IT, class NT>
+SpPackedCols<IT,NT>::SpPackedCols(const SpTuples<IT,NT> & rhs, bool transpose)
+: SpPackedCols(SpDCCols<IT,NT>(rhs, transpose))
+{
+}
+
+template <class IT, class NT>
+void SpPackedCols<IT,NT>::PrintInfo() const
+{
+	std::cout << "m: " << m ;
+	std::cout << ", n: " << n ;
+	std::cout << ", nnz: "<< nnz ;
+	std::cout << ", bytes: " << GetBytes();
+	const char * encodings[3] = {"raw", "dictionary", "constant"};
+	std::cout << ", values: " << encodings[pdcsc.GetValueEncoding()] << std::endl;
+}
+
+}
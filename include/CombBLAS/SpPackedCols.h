@@ -0,0 +1,87 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _SP_PACKED_COLS_H_
+#define _SP_PACKED_COLS_H_
+
+#include <iostream>
+#include "SpMat.h"	// Best to include the base class first
+#include "SpHelper.h"
+#include "SpTuples.h"
+#include "SpDCCols.h"
+#include "packeddcsc.h"
+
+namespace combblas {
+
+/**
+ * Read-only local matrix with compressed row indices and values (see PackedDcsc)
+ * Meant for bandwidth bound SpMV and SpMSpV on matrices that do not change:
+ * build the matrix as SpDCCols, then convert, e.g.
+ *	SpParMat<int64_t,bool,SpPackedCols<int64_t,bool>> P = A;	// A is SpParMat<int64_t,bool,SpDCCols<int64_t,bool>>
+ * Packed matrices are never split for multithreading.
+ */
+template <class IT, class NT>
+class SpPackedCols: public SpMat<IT, NT, SpPackedCols<IT, NT> >
+{
+public:
+	typedef IT LocalIT;
+	typedef NT LocalNT;
+
+	// Constructors :
+	SpPackedCols (): m(0), n(0), nnz(0) {}
+	SpPackedCols (const SpDCCols<IT,NT> & rhs);
+	SpPackedCols (const SpTuples<IT,NT> & rhs, bool transpose);
+
+	IT getnrow() const { return m; }
+	IT getncol() const { return n; }
+	IT getnnz() const { return nnz; }
+	IT getnzc() const { return pdcsc.nzc; }
+	int getnsplit() const { return 0; }
+	const std::vector<IT> & GetSplitOffsets() const { static const std::vector<IT> none; return none; }	// never split
+	bool isZero() const { return (nnz == 0); }
+
+	const PackedDcsc<IT,NT> * GetPackedDcsc() const { return &pdcsc; }
+	auto GetInternal() const { return GetPackedDcsc(); }
+	auto GetInternal(int i) const { return GetPackedDcsc(); }	// there is a single piece
+
+	size_t GetBytes() const { return pdcsc.GetBytes(); }
+	void PrintInfo() const;
+
+private:
+	IT m;
+	IT n;
+	IT nnz;
+	PackedDcsc<IT,NT> pdcsc;
+};
+
+}
+
+#include "SpPackedCols.cpp"
+
+#endif
@@ -42,6 +42,8 @@ extern "C" {
 #include <fstream>
 #include <algorithm>
 #include <set>
+#include <limits>
+#include <numeric>
 #include <stdexcept>
 
 namespace combblas {
@@ -769,6 +771,151 @@ float SpParMat< IT,NT,DER >::LoadImbalance() const
  	return static_cast<float>((commGrid->GetSize() * maxnnz)) / static_cast<float>(totnnz);  
 }
 
+/**
+ * Symmetric permutation that balances the nonzeros of the block rows and block columns
+ * of the processor grid while keeping most vertices in their original relative order.
+ * The vertices are first cut into pr contiguous ranges of equal nnz (row plus column counts),
+ * i.e. the split points a non-uniform distribution would use. As the distribution of SpParMat
+ * is uniform, each range is then mapped to its uniform block: the b highest-nnz vertices of a
+ * range that has more than the b slots of its block stay (in original order), and the remaining
+ * low-nnz vertices fill the free slots of the short ranges. The nonzeros these spilled vertices
+ * carry are fed back into the split points for up to NNZBALANCEROUNDS rounds.
+ * Unlike RandPermute, this keeps the locality of the input ordering on skewed graphs.
+ * On an unsymmetric matrix only the sums of the block row and block column nonzeros are balanced.
+ * @return p such that A(p,p) is balanced, p[new] = old; p.sort() gives the new label of each old vertex
+ */
+template <class IT, class NT, class DER>
+FullyDistVec<IT,IT> SpParMat<IT,NT,DER>::NnzBalancedPermutation() const
+{
+	if(getnrow() != getncol())
+	{
+		SpParHelper::Print("NnzBalancedPermutation() needs a square matrix\n");
+		MPI_Abort(MPI_COMM_WORLD, NOTSQUARE);
+	}
+	MPI_Comm World = commGrid->GetWorld();
+	int nranges = commGrid->GetGridRows();
+	IT n = getnrow();
+
+	FullyDistVec<IT,IT> degrees(commGrid), coldegrees(commGrid);
+	Reduce(degrees, Row, std::plus<IT>(), static_cast<IT>(0), [](NT){ return static_cast<IT>(1); });
+	Reduce(coldegrees, Column, std::plus<IT>(), static_cast<IT>(0), [](NT){ return static_cast<IT>(1); });
+	degrees += coldegrees;
+
+	IT locsize = degrees.LocArrSize();
+	IT offset = degrees.LengthUntil();
+	const IT * deg = degrees.GetLocArr();
+	IT localnnz = std::accumulate(deg, deg + locsize, static_cast<IT>(0));
+	IT firstnnz = 0, totalnnz = 0, maxdeg = 0;
+	MPI_Exscan(&localnnz, &firstnnz, 1, MPIType<IT>(), MPI_SUM, World);
+	if(commGrid->GetRank() == 0) firstnnz = 0;	// MPI_Exscan leaves it undefined on the first process
+	MPI_Allreduce(&localnnz, &totalnnz, 1, MPIType<IT>(), MPI_SUM, World);
+	if(locsize > 0) maxdeg = *std::max_element(deg, deg + locsize);
+	MPI_Allreduce(MPI_IN_PLACE, &maxdeg, 1, MPIType<IT>(), MPI_MAX, World);
+
+	// uniform blocks of the grid rows/columns
+	std::vector<IT> blockstart(nranges+1);
+	for(int r = 0; r < nranges; ++r)
+		blockstart[r] = r * (n / nranges);
+	blockstart[nranges] = n;
+	double target = static_cast<double>(totalnnz) / nranges;
+
+	// split points in nnz: range r holds the vertices whose preceding nonzeros fall in [split[r], split[r+1])
+	std::vector<double> split(nranges+1);
+	for(int r = 0; r <= nranges; ++r)
+		split[r] = r * target;
+
+	std::vector<IT> labels(locsize), bestlabels;
+	double bestmax = std::numeric_limits<double>::max();
+	for(int round = 0; round < NNZBALANCEROUNDS; ++round)
+	{
+		std::vector<int> range(locsize);
+		std::vector<IT> rangesize(nranges, 0);	// vertices per range
+		IT nnzbefore = firstnnz;
+		for(IT i = 0; i < locsize; ++i)
+		{
+			range[i] = static_cast<int>(std::upper_bound(split.begin()+1, split.end()-1, static_cast<double>(nnzbefore)) - (split.begin()+1));
+			nnzbefore += deg[i];
+			++rangesize[range[i]];
+		}
+		MPI_Allreduce(MPI_IN_PLACE, rangesize.data(), nranges, MPIType<IT>(), MPI_SUM, World);
+
+		// how many vertices of each range their block keeps
+		std::vector<IT> kept(nranges), keptbefore(nranges+1, 0), freebefore(nranges+1, 0), rangestart(nranges+1, 0);
+		for(int r = 0; r < nranges; ++r)
+		{
+			IT slots = blockstart[r+1] - blockstart[r];
+			kept[r] = std::min(rangesize[r], slots);
+			keptbefore[r+1] = keptbefore[r] + kept[r];
+			freebefore[r+1] = freebefore[r] + (slots - kept[r]);
+			rangestart[r+1] = rangestart[r] + rangesize[r];
+		}
+
+		// within each range, rank the vertices by decreasing nnz (ties by index) with a global sort
+		FullyDistVec<IT,IT> keys(commGrid, n, 0);
+		for(IT i = 0; i < locsize; ++i)
+			keys.SetLocalElement(i, static_cast<IT>(range[i]) * (maxdeg+1) + (maxdeg - deg[i]));
+		FullyDistVec<IT,IT> sortedfrom = keys.sort();	// keys are now sorted
+		IT sortedoffset = keys.LengthUntil();
+		std::vector<IT> keepidx;
+		const IT * sortedkeys = keys.GetLocArr();
+		const IT * from = sortedfrom.GetLocArr();
+		for(IT j = 0; j < keys.LocArrSize(); ++j)
+		{
+			int r = static_cast<int>(sortedkeys[j] / (maxdeg+1));
+			if(sortedoffset + j - rangestart[r] < kept[r])
+				keepidx.push_back(from[j]);
+		}
+		FullyDistVec<IT,IT> keep(commGrid, n, 0);
+		keep.SetElements(keepidx, std::vector<IT>(keepidx.size(), 1));
+
+		// new labels, in the original order: kept vertices fill their block from the start, the others the free slots
+		const IT * kp = keep.GetLocArr();
+		IT localkept = std::accumulate(kp, kp + locsize, static_cast<IT>(0));
+		IT keptsofar = 0;
+		MPI_Exscan(&localkept, &keptsofar, 1, MPIType<IT>(), MPI_SUM, World);
+		if(commGrid->GetRank() == 0) keptsofar = 0;
+		std::vector<double> blocknnz(nranges, 0.0);
+		for(IT i = 0; i < locsize; ++i)
+		{
+			int b = range[i];
+			if(kp[i])
+			{
+				labels[i] = blockstart[b] + (keptsofar - keptbefore[b]);
+				++keptsofar;
+			}
+			else
+			{
+				IT spill = offset + i - keptsofar;	// number of spilled vertices before this one
+				b = static_cast<int>(std::upper_bound(freebefore.begin(), freebefore.end(), spill) - freebefore.begin()) - 1;
+				labels[i] = blockstart[b] + kept[b] + (spill - freebefore[b]);
+			}
+			blocknnz[b] += deg[i];
+		}
+		MPI_Allreduce(MPI_IN_PLACE, blocknnz.data(), nranges, MPI_DOUBLE, MPI_SUM, World);
+
+		double maxnnz = *std::max_element(blocknnz.begin(), blocknnz.end());
+		if(maxnnz < bestmax)
+		{
+			bestmax = maxnnz;
+			bestlabels = labels;
+		}
+		if(maxnnz <= target * (1.0 + EPSILON)) break;
+
+		// a block that received too many nonzeros (mostly from spilled vertices) gets a shorter range next round
+		double excess = 0;
+		for(int r = 1; r < nranges; ++r)
+		{
+			excess += blocknnz[r-1] - target;
+			split[r] = std::min(std::max(split[r] - excess, split[r-1]), static_cast<double>(totalnnz));
+		}
+	}
+
+	FullyDistVec<IT,IT> newlabels(commGrid, n, 0);
+	for(IT i = 0; i < locsize; ++i)
+		newlabels.SetLocalElement(i, bestlabels[i]);
+	return newlabels.sort();
+}
+
 template <class IT, class NT, class DER>
 IT SpParMat< IT,NT,DER >::getnnz() const
 {
@@ -796,6 +943,69 @@ IT SpParMat< IT,NT,DER >::getncol() const
  	return totalcols;  
 }
 
+/**
+  * Gathers sum, sum of squares, maximum and count of every column in the same pass that replaces
+  * each nonzero v by __unary_op(v), also summing the new values; one allreduce along the processor column follows
+  * Used to fuse column bookkeeping such as MCL's normalize/chaos/inflate sequence, together with ColumnApply
+  * @return statistics of the local columns, identical on all processes of a processor column
+  */
+template <class IT, class NT, class DER>
+template <typename _UnaryOperation>
+std::vector< ColumnStats<NT> > SpParMat<IT,NT,DER>::ColumnStatsApply(_UnaryOperation __unary_op)
+{
+	typedef typename DER::LocalIT LIT;
+	LIT ncols = getlocalcols();
+	std::vector< ColumnStats<NT> > stats(ncols);
+	if(spSeq->getnnz() > 0)
+	{
+		auto dcsc = spSeq->GetDCSC();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+		for(LIT j=0; j < dcsc->nzc; ++j)	// columns are independent
+		{
+			ColumnStats<NT> & colstats = stats[dcsc->jc[j]];
+			for(LIT k = dcsc->cp[j]; k < dcsc->cp[j+1]; ++k)
+			{
+				NT before = dcsc->numx[k];
+				dcsc->numx[k] = __unary_op(before);
+				colstats.Add(before, dcsc->numx[k]);
+			}
+		}
+	}
+	MPI_Allreduce(MPI_IN_PLACE, stats.data(), static_cast<int>(ncols), MPIType< ColumnStats<NT> >(), ColumnStats<NT>::mpi_op(), commGrid->GetColWorld());
+	return stats;
+}
+
+/**
+  * Replaces each nonzero A(i,j) by __binary_op(A(i,j), colvals[j]), where j is the local column index
+  * Unlike DimApply, colvals is already replicated along the processor column (e.g. computed from ColumnStatsApply), so there is no communication
+  */
+template <class IT, class NT, class DER>
+template <typename _BinaryOperation>
+void SpParMat<IT,NT,DER>::ColumnApply(const std::vector<NT> & colvals, _BinaryOperation __binary_op)
+{
+	typedef typename DER::LocalIT LIT;
+	if(static_cast<LIT>(colvals.size()) != getlocalcols())
+	{
+		std::cout << "Column values do not match the local columns in SpParMat::ColumnApply" << std::endl;
+		MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+	}
+	if(spSeq->getnnz() > 0)
+	{
+		auto dcsc = spSeq->GetDCSC();
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64)
+#endif
+		for(LIT j=0; j < dcsc->nzc; ++j)
+		{
+			NT colval = colvals[dcsc->jc[j]];
+			for(LIT k = dcsc->cp[j]; k < dcsc->cp[j+1]; ++k)
+				dcsc->numx[k] = __binary_op(dcsc->numx[k], colval);
+		}
+	}
+}
+
 template <class IT, class NT, class DER>
 template <typename _BinaryOperation>	
 void SpParMat<IT,NT,DER>::DimApply(Dim dim, const FullyDistVec<IT, NT>& x, _BinaryOperation __binary_op)
@@ -2423,12 +2633,18 @@ SpParMat<IT, NT, DER>::SubsRef_SR (
 								   
 
 
+/**
+ * Assigns B to the submatrix A(ri,ci), i.e. A(ri[i],ci[j]) = B(i,j) for all i,j, removing the previous
+ * nonzeros of that region. Repeated indices in ri or ci add up the colliding entries of B.
+ * The nonzeros of B are mapped through ri and ci and sent to their owners with a single all-to-all,
+ * then merged into the (column sorted) local tuples; no permutation matrices or SpGEMMs are formed.
+ */
 template <class IT, class NT, class DER>
 void SpParMat<IT,NT,DER>::SpAsgn(const FullyDistVec<IT,IT> & ri, const FullyDistVec<IT,IT> & ci, SpParMat<IT,NT,DER> & B)
 {
-	typedef PlusTimesSRing<NT, NT> PTRing;
+	typedef typename DER::LocalIT LIT;
 	
-	if((*(ri.commGrid) != *(B.commGrid)) || (*(ci.commGrid) != *(B.commGrid)))
+	if((*(ri.commGrid) != *(B.commGrid)) || (*(ci.commGrid) != *(B.commGrid)) || (*(B.commGrid) != *commGrid))
 	{
 		SpParHelper::Print("Grids are not comparable, SpAsgn fails !", commGrid->GetWorld());
 		MPI_Abort(MPI_COMM_WORLD, GRIDMISMATCH);
@@ -2450,27 +2666,71 @@ void SpParMat<IT,NT,DER>::SpAsgn(const FullyDistVec<IT,IT> & ri, const FullyDist
 	}
 	Prune(ri, ci);	// make a hole	
 	
-	// embed B to the size of A
-	FullyDistVec<IT,IT> * rvec = new FullyDistVec<IT,IT>(ri.commGrid);
-	rvec->iota(total_m_B, 0);	// sparse() expects a zero based index
+	// targets of the local rows and columns of B
+	std::vector<IT> rowtarget = B.LocalIndexValues(ri, Row);
+	std::vector<IT> coltarget = B.LocalIndexValues(ci, Column);
 	
-	SpParMat<IT,NT,DER> R(total_m_A, total_m_B, ri, *rvec, 1);
-	delete rvec;	// free memory
-	SpParMat<IT,NT,DER> RB = Mult_AnXBn_DoubleBuff<PTRing, NT, DER>(R, B, true, false); // clear memory of R but not B
+	int nprocs = commGrid->GetSize();
+	std::vector< std::vector< std::tuple<LIT,LIT,NT> > > data(nprocs);
+	for(typename DER::SpColIter colit = B.spSeq->begcol(); colit != B.spSeq->endcol(); ++colit)
+	{
+		IT gcol = coltarget[colit.colid()];
+		for(typename DER::SpColIter::NzIter nzit = B.spSeq->begnz(colit); nzit != B.spSeq->endnz(colit); ++nzit)
+		{
+			LIT lrow, lcol;
+			int owner = Owner(total_m_A, total_n_A, rowtarget[nzit.rowid()], gcol, lrow, lcol);
+			data[owner].push_back(std::make_tuple(lrow, lcol, nzit.value()));
+		}
+	}
 	
-	FullyDistVec<IT,IT> * qvec = new FullyDistVec<IT,IT>(ri.commGrid);
-	qvec->iota(total_n_B, 0);
-	SpParMat<IT,NT,DER> Q(total_n_B, total_n_A, *qvec, ci, 1);
-	delete qvec;	// free memory
-	SpParMat<IT,NT,DER> RBQ = Mult_AnXBn_DoubleBuff<PTRing, NT, DER>(RB, Q, true, true); // clear memory of RB and Q
-	*this += RBQ;	// extend-add
+	std::vector<int> sendcnt(nprocs), recvcnt(nprocs), sdispls(nprocs+1, 0), rdispls(nprocs+1, 0);
+	for(int i=0; i<nprocs; ++i)
+		sendcnt[i] = static_cast<int>(data[i].size());
+	MPI_Alltoall(sendcnt.data(), 1, MPI_INT, recvcnt.data(), 1, MPI_INT, commGrid->GetWorld());
+	std::partial_sum(sendcnt.begin(), sendcnt.end(), sdispls.begin()+1);
+	std::partial_sum(recvcnt.begin(), recvcnt.end(), rdispls.begin()+1);
+	
+	std::vector< std::tuple<LIT,LIT,NT> > senddata(sdispls[nprocs]);
+	for(int i=0; i<nprocs; ++i)
+	{
+		std::copy(data[i].begin(), data[i].end(), senddata.begin() + sdispls[i]);
+		std::vector< std::tuple<LIT,LIT,NT> >().swap(data[i]);
+	}
+	MPI_Datatype MPI_triple;
+	MPI_Type_contiguous(sizeof(std::tuple<LIT,LIT,NT>), MPI_CHAR, &MPI_triple);
+	MPI_Type_commit(&MPI_triple);
+	IT totrecv = rdispls[nprocs];
+	std::tuple<LIT,LIT,NT> * recvdata = new std::tuple<LIT,LIT,NT>[totrecv];
+	MPI_Alltoallv(senddata.data(), sendcnt.data(), sdispls.data(), MPI_triple, recvdata, recvcnt.data(), rdispls.data(), MPI_triple, commGrid->GetWorld());
+	MPI_Type_free(&MPI_triple);
+	std::vector< std::tuple<LIT,LIT,NT> >().swap(senddata);
+	
+	if(totrecv == 0)
+	{
+		delete [] recvdata;
+		return;
+	}
+	LIT locrows = spSeq->getnrow();
+	LIT loccols = spSeq->getncol();
+	SpTuples<LIT,NT> inserts(totrecv, locrows, loccols, recvdata);	// sorts column-first, ~SpTuples deallocates
+	inserts.RemoveDuplicates(std::plus<NT>());
+	
+	// the hole guarantees that no existing nonzero shares a position with an insertion
+	SpTuples<LIT,NT> current(*spSeq);
+	int64_t mergednnz = current.getnnz() + inserts.getnnz();
+	std::tuple<LIT,LIT,NT> * merged = new std::tuple<LIT,LIT,NT>[mergednnz];
+	std::merge(current.tuples, current.tuples + current.getnnz(), inserts.tuples, inserts.tuples + inserts.getnnz(), merged, ColLexiCompare<LIT,NT>());
+	delete spSeq;
+	spSeq = new DER(SpTuples<LIT,NT>(mergednnz, locrows, loccols, merged, true), false);
 }
 
+/**
+ * Removes the nonzeros A(i,j) with i in ri and j in ci.
+ * Only the indices are communicated (to the processes owning the rows and columns); the nonzeros stay local.
+ */
 template <class IT, class NT, class DER>
 void SpParMat<IT,NT,DER>::Prune(const FullyDistVec<IT,IT> & ri, const FullyDistVec<IT,IT> & ci)
 {
-	typedef PlusTimesSRing<NT, NT> PTRing;
-
 	if((*(ri.commGrid) != *(commGrid)) || (*(ci.commGrid) != *(commGrid)))
 	{
 		SpParHelper::Print("Grids are not comparable, Prune fails!\n", commGrid->GetWorld());
@@ -2487,17 +2747,105 @@ void SpParMat<IT,NT,DER>::Prune(const FullyDistVec<IT,IT> & ri, const FullyDistV
 
 	IT total_m = getnrow();
 	IT total_n = getncol();
-	if(locmax_ri > total_m || locmax_ci > total_n)	
+	if(locmax_ri >= total_m || locmax_ci >= total_n)	
 	{
 		throw outofrangeexception();
 	}
 
-	SpParMat<IT,NT,DER> S(total_m, total_m, ri, ri, 1);
-	SpParMat<IT,NT,DER> SA = Mult_AnXBn_DoubleBuff<PTRing, NT, DER>(S, *this, true, false); // clear memory of S but not *this
+	std::vector<bool> rowmask = LocalIndexMask(ri, Row);
+	std::vector<bool> colmask = LocalIndexMask(ci, Column);
+	IT roffset = 0, coffset = 0;
+	GetPlaceInGlobalGrid(roffset, coffset);	// collective
+	if(std::find(rowmask.begin(), rowmask.end(), true) == rowmask.end() || std::find(colmask.begin(), colmask.end(), true) == colmask.end())
+		return;	// the region misses the local block
 
-	SpParMat<IT,NT,DER> T(total_n, total_n, ci, ci, 1);
-	SpParMat<IT,NT,DER> SAT = Mult_AnXBn_DoubleBuff<PTRing, NT, DER>(SA, T, true, true); // clear memory of SA and T
-	EWiseMult(SAT, true);	// In-place EWiseMult with not(SAT)
+	spSeq->PruneI([&rowmask, &colmask, roffset, coffset](const std::tuple<IT,IT,NT> & t)
+	{
+		return rowmask[std::get<0>(t) - roffset] && colmask[std::get<1>(t) - coffset];
+	}, true, roffset, coffset);
+}
+
+/**
+ * Each process sends the indices it holds to the processor row (column) owning them, whose members then
+ * share what they received; the result marks the local rows (columns) whose global indices appear in ind.
+ * Collective on the grid; ind can have any length.
+ */
+template <class IT, class NT, class DER>
+std::vector<bool> SpParMat<IT,NT,DER>::LocalIndexMask(const FullyDistVec<IT,IT> & ind, Dim dim) const
+{
+	typedef typename DER::LocalIT LIT;
+
+	MPI_Comm SendWorld = (dim == Row) ? commGrid->GetColWorld() : commGrid->GetRowWorld();	// reaches every owner of this dimension
+	MPI_Comm ShareWorld = (dim == Row) ? commGrid->GetRowWorld() : commGrid->GetColWorld();	// members of the same owner
+	int nowners = (dim == Row) ? commGrid->GetGridRows() : commGrid->GetGridCols();
+	IT total = (dim == Row) ? getnrow() : getncol();
+	IT perproc = total / nowners;
+	LIT loclen = (dim == Row) ? spSeq->getnrow() : spSeq->getncol();
+
+	std::vector< std::vector<LIT> > data(nowners);
+	for(auto it = ind.arr.begin(); it != ind.arr.end(); ++it)
+	{
+		int owner = (perproc != 0) ? std::min(static_cast<int>(*it / perproc), nowners-1) : nowners-1;
+		data[owner].push_back(static_cast<LIT>(*it - owner * perproc));
+	}
+	std::vector<int> sendcnt(nowners), recvcnt(nowners), sdispls(nowners+1, 0), rdispls(nowners+1, 0);
+	for(int i=0; i<nowners; ++i)
+		sendcnt[i] = static_cast<int>(data[i].size());
+	MPI_Alltoall(sendcnt.data(), 1, MPI_INT, recvcnt.data(), 1, MPI_INT, SendWorld);
+	std::partial_sum(sendcnt.begin(), sendcnt.end(), sdispls.begin()+1);
+	std::partial_sum(recvcnt.begin(), recvcnt.end(), rdispls.begin()+1);
+	std::vector<LIT> senddata(sdispls[nowners]);
+	for(int i=0; i<nowners; ++i)
+		std::copy(data[i].begin(), data[i].end(), senddata.begin() + sdispls[i]);
+	std::vector<LIT> recvdata(rdispls[nowners]);
+	MPI_Alltoallv(senddata.data(), sendcnt.data(), sdispls.data(), MPIType<LIT>(), recvdata.data(), recvcnt.data(), rdispls.data(), MPIType<LIT>(), SendWorld);
+
+	int nsharers;
+	MPI_Comm_size(ShareWorld, &nsharers);
+	int mycount = static_cast<int>(recvdata.size());
+	std::vector<int> counts(nsharers), dpls(nsharers+1, 0);
+	MPI_Allgather(&mycount, 1, MPI_INT, counts.data(), 1, MPI_INT, ShareWorld);
+	std::partial_sum(counts.begin(), counts.end(), dpls.begin()+1);
+	std::vector<LIT> allinds(dpls[nsharers]);
+	MPI_Allgatherv(recvdata.data(), mycount, MPIType<LIT>(), allinds.data(), counts.data(), dpls.data(), MPIType<LIT>(), ShareWorld);
+
+	std::vector<bool> mask(loclen, false);
+	for(auto it = allinds.begin(); it != allinds.end(); ++it)
+		mask[*it] = true;
+	return mask;
+}
+
+/**
+ * Replicates the entries of ind (whose length matches the dimension) along the processor rows (or columns)
+ * so that entry i of the result belongs to local row (column) i, the same alignment DimApply uses
+ */
+template <class IT, class NT, class DER>
+std::vector<IT> SpParMat<IT,NT,DER>::LocalIndexValues(const FullyDistVec<IT,IT> & ind, Dim dim) const
+{
+	MPI_Comm World = commGrid->GetWorld();
+	int xsize = static_cast<int>(ind.LocArrSize());
+	std::vector<IT> mine(ind.arr.begin(), ind.arr.end());
+	MPI_Comm GatherWorld = commGrid->GetRowWorld();
+	if(dim == Column)	// the transpose neighbor holds the piece of ind that lines up with our processor column
+	{
+		int trxsize = 0;
+		int diagneigh = commGrid->GetComplementRank();
+		MPI_Status status;
+		MPI_Sendrecv(&xsize, 1, MPI_INT, diagneigh, TRX, &trxsize, 1, MPI_INT, diagneigh, TRX, World, &status);
+		std::vector<IT> trx(trxsize);
+		MPI_Sendrecv(mine.data(), xsize, MPIType<IT>(), diagneigh, TRX, trx.data(), trxsize, MPIType<IT>(), diagneigh, TRX, World, &status);
+		mine.swap(trx);
+		xsize = trxsize;
+		GatherWorld = commGrid->GetColWorld();
+	}
+	int neighs;
+	MPI_Comm_size(GatherWorld, &neighs);
+	std::vector<int> sizes(neighs), dpls(neighs+1, 0);
+	MPI_Allgather(&xsize, 1, MPI_INT, sizes.data(), 1, MPI_INT, GatherWorld);
+	std::partial_sum(sizes.begin(), sizes.end(), dpls.begin()+1);
+	std::vector<IT> values(dpls[neighs]);
+	MPI_Allgatherv(mine.data(), xsize, MPIType<IT>(), values.data(), sizes.data(), dpls.data(), MPIType<IT>(), GatherWorld);
+	return values;
 }
 
 //! Prune every column of a sparse matrix based on pvals
@@ -2819,12 +3167,22 @@ void SpParMat< IT,NT,DER >::SparseCommon(std::vector< std::vector < std::tuple<L
 	if(myproccol != s-1)	loccols = n_perproc;
 	else	loccols = total_n - myproccol * n_perproc;
     
-	SpTuples<LIT,NT> A(totrecv, locrows, loccols, recvdata);	// It is ~SpTuples's job to deallocate
-	
-    	// the previous constructor sorts based on columns-first (but that doesn't matter as long as they are sorted one way or another)
-    	A.RemoveDuplicates(BinOp);
-	
-  	spSeq = new DER(A,false);        // Convert SpTuples to DER
+	// structure of arrays, so that a SpDCCols can take the sorted rows and values over without a copy
+	SpTuplesSoA<LIT,NT> A(totrecv, locrows, loccols);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(IT i=0; i< totrecv; ++i)
+	{
+		A.rows[i] = std::get<0>(recvdata[i]);
+		A.cols[i] = std::get<1>(recvdata[i]);
+		A.vals[i] = std::get<2>(recvdata[i]);
+	}
+	delete [] recvdata;
+
+	A.SortColBased();
+	A.RemoveDuplicates(BinOp);
+	spSeq = SoAToLocal<DER>::Convert(A);
 }
 
 
@@ -3444,6 +3802,49 @@ void SpParMat<IT,NT,DER>::Transpose()
 	}	
 }		
 
+/**
+  * Replaces A by the union of A and its transpose, combining the entries present in both with __binary_op(A(i,j), A(j,i))
+  * Unlike A += A' on a transposed copy, no second matrix is formed: the local block is transposed into tuples,
+  * exchanged with the diagonal neighbor in a single message and merged into the local matrix in place.
+  * Diagonal entries are combined with themselves, as with A += A', unless combineloops is false,
+  * in which case they are left unchanged, as with A += A' after removing the loops of A'
+  */
+template <class IT, class NT, class DER>
+template <typename _BinaryOperation>
+void SpParMat<IT,NT,DER>::Symmetrize(_BinaryOperation __binary_op, bool combineloops)
+{
+	if(getnrow() != getncol())
+	{
+		SpParHelper::Print("Symmetrize requires a square matrix\n");
+		MPI_Abort(MPI_COMM_WORLD, NOTSQUARE);
+	}
+	typedef typename DER::LocalIT LIT;
+	typedef std::tuple<LIT,LIT,NT> LocalTuple;
+	std::vector<LocalTuple> transposed;
+	spSeq->TransposedTuples(transposed);
+
+	if(commGrid->myproccol == commGrid->myprocrow)	// Diagonal
+	{
+		if(!combineloops)	// only diagonal blocks hold loops, at equal local row and column indices
+			transposed.erase(std::remove_if(transposed.begin(), transposed.end(), [](const LocalTuple & t){ return std::get<0>(t) == std::get<1>(t); }), transposed.end());
+		spSeq->MergeSortedTuples(transposed.data(), static_cast<LIT>(transposed.size()), __binary_op);
+	}
+	else
+	{
+		int diagneigh = commGrid->GetComplementRank();
+		LIT locnnz = static_cast<LIT>(transposed.size());
+		LIT remotennz;
+		MPI_Status status;
+		MPI_Sendrecv(&locnnz, 1, MPIType<LIT>(), diagneigh, SYMTAGNZ, &remotennz, 1, MPIType<LIT>(), diagneigh, SYMTAGNZ, commGrid->GetWorld(), &status);
+
+		std::vector<LocalTuple> received(remotennz);
+		MPI_Sendrecv(transposed.data(), locnnz, MPIType<LocalTuple>(), diagneigh, SYMTAGTUPLES, received.data(), remotennz, MPIType<LocalTuple>(), diagneigh, SYMTAGTUPLES, commGrid->GetWorld(), &status);
+		std::vector<LocalTuple>().swap(transposed);
+
+		spSeq->MergeSortedTuples(received.data(), remotennz, __binary_op);	// sent sorted by the neighbor's rows, which are our columns
+	}
+}
+
 
 template <class IT, class NT, class DER>
 template <class HANDLER>
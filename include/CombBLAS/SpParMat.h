@@ -39,6 +39,7 @@
 
 #include "SpMat.h"
 #include "SpTuples.h"
+#include "SpTuplesSoA.h"
 #include "SpDCCols.h"
 #include "CommGrid.h"
 #include "MPIType.h"
@@ -52,6 +53,7 @@
 #include "Friends.h"
 #include "Operations.h"
 #include "DistEdgeList.h"
+#include "ColumnStats.h"
 #include "CombBLAS.h"
 
 namespace combblas {
@@ -97,7 +99,11 @@ public:
 	void Square (); 
 
 	float LoadImbalance() const;
+	FullyDistVec<IT,IT> NnzBalancedPermutation() const;	//!< locality-preserving alternative to a random symmetric permutation
 	void Transpose();
+	template <typename _BinaryOperation>
+	void Symmetrize(_BinaryOperation __binary_op, bool combineloops = true);	//!< A = A + A^T in place, __binary_op combines entries present in both
+	void Symmetrize() { Symmetrize(std::plus<NT>()); }
 	void FreeMemory();
 	void EWiseMult (const SpParMat< IT,NT,DER >  & rhs, bool exclude);
 	void EWiseScale (const DenseParMat<IT,NT> & rhs);
@@ -107,6 +113,12 @@ public:
 	template <typename _BinaryOperation>
 	void DimApply(Dim dim, const FullyDistVec<IT, NT>& v, _BinaryOperation __binary_op);
 
+	template <typename _UnaryOperation>
+	std::vector< ColumnStats<NT> > ColumnStatsApply(_UnaryOperation __unary_op);	//!< Statistics of the local columns, gathered while applying __unary_op
+
+	template <typename _BinaryOperation>
+	void ColumnApply(const std::vector<NT> & colvals, _BinaryOperation __binary_op);	//!< DimApply(Column,...) with values of the local columns
+
 	template <typename _BinaryOperation, typename _UnaryOperation >	
 	FullyDistVec<IT,NT> Reduce(Dim dim, _BinaryOperation __binary_op, NT id, _UnaryOperation __unary_op) const;
 
@@ -297,7 +309,7 @@ public:
 	typename DER::LocalIT getlocalcols() const { return spSeq->getncol();} 
 	typename DER::LocalIT getlocalnnz() const { return spSeq->getnnz(); }
 	DER & seq() { return (*spSeq); }
-	DER * seqptr() { return spSeq; }
+	DER * seqptr() const { return spSeq; }
     
     template <typename _BinaryOperation, typename LIT>
     void SparseCommon(std::vector< std::vector < std::tuple<LIT,LIT,NT> > > & data, LIT locsize, IT total_m, IT total_n, _BinaryOperation BinOp);
@@ -420,6 +432,8 @@ private:
                     IT coffset, const FullyDistVec<GIT,VT> & rvec) const;
     
     void GetPlaceInGlobalGrid(IT& rowOffset, IT& colOffset) const;
+    std::vector<bool> LocalIndexMask(const FullyDistVec<IT,IT> & ind, Dim dim) const;	//!< marks the local rows (or columns) whose global indices appear in ind
+    std::vector<IT> LocalIndexValues(const FullyDistVec<IT,IT> & ind, Dim dim) const;	//!< entries of ind for the local rows (or columns), as DimApply aligns them
 	
 	void HorizontalSend(IT * & rows, IT * & cols, NT * & vals, IT * & temprows, IT * & tempcols, NT * & tempvals, std::vector < std::tuple <IT,IT,NT> > & localtuples,
 						int * rcurptrs, int * rdispls, IT buffperrowneigh, int rowneighs, int recvcount, IT m_perproc, IT n_perproc, int rankinrow);
@@ -440,6 +454,9 @@ private:
 	template <class IU, class NU>
 	friend class DenseParMat;
 
+	template <class IU, class NU, class UDER>
+	friend class DynamicSpParMat;
+
 	template <typename IU, typename NU, typename UDER> 	
 	friend std::ofstream& operator<< (std::ofstream& outfile, const SpParMat<IU,NU,UDER> & s);	
 };
@@ -47,6 +47,10 @@ extern "C" {
 
 namespace combblas
 {
+    // defined below, used by the constructors
+    template <class IT, class NT>
+    std::tuple<IT,IT,NT>* ExchangeData(std::vector<std::vector<std::tuple<IT,IT,NT>>> & tempTuples, MPI_Comm World, IT& datasize);
+
     template <class IT, class NT, class DER>
     SpParMat3D<IT, NT, DER>::~SpParMat3D(){
         // No need to delete layermat because it is a smart pointer
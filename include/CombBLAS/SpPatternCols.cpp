@@ -0,0 +1,145 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+#include "SpPatternCols.h"
+
+namespace combblas {
+
+template <class IT>
+const IT SpPatternCols<IT>::esscount = static_cast<IT>(4);
+
+template <class IT>
+template <typename NT>
+SpPatternCols<IT>::SpPatternCols(const SpDCCols<IT,NT> & rhs): m(rhs.getnrow()), n(rhs.getncol()), nnz(rhs.getnnz()), dcsc(NULL)
+{
+	assert(rhs.getnsplit() == 0);
+	if(nnz > 0)
+	{
+		const Dcsc<IT,NT> * src = rhs.GetDCSC();
+		CopyIndices(src->cp, src->jc, src->ir, src->nz, src->nzc);
+	}
+}
+
+template <class IT>
+SpPatternCols<IT>::SpPatternCols(const SpPatternCols<IT> & rhs): m(rhs.m), n(rhs.n), nnz(rhs.nnz), dcsc(NULL)
+{
+	if(nnz > 0)
+		CopyIndices(rhs.dcsc->cp, rhs.dcsc->jc, rhs.dcsc->ir, rhs.dcsc->nz, rhs.dcsc->nzc);
+}
+
+template <class IT>
+SpPatternCols<IT> & SpPatternCols<IT>::operator=(const SpPatternCols<IT> & rhs)
+{
+	if(this != &rhs)
+	{
+		delete dcsc;
+		dcsc = NULL;
+		m = rhs.m;
+		n = rhs.n;
+		nnz = rhs.nnz;
+		if(nnz > 0)
+			CopyIndices(rhs.dcsc->cp, rhs.dcsc->jc, rhs.dcsc->ir, rhs.dcsc->nz, rhs.dcsc->nzc);
+	}
+	return *this;
+}
+
+template <class IT>
+SpPatternCols<IT>::~SpPatternCols()
+{
+	delete dcsc;	// deleting the NULL numx is a no-op
+}
+
+template <class IT>
+void SpPatternCols<IT>::CopyIndices(const IT * cp, const IT * jc, const IT * ir, IT nz, IT nzc)
+{
+	IT * mycp = new IT[nzc+1];
+	IT * myjc = new IT[nzc];
+	IT * myir = new IT[nz];
+	std::copy(cp, cp+nzc+1, mycp);
+	std::copy(jc, jc+nzc, myjc);
+	std::copy(ir, ir+nz, myir);
+	dcsc = new Dcsc<IT,bool>(mycp, myjc, myir, NULL, nz, nzc, true);
+}
+
+template <class IT>
+void SpPatternCols<IT>::CreateImpl(const std::vector<IT> & essentials)
+{
+	assert(essentials.size() == esscount);
+	delete dcsc;
+	dcsc = NULL;
+	nnz = essentials[0];
+	m = essentials[1];
+	n = essentials[2];
+	if(nnz > 0)
+	{
+		IT nzc = essentials[3];
+		dcsc = new Dcsc<IT,bool>(new IT[nzc+1], new IT[nzc], new IT[nnz], NULL, nnz, nzc, true);
+	}
+}
+
+//! Index arrays only, there are no numerical arrays to send
+template <class IT>
+Arr<IT,bool> SpPatternCols<IT>::GetArrays() const
+{
+	Arr<IT,bool> arr(3,0);
+	if(nnz > 0)
+	{
+		arr.indarrs[0] = LocArr<IT,IT>(dcsc->cp, dcsc->nzc+1);
+		arr.indarrs[1] = LocArr<IT,IT>(dcsc->jc, dcsc->nzc);
+		arr.indarrs[2] = LocArr<IT,IT>(dcsc->ir, dcsc->nz);
+	}
+	else
+	{
+		arr.indarrs[0] = LocArr<IT,IT>(NULL, 0);
+		arr.indarrs[1] = LocArr<IT,IT>(NULL, 0);
+		arr.indarrs[2] = LocArr<IT,IT>(NULL, 0);
+	}
+	return arr;
+}
+
+template <class IT>
+std::vector<IT> SpPatternCols<IT>::GetEssentials() const
+{
+	std::vector<IT> essentials(esscount);
+	essentials[0] = nnz;
+	essentials[1] = m;
+	essentials[2] = n;
+	essentials[3] = (nnz > 0) ? dcsc->nzc : 0;
+	return essentials;
+}
+
+template <class IT>
+void SpPatternCols<IT>::PrintInfo() const
+{
+	std::cout << "m: " << m ;
+	std::cout << ", n: " << n ;
+	std::cout << ", nnz: "<< nnz ;
+	std::cout << ", bytes: " << GetBytes() << " (pattern only)" << std::endl;
+}
+
+}
@@ -0,0 +1,136 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _SP_PATTERN_COLS_H_
+#define _SP_PATTERN_COLS_H_
+
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include "SpMat.h"	// Best to include the base class first
+#include "SpHelper.h"
+#include "SpDCCols.h"
+#include "dcsc.h"
+#include "LocArr.h"
+#include "SemiringTraits.h"
+
+namespace combblas {
+
+/**
+ * Local matrix that keeps only the nonzero structure of a boolean graph: a Dcsc whose numx is NULL
+ * Every stored nonzero reads as true, so it is usable with all semirings written for boolean matrices,
+ * and multiplying it with a valued matrix takes an implicit 1 for each of its nonzeros.
+ * Broadcasts ship the three index arrays only. Supported operations are SpMV with dense and sparse
+ * vectors and Mult_AnXBn_Synch; build the matrix as SpDCCols, then convert, e.g.
+ *	SpParMat<int64_t,bool,SpPatternCols<int64_t>> G = A;	// A is SpParMat<int64_t,NT,SpDCCols<int64_t,NT>>, values are dropped
+ * Pattern matrices are never split for multithreading.
+ */
+template <class IT>
+class SpPatternCols: public SpMat<IT, bool, SpPatternCols<IT> >
+{
+public:
+	typedef IT LocalIT;
+	typedef bool LocalNT;
+
+	// Constructors :
+	SpPatternCols (): m(0), n(0), nnz(0), dcsc(NULL) {}
+	template <typename NT>
+	SpPatternCols (const SpDCCols<IT,NT> & rhs);	//!< keeps the nonzero structure of rhs
+	SpPatternCols (const SpPatternCols<IT> & rhs);
+	SpPatternCols<IT> & operator=(const SpPatternCols<IT> & rhs);
+	~SpPatternCols();
+
+	IT getnrow() const { return m; }
+	IT getncol() const { return n; }
+	IT getnnz() const { return nnz; }
+	IT getnzc() const { return (nnz > 0) ? dcsc->nzc : 0; }
+	int getnsplit() const { return 0; }
+	const std::vector<IT> & GetSplitOffsets() const { static const std::vector<IT> none; return none; }	// never split
+	bool isZero() const { return (nnz == 0); }
+
+	Dcsc<IT, bool> * GetDCSC() const { return dcsc; }	//!< numx is NULL
+	auto GetInternal() const { return GetDCSC(); }
+	auto GetInternal(int i) const { return GetDCSC(); }	// there is a single piece
+
+	//! Builds the O(1) column lookup index of the dcsc, empty if there is none
+	DcscColIndex<IT> ColumnIndex() const
+	{
+		return (dcsc == NULL) ? DcscColIndex<IT>() : DcscColIndex<IT>(dcsc->jc, dcsc->nzc, n);
+	}
+
+	void CreateImpl(const std::vector<IT> & essentials);
+	Arr<IT,bool> GetArrays() const;
+	std::vector<IT> GetEssentials() const;
+	const static IT esscount;
+
+	size_t GetBytes() const { return (nnz > 0) ? (static_cast<size_t>(2 * dcsc->nzc + 1) + dcsc->nz) * sizeof(IT) : 0; }
+	void PrintInfo() const;
+
+private:
+	void CopyIndices(const IT * cp, const IT * jc, const IT * ir, IT nz, IT nzc);
+
+	IT m;
+	IT n;
+	IT nnz;
+	Dcsc<IT, bool> * dcsc;
+};
+
+
+//! True for local matrix types that store no values
+template <class DER>
+struct IsPatternMatrix: std::false_type {};
+
+template <class IT>
+struct IsPatternMatrix< SpPatternCols<IT> >: std::true_type {};
+
+template <class NT, class IT>
+inline NT StoredValue(const NT * numx, IT pos, std::true_type) { return NT(true); }
+
+template <class NT, class IT>
+inline NT StoredValue(const NT * numx, IT pos, std::false_type) { return numx[pos]; }
+
+//! Value of the pos-th nonzero of a local matrix of type DER, true if DER stores no values
+template <class DER, class NT, class IT>
+inline NT StoredValue(const NT * numx, IT pos)
+{
+	return StoredValue(numx, pos, IsPatternMatrix<DER>());
+}
+
+//! Left operand of SR::multiply read from a local matrix of type DER, see MatrixOperand
+template <class SR, class DER, class NT, class IT>
+inline NT StoredOperand(const NT * numx, IT pos)
+{
+	return SemiringTraits<SR>::pattern_only ? NT() : StoredValue<DER>(numx, pos);
+}
+
+}
+
+#include "SpPatternCols.cpp"
+
+#endif
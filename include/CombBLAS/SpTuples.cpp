@@ -69,6 +69,7 @@ SpTuples<IT,NT>::SpTuples (int64_t size, IT nRow, IT nCol, std::tuple<IT, IT, NT
 template <class IT, class NT>
 SpTuples<IT,NT>::SpTuples (int64_t maxnnz, IT nRow, IT nCol, std::vector<IT> & edges, bool removeloops):m(nRow), n(nCol)
 {
+	tuples = NULL;	// processes without local edges (e.g. unscrambled R-MAT) still reach the delete below
 	if(maxnnz > 0)
 	{
 		tuples  = new std::tuple<IT, IT, NT>[maxnnz];
@@ -230,6 +231,47 @@ inline void SpTuples<IT,NT>::FillTuples (Dcsc<IT,NT> * mydcsc)
 }
 
 
+/**
+ * Sorts the tuples with a multithreaded LSD radix sort on the packed (col,row) or (row,col) key.
+ * Only the keys and a permutation go through the sorting passes; the tuples are moved once at the end.
+ * @return false (and leaves the tuples untouched) if the array is too short or the key does not fit into 64 bits
+ **/
+template <class IT,class NT>
+bool SpTuples<IT,NT>::RadixSort (bool colmajor)
+{
+	if(nnz < RADIXSORTTHRESHOLD || m <= 0 || n <= 0) return false;
+	uint64_t major = static_cast<uint64_t>(colmajor ? n : m);
+	uint64_t minor = static_cast<uint64_t>(colmajor ? m : n);
+	if(major > std::numeric_limits<uint64_t>::max() / minor) return false;
+
+	uint64_t * keys = new uint64_t[nnz];
+	int64_t * perm = new int64_t[nnz];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(int64_t i=0; i< nnz; ++i)
+	{
+		uint64_t r = static_cast<uint64_t>(joker::get<0>(tuples[i]));
+		uint64_t c = static_cast<uint64_t>(joker::get<1>(tuples[i]));
+		keys[i] = colmajor ? (c * minor + r) : (r * minor + c);
+		perm[i] = i;
+	}
+	intSort::parallelKeySort(keys, perm, nnz, major * minor - 1);
+	delete [] keys;
+
+	std::tuple<IT, IT, NT> * sorted = new std::tuple<IT, IT, NT>[nnz];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(int64_t i=0; i< nnz; ++i)
+		sorted[i] = tuples[perm[i]];
+	std::copy(sorted, sorted+nnz, tuples);	// callers may own (and keep using) the tuples array, so sort in place
+	delete [] sorted;
+	delete [] perm;
+	return true;
+}
+
+
 // Hint1: The assignment operator (operates on an existing object)
 // Hint2: The assignment operator is the only operator that is not inherited.
 //		  Make sure that base class data are also updated during assignment
@@ -39,6 +39,7 @@
 #include "SpDefs.h"
 #include "StackEntry.h"
 #include "Compare.h"
+#include "PBBS/radixSort.h"
 
 namespace combblas {
 
@@ -93,7 +94,10 @@ public:
 	{
 		RowLexiCompare<IT,NT> rowlexicogcmp;
 		if(!SpHelper::is_sorted(tuples, tuples+nnz, rowlexicogcmp))
-			sort(tuples , tuples+nnz, rowlexicogcmp);	
+		{
+			if(!RadixSort(false))
+				sort(tuples , tuples+nnz, rowlexicogcmp);	
+		}
 
 		// Default "operator<" for tuples uses lexicographical ordering 
 		// However, cray compiler complains about it, so we use rowlexicogcmp
@@ -103,7 +107,10 @@ public:
 	{
 		ColLexiCompare<IT,NT> collexicogcmp;
 		if(!SpHelper::is_sorted(tuples, tuples+nnz, collexicogcmp))
-			sort(tuples , tuples+nnz, collexicogcmp );
+		{
+			if(!RadixSort(true))
+				sort(tuples , tuples+nnz, collexicogcmp );
+		}
 	}
 
 	/**
@@ -202,6 +209,7 @@ public:
 	 **/
 	IT RemoveLoops()
 	{
+		if(nnz == 0) return 0;	// tuples is not allocated
 		IT loop = 0;
 		for(IT i=0; i< nnz; ++i)
 		{
@@ -288,6 +296,7 @@ private:
 	SpTuples (){};		// Default constructor does nothing, hide it
 	
 	void FillTuples (Dcsc<IT,NT> * mydcsc);
+	bool RadixSort (bool colmajor);
 
 	template <class IU, class NU>
 	friend class SpDCCols;
@@ -0,0 +1,152 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include "SpTuplesSoA.h"
+
+namespace combblas {
+
+template <class IT,class NT>
+SpTuplesSoA<IT,NT>::SpTuplesSoA(int64_t size, IT nRow, IT nCol)
+:m(nRow), n(nCol), nnz(size)
+{
+	rows = (nnz > 0) ? new IT[nnz] : NULL;
+	cols = (nnz > 0) ? new IT[nnz] : NULL;
+	vals = (nnz > 0) ? new NT[nnz] : NULL;
+}
+
+template <class IT,class NT>
+SpTuplesSoA<IT,NT>::SpTuplesSoA(const SpTuples<IT,NT> & rhs)
+:SpTuplesSoA(rhs.getnnz(), rhs.getnrow(), rhs.getncol())
+{
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(int64_t i=0; i< nnz; ++i)
+	{
+		rows[i] = rhs.rowindex(i);
+		cols[i] = rhs.colindex(i);
+		vals[i] = rhs.numvalue(i);
+	}
+}
+
+template <class IT,class NT>
+SpTuplesSoA<IT,NT>::~SpTuplesSoA()
+{
+	delete [] rows;		// all of them might have been handed over to a Dcsc (then they are NULL)
+	delete [] cols;
+	delete [] vals;
+}
+
+/**
+ * Multithreaded LSD radix sort keyed on packed (col,row) if colmajor, (row,col) otherwise
+ * Falls back to a comparison sort of the permutation for fewer than RADIXSORTTHRESHOLD tuples
+ * or when the packed key does not fit into 64 bits
+ * Peak extra memory is the permutation plus one array (keys during the radix sort)
+ **/
+template <class IT,class NT>
+void SpTuplesSoA<IT,NT>::Sort(bool colmajor)
+{
+	if(nnz < 2) return;
+	IT * major = colmajor ? cols : rows;
+	IT * minor = colmajor ? rows : cols;
+	uint64_t majordim = static_cast<uint64_t>(colmajor ? n : m);
+	uint64_t minordim = static_cast<uint64_t>(colmajor ? m : n);
+
+	bool sorted = true;
+	for(int64_t i=1; i< nnz && sorted; ++i)
+		sorted = (major[i-1] < major[i]) || (major[i-1] == major[i] && minor[i-1] <= minor[i]);
+	if(sorted) return;
+
+	int64_t * perm = new int64_t[nnz];
+	if(nnz >= RADIXSORTTHRESHOLD && majordim > 0 && minordim > 0 && majordim <= std::numeric_limits<uint64_t>::max() / minordim)
+	{
+		uint64_t * keys = new uint64_t[nnz];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+		for(int64_t i=0; i< nnz; ++i)
+		{
+			keys[i] = static_cast<uint64_t>(major[i]) * minordim + static_cast<uint64_t>(minor[i]);
+			perm[i] = i;
+		}
+		intSort::parallelKeySort(keys, perm, nnz, majordim * minordim - 1);
+		delete [] keys;
+	}
+	else
+	{
+		for(int64_t i=0; i< nnz; ++i) perm[i] = i;
+		std::stable_sort(perm, perm+nnz, [major, minor](int64_t a, int64_t b)
+			{ return (major[a] < major[b]) || (major[a] == major[b] && minor[a] < minor[b]); });
+	}
+
+	// apply the permutation one array at a time
+	Permute(rows, perm);
+	Permute(cols, perm);
+	Permute(vals, perm);
+	delete [] perm;
+}
+
+template <class IT,class NT>
+template <typename T>
+void SpTuplesSoA<IT,NT>::Permute(T * & arr, const int64_t * perm)
+{
+	T * narr = new T[nnz];
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for(int64_t i=0; i< nnz; ++i)
+		narr[i] = arr[perm[i]];
+	delete [] arr;
+	arr = narr;
+}
+
+template <class IT,class NT>
+template <typename BINFUNC>
+void SpTuplesSoA<IT,NT>::RemoveDuplicates(BINFUNC BinOp)
+{
+	if(nnz < 2) return;
+	int64_t cnz = 0;
+	for(int64_t i=1; i< nnz; ++i)
+	{
+		if(rows[i] == rows[cnz] && cols[i] == cols[cnz])
+		{
+			vals[cnz] = BinOp(vals[cnz], vals[i]);
+		}
+		else
+		{
+			++cnz;
+			rows[cnz] = rows[i];
+			cols[cnz] = cols[i];
+			vals[cnz] = vals[i];
+		}
+	}
+	nnz = cnz+1;	// the arrays keep their capacity
+}
+
+}
@@ -0,0 +1,128 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+ 
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+ 
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+ 
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _SP_TUPLES_SOA_H
+#define _SP_TUPLES_SOA_H
+
+#include <iostream>
+#include <cassert>
+#include "SpDefs.h"
+#include "SpTuples.h"
+#include "PBBS/radixSort.h"
+
+namespace combblas {
+
+template <class IU, class NU>
+class SpDCCols;
+
+/**
+ * Structure-of-arrays counterpart of SpTuples: row indices, column indices and values live in three separate arrays
+ * Sorting moves each array exactly once (the radix sort only permutes packed keys), and a column sorted object
+ * is converted into SpDCCols without copying its rows and values: they become the ir and numx arrays of the Dcsc
+ * \remarks Indices start from 0 in this class
+ * \remarks Arrays are allocated with new[], as Dcsc expects
+ */
+template <class IT, class NT>
+class SpTuplesSoA
+{
+public:
+	SpTuplesSoA (int64_t size, IT nRow, IT nCol);	//!< uninitialized arrays of the given size
+	SpTuplesSoA (const SpTuples<IT,NT> & rhs);
+	~SpTuplesSoA();
+
+	SpTuplesSoA (const SpTuplesSoA<IT,NT> & rhs) = delete;
+	SpTuplesSoA<IT,NT> & operator=(const SpTuplesSoA<IT,NT> & rhs) = delete;
+
+	void SortColBased() { Sort(true); }
+	void SortRowBased() { Sort(false); }
+
+	template <typename BINFUNC>
+	void RemoveDuplicates(BINFUNC BinOp);	//!< @pre {sorted either way}
+
+	IT getnrow() const { return m; }
+	IT getncol() const { return n; }
+	int64_t getnnz() const { return nnz; }
+
+	IT * rows;
+	IT * cols;
+	NT * vals;
+
+private:
+	void Sort(bool colmajor);
+	template <typename T>
+	void Permute(T * & arr, const int64_t * perm);	//!< arr[i] = arr[perm[i]] through a fresh array, freeing the old one
+
+	IT m;
+	IT n;
+	int64_t nnz;
+
+	template <class IU, class NU>
+	friend class SpDCCols;
+};
+
+/**
+ * Builds a local matrix of type DER out of a SpTuplesSoA through an SpTuples copy
+ */
+template <class DER, class IT, class NT>
+DER * SoAToLocalCopy(SpTuplesSoA<IT,NT> & rhs)
+{
+	rhs.SortColBased();
+	int64_t nnz = rhs.getnnz();
+	std::tuple<IT,IT,NT> * tuples = (nnz > 0) ? new std::tuple<IT,IT,NT>[nnz] : NULL;
+	for(int64_t i=0; i< nnz; ++i)
+		tuples[i] = std::make_tuple(rhs.rows[i], rhs.cols[i], rhs.vals[i]);
+	SpTuples<IT,NT> A(nnz, rhs.getnrow(), rhs.getncol(), tuples, true);	// It is ~SpTuples's job to deallocate
+	return new DER(A, false);
+}
+
+/**
+ * Builds a local matrix of type DER out of a SpTuplesSoA
+ * SpDCCols takes over the row and value arrays (leaving rhs empty), other local matrices are copied
+ */
+template <class DER>
+struct SoAToLocal
+{
+	template <class IT, class NT>
+	static DER * Convert(SpTuplesSoA<IT,NT> & rhs) { return SoAToLocalCopy<DER>(rhs); }
+};
+
+template <class IU, class NU>
+struct SoAToLocal< SpDCCols<IU,NU> >
+{
+	static SpDCCols<IU,NU> * Convert(SpTuplesSoA<IU,NU> & rhs) { return new SpDCCols<IU,NU>(rhs); }
+
+	template <class IT>
+	static SpDCCols<IU,NU> * Convert(SpTuplesSoA<IT,NU> & rhs) { return SoAToLocalCopy< SpDCCols<IU,NU> >(rhs); }	// other index type
+};
+
+}
+
+#include "SpTuplesSoA.cpp"
+
+#endif
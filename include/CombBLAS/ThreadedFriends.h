@@ -71,12 +71,8 @@ SpTuples<IT, NTO> * LocalSpGEMM
     
     Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
     Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-    IT nA = A.getncol();
     IT cnzmax = Adcsc->nz + Bdcsc->nz;	// estimate on the size of resulting matrix C
-    float cf  = static_cast<float>(nA+1) / static_cast<float>(Adcsc->nzc);
-    IT csize = static_cast<IT>(ceil(cf));   // chunk size
-    IT * aux;
-    Adcsc->ConstructAux(nA, aux);
+    DcscColIndex<IT> colindex = A.ColumnIndex();
     
     int numThreads = 1;	// default case
 #ifdef THREADED
@@ -86,7 +82,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
     }
 #endif
     
-    IT* colnnzC = estimateNNZ(A, B);
+    IT* colnnzC = estimateNNZ(A, B, colindex);
     IT* colptrC = prefixsum<IT>(colnnzC, Bdcsc->nzc, numThreads);
     delete [] colnnzC;
     IT nnzc = colptrC[Bdcsc->nzc];
@@ -117,7 +113,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
         
         // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
         // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
         std::pair<IT,IT> * colinds = colindsVec[myThread].data();
         HeapEntry<IT,NT1> * wset = globalheapVec[myThread].data();
         IT hsize = 0;
@@ -172,7 +168,6 @@ SpTuples<IT, NTO> * LocalSpGEMM
         delete const_cast<SpDCCols<IT, NT2> *>(&B);
     
     delete [] colptrC;
-    delete [] aux;
     
     SpTuples<IT, NTO>* spTuplesC = new SpTuples<IT, NTO> (nnzc, mdim, ndim, tuplesC, true);
     return spTuplesC;
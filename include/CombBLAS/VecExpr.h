@@ -0,0 +1,317 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _VEC_EXPR_H_
+#define _VEC_EXPR_H_
+
+#include <mpi.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <type_traits>
+#include <vector>
+#include "CommGrid.h"
+#include "MPIType.h"
+#include "MPIOp.h"
+#include "SpDefs.h"
+
+namespace combblas {
+
+template <class IU, class NU>
+class FullyDistVec;
+
+template <class IU, class NU>
+class FullyDistSpVec;
+
+/**
+ * Lazy element-wise expressions over distributed vectors
+ * Chains of Apply/EWiseApply/Select calls build a small expression tree instead of a
+ * temporary vector per call. The tree is evaluated in a single threaded loop over the
+ * local arrays when it is assigned to a FullyDistVec, converted to a FullyDistSpVec,
+ * or reduced, and grid compatibility is checked once for the whole tree.
+ * Example: D = Zip(Zip(Lazy(D), Lazy(gp), BinaryMin<IT>()), Lazy(mngp), BinaryMin<IT>());
+ * Expressions only hold references to their operands, so they should not outlive them.
+ * All operations are local; communication happens only when reducing the expression.
+ **/
+template <class DERIVED>
+struct VecExpr
+{
+	const DERIVED & self() const { return static_cast<const DERIVED &>(*this); }
+};
+
+/**
+ * The local iteration space of an expression: every local entry if all operands are
+ * dense, or the local nonzeros if a sparse operand is involved (then all sparse
+ * operands must share the same nonzero pattern)
+ **/
+template <class IT>
+struct VecDomain
+{
+	VecDomain(): glen(0), size(0), sparse(false), ind(NULL) {}
+
+	//! locind (the local indices of a sparse operand) is ignored for dense operands
+	void Add(std::shared_ptr<CommGrid> grid, IT length, IT locsize, bool locsparse, const IT * locind)
+	{
+		if(!commGrid)
+		{
+			commGrid = grid;
+			glen = length;
+		}
+		else if(!(*commGrid == *grid))
+		{
+			std::cout << "Grids are not comparable for vector expression" << std::endl;
+			MPI_Abort(MPI_COMM_WORLD, GRIDMISMATCH);
+		}
+		else if(glen != length)
+		{
+			std::cout << "Vector dimensions don't match (" << glen << " vs " << length << ") for vector expression" << std::endl;
+			MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+		}
+
+		if(!locsparse)
+		{
+			if(!sparse) size = locsize;
+		}
+		else if(!sparse)
+		{
+			sparse = true;
+			ind = locind;
+			size = locsize;
+		}
+		else if(ind != locind && (size != locsize || !std::equal(ind, ind+size, locind)))
+		{
+			std::cout << "Sparse operands of a vector expression need the same nonzero pattern" << std::endl;
+			MPI_Abort(MPI_COMM_WORLD, DIMMISMATCH);
+		}
+	}
+
+	bool IsSparse() const { return sparse; }
+	IT LocalIndex(IT k) const { return sparse ? ind[k] : k; }
+
+	std::shared_ptr<CommGrid> commGrid;
+	IT glen;
+	IT size;	// number of local entries to evaluate
+	bool sparse;
+	const IT * ind;	// local indices of the entries of a sparse domain
+};
+
+
+//! Leaf for a dense vector, evaluated at local index i
+template <class IT, class NT>
+class VecDenseLeaf: public VecExpr< VecDenseLeaf<IT,NT> >
+{
+public:
+	typedef IT index_type;
+	typedef NT value_type;
+
+	VecDenseLeaf(const FullyDistVec<IT,NT> & v): vec(v) {}
+
+	void Domain(VecDomain<IT> & dom) const
+	{
+		dom.Add(vec.getcommgrid(), vec.TotalLength(), vec.LocArrSize(), false, NULL);
+		arr = vec.GetLocArr();
+	}
+	NT operator()(IT k, IT i) const { return arr[i]; }
+
+private:
+	const FullyDistVec<IT,NT> & vec;
+	mutable const NT * arr;	// cached when the domain is formed, right before evaluation
+};
+
+//! Leaf for a sparse vector, evaluated at its k-th local nonzero
+template <class IT, class NT>
+class VecSparseLeaf: public VecExpr< VecSparseLeaf<IT,NT> >
+{
+public:
+	typedef IT index_type;
+	typedef NT value_type;
+
+	VecSparseLeaf(const FullyDistSpVec<IT,NT> & v): vec(v) {}
+
+	void Domain(VecDomain<IT> & dom) const
+	{
+		dom.Add(vec.getcommgrid(), vec.TotalLength(), static_cast<IT>(vec.ind.size()), true, vec.ind.data());
+		num = vec.num.data();
+	}
+	NT operator()(IT k, IT i) const { return num[k]; }
+
+private:
+	const FullyDistSpVec<IT,NT> & vec;
+	mutable const NT * num;
+};
+
+//! Leaf for the global index of each entry, like the index argument of ApplyInd
+template <class IT>
+class VecIndexLeaf: public VecExpr< VecIndexLeaf<IT> >
+{
+public:
+	typedef IT index_type;
+	typedef IT value_type;
+
+	template <class NT>
+	VecIndexLeaf(const FullyDistVec<IT,NT> & v): commGrid(v.getcommgrid()), glen(v.TotalLength()), locsize(v.LocArrSize()), offset(v.LengthUntil()) {}
+
+	void Domain(VecDomain<IT> & dom) const { dom.Add(commGrid, glen, locsize, false, NULL); }
+	IT operator()(IT k, IT i) const { return offset + i; }
+
+private:
+	std::shared_ptr<CommGrid> commGrid;
+	IT glen;
+	IT locsize;
+	IT offset;
+};
+
+template <class E, typename _UnaryOperation>
+class VecMap: public VecExpr< VecMap<E,_UnaryOperation> >
+{
+public:
+	typedef typename E::index_type index_type;
+	typedef typename std::decay<typename std::result_of<_UnaryOperation&(typename E::value_type)>::type>::type value_type;
+
+	VecMap(const E & e, _UnaryOperation op): expr(e), __unary_op(op) {}
+
+	void Domain(VecDomain<index_type> & dom) const { expr.Domain(dom); }
+	value_type operator()(index_type k, index_type i) const { return __unary_op(expr(k, i)); }
+
+private:
+	E expr;
+	mutable _UnaryOperation __unary_op;	// some functors in the tree have non-const operator()
+};
+
+template <class E1, class E2, typename _BinaryOperation>
+class VecZip: public VecExpr< VecZip<E1,E2,_BinaryOperation> >
+{
+public:
+	typedef typename E1::index_type index_type;
+	typedef typename std::decay<typename std::result_of<_BinaryOperation&(typename E1::value_type, typename E2::value_type)>::type>::type value_type;
+
+	VecZip(const E1 & e1, const E2 & e2, _BinaryOperation op): lhs(e1), rhs(e2), __binary_op(op) {}
+
+	void Domain(VecDomain<index_type> & dom) const
+	{
+		lhs.Domain(dom);
+		rhs.Domain(dom);
+	}
+	value_type operator()(index_type k, index_type i) const { return __binary_op(lhs(k, i), rhs(k, i)); }
+
+private:
+	E1 lhs;
+	E2 rhs;
+	mutable _BinaryOperation __binary_op;
+};
+
+
+//! Collects the domain of an expression, checking its operands for compatibility
+template <class E>
+VecDomain<typename E::index_type> GetDomain(const VecExpr<E> & e)
+{
+	VecDomain<typename E::index_type> dom;
+	e.self().Domain(dom);
+	return dom;
+}
+
+template <class IT, class NT>
+VecDenseLeaf<IT,NT> Lazy(const FullyDistVec<IT,NT> & v) { return VecDenseLeaf<IT,NT>(v); }
+
+template <class IT, class NT>
+VecSparseLeaf<IT,NT> Lazy(const FullyDistSpVec<IT,NT> & v) { return VecSparseLeaf<IT,NT>(v); }
+
+template <class IT, class NT>
+VecIndexLeaf<IT> LazyIndex(const FullyDistVec<IT,NT> & v) { return VecIndexLeaf<IT>(v); }
+
+template <class E, typename _UnaryOperation>
+VecMap<E,_UnaryOperation> Map(const VecExpr<E> & e, _UnaryOperation __unary_op)
+{
+	return VecMap<E,_UnaryOperation>(e.self(), __unary_op);
+}
+
+template <class E1, class E2, typename _BinaryOperation>
+VecZip<E1,E2,_BinaryOperation> Zip(const VecExpr<E1> & e1, const VecExpr<E2> & e2, _BinaryOperation __binary_op)
+{
+	return VecZip<E1,E2,_BinaryOperation>(e1.self(), e2.self(), __binary_op);
+}
+
+
+/**
+ * Reduces the expression over all entries of its domain with a single allreduce
+ * @pre __binary_op is associative and commutative, and has an MPIOp mapping (e.g. std::plus, maximum)
+ **/
+template <class E, typename _BinaryOperation>
+typename E::value_type Reduce(const VecExpr<E> & e, _BinaryOperation __binary_op, typename E::value_type identity)
+{
+	typedef typename E::index_type IT;
+	typedef typename E::value_type NT;
+	const E & expr = e.self();
+	VecDomain<IT> dom = GetDomain(e);
+
+	NT localsum = identity;
+#ifdef _OPENMP
+#pragma omp parallel
+#endif
+	{
+		NT threadsum = identity;
+#ifdef _OPENMP
+#pragma omp for nowait
+#endif
+		for(IT k = 0; k < dom.size; ++k)
+			threadsum = __binary_op(threadsum, expr(k, dom.LocalIndex(k)));
+#ifdef _OPENMP
+#pragma omp critical
+#endif
+		localsum = __binary_op(localsum, threadsum);
+	}
+
+	NT totalsum = identity;
+	MPI_Allreduce(&localsum, &totalsum, 1, MPIType<NT>(), MPIOp<_BinaryOperation, NT>::op(), dom.commGrid->GetWorld());
+	return totalsum;
+}
+
+//! Number of entries of the domain for which the (boolean valued) expression holds
+template <class E>
+typename E::index_type Count(const VecExpr<E> & e)
+{
+	typedef typename E::index_type IT;
+	const E & expr = e.self();
+	VecDomain<IT> dom = GetDomain(e);
+
+	IT localcnt = 0;
+#ifdef _OPENMP
+#pragma omp parallel for reduction(+:localcnt)
+#endif
+	for(IT k = 0; k < dom.size; ++k)
+		if(expr(k, dom.LocalIndex(k))) ++localcnt;
+
+	IT totalcnt = 0;
+	MPI_Allreduce(&localcnt, &totalcnt, 1, MPIType<IT>(), MPI_SUM, dom.commGrid->GetWorld());
+	return totalcnt;
+}
+
+}
+
+#endif
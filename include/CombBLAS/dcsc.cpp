@@ -1272,6 +1272,31 @@ void Dcsc<IT,NT>::FillColInds(const VT * colnums, IT nind, std::vector< std::pai
 }
 
 
+/**
+ * Same as above, but every lookup is O(1) through a prebuilt column index of this Dcsc
+ * The scanning based intersection is never cheaper than nind constant time lookups
+ **/
+template<class IT, class NT>
+template<class VT>
+void Dcsc<IT,NT>::FillColInds(const VT * colnums, IT nind, std::vector< std::pair<IT,IT> > & colinds, const DcscColIndex<IT> & colindex) const
+{
+	bool found;
+	for(IT j =0; j< nind; ++j)
+	{
+		IT pos = colindex.Find(static_cast<IT>(colnums[j]), found);
+		if(found)
+		{
+			colinds[j].first = cp[pos];
+			colinds[j].second = cp[pos+1];
+		}
+		else 	// not found, signal by setting first = second
+		{
+			colinds[j].first = 0;
+			colinds[j].second = 0;
+		}
+	}
+}
+
 template <class IT, class NT>
 Dcsc<IT,NT>::~Dcsc()
 {
@@ -40,6 +40,7 @@
 #include "StackEntry.h"
 #include "MemoryPool.h"
 #include "promote.h"
+#include "DcscColIndex.h"
 
 namespace combblas {
 
@@ -106,6 +107,8 @@ public:
 
 	template<class VT>	
 	void FillColInds(const VT * colnums, IT nind, std::vector< std::pair<IT,IT> > & colinds, IT * aux, IT csize) const;
+	template<class VT>
+	void FillColInds(const VT * colnums, IT nind, std::vector< std::pair<IT,IT> > & colinds, const DcscColIndex<IT> & colindex) const;
 
 	Dcsc<IT,NT> & AddAndAssign (StackEntry<NT, std::pair<IT,IT> > * multstack, IT mdim, IT ndim, IT nnz);
 
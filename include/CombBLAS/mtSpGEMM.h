@@ -2,6 +2,8 @@
 #define _mtSpGEMM_h
 
 #include "CombBLAS.h"
+#include "SemiringTraits.h"
+#include "SpPatternCols.h"
 
 namespace combblas {
 /*
@@ -88,11 +90,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
 	
     Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
     Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-    IT nA = A.getncol();
-    float cf  = static_cast<float>(nA+1) / static_cast<float>(Adcsc->nzc);
-    IT csize = static_cast<IT>(ceil(cf));   // chunk size
-    IT * aux;
-    Adcsc->ConstructAux(nA, aux);
+    DcscColIndex<IT> colindex = A.ColumnIndex();	// built once, shared with estimateNNZ
 
 	
     int numThreads = 1;
@@ -103,7 +101,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
     }
 #endif
    
-    IT* colnnzC = estimateNNZ(A, B, aux,false);	// don't free aux	
+    IT* colnnzC = estimateNNZ(A, B, colindex);
     IT* colptrC = prefixsum<IT>(colnnzC, Bdcsc->nzc, numThreads);
     delete [] colnnzC;
     IT nnzc = colptrC[Bdcsc->nzc];
@@ -139,7 +137,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
         
         // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
         // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
         std::pair<IT,IT> * colinds = colindsVec[myThread].data();
         HeapEntry<IT,NT1> * wset = globalheapVec[myThread].data();
         IT hsize = 0;
@@ -149,7 +147,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
         {
             if(colinds[j].first != colinds[j].second)	// current != end
             {
-                wset[hsize++] = HeapEntry< IT,NT1 > (Adcsc->ir[colinds[j].first], j, Adcsc->numx[colinds[j].first]);
+                wset[hsize++] = HeapEntry< IT,NT1 > (Adcsc->ir[colinds[j].first], j, MatrixOperand<SR>(Adcsc->numx, colinds[j].first));
             }
         }
         std::make_heap(wset, wset+hsize);
@@ -178,7 +176,7 @@ SpTuples<IT, NTO> * LocalSpGEMM
             {
                 // runr stays the same !
                 wset[hsize-1].key = Adcsc->ir[colinds[locb].first];
-                wset[hsize-1].num = Adcsc->numx[colinds[locb].first];
+                wset[hsize-1].num = MatrixOperand<SR>(Adcsc->numx, colinds[locb].first);
                 std::push_heap(wset, wset+hsize);
             }
             else
@@ -194,7 +192,6 @@ SpTuples<IT, NTO> * LocalSpGEMM
         delete const_cast<SpDCCols<IT, NT2> *>(&B);
     
     delete [] colptrC;
-    delete [] aux;
     
     SpTuples<IT, NTO>* spTuplesC = new SpTuples<IT, NTO> (nnzc, mdim, ndim, tuplesC, true, true);
     return spTuplesC;
@@ -210,12 +207,16 @@ bool sort_less(const std::pair<IT, NT> &left, const std::pair<IT, NT> &right)
 }
 
 // Hybrid approach of multithreaded HeapSpGEMM and HashSpGEMM
-template <typename SR, typename NTO, typename IT, typename NT1, typename NT2>
-SpTuples<IT, NTO> * LocalHybridSpGEMM
-(const SpDCCols<IT, NT1> & A,
- const SpDCCols<IT, NT2> & B,
- bool clearA, bool clearB, IT * aux = nullptr)
+// Works on any Dcsc based local matrix (SpDCCols or SpPatternCols) on either side
+template <typename SR, typename NTO, typename DERA, typename DERB>
+SpTuples<typename DERA::LocalIT, NTO> * LocalHybridSpGEMM
+(const DERA & A,
+ const DERB & B,
+ bool clearA, bool clearB)
 {
+    typedef typename DERA::LocalIT IT;
+    typedef typename DERA::LocalNT NT1;
+    typedef typename DERB::LocalNT NT2;
 
 
     IT mdim = A.getnrow();
@@ -225,20 +226,12 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
     {
         return new SpTuples<IT, NTO>(0, mdim, ndim);
     }
+    KERNELPROFILE_SCOPE("LocalHybridSpGEMM");
 	
 	
     Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
     Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-    IT nA = A.getncol();
-    float cf  = static_cast<float>(nA+1) / static_cast<float>(Adcsc->nzc);
-    IT csize = static_cast<IT>(ceil(cf));   // chunk size
-    //IT * aux;
-    bool deleteAux = false;
-    if(aux==nullptr)
-    {
-	deleteAux = true;
-    	Adcsc->ConstructAux(nA, aux);
-    }
+    DcscColIndex<IT> colindex = A.ColumnIndex();	// built once, shared with estimateFLOP and estimateNNZ_Hash
 	
     int numThreads = 1;
 #ifdef THREADED
@@ -250,13 +243,13 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
    
     // std::cout << "numThreads: " << numThreads << std::endl;
 
-    IT* flopC =  estimateFLOP(A, B, aux);
+    IT* flopC =  estimateFLOP(A, B, colindex);
     //IT* flopptr = prefixsum<IT>(flopC, Bdcsc->nzc, numThreads);
     //IT flop = flopptr[Bdcsc->nzc];
     // std::cout << "FLOP of A * B is " << flop << std::endl;
 
 
-    IT* colnnzC = estimateNNZ_Hash(A, B, flopC, aux);
+    IT* colnnzC = estimateNNZ_Hash(A, B, flopC, colindex);
     IT* flopptr = prefixsum<IT>(flopC, Bdcsc->nzc, numThreads);
     IT flop = flopptr[Bdcsc->nzc];
     IT* colptrC = prefixsum<IT>(colnnzC, Bdcsc->nzc, numThreads);
@@ -264,6 +257,9 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
     delete [] flopC;
     IT nnzc = colptrC[Bdcsc->nzc];
     //double compression_ratio = (double)flop / nnzc;
+    // compulsory traffic: both inputs are read and the output tuples are written once
+    KERNELPROFILE_WORK(2.0 * flop, static_cast<double>(nnzA) * (sizeof(IT) + sizeof(NT1)) + static_cast<double>(B.getnnz()) * (sizeof(IT) + sizeof(NT2))
+                       + static_cast<double>(nnzc) * sizeof(std::tuple<IT,IT,NTO>));
 
 
     // std::cout << "NNZ of A * B is " << nnzc << std::endl;
@@ -304,7 +300,7 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
         
         // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
         // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
         std::pair<IT,IT> * colinds = colindsVec[myThread].data();
 
         double cr = static_cast<double>(flopptr[i+1] - flopptr[i]) / (colptrC[i+1] - colptrC[i]);
@@ -322,7 +318,7 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
             {
                 if(colinds[j].first != colinds[j].second)	// current != end
                 {
-                    wset[hsize++] = HeapEntry< IT,NT1 > (Adcsc->ir[colinds[j].first], j, Adcsc->numx[colinds[j].first]);
+                    wset[hsize++] = HeapEntry< IT,NT1 > (Adcsc->ir[colinds[j].first], j, StoredOperand<SR,DERA>(Adcsc->numx, colinds[j].first));
                 }
             }
             std::make_heap(wset, wset+hsize);
@@ -333,7 +329,7 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
                 std::pop_heap(wset, wset + hsize);         // result is stored in wset[hsize-1]
                 IT locb = wset[hsize-1].runr;	// relative location of the nonzero in B's current column
             
-                NTO mrhs = SR::multiply(wset[hsize-1].num, Bdcsc->numx[Bdcsc->cp[i]+locb]);
+                NTO mrhs = SR::multiply(wset[hsize-1].num, StoredValue<DERB>(Bdcsc->numx, Bdcsc->cp[i]+locb));
                 if (!SR::returnedSAID())
                 {
                     if( (curptr > colptrC[i]) && std::get<0>(tuplesC[curptr-1]) == wset[hsize-1].key)
@@ -349,7 +345,7 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
                 {
                     // runr stays the same !
                     wset[hsize-1].key = Adcsc->ir[colinds[locb].first];
-                    wset[hsize-1].num = Adcsc->numx[colinds[locb].first];
+                    wset[hsize-1].num = StoredOperand<SR,DERA>(Adcsc->numx, colinds[locb].first);
                     std::push_heap(wset, wset+hsize);
                 }
                 else
@@ -395,10 +391,10 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
             for (size_t j=0; j < nnzcolB; ++j)
             {
                 IT t_bcol = Bdcsc->ir[Bdcsc->cp[i] + j];
-                NT2 t_bval = Bdcsc->numx[Bdcsc->cp[i] + j];
+                NT2 t_bval = StoredValue<DERB>(Bdcsc->numx, Bdcsc->cp[i] + j);
                 for (IT k = colinds[j].first; k < colinds[j].second; ++k)
                 {
-                    NTO mrhs = SR::multiply(Adcsc->numx[k], t_bval);
+                    NTO mrhs = SR::multiply(StoredOperand<SR,DERA>(Adcsc->numx, k), t_bval);
                     IT key = Adcsc->ir[k];
                     IT hash = (key*hashScale) & (ht_size-1);
                     while (1) //hash probing
@@ -441,14 +437,12 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
     }
     
     if(clearA)
-        delete const_cast<SpDCCols<IT, NT1> *>(&A);
+        delete const_cast<DERA *>(&A);
     if(clearB)
-        delete const_cast<SpDCCols<IT, NT2> *>(&B);
+        delete const_cast<DERB *>(&B);
     
     delete [] colptrC;
     delete [] flopptr;
-    if(deleteAux)
-    	delete [] aux;
     
     SpTuples<IT, NTO>* spTuplesC = new SpTuples<IT, NTO> (nnzc, mdim, ndim, tuplesC, true, true);
 
@@ -459,6 +453,16 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
     return spTuplesC;
 }
 
+// Former signature, aux is no longer used and stays owned by the caller
+template <typename SR, typename NTO, typename IT, typename NT1, typename NT2>
+SpTuples<IT, NTO> * LocalHybridSpGEMM
+(const SpDCCols<IT, NT1> & A,
+ const SpDCCols<IT, NT2> & B,
+ bool clearA, bool clearB, typename SpDCCols<IT, NT1>::LocalIT * aux)
+{
+    return LocalHybridSpGEMM<SR, NTO>(A, B, clearA, clearB);
+}
+
     // Hybrid approach of multithreaded HeapSpGEMM and HashSpGEMM
     template <typename SR, typename NTO, typename IT, typename NT1, typename NT2>
     SpTuples<IT, NTO> * LocalSpGEMMHash
@@ -476,15 +480,12 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
         {
             return new SpTuples<IT, NTO>(0, mdim, ndim);
         }
+        KERNELPROFILE_SCOPE("LocalSpGEMMHash");
 
 
         Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
         Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-        IT nA = A.getncol();
-        float cf  = static_cast<float>(nA+1) / static_cast<float>(Adcsc->nzc);
-        IT csize = static_cast<IT>(ceil(cf));   // chunk size
-        IT * aux;
-        Adcsc->ConstructAux(nA, aux);
+        DcscColIndex<IT> colindex = A.ColumnIndex();
 
 
         int numThreads = 1;
@@ -497,17 +498,19 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
 
         // std::cout << "numThreads: " << numThreads << std::endl;
 
-        IT* flopC = estimateFLOP(A, B);
+        IT* flopC = estimateFLOP(A, B, colindex);
         IT* flopptr = prefixsum<IT>(flopC, Bdcsc->nzc, numThreads);
         IT flop = flopptr[Bdcsc->nzc];
         // std::cout << "FLOP of A * B is " << flop << std::endl;
 
-        IT* colnnzC = estimateNNZ_Hash(A, B, flopC);
+        IT* colnnzC = estimateNNZ_Hash(A, B, flopC, colindex);
         IT* colptrC = prefixsum<IT>(colnnzC, Bdcsc->nzc, numThreads);
         delete [] colnnzC;
         delete [] flopC;
         IT nnzc = colptrC[Bdcsc->nzc];
         double compression_ratio = (double)flop / nnzc;
+        KERNELPROFILE_WORK(2.0 * flop, static_cast<double>(nnzA) * (sizeof(IT) + sizeof(NT1)) + static_cast<double>(B.getnnz()) * (sizeof(IT) + sizeof(NT2))
+                           + static_cast<double>(nnzc) * sizeof(std::tuple<IT,IT,NTO>));
 
         // std::cout << "NNZ of A * B is " << nnzc << std::endl;
         // std::cout << "Compression ratio is " << compression_ratio << std::endl;
@@ -543,7 +546,7 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
 
             // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
             // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-            Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+            Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
             std::pair<IT,IT> * colinds = colindsVec[myThread].data();
 
 
@@ -578,7 +581,7 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
                 NT2 t_bval = Bdcsc->numx[Bdcsc->cp[i] + j];
                 for (IT k = colinds[j].first; k < colinds[j].second; ++k)
                 {
-                    NTO mrhs = SR::multiply(Adcsc->numx[k], t_bval);
+                    NTO mrhs = SR::multiply(MatrixOperand<SR>(Adcsc->numx, k), t_bval);
                     IT key = Adcsc->ir[k];
                     IT hash = (key*hashScale) & (ht_size-1);
                     while (1) //hash probing
@@ -643,7 +646,6 @@ SpTuples<IT, NTO> * LocalHybridSpGEMM
 
         delete [] colptrC;
         delete [] flopptr;
-        delete [] aux;
 
         SpTuples<IT, NTO>* spTuplesC = new SpTuples<IT, NTO> (nnzc, mdim, ndim, tuplesC, true, false);
 
@@ -690,7 +692,7 @@ IT EstimateLocalFLOP
 
 // estimate space for result of SpGEMM
 template <typename IT, typename NT1, typename NT2>
-IT* estimateNNZ(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * aux = nullptr, bool freeaux = true)
+IT* estimateNNZ(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, const DcscColIndex<IT> & colindex)
 {
     IT nnzA = A.getnnz();
     if(A.isZero() || B.isZero())
@@ -700,13 +702,6 @@ IT* estimateNNZ(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * au
     
     Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
     Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-    
-    float cf  = static_cast<float>(A.getncol()+1) / static_cast<float>(Adcsc->nzc);
-    IT csize = static_cast<IT>(ceil(cf));   // chunk size
-    if(aux == nullptr)
-    {
-	    Adcsc->ConstructAux(A.getncol(), aux);
-    }
 	
 	
     int numThreads = 1;
@@ -757,7 +752,7 @@ IT* estimateNNZ(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * au
 		
         // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
         // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
         std::pair<IT,IT> * colinds = colindsVec[myThread].data();
         std::pair<IT,IT> * curheap = globalheapVec[myThread].data();
         IT hsize = 0;
@@ -797,15 +792,28 @@ IT* estimateNNZ(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * au
         }
     }
     
+    return colnnzC;
+}
+
+// estimate space for result of SpGEMM, building the column index of A
+// aux is no longer used by the kernel, it is only freed if freeaux is set
+template <typename IT, typename NT1, typename NT2>
+IT* estimateNNZ(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * aux = nullptr, bool freeaux = true)
+{
+    IT* colnnzC = estimateNNZ(A, B, A.ColumnIndex());
     if (freeaux) delete [] aux;
     return colnnzC;
 }
 
 
 // estimate space for result of SpGEMM with Hash
-template <typename IT, typename NT1, typename NT2>
-IT* estimateNNZ_Hash(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT *flopC, IT * aux=nullptr)
+template <typename DERA, typename DERB>
+typename DERA::LocalIT* estimateNNZ_Hash(const DERA & A,const DERB & B, typename DERA::LocalIT *flopC,
+					 const DcscColIndex<typename DERA::LocalIT> & colindex)
 {
+    typedef typename DERA::LocalIT IT;
+    typedef typename DERA::LocalNT NT1;
+    typedef typename DERB::LocalNT NT2;
     IT nnzA = A.getnnz();
     if(A.isZero() || B.isZero())
     {
@@ -814,15 +822,6 @@ IT* estimateNNZ_Hash(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT
     
     Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
     Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-    
-    float cf  = static_cast<float>(A.getncol()+1) / static_cast<float>(Adcsc->nzc);
-    IT csize = static_cast<IT>(ceil(cf));   // chunk size
-    bool deleteAux = false;
-    if(aux==nullptr)
-    {
-	deleteAux = true; 
-    	Adcsc->ConstructAux(A.getncol(), aux);
-    }	
 	
     int numThreads = 1;
 #ifdef THREADED
@@ -873,7 +872,7 @@ IT* estimateNNZ_Hash(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT
 		
         // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
         // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
         std::pair<IT,IT> * colinds = colindsVec[myThread].data();
 
         // Hash
@@ -927,11 +926,17 @@ IT* estimateNNZ_Hash(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT
         }
     }
     
-    if(deleteAux)
-    	delete [] aux;
     return colnnzC;
 }
 
+// estimate space for result of SpGEMM with Hash, building the column index of A
+// aux is no longer used and stays owned by the caller
+template <typename DERA, typename DERB>
+typename DERA::LocalIT* estimateNNZ_Hash(const DERA & A,const DERB & B, typename DERA::LocalIT *flopC, typename DERA::LocalIT * aux = nullptr)
+{
+    return estimateNNZ_Hash(A, B, flopC, A.ColumnIndex());
+}
+
 // sampling-based nnz estimation (within SUMMA)
 template <typename IT, typename NT1, typename NT2>
 int64_t
@@ -1054,9 +1059,12 @@ estimateNNZ_sampling(
 }
 
 // estimate the number of floating point operations of SpGEMM
-template <typename IT, typename NT1, typename NT2>
-IT* estimateFLOP(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * aux = nullptr)
+template <typename DERA, typename DERB>
+typename DERA::LocalIT* estimateFLOP(const DERA & A,const DERB & B, const DcscColIndex<typename DERA::LocalIT> & colindex)
 {
+    typedef typename DERA::LocalIT IT;
+    typedef typename DERA::LocalNT NT1;
+    typedef typename DERB::LocalNT NT2;
     IT nnzA = A.getnnz();
     if(A.isZero() || B.isZero())
     {
@@ -1065,16 +1073,6 @@ IT* estimateFLOP(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * a
     
     Dcsc<IT,NT1>* Adcsc = A.GetDCSC();
     Dcsc<IT,NT2>* Bdcsc = B.GetDCSC();
-    
-    float cf  = static_cast<float>(A.getncol()+1) / static_cast<float>(Adcsc->nzc);
-    IT csize = static_cast<IT>(ceil(cf));   // chunk size
-    //IT * aux;
-    bool deleteAux = false;
-    if(aux==nullptr)
-    {
-        deleteAux = true;
-        Adcsc->ConstructAux(A.getncol(), aux);
-    }
 	
 	
     int numThreads = 1;
@@ -1123,16 +1121,22 @@ IT* estimateFLOP(const SpDCCols<IT, NT1> & A,const SpDCCols<IT, NT2> & B, IT * a
 		
         // colinds.first vector keeps indices to A.cp, i.e. it dereferences "colnums" vector (above),
         // colinds.second vector keeps the end indices (i.e. it gives the index to the last valid element of A.cpnack)
-        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], aux, csize);
+        Adcsc->FillColInds(Bdcsc->ir + Bdcsc->cp[i], nnzcolB, colindsVec[myThread], colindex);
         for (IT j = 0; (unsigned)j < nnzcolB; ++j) {
             colflopC[i] += colindsVec[myThread][j].second - colindsVec[myThread][j].first;
         }
     }
-    if(deleteAux)
-    	delete [] aux;
     return colflopC;
 }
 
+// estimate the number of floating point operations of SpGEMM, building the column index of A
+// aux is no longer used and stays owned by the caller
+template <typename DERA, typename DERB>
+typename DERA::LocalIT* estimateFLOP(const DERA & A,const DERB & B, typename DERA::LocalIT * aux = nullptr)
+{
+    return estimateFLOP(A, B, A.ColumnIndex());
+}
+
 
 
 
@@ -1159,6 +1163,7 @@ LocalHybridSpGEMM (const SpCCols<IT, NT1>	&A,
 
 	if(A.isZero() || B.isZero())
 		return new SpTuples<IT, NTO>(0, mdim, ndim);
+	KERNELPROFILE_SCOPE("LocalHybridSpGEMM");
 
 	Csc<IT, NT1> *Acsc = A.GetCSC();
 	Csc<IT, NT2> *Bcsc = B.GetCSC();
@@ -1181,6 +1186,8 @@ LocalHybridSpGEMM (const SpCCols<IT, NT1>	&A,
     delete [] flopC;
 	IT		nnzc			  = colptrC[Bcsc->n];
 	double	compression_ratio = (double)flop / nnzc;
+	KERNELPROFILE_WORK(2.0 * flop, static_cast<double>(nnzA) * (sizeof(IT) + sizeof(NT1)) + static_cast<double>(B.getnnz()) * (sizeof(IT) + sizeof(NT2))
+					   + static_cast<double>(nnzc) * sizeof(std::tuple<IT, IT, NTO>));
 	
 	std::tuple<IT, IT, NTO> *tuplesC = static_cast<std::tuple<IT, IT, NTO> *>
 		(::operator new (sizeof(std::tuple<IT, IT, NTO>[nnzc])));
@@ -0,0 +1,187 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#include <algorithm>
+#include <map>
+#include "packeddcsc.h"
+
+namespace combblas {
+
+template <class IT, class NT>
+PackedDcsc<IT,NT>::PackedDcsc(): nz(0), nzc(0), n(0), valenc(RAWVALUES)
+{
+	cp.push_back(0);
+	bp.push_back(0);
+	BuildIndex();
+}
+
+template <class IT, class NT>
+PackedDcsc<IT,NT>::PackedDcsc(const Dcsc<IT,NT> & rhs, IT ndim): nz(rhs.nz), nzc(rhs.nzc), n(ndim), valenc(RAWVALUES)
+{
+	jc.assign(rhs.jc, rhs.jc + nzc);
+	cp.assign(rhs.cp, rhs.cp + nzc + 1);
+	PackRows(rhs);
+	PackValues(rhs, std::integral_constant<bool, std::is_arithmetic<NT>::value>());
+	BuildIndex();
+}
+
+template <class IT, class NT>
+PackedDcsc<IT,NT>::PackedDcsc(const PackedDcsc<IT,NT> & rhs)
+: jc(rhs.jc), cp(rhs.cp), bp(rhs.bp), width(rhs.width), rowbytes(rhs.rowbytes), numx(rhs.numx), codes(rhs.codes),
+  nz(rhs.nz), nzc(rhs.nzc), n(rhs.n), valenc(rhs.valenc)
+{
+	BuildIndex();
+}
+
+template <class IT, class NT>
+PackedDcsc<IT,NT> & PackedDcsc<IT,NT>::operator=(const PackedDcsc<IT,NT> & rhs)
+{
+	if(this != &rhs)
+	{
+		jc = rhs.jc;
+		cp = rhs.cp;
+		bp = rhs.bp;
+		width = rhs.width;
+		rowbytes = rhs.rowbytes;
+		numx = rhs.numx;
+		codes = rhs.codes;
+		nz = rhs.nz;
+		nzc = rhs.nzc;
+		n = rhs.n;
+		valenc = rhs.valenc;
+		BuildIndex();
+	}
+	return *this;
+}
+
+template <class IT, class NT>
+void PackedDcsc<IT,NT>::BuildIndex()
+{
+	colindex.reset(new DcscColIndex<IT>(jc.data(), nzc, n));
+}
+
+/**
+ * Chooses the narrowest width that holds all deltas of a column, then writes the deltas
+ * Two passes over ir: the first one sizes rowbytes exactly
+ **/
+template <class IT, class NT>
+void PackedDcsc<IT,NT>::PackRows(const Dcsc<IT,NT> & rhs)
+{
+	width.resize(nzc);
+	bp.resize(nzc+1);
+	bp[0] = 0;
+	for(IT j=0; j< nzc; ++j)
+	{
+		uint64_t maxdelta = 0;
+		IT prev = 0;
+		for(IT i = cp[j]; i < cp[j+1]; ++i)
+		{
+			maxdelta = std::max(maxdelta, static_cast<uint64_t>(rhs.ir[i] - prev));
+			prev = rhs.ir[i];
+		}
+		if(maxdelta <= std::numeric_limits<uint8_t>::max())		width[j] = 1;
+		else if(maxdelta <= std::numeric_limits<uint16_t>::max())	width[j] = 2;
+		else if(maxdelta <= std::numeric_limits<uint32_t>::max())	width[j] = 4;
+		else								width[j] = 8;
+		bp[j+1] = bp[j] + static_cast<size_t>(width[j]) * static_cast<size_t>(cp[j+1] - cp[j]);
+	}
+	rowbytes.resize(bp[nzc]);
+	for(IT j=0; j< nzc; ++j)
+	{
+		uint8_t * bytes = rowbytes.data() + bp[j];
+		IT prev = 0;
+		for(IT i = cp[j]; i < cp[j+1]; ++i)
+		{
+			uint64_t delta = static_cast<uint64_t>(rhs.ir[i] - prev);
+			prev = rhs.ir[i];
+			// little endian: the low order bytes come first
+			switch(width[j])
+			{
+				case 1: { uint8_t d = static_cast<uint8_t>(delta); std::memcpy(bytes, &d, 1); break; }
+				case 2: { uint16_t d = static_cast<uint16_t>(delta); std::memcpy(bytes, &d, 2); break; }
+				case 4: { uint32_t d = static_cast<uint32_t>(delta); std::memcpy(bytes, &d, 4); break; }
+				default: std::memcpy(bytes, &delta, 8); break;
+			}
+			bytes += width[j];
+		}
+	}
+}
+
+template <class IT, class NT>
+void PackedDcsc<IT,NT>::PackValues(const Dcsc<IT,NT> & rhs, std::false_type)
+{
+	if(nz > 0 && std::all_of(rhs.numx, rhs.numx + nz, [&rhs](const NT & v){ return v == rhs.numx[0]; }))
+	{
+		valenc = CONSTANT;
+		numx.assign(1, rhs.numx[0]);
+	}
+	else
+	{
+		valenc = RAWVALUES;
+		numx.assign(rhs.numx, rhs.numx + nz);
+	}
+}
+
+template <class IT, class NT>
+void PackedDcsc<IT,NT>::PackValues(const Dcsc<IT,NT> & rhs, std::true_type)
+{
+	PackValues(rhs, std::false_type());
+	if(valenc == CONSTANT || sizeof(NT) <= sizeof(uint8_t))
+		return;
+
+	std::map<NT, uint8_t> dictionary;
+	for(IT i=0; i< nz; ++i)
+	{
+		if(!(rhs.numx[i] == rhs.numx[i]))
+			return;		// NaN does not order, keep the raw values
+		if(dictionary.find(rhs.numx[i]) == dictionary.end())
+		{
+			if(dictionary.size() == 256)
+				return;		// too many distinct values, keep the raw values
+			uint8_t code = static_cast<uint8_t>(dictionary.size());
+			dictionary.insert(std::make_pair(rhs.numx[i], code));
+		}
+	}
+	valenc = DICTIONARY;
+	numx.resize(dictionary.size());
+	for(auto itr = dictionary.begin(); itr != dictionary.end(); ++itr)
+		numx[itr->second] = itr->first;
+	codes.resize(nz);
+	for(IT i=0; i< nz; ++i)
+		codes[i] = dictionary[rhs.numx[i]];
+}
+
+template <class IT, class NT>
+size_t PackedDcsc<IT,NT>::GetBytes() const
+{
+	return (jc.size() + cp.size()) * sizeof(IT) + bp.size() * sizeof(size_t) + width.size() + rowbytes.size()
+		+ numx.size() * sizeof(NT) + codes.size();
+}
+
+}
@@ -0,0 +1,193 @@
+/****************************************************************/
+/* Parallel Combinatorial BLAS Library (for Graph Computations) */
+/* version 1.6 -------------------------------------------------*/
+/* date: 6/15/2017 ---------------------------------------------*/
+/* authors: Ariful Azad, Aydin Buluc  --------------------------*/
+/****************************************************************/
+/*
+ Copyright (c) 2010-2017, The Regents of the University of California
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ */
+
+
+#ifndef _PACKED_DCSC_H
+#define _PACKED_DCSC_H
+
+#include <cstdlib>
+#include <cstring>
+#include <stdint.h>
+#include <vector>
+#include <memory>
+#include <type_traits>
+#include "SpDefs.h"
+#include "dcsc.h"
+#include "DcscColIndex.h"
+
+namespace combblas {
+
+/**
+ * Read-only, compressed counterpart of Dcsc for bandwidth bound SpMV and SpMSpV
+ * Row indices of each column are delta encoded with the narrowest of 1, 2, 4 or 8 bytes that fits
+ * all deltas of that column (the first delta is the row index itself), so the width is dispatched
+ * once per column and the decoding loop itself is branch free.
+ * Values are stored as
+ *	- CONSTANT: a single value, when all values are equal (pattern matrices)
+ *	- DICTIONARY: one byte code per nonzero into at most 256 distinct values (arithmetic types only)
+ *	- RAWVALUES: otherwise
+ * \pre {row indices are sorted within each column, as in every Dcsc built by the library}
+ */
+template <class IT, class NT>
+class PackedDcsc
+{
+public:
+	typedef NT value_type;
+	typedef IT index_type;
+	enum ValueEncoding { RAWVALUES, DICTIONARY, CONSTANT };
+
+	PackedDcsc ();
+	PackedDcsc (const Dcsc<IT,NT> & rhs, IT ndim);	//!< ndim: number of columns of the matrix
+	PackedDcsc (const PackedDcsc<IT,NT> & rhs);
+	PackedDcsc<IT,NT> & operator=(const PackedDcsc<IT,NT> & rhs);
+
+	//! Calls f(rowid, value) for every nonzero of the jth nonempty column, in increasing row order
+	template <typename _BinaryFunction>
+	void ForColumn(IT j, _BinaryFunction f) const
+	{
+		switch(width[j])
+		{
+			case 1: ForColumnWidth<uint8_t>(j, f); break;
+			case 2: ForColumnWidth<uint16_t>(j, f); break;
+			case 4: ForColumnWidth<uint32_t>(j, f); break;
+			default: ForColumnWidth<uint64_t>(j, f); break;
+		}
+	}
+
+	//! ForColumn for semirings whose multiply ignores the matrix value (pattern_tag is true): values are not decoded and f gets NT()
+	template <typename _BinaryFunction>
+	void ForColumn(IT j, _BinaryFunction f, std::true_type) const
+	{
+		switch(width[j])
+		{
+			case 1: ForColumnRowsWidth<uint8_t>(j, f); break;
+			case 2: ForColumnRowsWidth<uint16_t>(j, f); break;
+			case 4: ForColumnRowsWidth<uint32_t>(j, f); break;
+			default: ForColumnRowsWidth<uint64_t>(j, f); break;
+		}
+	}
+
+	template <typename _BinaryFunction>
+	void ForColumn(IT j, _BinaryFunction f, std::false_type) const
+	{
+		ForColumn(j, f);
+	}
+
+	//! Position of colid in jc, or -1 if the column is empty
+	IT FindColumn(IT colid) const
+	{
+		bool found;
+		IT pos = colindex->Find(colid, found);
+		return found ? pos : static_cast<IT>(-1);
+	}
+
+	ValueEncoding GetValueEncoding() const { return valenc; }
+	size_t GetBytes() const;	//!< total size of the arrays
+
+	std::vector<IT> jc;		//!< col indices, size nzc
+	std::vector<IT> cp;		//!< nonzero offsets of columns, size nzc+1
+	std::vector<size_t> bp;		//!< byte offsets of columns into rowbytes, size nzc+1
+	std::vector<uint8_t> width;	//!< bytes per row delta of each column
+	std::vector<uint8_t> rowbytes;	//!< delta encoded row indices
+	std::vector<NT> numx;		//!< values (RAWVALUES), distinct values (DICTIONARY), or the single value (CONSTANT)
+	std::vector<uint8_t> codes;	//!< DICTIONARY only: index into numx of every nonzero
+
+	IT nz;
+	IT nzc;
+	IT n;
+
+private:
+	template <typename DT, typename _BinaryFunction>
+	void ForColumnWidth(IT j, _BinaryFunction f) const
+	{
+		const uint8_t * bytes = rowbytes.data() + bp[j];
+		IT first = cp[j];
+		IT count = cp[j+1] - first;
+		IT rowid = 0;
+		DT delta;
+		if(valenc == CONSTANT)
+		{
+			const NT value = numx[0];
+			for(IT i=0; i< count; ++i)
+			{
+				std::memcpy(&delta, bytes + i*sizeof(DT), sizeof(DT));
+				rowid += static_cast<IT>(delta);
+				f(rowid, value);
+			}
+		}
+		else if(valenc == DICTIONARY)
+		{
+			const uint8_t * mycodes = codes.data() + first;
+			for(IT i=0; i< count; ++i)
+			{
+				std::memcpy(&delta, bytes + i*sizeof(DT), sizeof(DT));
+				rowid += static_cast<IT>(delta);
+				f(rowid, numx[mycodes[i]]);
+			}
+		}
+		else
+		{
+			for(IT i=0; i< count; ++i)
+			{
+				std::memcpy(&delta, bytes + i*sizeof(DT), sizeof(DT));
+				rowid += static_cast<IT>(delta);
+				f(rowid, numx[first+i]);
+			}
+		}
+	}
+
+	template <typename DT, typename _BinaryFunction>
+	void ForColumnRowsWidth(IT j, _BinaryFunction f) const
+	{
+		const uint8_t * bytes = rowbytes.data() + bp[j];
+		IT count = cp[j+1] - cp[j];
+		IT rowid = 0;
+		DT delta;
+		const NT value = NT();
+		for(IT i=0; i< count; ++i)
+		{
+			std::memcpy(&delta, bytes + i*sizeof(DT), sizeof(DT));
+			rowid += static_cast<IT>(delta);
+			f(rowid, value);
+		}
+	}
+
+	void PackRows(const Dcsc<IT,NT> & rhs);
+	void PackValues(const Dcsc<IT,NT> & rhs, std::true_type);	// arithmetic types: a dictionary might be used
+	void PackValues(const Dcsc<IT,NT> & rhs, std::false_type);
+	void BuildIndex();
+
+	ValueEncoding valenc;
+	std::unique_ptr< DcscColIndex<IT> > colindex;	// refers to jc, rebuilt on copy
+};
+
+}
+
+#include "packeddcsc.cpp"
+
+#endif